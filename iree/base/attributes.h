@@ -162,6 +162,19 @@
 #define IREE_UNLIKELY(x) (x)
 #endif  // IREE_HAVE_ATTRIBUTE(likely)
 
+//===----------------------------------------------------------------------===//
+// IREE_PREFETCH_READ
+//===----------------------------------------------------------------------===//
+
+// Compiler hint to prefetch the cache line containing |address| for reading.
+// Has no observable effect and is safe to use on any address, including ones
+// that are invalid to dereference.
+#if defined(__GNUC__) || defined(__clang__)
+#define IREE_PREFETCH_READ(address) __builtin_prefetch((address), 0, 3)
+#else
+#define IREE_PREFETCH_READ(address)
+#endif  // __GNUC__ || __clang__
+
 //===----------------------------------------------------------------------===//
 // IREE_ATTRIBUTE_PACKED
 //===----------------------------------------------------------------------===//
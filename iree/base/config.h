@@ -225,6 +225,18 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE 0
 #endif  // !IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE
 
+#if !defined(IREE_VM_BYTECODE_THREADED_TIER_ENABLE)
+// Enables the threaded-code execution tier for hot bytecode functions.
+// See iree/vm/bytecode_threaded.h for details.
+#define IREE_VM_BYTECODE_THREADED_TIER_ENABLE 1
+#endif  // !IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
+#if !defined(IREE_VM_BYTECODE_THREADED_TIER_THRESHOLD)
+// Number of calls to a bytecode function before it is translated into the
+// threaded-code tier.
+#define IREE_VM_BYTECODE_THREADED_TIER_THRESHOLD 16
+#endif  // !IREE_VM_BYTECODE_THREADED_TIER_THRESHOLD
+
 #if !defined(IREE_VM_EXT_I64_ENABLE)
 // Enables the 64-bit integer instruction extension.
 // Targeted from the compiler with `-iree-vm-target-extension-i64`.
@@ -22,16 +22,19 @@ struct iree_event_pool_t {
   // signal and wait on the events they get.
   iree_slim_mutex_t mutex;
   // Maximum number of events that will be maintained in the pool. More events
-  // may be allocated at any time but when they are no longer needed they will
-  // be disposed directly.
+  // may be allocated at any time but when they are no longer needed and the
+  // pool is at capacity they will be disposed directly.
+  iree_host_size_t max_capacity;
+  // Current capacity of |available_list|; grows up to |max_capacity|.
   iree_host_size_t available_capacity;
-  // Total number of available
+  // Total number of available events in |available_list|.
   iree_host_size_t available_count;
   // Dense left-aligned list of available_count events.
-  iree_event_t available_list[];
+  iree_event_t* available_list;
 };
 
-iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
+iree_status_t iree_event_pool_allocate(iree_host_size_t initial_capacity,
+                                       iree_host_size_t max_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool) {
   IREE_ASSERT_ARGUMENT(out_event_pool);
@@ -39,22 +42,31 @@ iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_event_pool_t* event_pool = NULL;
-  iree_host_size_t total_size =
-      sizeof(*event_pool) +
-      available_capacity * sizeof(event_pool->available_list[0]);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(host_allocator, total_size, (void**)&event_pool));
+      z0, iree_allocator_malloc(host_allocator, sizeof(*event_pool),
+                                (void**)&event_pool));
   event_pool->host_allocator = host_allocator;
-  event_pool->available_capacity = available_capacity;
+  iree_slim_mutex_initialize(&event_pool->mutex);
+  event_pool->max_capacity = iree_max(initial_capacity, max_capacity);
+  event_pool->available_capacity = 0;
   event_pool->available_count = 0;
+  event_pool->available_list = NULL;
 
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < available_capacity; ++i) {
-    status = iree_event_initialize(
-        /*initial_state=*/false,
-        &event_pool->available_list[event_pool->available_count++]);
-    if (!iree_status_is_ok(status)) break;
+  if (initial_capacity > 0) {
+    status = iree_allocator_malloc(
+        host_allocator, initial_capacity * sizeof(iree_event_t),
+        (void**)&event_pool->available_list);
+  }
+  if (iree_status_is_ok(status)) {
+    event_pool->available_capacity = initial_capacity;
+    for (iree_host_size_t i = 0; i < initial_capacity; ++i) {
+      status = iree_event_initialize(
+          /*initial_state=*/false,
+          &event_pool->available_list[event_pool->available_count]);
+      if (!iree_status_is_ok(status)) break;
+      ++event_pool->available_count;
+    }
   }
 
   if (iree_status_is_ok(status)) {
@@ -73,12 +85,35 @@ void iree_event_pool_free(iree_event_pool_t* event_pool) {
   for (iree_host_size_t i = 0; i < event_pool->available_count; ++i) {
     iree_event_deinitialize(&event_pool->available_list[i]);
   }
+  iree_allocator_free(host_allocator, event_pool->available_list);
   iree_slim_mutex_deinitialize(&event_pool->mutex);
   iree_allocator_free(host_allocator, event_pool);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Grows the available list such that it can hold at least |minimum_capacity|
+// events (clamped to the maximum capacity). Must be called with the lock held.
+// Failure to grow is not an error as the caller can dispose of events instead.
+static void iree_event_pool_grow_locked(iree_event_pool_t* event_pool,
+                                        iree_host_size_t minimum_capacity) {
+  iree_host_size_t new_capacity =
+      iree_min(iree_max(minimum_capacity, event_pool->available_capacity * 2),
+               event_pool->max_capacity);
+  if (new_capacity <= event_pool->available_capacity) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, new_capacity);
+  iree_status_t status = iree_allocator_realloc(
+      event_pool->host_allocator, new_capacity * sizeof(iree_event_t),
+      (void**)&event_pool->available_list);
+  if (iree_status_is_ok(status)) {
+    event_pool->available_capacity = new_capacity;
+  } else {
+    iree_status_ignore(status);
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
 iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
                                       iree_host_size_t event_count,
                                       iree_event_t* out_events) {
@@ -131,22 +166,28 @@ void iree_event_pool_release(iree_event_pool_t* event_pool,
   if (!event_count) return;
   IREE_ASSERT_ARGUMENT(events);
 
-  // We'll try to release all we can back to the pool and then deinitialize
-  // the ones that won't fit.
-  iree_host_size_t remaining_count = event_count;
+  // Reset the events so that they are ready to be acquired again. This may
+  // require syscalls and is done prior to taking the lock so that concurrent
+  // acquires/releases don't serialize on it. Events that end up not fitting in
+  // the pool will have been reset for nothing but that should be rare.
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    iree_event_reset(&events[i]);
+  }
 
-  // Try first to release to the pool.
-  // Note that we reset the events we add back to the pool so that they are
-  // ready to be acquired again.
+  // We'll try to release all we can back to the pool (growing it as needed)
+  // and then deinitialize the ones that won't fit.
+  iree_host_size_t remaining_count = event_count;
   iree_slim_mutex_lock(&event_pool->mutex);
+  if (event_pool->available_count + event_count >
+      event_pool->available_capacity) {
+    iree_event_pool_grow_locked(event_pool,
+                                event_pool->available_count + event_count);
+  }
   iree_host_size_t to_pool_count =
       iree_min(event_pool->available_capacity - event_pool->available_count,
                event_count);
   if (to_pool_count > 0) {
     iree_host_size_t pool_base_index = event_pool->available_count;
-    for (iree_host_size_t i = 0; i < to_pool_count; ++i) {
-      iree_event_reset(&events[i]);
-    }
     memcpy(&event_pool->available_list[pool_base_index], events,
            to_pool_count * sizeof(iree_event_t));
     event_pool->available_count += to_pool_count;
@@ -154,8 +195,7 @@ void iree_event_pool_release(iree_event_pool_t* event_pool,
   }
   iree_slim_mutex_unlock(&event_pool->mutex);
 
-  // Deallocate the rest of the events. We don't bother resetting them as we are
-  // getting rid of them.
+  // Deallocate the rest of the events.
   if (remaining_count > 0) {
     IREE_TRACE_ZONE_BEGIN(z0);
     for (iree_host_size_t i = 0; i < remaining_count; ++i) {
@@ -16,11 +16,19 @@ extern "C" {
 
 // A simple pool of iree_event_ts to recycle.
 //
+// The pool starts with an initial number of events and grows to retain up to a
+// maximum number as they are released such that workloads with many
+// simultaneous waits settle into a steady state without creating and
+// destroying events. Callers needing multiple events should acquire and
+// release them in a single call to avoid repeatedly taking the pool lock.
+//
 // Thread-safe; multiple threads may acquire and release events from the pool.
 typedef struct iree_event_pool_t iree_event_pool_t;
 
-// Allocates a new event pool with up to |available_capacity| events.
-iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
+// Allocates a new event pool with |initial_capacity| events that will grow to
+// retain up to |max_capacity| released events.
+iree_status_t iree_event_pool_allocate(iree_host_size_t initial_capacity,
+                                       iree_host_size_t max_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool);
 
@@ -37,7 +45,7 @@ iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
                                       iree_host_size_t event_count,
                                       iree_event_t* out_events);
 
-// Releases one or more events back to the block pool.
+// Releases one or more events back to the event pool.
 void iree_event_pool_release(iree_event_pool_t* event_pool,
                              iree_host_size_t event_count,
                              iree_event_t* events);
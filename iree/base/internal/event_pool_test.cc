@@ -0,0 +1,67 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/event_pool.h"
+
+#include <array>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Returns true if |event| is signaled without blocking.
+static bool IsSignaled(iree_event_t* event) {
+  iree_status_t status = iree_wait_one(event, IREE_TIME_INFINITE_PAST);
+  bool is_signaled = iree_status_is_ok(status);
+  iree_status_ignore(status);
+  return is_signaled;
+}
+
+TEST(EventPoolTest, Lifetime) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*initial_capacity=*/4,
+                                          /*max_capacity=*/8,
+                                          iree_allocator_system(), &event_pool));
+  iree_event_pool_free(event_pool);
+}
+
+TEST(EventPoolTest, EmptyInitialCapacity) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*initial_capacity=*/0,
+                                          /*max_capacity=*/0,
+                                          iree_allocator_system(), &event_pool));
+  iree_event_t event;
+  IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, 1, &event));
+  EXPECT_FALSE(IsSignaled(&event));
+  iree_event_pool_release(event_pool, 1, &event);
+  iree_event_pool_free(event_pool);
+}
+
+// Acquires and releases more events than the initial capacity in batches to
+// exercise growth and disposal of events beyond the maximum capacity.
+TEST(EventPoolTest, BatchedGrowth) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*initial_capacity=*/2,
+                                          /*max_capacity=*/8,
+                                          iree_allocator_system(), &event_pool));
+  for (int i = 0; i < 3; ++i) {
+    std::array<iree_event_t, 16> events;
+    IREE_ASSERT_OK(
+        iree_event_pool_acquire(event_pool, events.size(), events.data()));
+    for (auto& event : events) {
+      EXPECT_FALSE(IsSignaled(&event));
+    }
+    // Released events must come back unsignaled.
+    for (auto& event : events) {
+      iree_event_set(&event);
+    }
+    iree_event_pool_release(event_pool, events.size(), events.data());
+  }
+  iree_event_pool_free(event_pool);
+}
+
+}  // namespace
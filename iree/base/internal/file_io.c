@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -27,6 +28,14 @@
 #define IREE_SET_BINARY_MODE(handle) ((void)0)
 #endif  // IREE_PLATFORM_WINDOWS
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_FILE_IO_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_*
+
 // We could take alignment as an arg, but roughly page aligned should be
 // acceptable for all uses - if someone cares about memory usage they won't
 // be using this method.
@@ -60,8 +69,7 @@ iree_status_t iree_file_contents_allocator_ctl(void* self,
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "only the file contents buffer is valid");
   }
-  iree_allocator_t allocator = contents->allocator;
-  iree_allocator_free(allocator, contents);
+  iree_file_contents_free(contents);
   return iree_ok_status();
 }
 
@@ -77,6 +85,11 @@ iree_allocator_t iree_file_contents_deallocator(
 void iree_file_contents_free(iree_file_contents_t* contents) {
   if (!contents) return;
   IREE_TRACE_ZONE_BEGIN(z0);
+#if defined(IREE_FILE_IO_HAVE_MMAP)
+  if (contents->mapping) {
+    munmap(contents->mapping, contents->mapping_length);
+  }
+#endif  // IREE_FILE_IO_HAVE_MMAP
   iree_allocator_free(contents->allocator, contents);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -112,6 +125,8 @@ static iree_status_t iree_file_read_contents_impl(
   contents->buffer.data = (void*)iree_host_align(
       (uintptr_t)contents + sizeof(*contents), IREE_FILE_BASE_ALIGNMENT);
   contents->buffer.data_length = file_size;
+  contents->mapping = NULL;
+  contents->mapping_length = 0;
 
   // Attempt to read the file into memory.
   if (fread(contents->buffer.data, file_size, 1, file) != 1) {
@@ -154,6 +169,81 @@ iree_status_t iree_file_read_contents(const char* path,
   return status;
 }
 
+#if defined(IREE_FILE_IO_HAVE_MMAP)
+
+static iree_status_t iree_file_map_contents_impl(
+    int fd, iree_allocator_t allocator, iree_file_contents_t** out_contents) {
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno), "size query");
+  }
+  iree_host_size_t file_size = (iree_host_size_t)stat_buf.st_size;
+
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*contents), (void**)&contents));
+  memset(contents, 0, sizeof(*contents));
+  contents->allocator = allocator;
+
+  // Zero-length mappings are invalid; an empty file produces an empty span.
+  if (file_size > 0) {
+    void* mapping = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         fd, /*offset=*/0);
+    if (mapping == MAP_FAILED) {
+      iree_allocator_free(allocator, contents);
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "unable to map %zu file bytes", file_size);
+    }
+    contents->mapping = mapping;
+    contents->mapping_length = file_size;
+    contents->buffer.data = (uint8_t*)mapping;
+  }
+  contents->buffer.data_length = file_size;
+
+  *out_contents = contents;
+  return iree_ok_status();
+}
+
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(out_contents);
+  *out_contents = NULL;
+
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path);
+  }
+
+  // The mapping remains valid after the descriptor is closed.
+  iree_status_t status =
+      iree_file_map_contents_impl(fd, allocator, out_contents);
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(status, "mapping file '%s'", path);
+  }
+
+  close(fd);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents) {
+  // Platforms without mmap read the whole file into an allocation instead; the
+  // contents behave the same to callers, they just are not lazily paged in.
+  return iree_file_read_contents(path, allocator, out_contents);
+}
+
+#endif  // IREE_FILE_IO_HAVE_MMAP
+
 iree_status_t iree_file_write_contents(const char* path,
                                        iree_const_byte_span_t content) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -230,6 +320,8 @@ static iree_status_t iree_stdin_read_contents_impl(
   contents->allocator = allocator;
   contents->buffer.data[size] = 0;  // NUL
   contents->buffer.data_length = size;
+  contents->mapping = NULL;
+  contents->mapping_length = 0;
   *out_contents = contents;
   return iree_ok_status();
 }
@@ -263,6 +355,12 @@ iree_status_t iree_file_read_contents(const char* path,
   return iree_make_status(IREE_STATUS_UNAVAILABLE, "File I/O is disabled");
 }
 
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "File I/O is disabled");
+}
+
 iree_status_t iree_file_write_contents(const char* path,
                                        iree_const_byte_span_t content) {
   return iree_make_status(IREE_STATUS_UNAVAILABLE, "File I/O is disabled");
@@ -27,6 +27,11 @@ typedef struct iree_file_contents_t {
     iree_byte_span_t buffer;
     iree_const_byte_span_t const_buffer;
   };
+  // Base address and length of the platform file mapping when the contents
+  // were produced by iree_file_map_contents. NULL when the contents are held in
+  // an allocation from |allocator|.
+  void* mapping;
+  iree_host_size_t mapping_length;
 } iree_file_contents_t;
 
 // Returns an allocator that deallocates the |contents|.
@@ -45,6 +50,20 @@ iree_status_t iree_file_read_contents(const char* path,
                                       iree_allocator_t allocator,
                                       iree_file_contents_t** out_contents);
 
+// Maps a file's contents into memory without reading it.
+//
+// The mapping is private copy-on-write: the returned buffer may be written to
+// but the changes are never flushed back to the file. The base of the returned
+// buffer is page-aligned. On platforms without memory mapping support this
+// falls back to iree_file_read_contents.
+//
+// Returns the contents of the file in |out_contents|.
+// |allocator| is used to allocate the bookkeeping structure and the caller must
+// use iree_file_contents_free to unmap and release the memory.
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents);
+
 // Synchronously writes a byte buffer into a file.
 // Existing contents are overwritten.
 iree_status_t iree_file_write_contents(const char* path,
@@ -75,6 +75,37 @@ TEST(FileIO, ReadWriteContents) {
   iree_file_contents_free(read_contents);
 }
 
+TEST(FileIO, MapContents) {
+  constexpr const char* kUniqueName = "MapContents";
+  auto path = GetUniquePath(kUniqueName);
+
+  // Write the contents to disk.
+  auto write_contents = GetUniqueContents(kUniqueName);
+  IREE_ASSERT_OK(iree_file_write_contents(
+      path.c_str(),
+      iree_make_const_byte_span(write_contents.data(), write_contents.size())));
+
+  // Map the contents from disk.
+  iree_file_contents_t* mapped_contents = NULL;
+  IREE_ASSERT_OK(iree_file_map_contents(path.c_str(), iree_allocator_system(),
+                                        &mapped_contents));
+
+  // Expect the contents are equal.
+  EXPECT_EQ(write_contents.size(), mapped_contents->const_buffer.data_length);
+  EXPECT_EQ(memcmp(write_contents.data(), mapped_contents->const_buffer.data,
+                   mapped_contents->const_buffer.data_length),
+            0);
+
+  // Writes to the mapping must not be flushed back to the file.
+  mapped_contents->buffer.data[0] = '!';
+  iree_file_contents_free(mapped_contents);
+  iree_file_contents_t* read_contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(), iree_allocator_system(),
+                                         &read_contents));
+  EXPECT_EQ(write_contents[0], read_contents->const_buffer.data[0]);
+  iree_file_contents_free(read_contents);
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
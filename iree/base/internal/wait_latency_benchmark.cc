@@ -0,0 +1,128 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Measures the round-trip latency of waking a thread blocked in a host wait.
+// Each iteration signals a responder thread and waits for it to signal back
+// using the mechanism under test. This mirrors a host thread waiting on a
+// semaphore that is signaled shortly after by a worker.
+
+#include <cstdint>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/wait_handle.h"
+#include "iree/base/logging.h"
+
+namespace {
+
+//==============================================================================
+// iree_notification_t (futex or platform equivalent)
+//==============================================================================
+
+// A monotonically increasing value with a notification posted on each change;
+// the same structure iree_hal_task_semaphore_t uses for host waits.
+struct NotifyingValue {
+  NotifyingValue() { iree_notification_initialize(&notification); }
+  ~NotifyingValue() { iree_notification_deinitialize(&notification); }
+
+  void Signal(int64_t new_value) {
+    iree_atomic_store_int64(&value, new_value, iree_memory_order_release);
+    iree_notification_post(&notification, IREE_ALL_WAITERS);
+  }
+
+  // Waits for the value to reach |minimum_value| after polling it
+  // |spin_count| times.
+  void Wait(int64_t minimum_value, int spin_count) {
+    for (int i = 0; i < spin_count; ++i) {
+      if (iree_atomic_load_int64(&value, iree_memory_order_acquire) >=
+          minimum_value) {
+        return;
+      }
+    }
+    struct Condition {
+      NotifyingValue* self;
+      int64_t minimum_value;
+    } condition = {this, minimum_value};
+    iree_notification_await(
+        &notification,
+        +[](void* arg) -> bool {
+          auto* condition = reinterpret_cast<Condition*>(arg);
+          return iree_atomic_load_int64(&condition->self->value,
+                                        iree_memory_order_acquire) >=
+                 condition->minimum_value;
+        },
+        &condition, iree_infinite_timeout());
+  }
+
+  iree_atomic_int64_t value = IREE_ATOMIC_VAR_INIT(0);
+  iree_notification_t notification;
+};
+
+void NotificationPingPong(benchmark::State& state, int spin_count) {
+  NotifyingValue ping;
+  NotifyingValue pong;
+  const int64_t iteration_count = state.max_iterations;
+  std::thread responder([&]() {
+    for (int64_t i = 1; i <= iteration_count; ++i) {
+      ping.Wait(i, spin_count);
+      pong.Signal(i);
+    }
+  });
+  int64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    ping.Signal(i);
+    pong.Wait(i, spin_count);
+  }
+  responder.join();
+}
+
+void BM_NotificationWake(benchmark::State& state) {
+  NotificationPingPong(state, /*spin_count=*/0);
+}
+BENCHMARK(BM_NotificationWake)->UseRealTime();
+
+void BM_NotificationSpinWake(benchmark::State& state) {
+  NotificationPingPong(state, /*spin_count=*/state.range(0));
+}
+BENCHMARK(BM_NotificationSpinWake)
+    ->Arg(64)
+    ->Arg(512)
+    ->Arg(4096)
+    ->UseRealTime();
+
+//==============================================================================
+// iree_event_t (wait handles)
+//==============================================================================
+
+void BM_EventWake(benchmark::State& state) {
+  iree_event_t ping;
+  iree_event_t pong;
+  IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &ping));
+  IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &pong));
+  const int64_t iteration_count = state.max_iterations;
+  std::thread responder([&]() {
+    for (int64_t i = 0; i < iteration_count; ++i) {
+      IREE_CHECK_OK(iree_wait_one(&ping, IREE_TIME_INFINITE_FUTURE));
+      iree_event_reset(&ping);
+      iree_event_set(&pong);
+    }
+  });
+  for (auto _ : state) {
+    iree_event_set(&ping);
+    IREE_CHECK_OK(iree_wait_one(&pong, IREE_TIME_INFINITE_FUTURE));
+    iree_event_reset(&pong);
+  }
+  responder.join();
+  iree_event_deinitialize(&ping);
+  iree_event_deinitialize(&pong);
+}
+BENCHMARK(BM_EventWake)->UseRealTime();
+
+}  // namespace
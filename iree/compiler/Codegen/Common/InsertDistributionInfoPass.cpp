@@ -12,6 +12,7 @@
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/Flow/IR/PartitionableLoopsInterface.h"
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Pass/Pass.h"
@@ -117,6 +118,57 @@ static LogicalResult defineWorkgroupCountRegion(
   return defineWorkgroupCountRegion(builder, entryPointFn, regionBuilder);
 }
 
+/// Bounds the workgroup count returned by the workgroup count region of
+/// `entryPointOp` to `workgroupsPerWorker` times the dispatch concurrency of
+/// the device the dispatch is recorded on. The workgroups are distributed
+/// cyclically so fewer workgroups each process more tiles. Dimensions are
+/// reduced starting from x such that the product of the workgroup counts does
+/// not exceed the budget unless the y/z counts alone exceed it. Devices that
+/// cannot report their concurrency get the unbounded count.
+static void boundWorkgroupCountByConcurrency(
+    IREE::HAL::ExecutableEntryPointOp entryPointOp,
+    int64_t workgroupsPerWorker) {
+  Block *body = entryPointOp.getBlock();
+  auto returnOp = cast<IREE::HAL::ReturnOp>(body->getTerminator());
+  Location loc = returnOp.getLoc();
+  OpBuilder b(returnOp);
+  Value device = body->addArgument(b.getType<IREE::HAL::DeviceType>(),
+                                  entryPointOp.getLoc());
+  auto queryOp = b.create<IREE::HAL::DeviceQueryOp>(
+      loc, b.getI1Type(), b.getI32Type(), device,
+      b.getStringAttr("hal.dispatch"), b.getStringAttr("concurrency"),
+      b.getI32IntegerAttr(0));
+  Value concurrency =
+      b.create<arith::IndexCastOp>(loc, b.getIndexType(), queryOp.value());
+
+  SmallVector<Value> counts(returnOp.operands());
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value totalCount = b.create<arith::MulIOp>(
+      loc, b.create<arith::MulIOp>(loc, counts[0], counts[1]), counts[2]);
+  Value hasConcurrency = b.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::sgt, concurrency, zero);
+  Value budget = b.create<arith::SelectOp>(
+      loc, hasConcurrency,
+      b.create<arith::MulIOp>(
+          loc, concurrency,
+          b.create<arith::ConstantIndexOp>(loc, workgroupsPerWorker)),
+      totalCount);
+  for (unsigned i = 0; i < counts.size(); ++i) {
+    Value otherCount = one;
+    for (unsigned j = 0; j < counts.size(); ++j) {
+      if (j == i) continue;
+      otherCount = b.create<arith::MulIOp>(loc, otherCount, counts[j]);
+    }
+    // Empty workloads produce 0 workgroups; avoid dividing by them.
+    otherCount = b.create<arith::MaxUIOp>(loc, otherCount, one);
+    Value maxCount = b.create<arith::MaxUIOp>(
+        loc, b.create<arith::DivUIOp>(loc, budget, otherCount), one);
+    counts[i] = b.create<arith::MinUIOp>(loc, counts[i], maxCount);
+  }
+  returnOp->setOperands(counts);
+}
+
 /// Update the workload_per_wg value on the TranslationInfoAttr.
 // TODO(ravishankarm): The workload_per_wg field should be deprecated. This
 // is just transition before all dependencies on it can be removed.
@@ -187,6 +239,15 @@ void InsertDistributionInfoPass::runOnOperation() {
       failed(updateTranslationInfoAttr(funcOp, workloadPerWorkroup))) {
     return signalPassFailure();
   }
+
+  // Let the runtime pick fewer workgroups if the backend requested it.
+  auto entryPointOp = getEntryPoint(funcOp);
+  auto workgroupsPerWorkerAttr =
+      entryPointOp->getAttrOfType<IntegerAttr>(kWorkgroupsPerWorkerAttrName);
+  if (workgroupsPerWorkerAttr && !workloadPerWorkroup.empty()) {
+    boundWorkgroupCountByConcurrency(entryPointOp,
+                                     workgroupsPerWorkerAttr.getInt());
+  }
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
@@ -38,11 +38,12 @@ static unsigned dimToIndex(gpu::Dimension dim) {
 
 /// If the value is a threadID return the range [0, workgroupSize-1].
 /// If the number of workgroup is known also return the range of workgroupId ad
-/// workgroupCount.
+/// workgroupCount. If `isCountUpperBound` is set the workgroup count is chosen
+/// at dispatch time and `workgroupCount` is only its upper bound.
 static Optional<std::pair<AffineExpr, AffineExpr>> getWorkgroupRange(
     Value processorValue, SmallVectorImpl<Value> & /*dims*/,
     SmallVectorImpl<Value> & /*symbols*/, ArrayRef<int64_t> workgroupCount,
-    ArrayRef<int64_t> workgroupSize) {
+    ArrayRef<int64_t> workgroupSize, bool isCountUpperBound) {
   if (auto idOp = processorValue.getDefiningOp<gpu::ThreadIdOp>()) {
     unsigned index = dimToIndex(idOp.dimension());
     OpBuilder b(processorValue.getContext());
@@ -72,6 +73,9 @@ static Optional<std::pair<AffineExpr, AffineExpr>> getWorkgroupRange(
     OpBuilder builder(processorValue.getContext());
     unsigned index = dimOp.dimension().getZExtValue();
     AffineExpr bound = builder.getAffineConstantExpr(workgroupCount[index]);
+    if (isCountUpperBound) {
+      return std::make_pair(builder.getAffineConstantExpr(1), bound);
+    }
     return std::make_pair(bound, bound);
   }
   return llvm::None;
@@ -134,13 +138,14 @@ static SmallVector<int64_t> getNumWorkgroup(
 
 static LogicalResult removeOneTripTiledLoops(func::FuncOp funcOp,
                                              ArrayRef<int64_t> workgroupSize,
-                                             ArrayRef<int64_t> numWorkgroups) {
-  auto getWorkgroupRangeFn = [numWorkgroups, workgroupSize](
+                                             ArrayRef<int64_t> numWorkgroups,
+                                             bool isCountUpperBound) {
+  auto getWorkgroupRangeFn = [numWorkgroups, workgroupSize, isCountUpperBound](
                                  Value processorValue,
                                  SmallVectorImpl<Value> &dims,
                                  SmallVectorImpl<Value> &symbols) {
     return getWorkgroupRange(processorValue, dims, symbols, numWorkgroups,
-                             workgroupSize);
+                             workgroupSize, isCountUpperBound);
   };
   RewritePatternSet patterns(funcOp.getContext());
   populateRemoveSingleIterationLoopPattern(patterns, getWorkgroupRangeFn);
@@ -158,8 +163,10 @@ class RemoveSingleIterationLoopPass final
 
     SmallVector<int64_t> workgroupSize = getWorkgroupSize(entryPointOp);
     SmallVector<int64_t> numWorkgroups = getNumWorkgroup(funcOp, entryPointOp);
+    bool isCountUpperBound = hasRuntimeWorkgroupCount(entryPointOp);
 
-    if (failed(removeOneTripTiledLoops(funcOp, workgroupSize, numWorkgroups))) {
+    if (failed(removeOneTripTiledLoops(funcOp, workgroupSize, numWorkgroups,
+                                       isCountUpperBound))) {
       return signalPassFailure();
     }
   }
@@ -1149,3 +1149,73 @@ hal.executable private @scalar {
 //      CHECK:   %[[C1:.+]] = arith.constant 1 : index
 //      CHECK:   hal.return %[[C1]], %[[C1]], %[[C1]] : index, index, index
 //      CHECK: func @scalar()
+
+// -----
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64, 64, 0], [16, 4, 64], [4, 4, 4]]>
+#executable_layout = #hal.executable.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+#executable_target_embedded_elf_arm_64_ = #hal.executable.target<"llvm", "embedded-elf-arm_64", {
+  data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+  native_vector_size = 16 : index,
+  target_triple = "aarch64-unknown-unknown-eabi-elf"
+}>
+#translation = #iree_codegen.translation_info<CPUTileFuseAndVectorize>
+hal.executable private @matmul_runtime_workgroup_count {
+  hal.executable.variant public @llvm, target = #executable_target_embedded_elf_arm_64_ {
+    hal.executable.entry_point public @matmul_runtime_workgroup_count layout(#executable_layout) {
+      hal.dispatch.workgroups_per_worker = 2 : index,
+      translation_info = #translation
+    }
+    builtin.module {
+      func.func @matmul_runtime_workgroup_count() {
+        %0 = hal.interface.constant.load[0] : index
+        %1 = hal.interface.constant.load[1] : index
+        %2 = hal.interface.constant.load[2] : index
+        %3 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%0, %2}
+        %4 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%2, %1}
+        %5 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%0, %1}
+        %6 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer)
+            : !flow.dispatch.tensor<writeonly:?x?xf32>{%0, %1}
+        %7 = flow.dispatch.tensor.load %3, offsets = [0, 0], sizes = [%0, %2], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%0, %2} -> tensor<?x?xf32>
+        %8 = flow.dispatch.tensor.load %4, offsets = [0, 0], sizes = [%2, %1], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%2, %1} -> tensor<?x?xf32>
+        %9 = flow.dispatch.tensor.load %5, offsets = [0, 0], sizes = [%0, %1], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:?x?xf32>{%0, %1} -> tensor<?x?xf32>
+        %10 = linalg.matmul {lowering_config = #config}
+            ins(%7, %8 : tensor<?x?xf32>, tensor<?x?xf32>) outs(%9 : tensor<?x?xf32>) -> tensor<?x?xf32>
+        flow.dispatch.tensor.store %10, %6, offsets = [0, 0], sizes = [%0, %1], strides = [1, 1]
+            : tensor<?x?xf32> -> !flow.dispatch.tensor<writeonly:?x?xf32>{%0, %1}
+        return
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<()[s0] -> (s0 ceildiv 64)>
+//      CHECK: hal.executable.entry_point public @matmul_runtime_workgroup_count
+// CHECK-SAME:   hal.dispatch.workgroups_per_worker = 2 : index
+// CHECK-NEXT:   (%[[ARG0:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG1:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG2:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[DEVICE:[a-zA-Z0-9_]+]]: !hal.device)
+//  CHECK-DAG:    %[[D0:.+]] = affine.apply #[[MAP0]]()[%[[ARG0]]]
+//  CHECK-DAG:    %[[D1:.+]] = affine.apply #[[MAP0]]()[%[[ARG1]]]
+//      CHECK:    %{{.+}}, %[[CONCURRENCY_I32:.+]] = hal.device.query<%[[DEVICE]] : !hal.device>
+// CHECK-SAME:        key("hal.dispatch" :: "concurrency") : i1, i32 = 0 : i32
+//      CHECK:    %[[CONCURRENCY:.+]] = arith.index_cast %[[CONCURRENCY_I32]]
+//      CHECK:    %[[BUDGET:.+]] = arith.select
+//      CHECK:    %[[X:.+]] = arith.minui %[[D0]]
+//      CHECK:    %[[Y:.+]] = arith.minui %[[D1]]
+//      CHECK:    %[[Z:.+]] = arith.minui
+//      CHECK:    hal.return %[[X]], %[[Y]], %[[Z]] : index, index, index
+//      CHECK: func @matmul_runtime_workgroup_count()
@@ -173,3 +173,47 @@ hal.executable private @both_workgroup_and_workitem  {
     }
   }
 }
+
+// -----
+
+#executable_layout = #hal.executable.layout<push_constants = 1, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+
+// The workgroup count is picked at dispatch time and may be smaller than the
+// number of tiles so the loop cannot be removed.
+// CHECK-LABEL: func @workgroup_tile_loop_runtime_count()
+#translation = #iree_codegen.translation_info<CPUDefault, workload_per_wg = [32]>
+hal.executable private @workgroup_tile_loop_runtime_count  {
+  hal.executable.variant @llvm, target = #hal.executable.target<"llvm", "embedded-elf-x86_64"> {
+    hal.executable.entry_point @workgroup_tile_loop_runtime_count layout(#executable_layout) {
+      translation_info = #translation
+    } {
+    ^bb0(%arg0: index, %arg1: index, %arg2: index, %device: !hal.device):
+      %c1 = arith.constant 1 : index
+      %c64 = arith.constant 64 : index
+      %ok, %value = hal.device.query<%device : !hal.device> key("hal.dispatch" :: "concurrency") : i1, i32 = 0 : i32
+      %concurrency = arith.index_cast %value : i32 to index
+      %count = arith.minui %c64, %concurrency : index
+      hal.return %count, %c1, %c1 : index, index, index
+    }
+    builtin.module {
+      func.func @workgroup_tile_loop_runtime_count() {
+        %c2048 = arith.constant 2048 : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %idx = affine.apply affine_map<()[s0] -> (s0 * 32)>()[%workgroup_id_x]
+        %countx = affine.apply affine_map<()[s0] -> (s0 * 32)>()[%workgroup_count_x]
+        //     CHECK: scf.for
+        //     CHECK:   gpu.barrier
+        scf.for %arg0 = %idx to %c2048 step %countx {
+          gpu.barrier
+        }
+        return
+      }
+    }
+  }
+}
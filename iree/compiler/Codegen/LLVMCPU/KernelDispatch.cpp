@@ -11,6 +11,7 @@
 #include "iree/compiler/Codegen/Utils/MarkerUtils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetSelect.h"
@@ -42,6 +43,23 @@ static llvm::cl::opt<int> clNumberOfRuntimeThreads(
     llvm::cl::desc("number of threads that are used at runtime"),
     llvm::cl::init(8));
 
+static llvm::cl::opt<bool> clRuntimeWorkgroupCount(
+    "iree-codegen-llvm-runtime-workgroup-count",
+    llvm::cl::desc("compute the number of workgroups at dispatch time from the "
+                   "concurrency of the device instead of assuming "
+                   "--iree-codegen-llvm-number-of-threads"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<int> clMaxNumberOfRuntimeThreads(
+    "iree-codegen-llvm-max-number-of-threads",
+    llvm::cl::desc("maximum number of threads that are used at runtime when "
+                   "the number of workgroups is computed at dispatch time"),
+    llvm::cl::init(64));
+
+/// Number of workgroups to create per thread used at runtime. Over-provisioning
+/// lets the runtime balance uneven workgroups across threads.
+static constexpr int64_t kNumWorkgroupsPerThread = 2;
+
 static llvm::cl::list<int> mmt4dWorkgroupTileSizes(
     "iree-codegen-llvm-mmt4d-workgroup-tile-sizes",
     llvm::cl::desc("linalg.mmt4d workgroup tile size"), llvm::cl::ZeroOrMore,
@@ -200,8 +218,13 @@ static SmallVector<int64_t> getDefaultDistributedLoopTileSizes(
 
   // Reduce the number of workgroups in cases where we are dividing the work too
   // much. Over-provision the number of workgroups to twice the number of
-  // threads.
-  int64_t numWorkgroupsLimit = 2 * clNumberOfRuntimeThreads;
+  // threads. When the number of workgroups is picked at dispatch time produce
+  // enough tiles for the largest expected machine; smaller machines run fewer
+  // workgroups that each process more tiles.
+  int64_t numRuntimeThreads = clRuntimeWorkgroupCount
+                                  ? clMaxNumberOfRuntimeThreads
+                                  : clNumberOfRuntimeThreads;
+  int64_t numWorkgroupsLimit = kNumWorkgroupsPerThread * numRuntimeThreads;
   int64_t numWorkgroups = 1;
   for (auto ng : numWorkgroupsPerDim) {
     numWorkgroups *= ng;
@@ -557,18 +580,29 @@ static LogicalResult setRootConfig(
   }
 
   auto rank = fftOp.getOperandRank();
+  SmallVector<int64_t> vectorTileSizes;
   if (workgroupTileSizes.size() >= rank && workgroupTileSizes[rank - 1] != 0) {
     APInt value;
     if (matchPattern(fftOp.getStage(), m_ConstantInt(&value))) {
-      workgroupTileSizes[rank - 1] = 1ll << value.getSExtValue();
-      workgroupTileSizes[rank - 1] =
-          std::max(workgroupTileSizes[rank - 1],
-                   static_cast<int64_t>(defaultWorkgroupTileSize));
+      int64_t wholeSize = 1ll << value.getSExtValue();
+      workgroupTileSizes[rank - 1] = std::max(
+          wholeSize, static_cast<int64_t>(defaultWorkgroupTileSize));
+      // The twiddle factors come from the coefficient buffers when the last
+      // loop is partitioned, so the butterflies of a stage can be computed
+      // with one vector op per `vectorSize` of them.
+      int64_t halfSize = wholeSize >> 1;
+      if (halfSize > 0 && fftOp.hasCoeff()) {
+        int64_t vectorSize =
+            getVectorSize(entryPointFn, fftOp.getOperandType());
+        vectorTileSizes.resize(numLoops, 0);
+        vectorTileSizes[rank - 1] = std::min(halfSize, vectorSize);
+      }
     } else {
       return fftOp.emitOpError("non-constant stage might not work for fft op");
     }
   }
   TileSizesListType tileSizes = {workgroupTileSizes};
+  if (!vectorTileSizes.empty()) tileSizes.push_back(vectorTileSizes);
   return setOpConfigAndEntryPointFnTranslation(
       entryPointFn, fftOp, tileSizes, DispatchLoweringPassPipeline::CPUDefault);
 }
@@ -793,7 +827,22 @@ static LogicalResult setVMVXRootConfigImpl(
             })
         .Default([&](Operation *op) { return success(); });
   };
-  return setRootConfigFn(op);
+  if (failed(setRootConfigFn(op))) return failure();
+
+  // VMVX has no atomics, so the updates of a scatter with repeated indices are
+  // not distributed; a single workgroup applies them in order.
+  auto scatterOp = dyn_cast<IREE::LinalgExt::ScatterOp>(op);
+  if (scatterOp && !scatterOp.unique_indices()) {
+    if (IREE::Codegen::LoweringConfigAttr config = getLoweringConfig(op)) {
+      TileSizesListType tileSizes = config.getTileSizeVals();
+      if (!tileSizes.empty() && !tileSizes.front().empty()) {
+        tileSizes.front().front() = 0;
+        setLoweringConfig(op, IREE::Codegen::LoweringConfigAttr::get(
+                                  op->getContext(), tileSizes));
+      }
+    }
+  }
+  return success();
 }
 
 /// Find the root operation for the dispatch region.
@@ -907,6 +956,50 @@ static LogicalResult setTranslationInfoAndRootConfig(
   return setRootConfig(entryPointFn, computeOps, tiledLoops);
 }
 
+/// Appends `name=value;` to |os| if |option| was set on the command line.
+template <typename T>
+static void appendFlagCacheKey(llvm::cl::opt<T> &option,
+                               llvm::StringSet<> &serializedFlags,
+                               llvm::raw_ostream &os) {
+  serializedFlags.insert(option.ArgStr);
+  if (!option.getNumOccurrences()) return;
+  os << option.ArgStr << "=" << option.getValue() << ";";
+}
+template <typename T>
+static void appendFlagCacheKey(llvm::cl::list<T> &option,
+                               llvm::StringSet<> &serializedFlags,
+                               llvm::raw_ostream &os) {
+  serializedFlags.insert(option.ArgStr);
+  if (!option.getNumOccurrences()) return;
+  os << option.ArgStr << "=";
+  llvm::interleave(option, os, ",");
+  os << ";";
+}
+
+LogicalResult appendCPUCodegenFlagsCacheKey(llvm::raw_ostream &os) {
+  llvm::StringSet<> serializedFlags;
+  appendFlagCacheKey(clNativeVectorSizeInBytes, serializedFlags, os);
+  appendFlagCacheKey(clNumberOfRuntimeThreads, serializedFlags, os);
+  appendFlagCacheKey(clRuntimeWorkgroupCount, serializedFlags, os);
+  appendFlagCacheKey(clMaxNumberOfRuntimeThreads, serializedFlags, os);
+  appendFlagCacheKey(mmt4dWorkgroupTileSizes, serializedFlags, os);
+  appendFlagCacheKey(mmt4dL1TileSizes, serializedFlags, os);
+  appendFlagCacheKey(mmt4dVectorSizes, serializedFlags, os);
+  appendFlagCacheKey(defaultWorkgroupTileSize, serializedFlags, os);
+  appendFlagCacheKey(useLinalgTransformInterp, serializedFlags, os);
+
+  // Other codegen flags are private to the passes reading them; conservatively
+  // refuse to key results produced with any of them set.
+  for (auto &it : llvm::cl::getRegisteredOptions()) {
+    if (it.second->getNumOccurrences() &&
+        it.first().startswith("iree-codegen-") &&
+        !serializedFlags.count(it.first())) {
+      return failure();
+    }
+  }
+  return success();
+}
+
 LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
   llvm::StringMap<IREE::HAL::ExecutableEntryPointOp> entryPointOps =
       getAllEntryPoints(moduleOp);
@@ -937,6 +1030,14 @@ LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
             setTranslationInfoAndRootConfig(funcOp, computeOps, tiledLoops))) {
       return failure();
     }
+
+    // Request that the workgroup count region bound the number of workgroups
+    // by the concurrency of the device at dispatch time.
+    if (clRuntimeWorkgroupCount) {
+      OpBuilder builder(funcOp.getContext());
+      entryPointOp->setAttr(kWorkgroupsPerWorkerAttrName,
+                            builder.getIndexAttr(kNumWorkgroupsPerThread));
+    }
   }
 
   // The root confguration setting introduces `tensor.dim` operations. Resolve
@@ -8,6 +8,7 @@
 #define IREE_COMPILER_CODEGEN_LLVMCPU_KERNELDISPATCH_H_
 
 #include "iree/compiler/Codegen/Dialect/LoweringConfig.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/BuiltinOps.h"
 
 namespace mlir {
@@ -35,6 +36,11 @@ enum class StrategyTilingLevel : unsigned {
 
 LogicalResult initCPULaunchConfig(ModuleOp moduleOp);
 
+/// Appends the values of the codegen flags set on the command line to |os| so
+/// that they can be made part of the key of cached translation results.
+/// Fails if a codegen flag is set whose value cannot be serialized.
+LogicalResult appendCPUCodegenFlagsCacheKey(llvm::raw_ostream &os);
+
 }  // namespace iree_compiler
 }  // namespace mlir
 
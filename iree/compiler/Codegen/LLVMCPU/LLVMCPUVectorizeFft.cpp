@@ -0,0 +1,176 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
+#include "iree/compiler/Codegen/Dialect/LoweringConfig.h"
+#include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
+#include "iree/compiler/Codegen/PassDetail.h"
+#include "iree/compiler/Codegen/Passes.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+/// Lowers a bufferized radix-2 fft stage whose twiddle factors are held in the
+/// coefficient buffers to loops that compute `vectorSize` butterflies per
+/// iteration:
+///   for (int k = 0; k < n; k += m) {
+///     for (int j = 0; j < mh; j += vectorSize) {
+///       w = coeff[j : j + vectorSize];
+///       t = w * a[k + j + mh : k + j + mh + vectorSize];
+///       u = a[k + j : k + j + vectorSize];
+///       a[k + j : k + j + vectorSize] = u + t;
+///       a[k + j + mh : k + j + mh + vectorSize] = u - t;
+///     }
+///   }
+/// The real and imaginary parts live in separate buffers, so every access is a
+/// contiguous vector load or store along the innermost dimension. The vector
+/// size is taken from the second tiling level of the lowering config.
+struct VectorizeFftStage : public OpRewritePattern<IREE::LinalgExt::FftOp> {
+  using OpRewritePattern<IREE::LinalgExt::FftOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::FftOp fftOp,
+                                PatternRewriter &rewriter) const override {
+    if (!fftOp.hasBufferSemantics() || !fftOp.hasCoeff()) return failure();
+    Type elementType = fftOp.getOperandType().getElementType();
+    if (!elementType.isa<FloatType>()) return failure();
+
+    IREE::Codegen::LoweringConfigAttr config = getLoweringConfig(fftOp);
+    if (!config) return failure();
+    SmallVector<int64_t> vectorTileSizes = config.getTileSizeVals(
+        static_cast<unsigned>(TilingLevel::L1Tiles));
+    if (vectorTileSizes.empty()) return failure();
+    int64_t vectorSize = vectorTileSizes.back();
+
+    APInt stageValue;
+    if (!matchPattern(fftOp.getStage(), m_ConstantInt(&stageValue))) {
+      return failure();
+    }
+    int64_t stage = stageValue.getSExtValue();
+    if (stage < 1 || stage >= 32) return failure();
+    int64_t halfSize = int64_t(1) << (stage - 1);
+    if (vectorSize <= 0 || halfSize % vectorSize != 0) return failure();
+
+    Location loc = fftOp.getLoc();
+    int64_t rank = fftOp.getOperandRank();
+    SmallVector<Range> domain = fftOp.getIterationDomain(rewriter);
+    SmallVector<Value> lbs, ubs, steps;
+    for (Range range : domain) {
+      lbs.push_back(range.offset);
+      ubs.push_back(range.size);
+      steps.push_back(range.stride);
+    }
+
+    Value realBuffer = fftOp.getReal();
+    Value imagBuffer = fftOp.getImag();
+    Value realCoeff = fftOp.getRealCoeff();
+    Value imagCoeff = fftOp.getImagCoeff();
+    auto vectorType = VectorType::get({vectorSize}, elementType);
+    Value padding = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getZeroAttr(elementType));
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value half = rewriter.create<arith::ConstantIndexOp>(loc, halfSize);
+    Value step = rewriter.create<arith::ConstantIndexOp>(loc, vectorSize);
+    ArrayAttr inBounds = rewriter.getBoolArrayAttr({true});
+    auto operandMap = AffineMapAttr::get(
+        AffineMap::getMinorIdentityMap(rank, 1, rewriter.getContext()));
+    auto coeffMap = AffineMapAttr::get(
+        AffineMap::getMinorIdentityMap(1, 1, rewriter.getContext()));
+
+    scf::buildLoopNest(
+        rewriter, loc, lbs, ubs, steps,
+        [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          b.create<scf::ForOp>(
+              loc, zero, half, step, llvm::None,
+              [&](OpBuilder &b, Location loc, Value j, ValueRange) {
+                auto read = [&](Value source, ValueRange indices,
+                                AffineMapAttr map) -> Value {
+                  return b.create<vector::TransferReadOp>(
+                      loc, vectorType, source, indices, map, padding,
+                      /*mask=*/Value(), inBounds);
+                };
+                auto write = [&](Value vector, Value dest, ValueRange indices) {
+                  b.create<vector::TransferWriteOp>(loc, vector, dest, indices,
+                                                    operandMap,
+                                                    /*mask=*/Value(), inBounds);
+                };
+
+                SmallVector<Value> lhsIndices(ivs.begin(), ivs.end());
+                lhsIndices.back() =
+                    b.create<arith::AddIOp>(loc, ivs.back(), j);
+                SmallVector<Value> rhsIndices(lhsIndices);
+                rhsIndices.back() =
+                    b.create<arith::AddIOp>(loc, lhsIndices.back(), half);
+
+                Value wReal = read(realCoeff, j, coeffMap);
+                Value wImag = read(imagCoeff, j, coeffMap);
+                Value lhsReal = read(realBuffer, lhsIndices, operandMap);
+                Value lhsImag = read(imagBuffer, lhsIndices, operandMap);
+                Value rhsReal = read(realBuffer, rhsIndices, operandMap);
+                Value rhsImag = read(imagBuffer, rhsIndices, operandMap);
+
+                // t = w * a[k + j + mh];
+                // ->  (x + yi)(u + vi) = (xu - yv) + (xv + yu)i
+                Value xu = b.create<arith::MulFOp>(loc, wReal, rhsReal);
+                Value yv = b.create<arith::MulFOp>(loc, wImag, rhsImag);
+                Value xv = b.create<arith::MulFOp>(loc, wReal, rhsImag);
+                Value yu = b.create<arith::MulFOp>(loc, wImag, rhsReal);
+                Value tReal = b.create<arith::SubFOp>(loc, xu, yv);
+                Value tImag = b.create<arith::AddFOp>(loc, xv, yu);
+
+                // cplx u = a[k + j];
+                // a[k + j] = u + t;
+                // a[k + j + mh] = u - t;
+                write(b.create<arith::AddFOp>(loc, lhsReal, tReal), realBuffer,
+                      lhsIndices);
+                write(b.create<arith::AddFOp>(loc, lhsImag, tImag), imagBuffer,
+                      lhsIndices);
+                write(b.create<arith::SubFOp>(loc, lhsReal, tReal), realBuffer,
+                      rhsIndices);
+                write(b.create<arith::SubFOp>(loc, lhsImag, tImag), imagBuffer,
+                      rhsIndices);
+                b.create<scf::YieldOp>(loc);
+              });
+        });
+    rewriter.eraseOp(fftOp);
+    return success();
+  }
+};
+
+struct LLVMCPUVectorizeFftPass
+    : LLVMCPUVectorizeFftBase<LLVMCPUVectorizeFftPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect, scf::SCFDialect,
+                    vector::VectorDialect>();
+  }
+  void runOnOperation() override;
+};
+}  // namespace
+
+void LLVMCPUVectorizeFftPass::runOnOperation() {
+  MLIRContext *context = &getContext();
+  RewritePatternSet patterns(context);
+  patterns.insert<VectorizeFftStage>(context);
+  if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                          std::move(patterns)))) {
+    return signalPassFailure();
+  }
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>> createLLVMCPUVectorizeFftPass() {
+  return std::make_unique<LLVMCPUVectorizeFftPass>();
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
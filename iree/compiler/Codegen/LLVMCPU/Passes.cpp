@@ -412,6 +412,7 @@ void addCPUDefaultPassPipeline(OpPassManager &passManager) {
   passManager.addPass(createCSEPass());
   // Use stack allocation on CPU side.
   addLinalgBufferizePasses(passManager, cpuAllocationFunction);
+  passManager.addNestedPass<func::FuncOp>(createLLVMCPUVectorizeFftPass());
 }
 
 void addLinalgTransformInterpPasses(OpPassManager &passManager) {
@@ -0,0 +1,85 @@
+// RUN: iree-opt -iree-llvmcpu-vectorize-fft -split-input-file %s | FileCheck %s
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64], [4]]>
+func.func @fft_stage3(%real: memref<32xf32>, %imag: memref<32xf32>) {
+  %c3 = arith.constant 3 : index
+  %cst = arith.constant dense<[1.000000e+00, 0.707106769, 6.12323426E-17, -0.707106769]> : tensor<4xf32>
+  %cst_0 = arith.constant dense<[-0.000000e+00, -0.707106769, -1.000000e+00, -0.707106769]> : tensor<4xf32>
+  %0 = bufferization.to_memref %cst : memref<4xf32>
+  %1 = bufferization.to_memref %cst_0 : memref<4xf32>
+  iree_linalg_ext.fft {lowering_config = #config}
+      ins(%c3, %0, %1 : index, memref<4xf32>, memref<4xf32>)
+      outs(%real, %imag : memref<32xf32>, memref<32xf32>)
+  return
+}
+// CHECK-LABEL: func @fft_stage3
+//  CHECK-SAME:   %[[REAL:[a-zA-Z0-9]+]]: memref<32xf32>
+//  CHECK-SAME:   %[[IMAG:[a-zA-Z0-9]+]]: memref<32xf32>
+//   CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C4:.+]] = arith.constant 4 : index
+//   CHECK-DAG:   %[[C8:.+]] = arith.constant 8 : index
+//   CHECK-DAG:   %[[C32:.+]] = arith.constant 32 : index
+//   CHECK-DAG:   %[[WREAL:.+]] = bufferization.to_memref %{{.+}} : memref<4xf32>
+//   CHECK-DAG:   %[[WIMAG:.+]] = bufferization.to_memref %{{.+}} : memref<4xf32>
+//       CHECK:   scf.for %[[K:.+]] = %[[C0]] to %[[C32]] step %[[C8]]
+//       CHECK:     scf.for %[[J:.+]] = %[[C0]] to %[[C4]] step %[[C4]]
+//       CHECK:       %[[LHS:.+]] = arith.addi %[[K]], %[[J]]
+//       CHECK:       %[[RHS:.+]] = arith.addi %[[LHS]], %[[C4]]
+//   CHECK-DAG:       %[[XR:.+]] = vector.transfer_read %[[WREAL]][%[[J]]], %{{.+}} {in_bounds = [true]} : memref<4xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[YI:.+]] = vector.transfer_read %[[WIMAG]][%[[J]]], %{{.+}} {in_bounds = [true]} : memref<4xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[UR:.+]] = vector.transfer_read %[[REAL]][%[[LHS]]], %{{.+}} {in_bounds = [true]} : memref<32xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[UI:.+]] = vector.transfer_read %[[IMAG]][%[[LHS]]], %{{.+}} {in_bounds = [true]} : memref<32xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[VR:.+]] = vector.transfer_read %[[REAL]][%[[RHS]]], %{{.+}} {in_bounds = [true]} : memref<32xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[VI:.+]] = vector.transfer_read %[[IMAG]][%[[RHS]]], %{{.+}} {in_bounds = [true]} : memref<32xf32>, vector<4xf32>
+//   CHECK-DAG:       %[[XU:.+]] = arith.mulf %[[XR]], %[[VR]] : vector<4xf32>
+//   CHECK-DAG:       %[[YV:.+]] = arith.mulf %[[YI]], %[[VI]] : vector<4xf32>
+//   CHECK-DAG:       %[[XV:.+]] = arith.mulf %[[XR]], %[[VI]] : vector<4xf32>
+//   CHECK-DAG:       %[[YU:.+]] = arith.mulf %[[YI]], %[[VR]] : vector<4xf32>
+//   CHECK-DAG:       %[[TR:.+]] = arith.subf %[[XU]], %[[YV]] : vector<4xf32>
+//   CHECK-DAG:       %[[TI:.+]] = arith.addf %[[XV]], %[[YU]] : vector<4xf32>
+//   CHECK-DAG:       %[[R1:.+]] = arith.addf %[[UR]], %[[TR]] : vector<4xf32>
+//   CHECK-DAG:       %[[R2:.+]] = arith.addf %[[UI]], %[[TI]] : vector<4xf32>
+//   CHECK-DAG:       %[[R3:.+]] = arith.subf %[[UR]], %[[TR]] : vector<4xf32>
+//   CHECK-DAG:       %[[R4:.+]] = arith.subf %[[UI]], %[[TI]] : vector<4xf32>
+//       CHECK:       vector.transfer_write %[[R1]], %[[REAL]][%[[LHS]]] {in_bounds = [true]}
+//       CHECK:       vector.transfer_write %[[R2]], %[[IMAG]][%[[LHS]]] {in_bounds = [true]}
+//       CHECK:       vector.transfer_write %[[R3]], %[[REAL]][%[[RHS]]] {in_bounds = [true]}
+//       CHECK:       vector.transfer_write %[[R4]], %[[IMAG]][%[[RHS]]] {in_bounds = [true]}
+//   CHECK-NOT:   iree_linalg_ext.fft
+
+// -----
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[1, 64], [0, 4]]>
+func.func @fft_2d_stage4(%real: memref<1x64xf32>, %imag: memref<1x64xf32>,
+                         %coeff_real: memref<8xf32>, %coeff_imag: memref<8xf32>) {
+  %c4 = arith.constant 4 : index
+  iree_linalg_ext.fft {lowering_config = #config}
+      ins(%c4, %coeff_real, %coeff_imag : index, memref<8xf32>, memref<8xf32>)
+      outs(%real, %imag : memref<1x64xf32>, memref<1x64xf32>)
+  return
+}
+// CHECK-LABEL: func @fft_2d_stage4
+//  CHECK-SAME:   %[[REAL:[a-zA-Z0-9]+]]: memref<1x64xf32>
+//   CHECK-DAG:   %[[C4:.+]] = arith.constant 4 : index
+//   CHECK-DAG:   %[[C8:.+]] = arith.constant 8 : index
+//   CHECK-DAG:   %[[C16:.+]] = arith.constant 16 : index
+//       CHECK:   scf.for %[[I:.+]] =
+//       CHECK:     scf.for %[[K:.+]] = %{{.+}} to %{{.+}} step %[[C16]]
+//       CHECK:       scf.for %[[J:.+]] = %{{.+}} to %[[C8]] step %[[C4]]
+//       CHECK:         %[[LHS:.+]] = arith.addi %[[K]], %[[J]]
+//       CHECK:         vector.transfer_read %[[REAL]][%[[I]], %[[LHS]]], %{{.+}} {in_bounds = [true]} : memref<1x64xf32>, vector<4xf32>
+//   CHECK-NOT:   iree_linalg_ext.fft
+
+// -----
+
+func.func @fft_without_config(%real: memref<32xf32>, %imag: memref<32xf32>,
+                              %coeff_real: memref<4xf32>, %coeff_imag: memref<4xf32>) {
+  %c3 = arith.constant 3 : index
+  iree_linalg_ext.fft
+      ins(%c3, %coeff_real, %coeff_imag : index, memref<4xf32>, memref<4xf32>)
+      outs(%real, %imag : memref<32xf32>, memref<32xf32>)
+  return
+}
+// CHECK-LABEL: func @fft_without_config
+//   CHECK-NOT:   vector.transfer_read
+//       CHECK:   iree_linalg_ext.fft
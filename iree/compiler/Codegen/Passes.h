@@ -226,6 +226,10 @@ createLLVMCPUTileFuseAndVectorizePass(bool lowerToVectors = true);
 /// Replaces llvm.intr.fma with its unfused mul and add ops.
 std::unique_ptr<OperationPass<func::FuncOp>> createLLVMCPUUnfuseFMAOpsPass();
 
+/// Lowers bufferized linalg_ext.fft stages with coefficient buffers to loops of
+/// vector butterflies, using the vector size set in their lowering config.
+std::unique_ptr<OperationPass<func::FuncOp>> createLLVMCPUVectorizeFftPass();
+
 /// A pass that converts certain vector.contract ops to custom kernels.
 std::unique_ptr<OperationPass<func::FuncOp>>
 createVectorContractCustomKernelsPass();
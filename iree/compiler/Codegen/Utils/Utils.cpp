@@ -41,6 +41,12 @@ IREE::HAL::ExecutableEntryPointOp getEntryPoint(func::FuncOp funcOp) {
   return nullptr;
 }
 
+bool hasRuntimeWorkgroupCount(IREE::HAL::ExecutableEntryPointOp entryPointOp) {
+  // Regions taking the device may derive the count from device queries.
+  Block *body = entryPointOp.getBlock();
+  return body && body->getNumArguments() > kNumMaxParallelDims;
+}
+
 llvm::StringMap<IREE::HAL::ExecutableEntryPointOp> getAllEntryPoints(
     ModuleOp module) {
   auto variantOp = module->getParentOfType<IREE::HAL::ExecutableVariantOp>();
@@ -22,6 +22,16 @@ namespace iree_compiler {
 
 static constexpr unsigned kNumMaxParallelDims = 3;
 
+/// Discardable attribute on hal.executable.entry_point ops requesting that the
+/// number of workgroups be bounded at dispatch time to this many workgroups
+/// per unit of device dispatch concurrency.
+static const char kWorkgroupsPerWorkerAttrName[] =
+    "hal.dispatch.workgroups_per_worker";
+
+/// Returns true if the workgroup count of `entryPointOp` is computed at
+/// dispatch time and may be smaller than the number of distributed tiles.
+bool hasRuntimeWorkgroupCount(IREE::HAL::ExecutableEntryPointOp entryPointOp);
+
 //===----------------------------------------------------------------------===//
 // Utility functions to get entry points
 //===----------------------------------------------------------------------===//
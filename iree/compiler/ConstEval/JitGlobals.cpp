@@ -7,6 +7,7 @@
 #include "iree/compiler/ConstEval/PassDetail.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/ConstEval/Runtime.h"
+#include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/DenseSet.h"
@@ -16,7 +17,10 @@
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/SubElementInterfaces.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
 #define DEBUG_TYPE "iree-const-eval"
 using llvm::dbgs;
@@ -27,6 +31,84 @@ namespace ConstEval {
 
 namespace {
 
+// Calls |fn| with every symbol referenced by |parentOp| or the ops nested in
+// it, not descending into nested symbol tables.
+static void walkSymbolRefs(Operation *parentOp,
+                           function_ref<void(SymbolRefAttr)> fn) {
+  parentOp->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (op != parentOp && op->hasTrait<OpTrait::SymbolTable>()) {
+      return WalkResult::skip();
+    }
+    op->getAttrDictionary().walkSubAttrs([&](Attribute attr) {
+      if (auto refAttr = attr.dyn_cast<SymbolRefAttr>()) fn(refAttr);
+    });
+    return WalkResult::advance();
+  });
+}
+
+// Globals read and written by an op and the functions it references.
+struct GlobalAccesses {
+  DenseSet<StringAttr> loadedGlobals;
+  DenseSet<StringAttr> storedGlobals;
+  // False if some access cannot be attributed to a global, such as an access
+  // through a global address.
+  bool isKnown = true;
+  // True if the op or the functions it references may have effects other than
+  // the global accesses or call functions whose bodies are not available.
+  bool hasSideEffects = false;
+};
+
+// Returns true if |op| may have effects other than global accesses (which are
+// tracked separately), calls (whose callees are checked individually), and
+// allocations.
+static bool hasUntrackedSideEffects(Operation *op) {
+  if (isa<IREE::Util::GlobalLoadOp, IREE::Util::GlobalStoreOp,
+          IREE::Util::GlobalAddressOp, func::CallOp>(op)) {
+    return false;
+  }
+  // Ops nested within are checked on their own.
+  if (op->hasTrait<OpTrait::HasRecursiveSideEffects>()) return false;
+  auto effectOp = dyn_cast<MemoryEffectOpInterface>(op);
+  if (!effectOp) return true;
+  SmallVector<MemoryEffects::EffectInstance> effects;
+  effectOp.getEffects(effects);
+  return llvm::any_of(effects, [](const MemoryEffects::EffectInstance &effect) {
+    return !isa<MemoryEffects::Allocate, MemoryEffects::Free>(
+        effect.getEffect());
+  });
+}
+
+// Collects the globals accessed by |op|, including through the functions it
+// references.
+static void collectGlobalAccesses(Operation *op, SymbolTable &symbolTable,
+                                  DenseSet<Operation *> &visitedOps,
+                                  GlobalAccesses &accesses) {
+  if (!visitedOps.insert(op).second) return;
+  op->walk([&](Operation *childOp) {
+    if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOp>(childOp)) {
+      accesses.loadedGlobals.insert(loadOp.getGlobalRefAttr().getAttr());
+    } else if (auto storeOp = dyn_cast<IREE::Util::GlobalStoreOp>(childOp)) {
+      accesses.storedGlobals.insert(storeOp.getGlobalRefAttr().getAttr());
+    } else if (isa<IREE::Util::GlobalAddressOp>(childOp)) {
+      accesses.isKnown = false;
+    }
+    if (childOp != op && hasUntrackedSideEffects(childOp)) {
+      accesses.hasSideEffects = true;
+    }
+  });
+  walkSymbolRefs(op, [&](SymbolRefAttr refAttr) {
+    if (auto funcOp = dyn_cast_or_null<func::FuncOp>(
+            symbolTable.lookup(refAttr.getRootReference()))) {
+      // External functions may do anything when called.
+      if (funcOp.isExternal()) {
+        accesses.hasSideEffects = true;
+        return;
+      }
+      collectGlobalAccesses(funcOp, symbolTable, visitedOps, accesses);
+    }
+  });
+}
+
 struct ProgramExtractor {
  public:
   ProgramExtractor(Operation *sourceModuleOp, Operation *targetModuleOp)
@@ -92,13 +174,11 @@ struct ProgramExtractor {
   }
 
   void scanDependentSymbols(Operation *parentOp) {
-    // Find any global accessors and note their dependent symbols.
-    parentOp->walk([&](IREE::Util::GlobalAccessorOpInterface accessorOp) {
-      FlatSymbolRefAttr refAttr = accessorOp.getGlobalRefAttr();
-      symbolImportWorklist.push_back(refAttr.getAttr());
+    // Note every referenced symbol: globals from their accessors, functions
+    // from calls and global initializers, etc.
+    walkSymbolRefs(parentOp, [&](SymbolRefAttr refAttr) {
+      symbolImportWorklist.push_back(refAttr.getRootReference());
     });
-
-    // TODO: Scan for functions, etc.
   }
 
  private:
@@ -130,6 +210,10 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     options->targetOptions.i64Extension = true;
     options->targetOptions.f32Extension = true;
     options->targetOptions.f64Extension = true;
+    // The extracted program only contains initializers: there is nothing to
+    // hoist and evaluating recursively would never terminate.
+    options->highLevelOptimizationOptions.constExprHoisting = false;
+    options->highLevelOptimizationOptions.constEval = false;
 
     buildIREEVMTransformPassPipeline(
         options->bindingOptions, options->inputOptions,
@@ -143,6 +227,13 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
   }
 
   void runOnOperation() override {
+    // The extracted program is compiled for and run on VMVX; compilers built
+    // without it leave initializers to run at program load.
+    if (!IREE::HAL::getTargetBackend("vmvx")) {
+      LLVM_DEBUG(dbgs() << "Not JIT'ing globals: vmvx target not available\n");
+      return;
+    }
+
     auto outerModule = getOperation();
     SymbolTable outerSymbolTable(outerModule);
     OpBuilder builder = OpBuilder::atBlockEnd(outerModule.getBody());
@@ -150,15 +241,41 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     ProgramExtractor extractor(outerModule, innerModule);
     SmallVector<Operation *> pruneOps;
 
-    // Import initializers.
+    // Import initializers that only produce values our runtime bridge can hand
+    // back. The others, and any initializer that reads what they produce,
+    // stay in the program to run at load time.
+    DenseMap<Operation *, GlobalAccesses> initializerAccesses;
+    DenseSet<StringAttr> loadTimeGlobals;
+    bool hasUnknownAccesses = false;
+    auto isSupportedGlobal = [&](StringAttr name) {
+      auto globalOp = outerSymbolTable.lookup<IREE::Util::GlobalOp>(name);
+      return globalOp && CompiledBinary::isSupportedResultType(globalOp.type());
+    };
+    auto isLoadTimeGlobal = [&](StringAttr name) {
+      return loadTimeGlobals.contains(name);
+    };
     for (auto childOp : outerModule.getOps<IREE::Util::InitializerOp>()) {
+      DenseSet<Operation *> visitedOps;
+      GlobalAccesses &accesses = initializerAccesses[childOp];
+      collectGlobalAccesses(childOp, outerSymbolTable, visitedOps, accesses);
+      hasUnknownAccesses |= !accesses.isKnown;
+      bool isEvaluable =
+          !hasUnknownAccesses && !accesses.hasSideEffects &&
+          llvm::all_of(accesses.storedGlobals, isSupportedGlobal) &&
+          llvm::none_of(accesses.loadedGlobals, isLoadTimeGlobal);
+      if (!isEvaluable) {
+        loadTimeGlobals.insert(accesses.storedGlobals.begin(),
+                               accesses.storedGlobals.end());
+        continue;
+      }
       extractor.importOperation(childOp);
       pruneOps.push_back(childOp);
     }
 
     // Transitively import any dependencies.
     if (failed(extractor.importDependencies())) {
-      signalPassFailure();
+      innerModule.erase();
+      return signalPassFailure();
     }
 
     // Find any globals that we pulled in which lack an initializer. These
@@ -190,23 +307,39 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       return;
     }
 
+    // Evaluation is an optimization: if the extracted program fails to
+    // compile or run the initializers are left to run at load time instead.
+    // Diagnostics from the attempt are dropped so they don't fail the
+    // compilation.
+    ScopedDiagnosticHandler diagnosticHandler(
+        &getContext(), [](Diagnostic &diagnostic) {
+          LLVM_DEBUG(dbgs() << "JitGlobals: " << diagnostic << "\n");
+          return success();
+        });
+
     // Run the IREE compiler, transforming the inner module into a vm.module.
     LLVM_DEBUG(dbgs() << "JIT'ing " << uninitializedGlobals.size()
                       << " uninitialized globals\n");
     if (failed(runPipeline(compilePipeline, innerModule))) {
-      return signalPassFailure();
+      LLVM_DEBUG(dbgs() << "Not JIT'ing globals: compilation failed\n");
+      innerModule.erase();
+      return;
     }
 
     // Generate a binary.
     InMemoryCompiledBinary binary;
     if (failed(binary.translateFromModule(innerModule))) {
-      return signalPassFailure();
+      LLVM_DEBUG(dbgs() << "Not JIT'ing globals: translation failed\n");
+      innerModule.erase();
+      return;
     }
 
     // Kill the temporary program we constructed.
     innerModule.erase();
 
-    bool modified = false;
+    // Evaluate every global before changing any so that a failure leaves the
+    // program untouched.
+    SmallVector<std::pair<IREE::Util::GlobalOp, Attribute>> evaluatedValues;
     for (auto &it : uninitializedGlobals) {
       StringAttr funcSymbol = it.first;
       StringAttr globalSymbol = it.second;
@@ -217,16 +350,30 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       Attribute value =
           binary.invokeNullaryAsAttribute(loc, funcSymbol.strref());
       if (!value) {
-        return signalPassFailure();
+        LLVM_DEBUG(dbgs() << "Not JIT'ing globals: evaluating "
+                          << globalSymbol << " failed\n");
+        return;
       }
+      evaluatedValues.emplace_back(targetGlobal, value);
+    }
 
+    bool modified = false;
+    DenseSet<StringAttr> evaluatedGlobals;
+    for (auto &it : evaluatedValues) {
       modified = true;
-      targetGlobal.setInitialValue(value);
+      it.first.setInitialValue(it.second);
+      evaluatedGlobals.insert(it.first.sym_nameAttr());
     }
 
-    // Delete any ops noted for pruning.
+    // Delete the initializers whose stores have all been folded into the
+    // initial values of their globals.
     for (Operation *op : pruneOps) {
-      op->erase();
+      if (llvm::all_of(initializerAccesses[op].storedGlobals,
+                       [&](StringAttr name) {
+                         return evaluatedGlobals.contains(name);
+                       })) {
+        op->erase();
+      }
     }
 
     // Signal any outer fixed point iterator that we have modified
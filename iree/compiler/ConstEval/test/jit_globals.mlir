@@ -221,3 +221,141 @@ module @eval_i64_tensor {
     util.initializer.return
   }
 }
+
+// -----
+// CHECK-LABEL: @eval_through_call
+// CHECK: util.global private @hoisted = dense<[4.000000e+02, 6.400000e+03]> : tensor<2xf32>
+// CHECK-NOT: util.initializer
+module @eval_through_call {
+  util.global private @hoisted : tensor<2xf32>
+  func.func private @double(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+    %0 = arith.addf %arg0, %arg0 : tensor<2xf32>
+    return %0 : tensor<2xf32>
+  }
+  func.func @main() -> tensor<2xf32> {
+    %hoisted = util.global.load @hoisted : tensor<2xf32>
+    return %hoisted : tensor<2xf32>
+  }
+  util.initializer {
+    %cst = arith.constant dense<[2.0e+2, 3.2e+3]> : tensor<2xf32>
+    %0 = func.call @double(%cst) : (tensor<2xf32>) -> tensor<2xf32>
+    util.global.store %0, @hoisted : tensor<2xf32>
+    util.initializer.return
+  }
+}
+
+// -----
+// CHECK-LABEL: @eval_partially_supported
+// Only the initializer producing the unsupported f16 type should remain.
+// CHECK: util.global private @hoisted_f32 = dense<2.000000e+02> : tensor<2xf32>
+// CHECK: util.global private @hoisted_f16 : tensor<2xf16>
+// CHECK: util.initializer
+// CHECK: util.global.store {{.+}}, @hoisted_f16
+// CHECK-NOT: util.initializer
+module @eval_partially_supported {
+  util.global private @hoisted_f32 : tensor<2xf32>
+  util.global private @hoisted_f16 : tensor<2xf16>
+  func.func @main() -> (tensor<2xf32>, tensor<2xf16>) {
+    %hoisted_f32 = util.global.load @hoisted_f32 : tensor<2xf32>
+    %hoisted_f16 = util.global.load @hoisted_f16 : tensor<2xf16>
+    return %hoisted_f32, %hoisted_f16 : tensor<2xf32>, tensor<2xf16>
+  }
+  util.initializer {
+    %cst = arith.constant dense<2.0e+2> : tensor<2xf32>
+    util.global.store %cst, @hoisted_f32 : tensor<2xf32>
+    util.initializer.return
+  }
+  util.initializer {
+    %cst = arith.constant dense<2.0e+2> : tensor<2xf16>
+    util.global.store %cst, @hoisted_f16 : tensor<2xf16>
+    util.initializer.return
+  }
+}
+
+// -----
+// CHECK-LABEL: @skip_external_call
+// External functions may have side effects (initializer should remain).
+// CHECK: util.global private @hoisted : tensor<2xf32>
+// CHECK: util.initializer
+// CHECK:   func.call @external
+module @skip_external_call {
+  util.global private @hoisted : tensor<2xf32>
+  func.func private @external() -> tensor<2xf32>
+  func.func @main() -> tensor<2xf32> {
+    %hoisted = util.global.load @hoisted : tensor<2xf32>
+    return %hoisted : tensor<2xf32>
+  }
+  util.initializer {
+    %0 = func.call @external() : () -> tensor<2xf32>
+    util.global.store %0, @hoisted : tensor<2xf32>
+    util.initializer.return
+  }
+}
+
+// -----
+// CHECK-LABEL: @skip_side_effecting_callee
+// Side effects in called functions must be preserved (initializer should
+// remain).
+// CHECK: util.global private @hoisted : tensor<2xf32>
+// CHECK: util.initializer
+// CHECK:   func.call @side_effecting
+module @skip_side_effecting_callee {
+  util.global private @hoisted : tensor<2xf32>
+  func.func private @side_effecting() -> tensor<2xf32> {
+    %0 = util.unfoldable_constant dense<2.0e+2> : tensor<2xf32>
+    return %0 : tensor<2xf32>
+  }
+  func.func @main() -> tensor<2xf32> {
+    %hoisted = util.global.load @hoisted : tensor<2xf32>
+    return %hoisted : tensor<2xf32>
+  }
+  util.initializer {
+    %0 = func.call @side_effecting() : () -> tensor<2xf32>
+    util.global.store %0, @hoisted : tensor<2xf32>
+    util.initializer.return
+  }
+}
+
+// -----
+// CHECK-LABEL: @fallback_on_compile_failure
+// i128 values cannot be compiled for the VM: the initializer should remain and
+// the pass should not fail.
+// CHECK: util.global private @hoisted : tensor<2xi32>
+// CHECK: util.initializer
+// CHECK:   util.global.store {{.+}}, @hoisted
+module @fallback_on_compile_failure {
+  util.global private mutable @source = dense<2> : tensor<2xi128>
+  util.global private @hoisted : tensor<2xi32>
+  func.func @main() -> tensor<2xi32> {
+    %hoisted = util.global.load @hoisted : tensor<2xi32>
+    return %hoisted : tensor<2xi32>
+  }
+  util.initializer {
+    %source = util.global.load @source : tensor<2xi128>
+    %0 = arith.trunci %source : tensor<2xi128> to tensor<2xi32>
+    util.global.store %0, @hoisted : tensor<2xi32>
+    util.initializer.return
+  }
+}
+
+// -----
+// CHECK-LABEL: @fallback_on_evaluation_failure
+// The value is too large to allocate when evaluated: the initializer should
+// remain and the pass should not fail.
+// CHECK: util.global private @hoisted : tensor<4611686018427387904xi8>
+// CHECK: util.initializer
+// CHECK:   util.global.store {{.+}}, @hoisted
+module @fallback_on_evaluation_failure {
+  util.global private @hoisted : tensor<4611686018427387904xi8>
+  func.func @main() -> tensor<4611686018427387904xi8> {
+    %hoisted = util.global.load @hoisted : tensor<4611686018427387904xi8>
+    return %hoisted : tensor<4611686018427387904xi8>
+  }
+  util.initializer {
+    %c1 = arith.constant 1 : i8
+    %0 = linalg.init_tensor [4611686018427387904] : tensor<4611686018427387904xi8>
+    %1 = linalg.fill ins(%c1 : i8) outs(%0 : tensor<4611686018427387904xi8>) -> tensor<4611686018427387904xi8>
+    util.global.store %1, @hoisted : tensor<4611686018427387904xi8>
+    util.initializer.return
+  }
+}
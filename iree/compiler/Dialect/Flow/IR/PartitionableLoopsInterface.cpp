@@ -220,7 +220,7 @@ void registerPartitionableLoopsInterfaceModels(DialectRegistry &registry) {
       +[](MLIRContext *ctx, LinalgExt::IREELinalgExtDialect *dialect) {
         registerInterfaceForTiledOpInterfaceOps<
             LinalgExt::FftOp, LinalgExt::ReverseOp, LinalgExt::ScanOp,
-            LinalgExt::ScatterOp, LinalgExt::SortOp>(ctx);
+            LinalgExt::ScatterOp, LinalgExt::SortOp, LinalgExt::TopkOp>(ctx);
       });
   registry.addExtension(+[](MLIRContext *ctx, tensor::TensorDialect *dialect) {
     registerInterfaceForTiledOpInterfaceOps<tensor::ExtractSliceOp,
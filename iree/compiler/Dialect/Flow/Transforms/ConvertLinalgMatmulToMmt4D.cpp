@@ -5,6 +5,8 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <array>
+#include <cstring>
+#include <vector>
 
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
@@ -12,6 +14,7 @@
 #include "llvm/ADT/Optional.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -212,6 +215,59 @@ static Value extractSliceLike(Location loc, PatternRewriter &rewriter,
                                                  offsets, dims, strides);
 }
 
+// If |rhs| is a constant, returns it already padded to a multiple of
+// |tileShape| = (K0, N0) and packed into the (N1, K1, N0, K0) layout that mmt4d
+// expects, so that weights are not repacked on every call. Returns a null value
+// otherwise. Non-constant weights such as immutable globals are packed by ops
+// that global optimization hoists and evaluates instead.
+static Value packConstantRhs(Location loc, PatternRewriter &rewriter,
+                             Value rhs, ArrayRef<int64_t> tileShape) {
+  DenseElementsAttr attr;
+  if (!matchPattern(rhs, m_Constant(&attr))) return {};
+  ShapedType rhsType = attr.getType();
+  Type elementType = rhsType.getElementType();
+  if (!rhsType.hasStaticShape() || !elementType.isIntOrFloat() ||
+      elementType.getIntOrFloatBitWidth() % 8 != 0) {
+    return {};
+  }
+  int64_t K = rhsType.getDimSize(0);
+  int64_t N = rhsType.getDimSize(1);
+  int64_t K0 = tileShape[0];
+  int64_t N0 = tileShape[1];
+  int64_t K1 = llvm::divideCeil(K, K0);
+  int64_t N1 = llvm::divideCeil(N, N0);
+  auto packedType = RankedTensorType::get({N1, K1, N0, K0}, elementType);
+  if (attr.isSplat() && !needsPadding(rhsType.getShape(), tileShape)) {
+    return rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(packedType,
+                                    attr.getSplatValue<Attribute>()));
+  }
+
+  // Copy the bytes of each element from its (k, n) position in the source,
+  // leaving the padding zero.
+  int64_t elementBytes = elementType.getIntOrFloatBitWidth() / 8;
+  ArrayRef<char> rawData = attr.getRawData();
+  std::vector<char> packedData(packedType.getNumElements() * elementBytes, 0);
+  char *dst = packedData.data();
+  for (int64_t n1 = 0; n1 < N1; ++n1) {
+    for (int64_t k1 = 0; k1 < K1; ++k1) {
+      for (int64_t n0 = 0; n0 < N0; ++n0) {
+        for (int64_t k0 = 0; k0 < K0; ++k0, dst += elementBytes) {
+          int64_t k = k1 * K0 + k0;
+          int64_t n = n1 * N0 + n0;
+          if (k >= K || n >= N) continue;
+          int64_t index = attr.isSplat() ? 0 : k * N + n;
+          std::memcpy(dst, rawData.data() + index * elementBytes,
+                      elementBytes);
+        }
+      }
+    }
+  }
+  return rewriter.create<arith::ConstantOp>(
+      loc, DenseElementsAttr::getFromRawBuffer(packedType, packedData,
+                                               /*isSplatBuffer=*/false));
+}
+
 static bool haveEqualShapeDim(Value x, Value y, int i) {
   return x.getType().cast<ShapedType>().getDimSize(i) ==
          y.getType().cast<ShapedType>().getDimSize(i);
@@ -277,16 +333,24 @@ class LinalgMatmulOpToLinalgMmt4DOpPattern
     }
     const Mmt4DTileParams &tileParams = maybeTileParams.getValue();
 
+    // Constant weights are packed at compile time; only the remaining
+    // operands are packed at runtime.
+    Value packedRhs = packConstantRhs(loc, rewriter, rhs, tileParams.rhs());
+
     Value paddedLhs = pad(loc, rewriter, lhs, tileParams.lhs());
-    Value paddedRhs = pad(loc, rewriter, rhs, tileParams.rhs());
+    Value paddedRhs =
+        packedRhs ? Value() : pad(loc, rewriter, rhs, tileParams.rhs());
     Value paddedAcc = pad(loc, rewriter, acc, tileParams.acc());
 
     Value lhs4D = expandTo4D(loc, rewriter, paddedLhs, tileParams.lhs());
-    Value rhs4D = expandTo4D(loc, rewriter, paddedRhs, tileParams.rhs());
+    Value rhs4D = packedRhs
+                      ? Value()
+                      : expandTo4D(loc, rewriter, paddedRhs, tileParams.rhs());
     Value acc4D = expandTo4D(loc, rewriter, paddedAcc, tileParams.acc());
 
     Value lhs4DT = transpose(loc, rewriter, lhs4D, {0, 2, 1, 3});
-    Value rhs4DT = transpose(loc, rewriter, rhs4D, {2, 0, 3, 1});
+    Value rhs4DT =
+        packedRhs ? packedRhs : transpose(loc, rewriter, rhs4D, {2, 0, 3, 1});
     Value acc4DT = transpose(loc, rewriter, acc4D, {0, 2, 1, 3});
 
     auto mmt4d = rewriter.create<linalg::Mmt4DOp>(
@@ -0,0 +1,238 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--- FuseSiblingMatmuls.cpp - Horizontally fuse matmuls ---------------===//
+//
+// Fuses linalg.matmul ops that share their LHS, such as the Q/K/V projections
+// of attention or parallel 1x1 convolutions, into a single matmul against the
+// concatenation of their RHS. The result is one dispatch that streams the
+// shared LHS once per tile instead of one dispatch per sibling that each read
+// all of it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/MapVector.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+/// Returns the value `value` is collapsed from by any chain of
+/// tensor.collapse_shape ops, or `value` itself. 1x1 convolutions converted to
+/// matmuls collapse each of their operands separately, so the operands of
+/// sibling convolutions are distinct values collapsed from the same source.
+static Value lookThroughCollapseShape(Value value) {
+  while (auto collapseOp = value.getDefiningOp<tensor::CollapseShapeOp>()) {
+    value = collapseOp.src();
+  }
+  return value;
+}
+
+/// Returns true if `value` is a constant or is loaded from an immutable
+/// global. Concatenating such values is hoisted out of the program by
+/// constant evaluation, so fusing does not add a copy of the RHS at runtime.
+static bool isConstantLike(Value value) {
+  value = lookThroughCollapseShape(value);
+  if (matchPattern(value, m_Constant())) return true;
+  if (auto loadOp = value.getDefiningOp<IREE::Util::GlobalLoadOp>()) {
+    return loadOp.isGlobalImmutable();
+  }
+  return false;
+}
+
+/// Returns the constant the output of `matmulOp` is filled with before the
+/// matmul accumulates into it, or null if it is not a filled constant.
+static Attribute getOutputFillValue(linalg::MatmulOp matmulOp) {
+  auto fillOp = lookThroughCollapseShape(matmulOp.getOutputOperand(0)->get())
+                    .getDefiningOp<linalg::FillOp>();
+  if (!fillOp) return {};
+  Attribute value;
+  if (!matchPattern(fillOp.value(), m_Constant(&value))) return {};
+  return value;
+}
+
+/// Returns true if `matmulOp` may be fused with its siblings.
+static bool isFusableMatmul(linalg::MatmulOp matmulOp) {
+  if (!matmulOp.hasTensorSemantics()) return false;
+  // Do not drop user provided attributes such as compilation info.
+  ArrayRef<StringRef> odsAttrs = matmulOp.getAttributeNames();
+  for (NamedAttribute attr : matmulOp->getAttrs()) {
+    if (!llvm::is_contained(odsAttrs, attr.getName().getValue())) return false;
+  }
+  for (OpOperand *opOperand : matmulOp.getInputAndOutputOperands()) {
+    if (!opOperand->get().getType().cast<ShapedType>().hasStaticShape()) {
+      return false;
+    }
+  }
+  return isConstantLike(matmulOp.getInputOperand(1)->get()) &&
+         getOutputFillValue(matmulOp);
+}
+
+/// Returns true if `value` is defined before `op` or only its
+/// tensor.collapse_shape ops are defined after `op`.
+static bool isAvailableAt(DominanceInfo &dominanceInfo, Value value,
+                          Operation *op) {
+  if (dominanceInfo.properlyDominates(value, op)) return true;
+  auto collapseOp = value.getDefiningOp<tensor::CollapseShapeOp>();
+  return collapseOp && isAvailableAt(dominanceInfo, collapseOp.src(), op);
+}
+
+/// Returns `value` at the insertion point of `builder`, placed before `op`,
+/// cloning the tensor.collapse_shape ops producing it that are defined after
+/// `op`. `value` must be available at `op`.
+static Value materializeAt(OpBuilder &builder, DominanceInfo &dominanceInfo,
+                           Value value, Operation *op) {
+  if (dominanceInfo.properlyDominates(value, op)) return value;
+  auto collapseOp = value.getDefiningOp<tensor::CollapseShapeOp>();
+  BlockAndValueMapping mapping;
+  mapping.map(collapseOp.src(), materializeAt(builder, dominanceInfo,
+                                              collapseOp.src(), op));
+  return builder.clone(*collapseOp, mapping)->getResult(0);
+}
+
+/// Replaces `siblings`, which all multiply the same LHS, with one matmul
+/// against their concatenated RHS followed by a slice per sibling.
+static void fuseSiblings(DominanceInfo &dominanceInfo,
+                         ArrayRef<linalg::MatmulOp> siblings) {
+  linalg::MatmulOp firstOp = siblings.front();
+  OpBuilder builder(firstOp);
+  SmallVector<Location> locs;
+  for (linalg::MatmulOp matmulOp : siblings) locs.push_back(matmulOp.getLoc());
+  Location loc = builder.getFusedLoc(locs);
+
+  Value lhs = firstOp.getInputOperand(0)->get();
+  auto lhsType = lhs.getType().cast<RankedTensorType>();
+  auto rhsType =
+      firstOp.getInputOperand(1)->get().getType().cast<RankedTensorType>();
+  auto resultType = firstOp.getResult(0).getType().cast<RankedTensorType>();
+  int64_t m = lhsType.getDimSize(0);
+  int64_t k = lhsType.getDimSize(1);
+  int64_t n = 0;
+  for (linalg::MatmulOp matmulOp : siblings) {
+    n += matmulOp.getResult(0).getType().cast<ShapedType>().getDimSize(1);
+  }
+
+  // Concatenate the RHS along N.
+  Value rhs = builder.create<linalg::InitTensorOp>(
+      loc, ValueRange{}, ArrayRef<int64_t>{k, n}, rhsType.getElementType());
+  SmallVector<OpFoldResult> strides(2, builder.getIndexAttr(1));
+  int64_t offset = 0;
+  for (linalg::MatmulOp matmulOp : siblings) {
+    int64_t size =
+        matmulOp.getResult(0).getType().cast<ShapedType>().getDimSize(1);
+    Value siblingRhs = materializeAt(
+        builder, dominanceInfo, matmulOp.getInputOperand(1)->get(), firstOp);
+    rhs = builder.create<tensor::InsertSliceOp>(
+        loc, siblingRhs, rhs,
+        ArrayRef<OpFoldResult>{builder.getIndexAttr(0),
+                               builder.getIndexAttr(offset)},
+        ArrayRef<OpFoldResult>{builder.getIndexAttr(k),
+                               builder.getIndexAttr(size)},
+        strides);
+    offset += size;
+  }
+
+  Value fillValue =
+      builder.create<arith::ConstantOp>(loc, getOutputFillValue(firstOp));
+  Value init = builder.create<linalg::InitTensorOp>(
+      loc, ValueRange{}, ArrayRef<int64_t>{m, n}, resultType.getElementType());
+  init = builder.create<linalg::FillOp>(loc, fillValue, init).getResult(0);
+  auto fusedOp = builder.create<linalg::MatmulOp>(
+      loc, TypeRange{init.getType()}, ValueRange{lhs, rhs}, ValueRange{init});
+
+  offset = 0;
+  for (linalg::MatmulOp matmulOp : siblings) {
+    auto type = matmulOp.getResult(0).getType().cast<RankedTensorType>();
+    Value slice = builder.create<tensor::ExtractSliceOp>(
+        matmulOp.getLoc(), type, fusedOp.getResult(0),
+        ArrayRef<OpFoldResult>{builder.getIndexAttr(0),
+                               builder.getIndexAttr(offset)},
+        ArrayRef<OpFoldResult>{builder.getIndexAttr(m),
+                               builder.getIndexAttr(type.getDimSize(1))},
+        strides);
+    offset += type.getDimSize(1);
+    matmulOp.getResult(0).replaceAllUsesWith(slice);
+  }
+  for (linalg::MatmulOp matmulOp : siblings) matmulOp.erase();
+}
+
+namespace {
+
+struct FuseSiblingMatmulsPass
+    : public FuseSiblingMatmulsBase<FuseSiblingMatmulsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    Operation *rootOp = getOperation();
+    DominanceInfo dominanceInfo(rootOp);
+
+    // Group the fusable matmuls by the LHS they read, in program order. A
+    // collapse_shape only reinterprets the shape of its source, so LHS of the
+    // same type collapsed from the same source are the same value.
+    llvm::MapVector<std::pair<Value, Type>, SmallVector<linalg::MatmulOp>>
+        matmulsByLhs;
+    rootOp->walk([&](linalg::MatmulOp matmulOp) {
+      if (!isFusableMatmul(matmulOp)) return;
+      Value lhs = matmulOp.getInputOperand(0)->get();
+      matmulsByLhs[{lookThroughCollapseShape(lhs), lhs.getType()}].push_back(
+          matmulOp);
+    });
+
+    for (auto &it : matmulsByLhs) {
+      ArrayRef<linalg::MatmulOp> candidates = it.second;
+      if (candidates.size() < 2) continue;
+
+      // The fused matmul replaces the first sibling, so every other sibling
+      // must be able to move up to it.
+      linalg::MatmulOp firstOp = candidates.front();
+      Attribute fillValue = getOutputFillValue(firstOp);
+      auto rhsType =
+          firstOp.getInputOperand(1)->get().getType().cast<ShapedType>();
+      auto resultType = firstOp.getResult(0).getType().cast<ShapedType>();
+      SmallVector<linalg::MatmulOp> siblings;
+      for (linalg::MatmulOp matmulOp : candidates) {
+        Value rhs = matmulOp.getInputOperand(1)->get();
+        if (matmulOp->getBlock() != firstOp->getBlock() ||
+            getOutputFillValue(matmulOp) != fillValue ||
+            rhs.getType().cast<ShapedType>().getElementType() !=
+                rhsType.getElementType() ||
+            getElementTypeOrSelf(matmulOp.getResult(0).getType()) !=
+                resultType.getElementType() ||
+            !isAvailableAt(dominanceInfo, rhs, firstOp)) {
+          continue;
+        }
+        siblings.push_back(matmulOp);
+      }
+      if (siblings.size() < 2) continue;
+      fuseSiblings(dominanceInfo, siblings);
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<Pass> createFuseSiblingMatmulsPass() {
+  return std::make_unique<FuseSiblingMatmulsPass>();
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
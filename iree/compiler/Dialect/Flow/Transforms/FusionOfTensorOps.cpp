@@ -17,14 +17,89 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
+static llvm::cl::opt<int64_t> clProducerDuplicationOpsPerByte(
+    "iree-flow-producer-duplication-ops-per-byte",
+    llvm::cl::desc("Number of scalar operations that are estimated to cost as "
+                   "much as moving one byte to or from memory, used to decide "
+                   "when an elementwise producer is recomputed in each of its "
+                   "consumers instead of being materialized"),
+    llvm::cl::init(8));
+
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
 namespace Flow {
 
+/// Returns the estimated cost, in scalar operations, of one iteration of the
+/// body of `genericOp`. Transcendental math operations are weighted more.
+static int64_t getOpsPerIteration(linalg::GenericOp genericOp) {
+  const int64_t kMathOpCost = 8;
+  int64_t ops = 0;
+  for (Operation &op : genericOp.getBody()->without_terminator()) {
+    if (isa<linalg::IndexOp>(op)) continue;
+    ops += isa_and_nonnull<math::MathDialect>(op.getDialect()) ? kMathOpCost
+                                                               : 1;
+  }
+  return ops;
+}
+
+/// Returns the number of bytes of `opOperand` accessed per iteration of
+/// `genericOp`, amortized over the iteration space. Operands that are
+/// broadcast along some loops are treated as fully reused when the shapes are
+/// not static.
+static double getBytesPerIteration(linalg::GenericOp genericOp,
+                                   OpOperand *opOperand) {
+  auto type = opOperand->get().getType().dyn_cast<ShapedType>();
+  if (!type) return 0;
+  double elementBytes = llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+  SmallVector<int64_t> loopRanges = genericOp.getStaticLoopRanges();
+  bool hasStaticLoops = llvm::none_of(
+      loopRanges, [](int64_t size) { return ShapedType::isDynamic(size); });
+  if (type.hasStaticShape() && hasStaticLoops) {
+    int64_t iterations = 1;
+    for (int64_t size : loopRanges) iterations *= size;
+    if (iterations == 0) return 0;
+    return elementBytes * type.getNumElements() / iterations;
+  }
+  AffineMap indexingMap = genericOp.getTiedIndexingMap(opOperand);
+  return indexingMap.getNumResults() < indexingMap.getNumDims() ? 0
+                                                                : elementBytes;
+}
+
+/// Returns true if recomputing the elementwise `producer` inside each of its
+/// `numConsumers` consumers is estimated to be cheaper than materializing its
+/// result to memory once and reading it back in every consumer. Per iteration
+/// of the producer:
+///   materialize = inputs + result * (1 + numConsumers)
+///   duplicate = inputs * numConsumers + ops * (numConsumers - 1) / opsPerByte
+/// This favors duplicating cheap producers of large tensors, e.g. the
+/// elementwise and broadcast ops of memory-bound blocks, and keeps producers
+/// with high arithmetic intensity materialized.
+static bool isCheaperToDuplicate(linalg::GenericOp producer,
+                                 int64_t numConsumers) {
+  if (numConsumers <= 1) return true;
+  if (producer.getNumParallelLoops() != producer.getNumLoops() ||
+      producer.getNumOutputs() != 1 || clProducerDuplicationOpsPerByte <= 0) {
+    return false;
+  }
+  double inputBytes = 0;
+  for (OpOperand *opOperand : producer.getInputOperands()) {
+    inputBytes += getBytesPerIteration(producer, opOperand);
+  }
+  double resultBytes =
+      getBytesPerIteration(producer, producer.getOutputOperand(0));
+  double materializeCost = inputBytes + resultBytes * (1 + numConsumers);
+  double duplicateCost =
+      inputBytes * numConsumers +
+      static_cast<double>(getOpsPerIteration(producer) * (numConsumers - 1)) /
+          clProducerDuplicationOpsPerByte;
+  return duplicateCost <= materializeCost;
+}
+
 namespace {
 
 using linalg::LinalgOp;
@@ -81,10 +156,9 @@ struct FusionOfTensorOpsPass
               }
             }
           }
-          // Only fuse if it has a single linalg generic user. It is a
-          // simplistic heuristic to avoid duplicating ops that may be
-          // expensive.
-          // TODO: Add a cost model to allow ops to be duplicated.
+          // Fusing a producer with several users duplicates it in each of
+          // them. Allow that when the cost model estimates recomputation to be
+          // cheaper than materializing the producer to memory.
           bool hasI1ReturnType =
               llvm::any_of(producer->getResultTypes(), [](Type t) {
                 if (t.isInteger(1)) return true;
@@ -96,7 +170,14 @@ struct FusionOfTensorOpsPass
           if (!isBroadcast && !isa<arith::ConstantOp>(producer) &&
               !hasI1ReturnType &&
               !llvm::hasSingleElement(producerResult.getUsers())) {
-            return false;
+            auto genericOp = dyn_cast<linalg::GenericOp>(producer);
+            SmallPtrSet<Operation *, 4> consumers(
+                producerResult.getUsers().begin(),
+                producerResult.getUsers().end());
+            int64_t numConsumers = consumers.size();
+            if (!genericOp || !isCheaperToDuplicate(genericOp, numConsumers)) {
+              return false;
+            }
           }
           return llvm::all_of(producerResult.getUsers(), [](Operation *user) {
             return isa<linalg::GenericOp>(user);
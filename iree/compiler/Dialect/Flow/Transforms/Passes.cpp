@@ -43,6 +43,14 @@ static llvm::cl::opt<bool> clEnableConvToImg2Col(
     llvm::cl::desc("Enable converting convolution ops to img2col form."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableFuseSiblingMatmuls(
+    "iree-flow-enable-fuse-sibling-matmuls",
+    llvm::cl::desc("Enable fusing matmuls that share their LHS and have "
+                   "constant RHS into a single matmul. Only applies when "
+                   "constant expression hoisting is enabled, as the "
+                   "concatenated RHS would otherwise be built on every call."),
+    llvm::cl::init(true));
+
 static llvm::cl::opt<bool> clEnablePaddingLinalgOps(
     "iree-flow-enable-padding-linalg-ops",
     llvm::cl::desc("Enable padding linalg ops to an integer multiple of "
@@ -131,6 +139,12 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       .addPass(IREE::Flow::createConvertConv2D1x1ToMatmulPass)
       .addPredicatedPass(clEnableConvToImg2Col,
                          IREE::Flow::createConvertConv2DToImg2ColPass)
+      // Fuse sibling matmuls, including the 1x1 convolutions converted above,
+      // before their constant RHS are concatenated by global optimization.
+      // Without hoisting the concatenation is left in the program.
+      .addPredicatedPass(
+          clEnableFuseSiblingMatmuls && transformOptions.constExprHoisting,
+          IREE::Flow::createFuseSiblingMatmulsPass)
       // Input should now be legal.
       .addPass(IREE::Flow::createVerifyInputLegalityPass)
       // Catch matmul ops before we do anything else with them.
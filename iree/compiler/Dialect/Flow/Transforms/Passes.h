@@ -90,6 +90,10 @@ std::unique_ptr<Pass> createConvertLinalgMatmulToMmt4DPass(
     CustomKernelsTargetInfo targetInfo);
 std::unique_ptr<Pass> createConvertLinalgMatmulToMmt4DPass(StringRef options);
 
+// Creates a pass to fuse linalg.matmul ops that share their LHS and have
+// constant RHS into one matmul against the concatenated RHS.
+std::unique_ptr<Pass> createFuseSiblingMatmulsPass();
+
 // Creates a pass to fuse Linalg operations on tensors.
 std::unique_ptr<Pass> createFusionOfTensorOpsPass();
 
@@ -7,14 +7,25 @@
 //===--------------- SplitReduction.cpp ----------------------------===//
 //
 // Split reduction dimension to increase parallelism of a linalg operation.
+// Long inclusive iree_linalg_ext.scan ops are split the same way into a
+// blocked scan so the scan dimension is no longer serialized, and long
+// iree_linalg_ext.topk ops into per-block selections merged by a final topk.
 //
 //===----------------------------------------------------------------------===//
 
+#include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
+#include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -24,8 +35,140 @@ namespace Flow {
 
 // TODO(thomasraoux): Move to attributes.
 static llvm::cl::opt<int64_t> splitReductionRatio(
-    "iree-flow-split-matmul-reduction", llvm::cl::desc("split ratio"),
-    llvm::cl::init(1));
+    "iree-flow-split-matmul-reduction",
+    llvm::cl::desc("Split ratio of the reduction dimension of matmuls; 0 "
+                   "picks a ratio per matmul from its shape and 1 disables "
+                   "splitting"),
+    llvm::cl::init(0));
+
+static llvm::cl::opt<int64_t> splitReductionParallelism(
+    "iree-flow-split-matmul-reduction-parallelism",
+    llvm::cl::desc("Number of parallel output tiles a matmul needs to keep the "
+                   "target busy; matmuls with fewer tiles get their reduction "
+                   "dimension split automatically"),
+    llvm::cl::init(64));
+
+// Tile size assumed for each parallel dimension of a matmul when estimating
+// how many workgroups it distributes to.
+static const int64_t kSplitReductionParallelTileSize = 64;
+
+// Each split of the reduction dimension keeps at least this many elements so
+// the partial matmuls stay efficient and the final reduction stays cheap.
+static const int64_t kMinSplitReductionSize = 256;
+
+static llvm::cl::opt<int64_t> splitScanRatio(
+    "iree-flow-split-scan-ratio",
+    llvm::cl::desc("Number of blocks the scan dimension of long inclusive "
+                   "iree_linalg_ext.scan ops is split into"),
+    llvm::cl::init(8));
+
+static llvm::cl::opt<bool> splitScanReassociateFloats(
+    "iree-flow-split-scan-reassociate-floats",
+    llvm::cl::desc("Also split scans that add or multiply floats. The blocked "
+                   "scan sums in a different order than the sequential one, "
+                   "so results may differ in their rounding"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<int64_t> splitTopkRatio(
+    "iree-flow-split-topk-ratio",
+    llvm::cl::desc("Number of blocks the selection dimension of long "
+                   "iree_linalg_ext.topk ops is split into"),
+    llvm::cl::init(8));
+
+static llvm::cl::opt<int64_t> splitSortRatio(
+    "iree-flow-split-sort-ratio",
+    llvm::cl::desc("Number of blocks long 1-D iree_linalg_ext.sort ops are "
+                   "split into"),
+    llvm::cl::init(8));
+
+// Scans, selections and sorts with fewer elements per block than this are
+// left alone; the extra dispatches would cost more than running sequentially.
+static const int64_t kMinSplitBlockSize = 128;
+
+/// Returns the reassociation that expands `dim` of a rank `rank` shape into
+/// two dimensions, or collapses them back.
+static SmallVector<ReassociationIndices> getSplitDimReassociation(
+    int64_t rank, int64_t dim) {
+  SmallVector<ReassociationIndices> reassociation;
+  for (int64_t i = 0; i < rank; ++i) {
+    if (i < dim) {
+      reassociation.push_back({i});
+    } else if (i == dim) {
+      reassociation.push_back({i, i + 1});
+    } else {
+      reassociation.push_back({i + 1});
+    }
+  }
+  return reassociation;
+}
+
+/// Returns the identity value of `op` if it is a binary arithmetic operation
+/// known to be associative and commutative, or null otherwise.
+static Attribute getCombinerIdentity(Operation *op) {
+  Type type = op->getResult(0).getType();
+  if (auto intType = type.dyn_cast<IntegerType>()) {
+    unsigned width = intType.getWidth();
+    Optional<APInt> identity =
+        llvm::TypeSwitch<Operation *, Optional<APInt>>(op)
+            .Case<arith::AddIOp, arith::OrIOp, arith::XOrIOp, arith::MaxUIOp>(
+                [&](auto) { return APInt::getZero(width); })
+            .Case<arith::MulIOp>([&](auto) { return APInt(width, 1); })
+            .Case<arith::AndIOp, arith::MinUIOp>(
+                [&](auto) { return APInt::getAllOnes(width); })
+            .Case<arith::MaxSIOp>(
+                [&](auto) { return APInt::getSignedMinValue(width); })
+            .Case<arith::MinSIOp>(
+                [&](auto) { return APInt::getSignedMaxValue(width); })
+            .Default([](Operation *) { return llvm::None; });
+    if (!identity) return {};
+    return IntegerAttr::get(type, *identity);
+  }
+  if (auto floatType = type.dyn_cast<FloatType>()) {
+    const llvm::fltSemantics &semantics = floatType.getFloatSemantics();
+    Optional<APFloat> identity =
+        llvm::TypeSwitch<Operation *, Optional<APFloat>>(op)
+            .Case<arith::AddFOp>([&](auto) {
+              return APFloat::getZero(semantics, /*Negative=*/true);
+            })
+            .Case<arith::MulFOp>([&](auto) { return APFloat(semantics, 1); })
+            .Case<arith::MaxFOp>([&](auto) {
+              return APFloat::getInf(semantics, /*Negative=*/true);
+            })
+            .Case<arith::MinFOp>([&](auto) {
+              return APFloat::getInf(semantics, /*Negative=*/false);
+            })
+            .Default([](Operation *) { return llvm::None; });
+    if (!identity) return {};
+    return FloatAttr::get(type, *identity);
+  }
+  return {};
+}
+
+/// Returns the ratio the reduction dimension of `matmulOp` is split by, or 0
+/// to leave it alone. Matmuls whose output distributes to fewer tiles than the
+/// target parallelism, e.g. the skinny matmuls of batch-1 decoding, get enough
+/// splits to make up the difference as long as K stays long enough per split.
+static int64_t getAutomaticSplitReductionRatio(linalg::MatmulOp matmulOp) {
+  auto lhsType =
+      matmulOp.getInputOperand(0)->get().getType().cast<ShapedType>();
+  auto rhsType =
+      matmulOp.getInputOperand(1)->get().getType().cast<ShapedType>();
+  if (!lhsType.hasStaticShape() || !rhsType.hasStaticShape()) return 0;
+  int64_t m = lhsType.getDimSize(0);
+  int64_t k = lhsType.getDimSize(1);
+  int64_t n = rhsType.getDimSize(1);
+  int64_t numTiles = llvm::divideCeil(m, kSplitReductionParallelTileSize) *
+                     llvm::divideCeil(n, kSplitReductionParallelTileSize);
+  if (numTiles == 0 || numTiles >= splitReductionParallelism) return 0;
+  int64_t maxRatio =
+      std::min<int64_t>(llvm::divideCeil(splitReductionParallelism, numTiles),
+                        k / kMinSplitReductionSize);
+  // The reduction dimension must divide evenly.
+  for (int64_t ratio = maxRatio; ratio > 1; --ratio) {
+    if (k % ratio == 0) return ratio;
+  }
+  return 0;
+}
 
 namespace {
 /// Pattern to wrap splitReduction transformation. This also propagates
@@ -69,28 +212,551 @@ struct LinalgSplitReduction
   linalg::LinalgTransformationFilter filter;
 };
 
+/// Splits the scan dimension of an inclusive iree_linalg_ext.scan into
+/// `ratio` blocks. The result is a two-pass blocked scan:
+///   1. every block is scanned independently, producing the partial scans and
+///      the total of each block; the blocks are parallel dimensions of this
+///      scan so they distribute across workgroups,
+///   2. an exclusive scan over the `ratio` block totals computes the carry
+///      into each block,
+///   3. an elementwise linalg.generic combines each partial scan with the
+///      carry of its block.
+/// Only applies when the scan region is a single associative and commutative
+/// operation with a known identity, which seeds the carry scan. Float adds and
+/// multiplies are only associative up to rounding, so they are split only if
+/// `reassociateFloats` is set.
+struct SplitScan : public OpRewritePattern<IREE::LinalgExt::ScanOp> {
+  SplitScan(MLIRContext *context, int64_t ratio, bool reassociateFloats,
+            PatternBenefit benefit = 1)
+      : OpRewritePattern<IREE::LinalgExt::ScanOp>(context, benefit),
+        ratio(ratio),
+        reassociateFloats(reassociateFloats) {}
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::ScanOp scanOp,
+                                PatternRewriter &rewriter) const override {
+    // Scans created by this pattern are not split again.
+    if (scanOp->hasAttr(linalg::LinalgTransforms::kLinalgTransformMarker)) {
+      return failure();
+    }
+    if (!scanOp.hasTensorSemantics() || !scanOp.inclusive()) return failure();
+    auto inputType = scanOp.input().getType().dyn_cast<RankedTensorType>();
+    if (!inputType || !inputType.hasStaticShape()) return failure();
+    if (llvm::any_of(scanOp->getResultTypes(), [](Type type) {
+          return !type.cast<ShapedType>().hasStaticShape();
+        })) {
+      return failure();
+    }
+    int64_t dim = scanOp.dimension();
+    int64_t size = inputType.getDimSize(dim);
+    if (size % ratio != 0 || size / ratio < kMinSplitBlockSize) {
+      return failure();
+    }
+
+    Block &body = scanOp.region().front();
+    if (body.getNumArguments() != 2 ||
+        !llvm::hasSingleElement(body.without_terminator())) {
+      return failure();
+    }
+    Operation &combiner = body.front();
+    Operation *yieldOp = body.getTerminator();
+    if (combiner.getNumOperands() != 2 || combiner.getNumResults() != 1 ||
+        yieldOp->getNumOperands() != 1 ||
+        yieldOp->getOperand(0) != combiner.getResult(0) ||
+        !llvm::is_contained(combiner.getOperands(), body.getArgument(0)) ||
+        !llvm::is_contained(combiner.getOperands(), body.getArgument(1))) {
+      return failure();
+    }
+    if (!reassociateFloats && isa<arith::AddFOp, arith::MulFOp>(combiner)) {
+      return failure();
+    }
+    Attribute identity = getCombinerIdentity(&combiner);
+    if (!identity) return failure();
+
+    Location loc = scanOp.getLoc();
+    MLIRContext *context = rewriter.getContext();
+    Type elementType = inputType.getElementType();
+    int64_t rank = inputType.getRank();
+    auto createInitTensor = [&](ArrayRef<int64_t> shape) -> Value {
+      return rewriter.create<linalg::InitTensorOp>(loc, ValueRange{}, shape,
+                                                   elementType);
+    };
+    auto createScan = [&](Value input, Value output, Value accumulator,
+                          int64_t dimension, bool inclusive) {
+      auto newScanOp = rewriter.create<IREE::LinalgExt::ScanOp>(
+          loc, TypeRange{output.getType(), accumulator.getType()},
+          ValueRange{input}, ValueRange{output, accumulator},
+          rewriter.getI64IntegerAttr(dimension),
+          rewriter.getBoolAttr(inclusive));
+      rewriter.cloneRegionBefore(scanOp.region(), newScanOp.region(),
+                                 newScanOp.region().end());
+      newScanOp->setAttr(linalg::LinalgTransforms::kLinalgTransformMarker,
+                         rewriter.getStringAttr("SPLIT"));
+      return newScanOp;
+    };
+
+    // [..., size, ...] -> [..., ratio, size / ratio, ...]
+    SmallVector<int64_t> expandedShape(inputType.getShape().begin(),
+                                       inputType.getShape().end());
+    expandedShape[dim] = size / ratio;
+    expandedShape.insert(expandedShape.begin() + dim, ratio);
+    SmallVector<ReassociationIndices> reassociation =
+        getSplitDimReassociation(rank, dim);
+    auto expandedType = RankedTensorType::get(expandedShape, elementType);
+    SmallVector<int64_t> totalsShape(inputType.getShape().begin(),
+                                     inputType.getShape().end());
+    totalsShape[dim] = ratio;
+    SmallVector<int64_t> carryShape(inputType.getShape().begin(),
+                                    inputType.getShape().end());
+    carryShape.erase(carryShape.begin() + dim);
+
+    // Scan each block independently.
+    Value expandedInput = rewriter.create<tensor::ExpandShapeOp>(
+        loc, expandedType, scanOp.input(), reassociation);
+    auto blockScanOp =
+        createScan(expandedInput, createInitTensor(expandedShape),
+                   createInitTensor(totalsShape), dim + 1, /*inclusive=*/true);
+
+    // Exclusive scan of the block totals gives the carry into each block.
+    Value identityValue = rewriter.create<arith::ConstantOp>(loc, identity);
+    Value carryInit =
+        rewriter
+            .create<linalg::FillOp>(loc, identityValue,
+                                    createInitTensor(carryShape))
+            .getResult(0);
+    auto carryScanOp =
+        createScan(blockScanOp.getResult(1), createInitTensor(totalsShape),
+                   carryInit, dim, /*inclusive=*/false);
+
+    // Combine each element with the carry of its block.
+    SmallVector<AffineExpr> carryExprs;
+    for (int64_t i = 0; i < rank + 1; ++i) {
+      if (i != dim + 1) carryExprs.push_back(rewriter.getAffineDimExpr(i));
+    }
+    AffineMap identityMap =
+        AffineMap::getMultiDimIdentityMap(rank + 1, context);
+    SmallVector<AffineMap> indexingMaps = {
+        identityMap, AffineMap::get(rank + 1, 0, carryExprs, context),
+        identityMap};
+    SmallVector<StringRef> iteratorTypes(rank + 1,
+                                         getParallelIteratorTypeName());
+    auto combineOp = rewriter.create<linalg::GenericOp>(
+        loc, expandedType,
+        /*inputs=*/
+        ValueRange{blockScanOp.getResult(0), carryScanOp.getResult(0)},
+        /*outputs=*/createInitTensor(expandedShape), indexingMaps,
+        iteratorTypes,
+        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+          BlockAndValueMapping bvm;
+          bvm.map(body.getArgument(0), args[1]);
+          bvm.map(body.getArgument(1), args[0]);
+          Operation *combined = nestedBuilder.clone(combiner, bvm);
+          nestedBuilder.create<linalg::YieldOp>(nestedLoc,
+                                                combined->getResult(0));
+        });
+    Value result = rewriter.create<tensor::CollapseShapeOp>(
+        loc, scanOp.getResult(0).getType(), combineOp.getResult(0),
+        reassociation);
+
+    // The accumulator of an inclusive scan holds the last scanned element.
+    SmallVector<OpFoldResult> offsets(rank, rewriter.getIndexAttr(0));
+    offsets[dim] = rewriter.getIndexAttr(size - 1);
+    SmallVector<OpFoldResult> sizes;
+    for (int64_t dimSize : inputType.getShape()) {
+      sizes.push_back(rewriter.getIndexAttr(dimSize));
+    }
+    sizes[dim] = rewriter.getIndexAttr(1);
+    SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+    Value accumulator = rewriter.create<tensor::ExtractSliceOp>(
+        loc, scanOp.getResult(1).getType().cast<RankedTensorType>(), result,
+        offsets, sizes, strides);
+
+    rewriter.replaceOp(scanOp, {result, accumulator});
+    return success();
+  }
+
+ private:
+  int64_t ratio;
+  bool reassociateFloats;
+};
+
+/// Splits the selection dimension of an iree_linalg_ext.topk into `ratio`
+/// blocks:
+///   1. a topk along the block dimension selects K candidates from every
+///      block; the blocks are parallel dimensions of this topk so they
+///      distribute across workgroups,
+///   2. a final topk merges the `ratio` * K candidates, with their original
+///      indices, into the original outputs.
+/// The candidates of each block are seeded with the first K elements of the
+/// block (see IREE::LinalgExt::buildSeededTopkOperands), so every candidate is
+/// a real input and the outputs of the original topk may hold anything.
+/// Blocks are merged in order, so ties still resolve to the lowest index.
+struct SplitTopk : public OpRewritePattern<IREE::LinalgExt::TopkOp> {
+  SplitTopk(MLIRContext *context, int64_t ratio, PatternBenefit benefit = 1)
+      : OpRewritePattern<IREE::LinalgExt::TopkOp>(context, benefit),
+        ratio(ratio) {}
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::TopkOp topkOp,
+                                PatternRewriter &rewriter) const override {
+    // Topk ops created by this pattern are not split again.
+    if (topkOp->hasAttr(linalg::LinalgTransforms::kLinalgTransformMarker)) {
+      return failure();
+    }
+    if (!topkOp.hasTensorSemantics()) return failure();
+    auto inputType = topkOp.values().getType().dyn_cast<RankedTensorType>();
+    auto outputType =
+        topkOp.outputValues().getType().dyn_cast<RankedTensorType>();
+    if (!inputType || !inputType.hasStaticShape() || !outputType ||
+        !outputType.hasStaticShape()) {
+      return failure();
+    }
+    int64_t dim = topkOp.dimension();
+    int64_t size = inputType.getDimSize(dim);
+    int64_t k = outputType.getDimSize(dim);
+    int64_t blockSize = size / ratio;
+    if (size % ratio != 0 || blockSize < kMinSplitBlockSize || blockSize <= k) {
+      return failure();
+    }
+
+    Location loc = topkOp.getLoc();
+    MLIRContext *context = rewriter.getContext();
+    int64_t rank = inputType.getRank();
+    Type indexElementType = rewriter.getI32Type();
+    SmallVector<ReassociationIndices> reassociation =
+        getSplitDimReassociation(rank, dim);
+    auto expand = [&](Value value) -> Value {
+      auto type = value.getType().cast<RankedTensorType>();
+      SmallVector<int64_t> shape(type.getShape().begin(),
+                                 type.getShape().end());
+      shape[dim] = blockSize;
+      shape.insert(shape.begin() + dim, ratio);
+      return rewriter.create<tensor::ExpandShapeOp>(
+          loc, RankedTensorType::get(shape, type.getElementType()), value,
+          reassociation);
+    };
+
+    // [..., ratio, K, ...] candidates of every block.
+    SmallVector<int64_t> candidatesShape(outputType.getShape().begin(),
+                                         outputType.getShape().end());
+    candidatesShape.insert(candidatesShape.begin() + dim, ratio);
+    Block &regionBlock = topkOp.region().front();
+    auto compare = [&](OpBuilder &b, Location loc, Value lhs, Value rhs) {
+      BlockAndValueMapping mapping;
+      mapping.map(regionBlock.getArgument(0), lhs);
+      mapping.map(regionBlock.getArgument(1), rhs);
+      for (Operation &op : regionBlock.without_terminator()) {
+        b.clone(op, mapping);
+      }
+      return mapping.lookupOrDefault(
+          regionBlock.getTerminator()->getOperand(0));
+    };
+    Optional<Value> blockIndices;
+    if (Optional<Value> indices = topkOp.indices()) {
+      blockIndices = expand(*indices);
+    }
+    SmallVector<Value> blockInputs, blockOutputs;
+    IREE::LinalgExt::buildSeededTopkOperands(
+        rewriter, loc, expand(topkOp.values()), blockIndices, dim + 1, k,
+        compare, blockInputs, blockOutputs);
+    auto blockTopkOp = rewriter.create<IREE::LinalgExt::TopkOp>(
+        loc, TypeRange(ValueRange(blockOutputs)), blockInputs, blockOutputs,
+        rewriter.getI64IntegerAttr(dim + 1));
+    rewriter.cloneRegionBefore(topkOp.region(), blockTopkOp.region(),
+                               blockTopkOp.region().end());
+    blockTopkOp->setAttr(linalg::LinalgTransforms::kLinalgTransformMarker,
+                         rewriter.getStringAttr("SPLIT"));
+    Value candidateIndices = blockTopkOp.getResult(1);
+
+    // Without an indices input the block topk yields positions within each
+    // block; offset them by the start of their block.
+    if (!topkOp.indices()) {
+      SmallVector<AffineMap> indexingMaps(
+          2, AffineMap::getMultiDimIdentityMap(rank + 1, context));
+      SmallVector<StringRef> iteratorTypes(rank + 1,
+                                           getParallelIteratorTypeName());
+      Value init = rewriter.create<linalg::InitTensorOp>(
+          loc, ValueRange{}, candidatesShape, indexElementType);
+      candidateIndices =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, init.getType(), candidateIndices, init, indexingMaps,
+                  iteratorTypes,
+                  [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                    Value block = b.create<linalg::IndexOp>(nestedLoc, dim);
+                    Value blockStart = b.create<arith::MulIOp>(
+                        nestedLoc, block,
+                        b.create<arith::ConstantIndexOp>(nestedLoc,
+                                                         blockSize));
+                    Value offset = b.create<arith::IndexCastOp>(
+                        nestedLoc, indexElementType, blockStart);
+                    b.create<linalg::YieldOp>(
+                        nestedLoc,
+                        b.create<arith::AddIOp>(nestedLoc, args[0], offset)
+                            .getResult());
+                  })
+              .getResult(0);
+    }
+
+    // Merge the [..., ratio * K, ...] candidates into the original outputs.
+    auto collapse = [&](Value value) -> Value {
+      auto type = value.getType().cast<RankedTensorType>();
+      SmallVector<int64_t> shape(outputType.getShape().begin(),
+                                 outputType.getShape().end());
+      shape[dim] = ratio * k;
+      return rewriter.create<tensor::CollapseShapeOp>(
+          loc, RankedTensorType::get(shape, type.getElementType()), value,
+          reassociation);
+    };
+    auto mergeTopkOp = rewriter.create<IREE::LinalgExt::TopkOp>(
+        loc, topkOp->getResultTypes(),
+        ValueRange{collapse(blockTopkOp.getResult(0)),
+                   collapse(candidateIndices)},
+        ValueRange{topkOp.outputValues(), topkOp.outputIndices()},
+        topkOp.dimensionAttr());
+    rewriter.cloneRegionBefore(topkOp.region(), mergeTopkOp.region(),
+                               mergeTopkOp.region().end());
+    mergeTopkOp->setAttr(linalg::LinalgTransforms::kLinalgTransformMarker,
+                         rewriter.getStringAttr("SPLIT"));
+
+    rewriter.replaceOp(topkOp, mergeTopkOp->getResults());
+    return success();
+  }
+
+ private:
+  int64_t ratio;
+};
+
+/// Splits a 1-D iree_linalg_ext.sort into `ratio` blocks:
+///   1. a sort along the block dimension sorts every block; the blocks are
+///      parallel dimensions of this sort so they distribute across
+///      workgroups,
+///   2. a linalg.generic computes the final position of every element: its
+///      position in its block plus, for every other block, the number of
+///      elements ordering before it, found by a binary search of that block,
+///   3. an iree_linalg_ext.scatter per operand moves the elements to their
+///      final positions.
+/// Equivalent elements of earlier blocks are counted as ordering before, so
+/// the positions are distinct as long as the comparator is a strict weak
+/// order, as the sort requires. Sorts of more than one line are left alone;
+/// they already distribute over their other dimensions.
+struct SplitSort : public OpRewritePattern<IREE::LinalgExt::SortOp> {
+  SplitSort(MLIRContext *context, int64_t ratio, PatternBenefit benefit = 1)
+      : OpRewritePattern<IREE::LinalgExt::SortOp>(context, benefit),
+        ratio(ratio) {}
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::SortOp sortOp,
+                                PatternRewriter &rewriter) const override {
+    // Sorts created by this pattern are not split again.
+    if (sortOp->hasAttr(linalg::LinalgTransforms::kLinalgTransformMarker)) {
+      return failure();
+    }
+    if (!sortOp.hasTensorSemantics() || !sortOp.inputs().empty()) {
+      return failure();
+    }
+    ShapedType operandType = sortOp.getOperandType(0);
+    if (operandType.getRank() != 1 || !operandType.hasStaticShape()) {
+      return failure();
+    }
+    int64_t size = operandType.getDimSize(0);
+    int64_t blockSize = size / ratio;
+    if (size % ratio != 0 || blockSize < kMinSplitBlockSize) return failure();
+
+    Location loc = sortOp.getLoc();
+    MLIRContext *context = rewriter.getContext();
+    Type indexElementType = rewriter.getI32Type();
+    SmallVector<ReassociationIndices> reassociation =
+        getSplitDimReassociation(/*rank=*/1, /*dim=*/0);
+
+    // 1. Sort every block.
+    SmallVector<Value> blockOperands;
+    for (Value operand : sortOp.outputs()) {
+      auto type = operand.getType().cast<RankedTensorType>();
+      blockOperands.push_back(rewriter.create<tensor::ExpandShapeOp>(
+          loc,
+          RankedTensorType::get({ratio, blockSize}, type.getElementType()),
+          operand, reassociation));
+    }
+    auto blockSortOp = rewriter.create<IREE::LinalgExt::SortOp>(
+        loc, TypeRange(ValueRange(blockOperands)), /*inputs=*/ValueRange{},
+        blockOperands, rewriter.getI64IntegerAttr(1));
+    rewriter.cloneRegionBefore(sortOp.region(), blockSortOp.region(),
+                               blockSortOp.region().end());
+    blockSortOp->setAttr(linalg::LinalgTransforms::kLinalgTransformMarker,
+                         rewriter.getStringAttr("SPLIT"));
+    SmallVector<Value> sortedBlocks(blockSortOp->getResults());
+
+    // 2. Compute the final position of every element.
+    Block &comparator = sortOp.region().front();
+    // Returns true if the elements `lhs` order before the elements `rhs`.
+    auto emitCompare = [&](OpBuilder &b, Location loc, ValueRange lhs,
+                           ValueRange rhs) -> Value {
+      BlockAndValueMapping mapping;
+      for (auto it : llvm::enumerate(llvm::zip(lhs, rhs))) {
+        mapping.map(comparator.getArgument(2 * it.index()),
+                    std::get<0>(it.value()));
+        mapping.map(comparator.getArgument(2 * it.index() + 1),
+                    std::get<1>(it.value()));
+      }
+      for (Operation &op : comparator.without_terminator()) {
+        b.clone(op, mapping);
+      }
+      return mapping.lookupOrDefault(
+          comparator.getTerminator()->getOperand(0));
+    };
+    // Steps of a binary search over [0, blockSize], from the largest.
+    SmallVector<int64_t> searchSteps;
+    for (int64_t step = llvm::PowerOf2Floor(blockSize); step > 0; step /= 2) {
+      searchSteps.push_back(step);
+    }
+    SmallVector<AffineMap> indexingMaps(
+        sortedBlocks.size() + 1, AffineMap::getMultiDimIdentityMap(2, context));
+    SmallVector<StringRef> iteratorTypes(2, getParallelIteratorTypeName());
+    Value positionsInit = rewriter.create<linalg::InitTensorOp>(
+        loc, ValueRange{}, ArrayRef<int64_t>{ratio, blockSize},
+        indexElementType);
+    Value positions =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, positionsInit.getType(), sortedBlocks, positionsInit,
+                indexingMaps, iteratorTypes,
+                [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                  ValueRange element = args.drop_back();
+                  Value block = b.create<linalg::IndexOp>(nestedLoc, 0);
+                  Value position = b.create<linalg::IndexOp>(nestedLoc, 1);
+                  Value zero = b.create<arith::ConstantIndexOp>(nestedLoc, 0);
+                  Value one = b.create<arith::ConstantIndexOp>(nestedLoc, 1);
+                  Value blockSizeValue =
+                      b.create<arith::ConstantIndexOp>(nestedLoc, blockSize);
+                  Value result = position;
+                  for (int64_t other = 0; other < ratio; ++other) {
+                    Value otherBlock =
+                        b.create<arith::ConstantIndexOp>(nestedLoc, other);
+                    // Earlier blocks also count their equivalent elements.
+                    Value isEarlier = b.create<arith::CmpIOp>(
+                        nestedLoc, arith::CmpIPredicate::ult, otherBlock,
+                        block);
+                    // Number of elements of `other` ordering before.
+                    Value count = zero;
+                    for (int64_t step : searchSteps) {
+                      Value candidate = b.create<arith::AddIOp>(
+                          nestedLoc, count,
+                          b.create<arith::ConstantIndexOp>(nestedLoc, step));
+                      Value inBounds = b.create<arith::CmpIOp>(
+                          nestedLoc, arith::CmpIPredicate::ule, candidate,
+                          blockSizeValue);
+                      Value probe = b.create<arith::SelectOp>(
+                          nestedLoc, inBounds,
+                          b.create<arith::SubIOp>(nestedLoc, candidate, one),
+                          zero);
+                      SmallVector<Value> probed;
+                      for (Value sortedBlock : sortedBlocks) {
+                        probed.push_back(b.create<tensor::ExtractOp>(
+                            nestedLoc, sortedBlock,
+                            ValueRange{otherBlock, probe}));
+                      }
+                      Value isBefore =
+                          emitCompare(b, nestedLoc, probed, element);
+                      Value isAfter =
+                          emitCompare(b, nestedLoc, element, probed);
+                      Value isNotAfter = b.create<arith::XOrIOp>(
+                          nestedLoc, isAfter,
+                          b.create<arith::ConstantIntOp>(nestedLoc, 1, 1));
+                      Value counts = b.create<arith::AndIOp>(
+                          nestedLoc, inBounds,
+                          b.create<arith::SelectOp>(nestedLoc, isEarlier,
+                                                    isNotAfter, isBefore));
+                      count = b.create<arith::SelectOp>(nestedLoc, counts,
+                                                        candidate, count);
+                    }
+                    Value isSame = b.create<arith::CmpIOp>(
+                        nestedLoc, arith::CmpIPredicate::eq, otherBlock, block);
+                    result = b.create<arith::AddIOp>(
+                        nestedLoc, result,
+                        b.create<arith::SelectOp>(nestedLoc, isSame, zero,
+                                                  count));
+                  }
+                  b.create<linalg::YieldOp>(
+                      nestedLoc, b.create<arith::IndexCastOp>(
+                                     nestedLoc, indexElementType, result)
+                                     .getResult());
+                })
+            .getResult(0);
+    Value indices = rewriter.create<tensor::CollapseShapeOp>(
+        loc, RankedTensorType::get({size}, indexElementType), positions,
+        reassociation);
+    indices = rewriter.create<tensor::ExpandShapeOp>(
+        loc, RankedTensorType::get({size, 1}, indexElementType), indices,
+        reassociation);
+
+    // 3. Move every element to its final position.
+    SmallVector<Value> results;
+    for (auto it : llvm::zip(sortedBlocks, sortOp.outputs())) {
+      Value updates = rewriter.create<tensor::CollapseShapeOp>(
+          loc, std::get<1>(it).getType(), std::get<0>(it), reassociation);
+      auto scatterOp = rewriter.create<IREE::LinalgExt::ScatterOp>(
+          loc, std::get<1>(it).getType(), ValueRange{updates, indices},
+          ValueRange{std::get<1>(it)}, rewriter.getBoolAttr(true));
+      Type elementType = getElementTypeOrSelf(std::get<1>(it).getType());
+      {
+        OpBuilder::InsertionGuard guard(rewriter);
+        Block *block =
+            rewriter.createBlock(&scatterOp.region(), {},
+                                 {elementType, elementType}, {loc, loc});
+        rewriter.create<IREE::LinalgExt::YieldOp>(loc, block->getArgument(0));
+      }
+      results.push_back(scatterOp->getResult(0));
+    }
+
+    rewriter.replaceOp(sortOp, results);
+    return success();
+  }
+
+ private:
+  int64_t ratio;
+};
+
 struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
-    registry.insert<linalg::LinalgDialect>();
+    registry.insert<arith::ArithmeticDialect, linalg::LinalgDialect,
+                    IREE::LinalgExt::IREELinalgExtDialect,
+                    tensor::TensorDialect>();
   }
 
   void runOnOperation() override {
-    if (splitReductionRatio <= 1) return;
+    if (splitReductionRatio == 1 && splitScanRatio <= 1 &&
+        splitTopkRatio <= 1 && splitSortRatio <= 1) {
+      return;
+    }
 
     RewritePatternSet patterns(&getContext());
-    patterns.add<LinalgSplitReduction>(
-        &getContext(),
-        [&](linalg::LinalgOp op) {
-          // For matmul make the new parallel dimension first so that it looks
-          // like a batch_matmul and can follow the same codegen.
-          if (isa<linalg::MatmulOp>(op))
-            return std::make_pair(int64_t(splitReductionRatio), 0);
-          // Currently disable spliting reduction for non-matmul op. This will
-          // get enabled after once tests are ready.
-          return std::make_pair(int64_t(0), 0);
-        },
-        linalg::LinalgTransformationFilter(
-            ArrayRef<StringAttr>{}, StringAttr::get(&getContext(), "SPLIT")));
+    if (splitReductionRatio != 1) {
+      patterns.add<LinalgSplitReduction>(
+          &getContext(),
+          [&](linalg::LinalgOp op) {
+            // For matmul make the new parallel dimension first so that it
+            // looks like a batch_matmul and can follow the same codegen.
+            if (auto matmulOp = dyn_cast<linalg::MatmulOp>(op.getOperation())) {
+              int64_t ratio = splitReductionRatio > 1
+                                  ? int64_t(splitReductionRatio)
+                                  : getAutomaticSplitReductionRatio(matmulOp);
+              return std::make_pair(ratio, 0);
+            }
+            // Currently disable spliting reduction for non-matmul op. This
+            // will get enabled after once tests are ready.
+            return std::make_pair(int64_t(0), 0);
+          },
+          linalg::LinalgTransformationFilter(
+              ArrayRef<StringAttr>{}, StringAttr::get(&getContext(), "SPLIT")));
+    }
+    if (splitScanRatio > 1) {
+      patterns.add<SplitScan>(&getContext(), splitScanRatio,
+                              splitScanReassociateFloats);
+    }
+    if (splitTopkRatio > 1) {
+      patterns.add<SplitTopk>(&getContext(), splitTopkRatio);
+    }
+    if (splitSortRatio > 1) {
+      patterns.add<SplitSort>(&getContext(), splitSortRatio);
+    }
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -98,7 +764,7 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
 
     // Remove all the markers at the end.
     auto funcOp = getOperation();
-    funcOp->walk([&](linalg::LinalgOp op) {
+    funcOp->walk([&](Operation *op) {
       op->removeAttr(linalg::LinalgTransforms::kLinalgTransformMarker);
     });
   }
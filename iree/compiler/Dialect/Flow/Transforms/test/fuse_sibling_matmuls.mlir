@@ -0,0 +1,104 @@
+// RUN: iree-opt -split-input-file -pass-pipeline="func.func(iree-flow-fuse-sibling-matmuls)" %s | FileCheck %s
+
+func.func @qkv_projection(%arg0: tensor<128x64xf32>) -> (tensor<128x32xf32>, tensor<128x32xf32>, tensor<128x16xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %wq = arith.constant dense<1.0> : tensor<64x32xf32>
+  %wk = arith.constant dense<2.0> : tensor<64x32xf32>
+  %wv = arith.constant dense<3.0> : tensor<64x16xf32>
+  %init0 = linalg.init_tensor [128, 32] : tensor<128x32xf32>
+  %fill0 = linalg.fill ins(%zero : f32) outs(%init0 : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %q = linalg.matmul ins(%arg0, %wq : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill0 : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %k = linalg.matmul ins(%arg0, %wk : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill0 : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %init1 = linalg.init_tensor [128, 16] : tensor<128x16xf32>
+  %fill1 = linalg.fill ins(%zero : f32) outs(%init1 : tensor<128x16xf32>) -> tensor<128x16xf32>
+  %v = linalg.matmul ins(%arg0, %wv : tensor<128x64xf32>, tensor<64x16xf32>)
+      outs(%fill1 : tensor<128x16xf32>) -> tensor<128x16xf32>
+  return %q, %k, %v : tensor<128x32xf32>, tensor<128x32xf32>, tensor<128x16xf32>
+}
+// CHECK-LABEL: func.func @qkv_projection(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]
+//   CHECK-DAG:   %[[WQ:.+]] = arith.constant dense<1.000000e+00> : tensor<64x32xf32>
+//   CHECK-DAG:   %[[WK:.+]] = arith.constant dense<2.000000e+00> : tensor<64x32xf32>
+//   CHECK-DAG:   %[[WV:.+]] = arith.constant dense<3.000000e+00> : tensor<64x16xf32>
+//       CHECK:   %[[RHS_INIT:.+]] = linalg.init_tensor [64, 80] : tensor<64x80xf32>
+//       CHECK:   %[[RHS0:.+]] = tensor.insert_slice %[[WQ]] into %[[RHS_INIT]][0, 0] [64, 32] [1, 1]
+//       CHECK:   %[[RHS1:.+]] = tensor.insert_slice %[[WK]] into %[[RHS0]][0, 32] [64, 32] [1, 1]
+//       CHECK:   %[[RHS:.+]] = tensor.insert_slice %[[WV]] into %[[RHS1]][0, 64] [64, 16] [1, 1]
+//       CHECK:   %[[INIT:.+]] = linalg.init_tensor [128, 80] : tensor<128x80xf32>
+//       CHECK:   %[[FILL:.+]] = linalg.fill ins(%{{.+}} : f32) outs(%[[INIT]] : tensor<128x80xf32>)
+//       CHECK:   %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:       ins(%[[ARG0]], %[[RHS]] : tensor<128x64xf32>, tensor<64x80xf32>)
+//  CHECK-SAME:       outs(%[[FILL]] : tensor<128x80xf32>)
+//   CHECK-DAG:   %[[Q:.+]] = tensor.extract_slice %[[MATMUL]][0, 0] [128, 32] [1, 1]
+//   CHECK-DAG:   %[[K:.+]] = tensor.extract_slice %[[MATMUL]][0, 32] [128, 32] [1, 1]
+//   CHECK-DAG:   %[[V:.+]] = tensor.extract_slice %[[MATMUL]][0, 64] [128, 16] [1, 1]
+//   CHECK-NOT:   linalg.matmul
+//       CHECK:   return %[[Q]], %[[K]], %[[V]]
+
+// -----
+
+func.func @no_fusion_with_dynamic_rhs(%arg0: tensor<128x64xf32>, %arg1: tensor<64x32xf32>, %arg2: tensor<64x32xf32>) -> (tensor<128x32xf32>, tensor<128x32xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [128, 32] : tensor<128x32xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %1 = linalg.matmul ins(%arg0, %arg2 : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<128x32xf32>) -> tensor<128x32xf32>
+  return %0, %1 : tensor<128x32xf32>, tensor<128x32xf32>
+}
+// Concatenating non-constant RHS would copy them on every invocation.
+// CHECK-LABEL: func.func @no_fusion_with_dynamic_rhs(
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.matmul
+//   CHECK-NOT:   tensor.insert_slice
+
+// -----
+
+// 1x1 convolutions converted to matmuls collapse each of their operands
+// separately.
+func.func @conv_1x1_siblings(%arg0: tensor<1x4x4x8xf32>) -> (tensor<1x4x4x16xf32>, tensor<1x4x4x32xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %w0 = arith.constant dense<1.0> : tensor<1x1x8x16xf32>
+  %w1 = arith.constant dense<2.0> : tensor<1x1x8x32xf32>
+  %init0 = linalg.init_tensor [1, 4, 4, 16] : tensor<1x4x4x16xf32>
+  %fill0 = linalg.fill ins(%zero : f32) outs(%init0 : tensor<1x4x4x16xf32>) -> tensor<1x4x4x16xf32>
+  %lhs0 = tensor.collapse_shape %arg0 [[0, 1, 2], [3]] : tensor<1x4x4x8xf32> into tensor<16x8xf32>
+  %rhs0 = tensor.collapse_shape %w0 [[0, 1, 2], [3]] : tensor<1x1x8x16xf32> into tensor<8x16xf32>
+  %out0 = tensor.collapse_shape %fill0 [[0, 1, 2], [3]] : tensor<1x4x4x16xf32> into tensor<16x16xf32>
+  %mm0 = linalg.matmul ins(%lhs0, %rhs0 : tensor<16x8xf32>, tensor<8x16xf32>)
+      outs(%out0 : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %res0 = tensor.expand_shape %mm0 [[0, 1, 2], [3]] : tensor<16x16xf32> into tensor<1x4x4x16xf32>
+  %init1 = linalg.init_tensor [1, 4, 4, 32] : tensor<1x4x4x32xf32>
+  %fill1 = linalg.fill ins(%zero : f32) outs(%init1 : tensor<1x4x4x32xf32>) -> tensor<1x4x4x32xf32>
+  %lhs1 = tensor.collapse_shape %arg0 [[0, 1, 2], [3]] : tensor<1x4x4x8xf32> into tensor<16x8xf32>
+  %rhs1 = tensor.collapse_shape %w1 [[0, 1, 2], [3]] : tensor<1x1x8x32xf32> into tensor<8x32xf32>
+  %out1 = tensor.collapse_shape %fill1 [[0, 1, 2], [3]] : tensor<1x4x4x32xf32> into tensor<16x32xf32>
+  %mm1 = linalg.matmul ins(%lhs1, %rhs1 : tensor<16x8xf32>, tensor<8x32xf32>)
+      outs(%out1 : tensor<16x32xf32>) -> tensor<16x32xf32>
+  %res1 = tensor.expand_shape %mm1 [[0, 1, 2], [3]] : tensor<16x32xf32> into tensor<1x4x4x32xf32>
+  return %res0, %res1 : tensor<1x4x4x16xf32>, tensor<1x4x4x32xf32>
+}
+// CHECK-LABEL: func.func @conv_1x1_siblings(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]
+//   CHECK-DAG:   %[[W0:.+]] = arith.constant dense<1.000000e+00> : tensor<1x1x8x16xf32>
+//   CHECK-DAG:   %[[W1:.+]] = arith.constant dense<2.000000e+00> : tensor<1x1x8x32xf32>
+//       CHECK:   %[[LHS:.+]] = tensor.collapse_shape %[[ARG0]]
+//       CHECK:   %[[RHS0:.+]] = tensor.collapse_shape %[[W0]]
+//       CHECK:   %[[RHS_INIT:.+]] = linalg.init_tensor [8, 48] : tensor<8x48xf32>
+//       CHECK:   %[[CAT0:.+]] = tensor.insert_slice %[[RHS0]] into %[[RHS_INIT]][0, 0] [8, 16] [1, 1]
+//       CHECK:   %[[RHS1:.+]] = tensor.collapse_shape %[[W1]]
+//       CHECK:   %[[CAT:.+]] = tensor.insert_slice %[[RHS1]] into %[[CAT0]][0, 16] [8, 32] [1, 1]
+//       CHECK:   %[[INIT:.+]] = linalg.init_tensor [16, 48] : tensor<16x48xf32>
+//       CHECK:   %[[FILL:.+]] = linalg.fill ins(%{{.+}} : f32) outs(%[[INIT]] : tensor<16x48xf32>)
+//       CHECK:   %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:       ins(%[[LHS]], %[[CAT]] : tensor<16x8xf32>, tensor<8x48xf32>)
+//  CHECK-SAME:       outs(%[[FILL]] : tensor<16x48xf32>)
+//   CHECK-DAG:   %[[S0:.+]] = tensor.extract_slice %[[MATMUL]][0, 0] [16, 16] [1, 1]
+//   CHECK-DAG:   %[[S1:.+]] = tensor.extract_slice %[[MATMUL]][0, 16] [16, 32] [1, 1]
+//   CHECK-DAG:   %[[RES0:.+]] = tensor.expand_shape %[[S0]]
+//   CHECK-DAG:   %[[RES1:.+]] = tensor.expand_shape %[[S1]]
+//   CHECK-NOT:   linalg.matmul
+//       CHECK:   return %[[RES0]], %[[RES1]]
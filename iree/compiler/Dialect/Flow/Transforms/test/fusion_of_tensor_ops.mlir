@@ -0,0 +1,86 @@
+// RUN: iree-opt -split-input-file -pass-pipeline="func.func(iree-flow-fusion-of-tensor-ops)" %s | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @duplicate_cheap_producer(%arg0: tensor<1024x1024xf32>, %arg1: tensor<1024x1024xf32>)
+    -> (tensor<1024x1024xf32>, tensor<1024x1024xf32>) {
+  %init = linalg.init_tensor [1024, 1024] : tensor<1024x1024xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %arg1 : tensor<1024x1024xf32>, tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %b: f32, %out: f32):
+    %sum = arith.addf %a, %b : f32
+    linalg.yield %sum : f32
+  } -> tensor<1024x1024xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0 : tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %out: f32):
+    %square = arith.mulf %a, %a : f32
+    linalg.yield %square : f32
+  } -> tensor<1024x1024xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0 : tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %out: f32):
+    %neg = arith.negf %a : f32
+    linalg.yield %neg : f32
+  } -> tensor<1024x1024xf32>
+  return %1, %2 : tensor<1024x1024xf32>, tensor<1024x1024xf32>
+}
+// The add is recomputed in both consumers instead of being written to memory
+// and read back twice.
+// CHECK-LABEL: func.func @duplicate_cheap_producer(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]
+//       CHECK:   %[[SQUARE:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+//       CHECK:     arith.addf
+//       CHECK:     arith.mulf
+//       CHECK:   %[[NEG:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+//       CHECK:     arith.addf
+//       CHECK:     arith.negf
+//       CHECK:   return %[[SQUARE]], %[[NEG]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @materialize_producer_with_many_inputs(
+    %arg0: tensor<1024x1024xf32>, %arg1: tensor<1024x1024xf32>,
+    %arg2: tensor<1024x1024xf32>, %arg3: tensor<1024x1024xf32>)
+    -> (tensor<1024x1024xf32>, tensor<1024x1024xf32>) {
+  %init = linalg.init_tensor [1024, 1024] : tensor<1024x1024xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map, #map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %arg1, %arg2, %arg3 : tensor<1024x1024xf32>, tensor<1024x1024xf32>, tensor<1024x1024xf32>, tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32, %d: f32, %out: f32):
+    %ab = arith.addf %a, %b : f32
+    %cd = arith.addf %c, %d : f32
+    %sum = arith.addf %ab, %cd : f32
+    linalg.yield %sum : f32
+  } -> tensor<1024x1024xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0 : tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %out: f32):
+    %square = arith.mulf %a, %a : f32
+    linalg.yield %square : f32
+  } -> tensor<1024x1024xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0 : tensor<1024x1024xf32>)
+      outs(%init : tensor<1024x1024xf32>) {
+  ^bb0(%a: f32, %out: f32):
+    %neg = arith.negf %a : f32
+    linalg.yield %neg : f32
+  } -> tensor<1024x1024xf32>
+  return %1, %2 : tensor<1024x1024xf32>, tensor<1024x1024xf32>
+}
+// Reading the four inputs in each consumer costs more than materializing the
+// sum once.
+// CHECK-LABEL: func.func @materialize_producer_with_many_inputs(
+//       CHECK:   %[[SUM:.+]] = linalg.generic
+//       CHECK:   %[[SQUARE:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[SUM]] :
+//       CHECK:   %[[NEG:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[SUM]] :
+//       CHECK:   return %[[SQUARE]], %[[NEG]]
@@ -144,6 +144,18 @@ func.func @check_mmt4d_i8_dynamic(%arg0: tensor<?x?xi8>, %arg1: tensor<?x?xi8>,
 // CHECK-SAME: tensor<?x?xi32> to tensor<?x?xi32>
 //      CHECK: return %[[RES]] : tensor<?x?xi32>
 
+// -----
+func.func @check_mmt4d_i8_constant_rhs(%arg0: tensor<3x5xi8>, %arg1: tensor<3x2xi32>) -> tensor<3x2xi32> {
+    %cst = arith.constant dense<[[1, 2], [3, 4], [5, 6], [7, 8], [9, 10]]> : tensor<5x2xi8>
+    %0 = linalg.matmul ins(%arg0, %cst : tensor<3x5xi8>, tensor<5x2xi8>) outs(%arg1 : tensor<3x2xi32>) -> tensor<3x2xi32>
+    return %0 : tensor<3x2xi32>
+}
+// CHECK-LABEL: @check_mmt4d_i8_constant_rhs(
+//   CHECK-DAG:   %[[RHS4DT:.+]] = arith.constant dense<{{\[}}[{{\[}}[1, 3], [2, 4], [0, 0], [0, 0]], {{\[}}[5, 7], [6, 8], [0, 0], [0, 0]], {{\[}}[9, 0], [10, 0], [0, 0], [0, 0]]]]> : tensor<1x3x4x2xi8>
+//   CHECK-NOT:   tensor.expand_shape {{.+}} : tensor<6x4xi8>
+//       CHECK:   linalg.mmt4d
+//  CHECK-SAME:     ins(%{{.+}}, %[[RHS4DT]] : tensor<1x3x8x2xi8>, tensor<1x3x4x2xi8>)
+
 
 //////////////////////////////////////////////////////////////////////////////
 // The "wide" part: test that target-specific mmt4d kernel shapes are used
@@ -0,0 +1,234 @@
+// RUN: iree-opt -split-input-file -iree-flow-split-reduction-ops -iree-flow-split-scan-ratio=4 -iree-flow-split-topk-ratio=4 -iree-flow-split-sort-ratio=4 %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-flow-split-reduction-ops -iree-flow-split-scan-ratio=4 -iree-flow-split-scan-reassociate-floats %s | FileCheck %s --check-prefix=REASSOC
+
+func.func @scan_1d(%arg0: tensor<1024xi32>) -> (tensor<1024xi32>, tensor<i32>) {
+  %0 = linalg.init_tensor [1024] : tensor<1024xi32>
+  %1 = linalg.init_tensor [] : tensor<i32>
+  %2:2 = iree_linalg_ext.scan dimension(0) inclusive(true)
+      ins(%arg0 : tensor<1024xi32>) outs(%0, %1 : tensor<1024xi32>, tensor<i32>) {
+    ^bb0(%arg1 : i32, %arg2 : i32):
+      %sum = arith.addi %arg1, %arg2 : i32
+      iree_linalg_ext.yield %sum : i32
+  } -> tensor<1024xi32>, tensor<i32>
+  return %2#0, %2#1 : tensor<1024xi32>, tensor<i32>
+}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1) -> (d0)>
+//      CHECK: func.func @scan_1d(
+// CHECK-SAME:     %[[ARG0:.+]]: tensor<1024xi32>
+//  CHECK-DAG:   %[[ZERO:.+]] = arith.constant 0 : i32
+//      CHECK:   %[[EXPANDED:.+]] = tensor.expand_shape %[[ARG0]] {{\[}}[0, 1]] : tensor<1024xi32> into tensor<4x256xi32>
+//      CHECK:   %[[BLOCKS:.+]]:2 = iree_linalg_ext.scan dimension(1) inclusive(true)
+// CHECK-SAME:       ins(%[[EXPANDED]] : tensor<4x256xi32>)
+// CHECK-SAME:       -> tensor<4x256xi32>, tensor<4xi32>
+//      CHECK:   %[[INIT:.+]] = linalg.fill ins(%[[ZERO]] : i32)
+// CHECK-SAME:       -> tensor<i32>
+//      CHECK:   %[[CARRIES:.+]]:2 = iree_linalg_ext.scan dimension(0) inclusive(false)
+// CHECK-SAME:       ins(%[[BLOCKS]]#1 : tensor<4xi32>)
+// CHECK-SAME:       outs(%{{.+}}, %[[INIT]] : tensor<4xi32>, tensor<i32>)
+//      CHECK:   %[[COMBINED:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP0]], #[[MAP1]], #[[MAP0]]]
+// CHECK-SAME:       iterator_types = ["parallel", "parallel"]
+// CHECK-SAME:       ins(%[[BLOCKS]]#0, %[[CARRIES]]#0 : tensor<4x256xi32>, tensor<4xi32>)
+//      CHECK:   ^bb0(%[[PARTIAL:.+]]: i32, %[[CARRY:.+]]: i32, %{{.+}}: i32):
+//      CHECK:     %[[SUM:.+]] = arith.addi %[[CARRY]], %[[PARTIAL]] : i32
+//      CHECK:     linalg.yield %[[SUM]]
+//      CHECK:   %[[RESULT:.+]] = tensor.collapse_shape %[[COMBINED]] {{\[}}[0, 1]] : tensor<4x256xi32> into tensor<1024xi32>
+//      CHECK:   %[[LAST:.+]] = tensor.extract_slice %[[RESULT]][1023] [1] [1] : tensor<1024xi32> to tensor<i32>
+//      CHECK:   return %[[RESULT]], %[[LAST]]
+
+// -----
+
+func.func @scan_2d_maxf(%arg0: tensor<3x512xf32>) -> tensor<3x512xf32> {
+  %0 = linalg.init_tensor [3, 512] : tensor<3x512xf32>
+  %1 = linalg.init_tensor [3] : tensor<3xf32>
+  %2:2 = iree_linalg_ext.scan dimension(1) inclusive(true)
+      ins(%arg0 : tensor<3x512xf32>) outs(%0, %1 : tensor<3x512xf32>, tensor<3xf32>) {
+    ^bb0(%arg1 : f32, %arg2 : f32):
+      %max = arith.maxf %arg1, %arg2 : f32
+      iree_linalg_ext.yield %max : f32
+  } -> tensor<3x512xf32>, tensor<3xf32>
+  return %2#0 : tensor<3x512xf32>
+}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<(d0, d1, d2) -> (d0, d1, d2)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+//      CHECK: func.func @scan_2d_maxf(
+//  CHECK-DAG:   %[[NEG_INF:.+]] = arith.constant 0xFF800000 : f32
+//      CHECK:   tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<3x512xf32> into tensor<3x4x128xf32>
+//      CHECK:   iree_linalg_ext.scan dimension(2) inclusive(true)
+// CHECK-SAME:       -> tensor<3x4x128xf32>, tensor<3x4xf32>
+//      CHECK:   linalg.fill ins(%[[NEG_INF]] : f32)
+//      CHECK:   iree_linalg_ext.scan dimension(1) inclusive(false)
+// CHECK-SAME:       -> tensor<3x4xf32>, tensor<3xf32>
+//      CHECK:   linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP0]], #[[MAP1]], #[[MAP0]]]
+//      CHECK:     arith.maxf
+//      CHECK:   tensor.collapse_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<3x4x128xf32> into tensor<3x512xf32>
+
+// -----
+
+// Exclusive scans, scans with non-associative regions and, by default, float
+// sums are left alone.
+
+func.func @scan_not_split(%arg0: tensor<1024xf32>) -> (tensor<1024xf32>, tensor<1024xf32>, tensor<1024xf32>) {
+  %0 = linalg.init_tensor [1024] : tensor<1024xf32>
+  %1 = linalg.init_tensor [] : tensor<f32>
+  %2:2 = iree_linalg_ext.scan dimension(0) inclusive(false)
+      ins(%arg0 : tensor<1024xf32>) outs(%0, %1 : tensor<1024xf32>, tensor<f32>) {
+    ^bb0(%arg1 : f32, %arg2 : f32):
+      %sum = arith.addf %arg1, %arg2 : f32
+      iree_linalg_ext.yield %sum : f32
+  } -> tensor<1024xf32>, tensor<f32>
+  %3:2 = iree_linalg_ext.scan dimension(0) inclusive(true)
+      ins(%arg0 : tensor<1024xf32>) outs(%0, %1 : tensor<1024xf32>, tensor<f32>) {
+    ^bb0(%arg1 : f32, %arg2 : f32):
+      %diff = arith.subf %arg1, %arg2 : f32
+      iree_linalg_ext.yield %diff : f32
+  } -> tensor<1024xf32>, tensor<f32>
+  %4:2 = iree_linalg_ext.scan dimension(0) inclusive(true)
+      ins(%arg0 : tensor<1024xf32>) outs(%0, %1 : tensor<1024xf32>, tensor<f32>) {
+    ^bb0(%arg1 : f32, %arg2 : f32):
+      %sum = arith.addf %arg1, %arg2 : f32
+      iree_linalg_ext.yield %sum : f32
+  } -> tensor<1024xf32>, tensor<f32>
+  return %2#0, %3#0, %4#0 : tensor<1024xf32>, tensor<1024xf32>, tensor<1024xf32>
+}
+//      CHECK: func.func @scan_not_split(
+//  CHECK-NOT:   tensor.expand_shape
+//      CHECK:   iree_linalg_ext.scan dimension(0) inclusive(false)
+//  CHECK-NOT:   tensor.expand_shape
+//      CHECK:   iree_linalg_ext.scan dimension(0) inclusive(true)
+//  CHECK-NOT:   tensor.expand_shape
+//      CHECK:   iree_linalg_ext.scan dimension(0) inclusive(true)
+//  CHECK-NOT:   tensor.expand_shape
+
+// Float sums are split when reassociation is allowed.
+// REASSOC-LABEL: func.func @scan_not_split(
+//       REASSOC:   tensor.expand_shape %{{.+}} {{\[}}[0, 1]] : tensor<1024xf32> into tensor<4x256xf32>
+//       REASSOC:   iree_linalg_ext.scan dimension(1) inclusive(true)
+//       REASSOC:     arith.addf
+
+// -----
+
+func.func @topk_1d(%arg0: tensor<1024xf32>) -> (tensor<8xf32>, tensor<8xi32>) {
+  %neg_inf = arith.constant 0xFF800000 : f32
+  %c0 = arith.constant 0 : i32
+  %0 = linalg.init_tensor [8] : tensor<8xf32>
+  %1 = linalg.fill ins(%neg_inf : f32) outs(%0 : tensor<8xf32>) -> tensor<8xf32>
+  %2 = linalg.init_tensor [8] : tensor<8xi32>
+  %3 = linalg.fill ins(%c0 : i32) outs(%2 : tensor<8xi32>) -> tensor<8xi32>
+  %4:2 = iree_linalg_ext.topk dimension(0)
+    ins(%arg0 : tensor<1024xf32>)
+    outs(%1, %3 : tensor<8xf32>, tensor<8xi32>) {
+  ^bb0(%arg1: f32, %arg2: f32):
+    %5 = arith.cmpf ogt, %arg1, %arg2 : f32
+    iree_linalg_ext.yield %5 : i1
+  } -> tensor<8xf32>, tensor<8xi32>
+  return %4#0, %4#1 : tensor<8xf32>, tensor<8xi32>
+}
+//  CHECK-DAG: #[[MAP:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//      CHECK: func.func @topk_1d(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]
+//  CHECK-DAG:   %[[NEG_INF:.+]] = arith.constant 0xFF800000 : f32
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : i32
+//  CHECK-DAG:   %[[FILL_V:.+]] = linalg.fill ins(%[[NEG_INF]] : f32) outs(%{{.+}} : tensor<8xf32>)
+//  CHECK-DAG:   %[[FILL_I:.+]] = linalg.fill ins(%[[C0]] : i32) outs(%{{.+}} : tensor<8xi32>)
+//  CHECK-DAG:   %[[EXPANDED:.+]] = tensor.expand_shape %[[ARG0]] {{\[}}[0, 1]] : tensor<1024xf32> into tensor<4x256xf32>
+//      CHECK:   %[[POSITIONS:.+]] = linalg.generic
+// CHECK-SAME:       outs(%{{.+}} : tensor<4x256xi32>)
+//      CHECK:     linalg.index 1 : index
+//  CHECK-DAG:   %[[SEED_V:.+]] = tensor.extract_slice %[[EXPANDED]][0, 0] [4, 8] [1, 1]
+//  CHECK-DAG:   %[[SEED_I:.+]] = tensor.extract_slice %[[POSITIONS]][0, 0] [4, 8] [1, 1]
+//      CHECK:   %[[SEEDS:.+]]:2 = iree_linalg_ext.sort dimension(1)
+// CHECK-SAME:       outs(%[[SEED_V]], %[[SEED_I]] : tensor<4x8xf32>, tensor<4x8xi32>)
+//      CHECK:     arith.cmpf ogt
+//      CHECK:     arith.cmpi slt
+//  CHECK-DAG:   %[[REST_V:.+]] = tensor.extract_slice %[[EXPANDED]][0, 8] [4, 248] [1, 1]
+//  CHECK-DAG:   %[[REST_I:.+]] = tensor.extract_slice %[[POSITIONS]][0, 8] [4, 248] [1, 1]
+//      CHECK:   %[[BLOCK:.+]]:2 = iree_linalg_ext.topk dimension(1)
+// CHECK-SAME:       ins(%[[REST_V]], %[[REST_I]] : tensor<4x248xf32>, tensor<4x248xi32>)
+// CHECK-SAME:       outs(%[[SEEDS]]#0, %[[SEEDS]]#1 : tensor<4x8xf32>, tensor<4x8xi32>)
+//      CHECK:   %[[OFFSET:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP]], #[[MAP]]]
+// CHECK-SAME:       ins(%[[BLOCK]]#1 : tensor<4x8xi32>)
+//      CHECK:     %[[B:.+]] = linalg.index 0 : index
+//      CHECK:     %[[START:.+]] = arith.muli %[[B]], %{{.+}} : index
+//      CHECK:     %[[START_I32:.+]] = arith.index_cast %[[START]] : index to i32
+//      CHECK:     arith.addi %{{.+}}, %[[START_I32]] : i32
+//  CHECK-DAG:   %[[CAND_V:.+]] = tensor.collapse_shape %[[BLOCK]]#0 {{\[}}[0, 1]] : tensor<4x8xf32> into tensor<32xf32>
+//  CHECK-DAG:   %[[CAND_I:.+]] = tensor.collapse_shape %[[OFFSET]] {{\[}}[0, 1]] : tensor<4x8xi32> into tensor<32xi32>
+//      CHECK:   %[[RESULT:.+]]:2 = iree_linalg_ext.topk dimension(0)
+// CHECK-SAME:       ins(%[[CAND_V]], %[[CAND_I]] : tensor<32xf32>, tensor<32xi32>)
+// CHECK-SAME:       outs(%[[FILL_V]], %[[FILL_I]] : tensor<8xf32>, tensor<8xi32>)
+//      CHECK:   return %[[RESULT]]#0, %[[RESULT]]#1
+
+// -----
+
+func.func @sort_1d(%arg0: tensor<1024xi32>, %arg1: tensor<1024xf32>) -> (tensor<1024xi32>, tensor<1024xf32>) {
+  %0:2 = iree_linalg_ext.sort dimension(0)
+    outs(%arg0, %arg1 : tensor<1024xi32>, tensor<1024xf32>) {
+  ^bb0(%arg2: i32, %arg3: i32, %arg4: f32, %arg5: f32):
+    %1 = arith.cmpi slt, %arg2, %arg3 : i32
+    iree_linalg_ext.yield %1 : i1
+  } -> tensor<1024xi32>, tensor<1024xf32>
+  return %0#0, %0#1 : tensor<1024xi32>, tensor<1024xf32>
+}
+//      CHECK: func.func @sort_1d(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]
+//  CHECK-DAG:   %[[EXPANDED0:.+]] = tensor.expand_shape %[[ARG0]] {{\[}}[0, 1]] : tensor<1024xi32> into tensor<4x256xi32>
+//  CHECK-DAG:   %[[EXPANDED1:.+]] = tensor.expand_shape %[[ARG1]] {{\[}}[0, 1]] : tensor<1024xf32> into tensor<4x256xf32>
+//      CHECK:   %[[BLOCKS:.+]]:2 = iree_linalg_ext.sort dimension(1)
+// CHECK-SAME:       outs(%[[EXPANDED0]], %[[EXPANDED1]] : tensor<4x256xi32>, tensor<4x256xf32>)
+//      CHECK:   %[[POSITIONS:.+]] = linalg.generic
+// CHECK-SAME:       ins(%[[BLOCKS]]#0, %[[BLOCKS]]#1 : tensor<4x256xi32>, tensor<4x256xf32>)
+// CHECK-SAME:       outs(%{{.+}} : tensor<4x256xi32>)
+//      CHECK:     tensor.extract %[[BLOCKS]]#0
+//      CHECK:     arith.cmpi slt
+//      CHECK:     arith.index_cast %{{.+}} : index to i32
+//      CHECK:   %[[COLLAPSED:.+]] = tensor.collapse_shape %[[POSITIONS]] {{\[}}[0, 1]] : tensor<4x256xi32> into tensor<1024xi32>
+//      CHECK:   %[[INDICES:.+]] = tensor.expand_shape %[[COLLAPSED]] {{\[}}[0, 1]] : tensor<1024xi32> into tensor<1024x1xi32>
+//      CHECK:   %[[UPDATES0:.+]] = tensor.collapse_shape %[[BLOCKS]]#0 {{\[}}[0, 1]] : tensor<4x256xi32> into tensor<1024xi32>
+//      CHECK:   %[[RESULT0:.+]] = iree_linalg_ext.scatter unique_indices(true)
+// CHECK-SAME:       ins(%[[UPDATES0]], %[[INDICES]] : tensor<1024xi32>, tensor<1024x1xi32>)
+// CHECK-SAME:       outs(%[[ARG0]] : tensor<1024xi32>)
+//      CHECK:   %[[UPDATES1:.+]] = tensor.collapse_shape %[[BLOCKS]]#1 {{\[}}[0, 1]] : tensor<4x256xf32> into tensor<1024xf32>
+//      CHECK:   %[[RESULT1:.+]] = iree_linalg_ext.scatter unique_indices(true)
+// CHECK-SAME:       ins(%[[UPDATES1]], %[[INDICES]] : tensor<1024xf32>, tensor<1024x1xi32>)
+// CHECK-SAME:       outs(%[[ARG1]] : tensor<1024xf32>)
+//      CHECK:   return %[[RESULT0]], %[[RESULT1]]
+
+// -----
+
+func.func @skinny_matmul(%arg0: tensor<1x4096xf32>, %arg1: tensor<4096x64xf32>) -> tensor<1x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = linalg.init_tensor [1, 64] : tensor<1x64xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<1x64xf32>) -> tensor<1x64xf32>
+  %2 = linalg.matmul ins(%arg0, %arg1 : tensor<1x4096xf32>, tensor<4096x64xf32>) outs(%1 : tensor<1x64xf32>) -> tensor<1x64xf32>
+  return %2 : tensor<1x64xf32>
+}
+// CHECK-LABEL: func.func @skinny_matmul
+//  CHECK-SAME:   %[[ARG0:[a-zA-Z0-9_]+]]: tensor<1x4096xf32>
+//  CHECK-SAME:   %[[ARG1:[a-zA-Z0-9_]+]]: tensor<4096x64xf32>
+//   CHECK-DAG:   tensor.expand_shape %[[ARG0]] {{.+}} : tensor<1x4096xf32> into tensor<1x16x256xf32>
+//   CHECK-DAG:   tensor.expand_shape %[[ARG1]] {{.+}} : tensor<4096x64xf32> into tensor<16x256x64xf32>
+//       CHECK:   %[[PARTIAL:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["parallel", "parallel", "parallel", "reduction"]
+//  CHECK-SAME:     -> tensor<16x1x64xf32>
+//       CHECK:   %[[RESULT:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["parallel", "parallel", "reduction"]
+//  CHECK-SAME:     ins(%[[PARTIAL]] : tensor<16x1x64xf32>)
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @wide_matmul(%arg0: tensor<512x512xf32>, %arg1: tensor<512x512xf32>) -> tensor<512x512xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = linalg.init_tensor [512, 512] : tensor<512x512xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<512x512xf32>) -> tensor<512x512xf32>
+  %2 = linalg.matmul ins(%arg0, %arg1 : tensor<512x512xf32>, tensor<512x512xf32>) outs(%1 : tensor<512x512xf32>) -> tensor<512x512xf32>
+  return %2 : tensor<512x512xf32>
+}
+// CHECK-LABEL: func.func @wide_matmul
+//   CHECK-NOT:   tensor.expand_shape
+//       CHECK:   linalg.matmul
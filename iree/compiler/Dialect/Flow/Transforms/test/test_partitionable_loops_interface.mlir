@@ -173,3 +173,39 @@ func.func @sort_unit_dim(%arg0 : tensor<?x1xf32>) -> tensor<?x1xf32> {
 }
 // CHECK-LABEL: func @sort_unit_dim(
 //       CHECK:   util.unfoldable_constant dense<[0, 1]> : tensor<2xindex>
+
+// -----
+
+func.func @scatter_repeated_indices_add(%arg0 : tensor<?x?xi32>,
+    %arg1 : tensor<?x1xi32>, %arg2 : tensor<?x?xi32>) -> tensor<?x?xi32> {
+  %0 = iree_linalg_ext.scatter
+      {__test_interface__ = true}
+      unique_indices(false)
+      ins(%arg2, %arg1 : tensor<?x?xi32>, tensor<?x1xi32>)
+      outs(%arg0 : tensor<?x?xi32>) {
+        ^bb0(%arg3 : i32, %arg4 : i32):
+          %1 = arith.addi %arg3, %arg4 : i32
+          iree_linalg_ext.yield %1 : i32
+      } -> tensor<?x?xi32>
+  return %0 : tensor<?x?xi32>
+}
+// CHECK-LABEL: func @scatter_repeated_indices_add(
+//       CHECK:   util.unfoldable_constant dense<1> : tensor<2xindex>
+
+// -----
+
+func.func @scatter_repeated_indices_sub(%arg0 : tensor<?x?xf32>,
+    %arg1 : tensor<?x1xi32>, %arg2 : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = iree_linalg_ext.scatter
+      {__test_interface__ = true}
+      unique_indices(false)
+      ins(%arg2, %arg1 : tensor<?x?xf32>, tensor<?x1xi32>)
+      outs(%arg0 : tensor<?x?xf32>) {
+        ^bb0(%arg3 : f32, %arg4 : f32):
+          %1 = arith.subf %arg3, %arg4 : f32
+          iree_linalg_ext.yield %1 : f32
+      } -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+// CHECK-LABEL: func @scatter_repeated_indices_sub(
+//       CHECK:   util.unfoldable_constant dense<0> : tensor<2xindex>
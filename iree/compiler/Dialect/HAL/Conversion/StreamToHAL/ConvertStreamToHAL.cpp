@@ -699,7 +699,7 @@ struct CmdDispatchOpPattern
                              {SymbolRefAttr::get(entryPointOp->getParentOp()),
                               SymbolRefAttr::get(entryPointOp)});
       auto caseWorkgroupCount = calculateDispatchWorkgroupCount(
-          loc, executableOp, entryPointOp, adaptor.workgroup_count(),
+          loc, device, executableOp, entryPointOp, adaptor.workgroup_count(),
           caseBuilder);
       caseBuilder.create<IREE::HAL::CommandBufferDispatchSymbolOp>(
           loc, commandBuffer, entryPointSymRef, caseWorkgroupCount[0],
@@ -778,13 +778,13 @@ struct CmdDispatchOpPattern
   // of invocations required as calculated by the generic workload logic
   // (basically, number of output elements in tensors).
   static std::array<Value, 3> calculateDispatchWorkgroupCount(
-      Location loc, IREE::HAL::ExecutableOp executableOp,
+      Location loc, Value device, IREE::HAL::ExecutableOp executableOp,
       IREE::HAL::ExecutableEntryPointOp entryPointOp, ValueRange workload,
       OpBuilder &builder) {
     Region *region = entryPointOp.getBody();
     if (region) {
-      return calculateDispatchWorkgroupCountFromRegion(loc, entryPointOp,
-                                                       workload, builder);
+      return calculateDispatchWorkgroupCountFromRegion(
+          loc, device, entryPointOp, workload, builder);
     }
     auto workgroupSize = calculateDispatchWorkgroupSize(
         loc, executableOp, entryPointOp, workload, builder);
@@ -808,14 +808,19 @@ struct CmdDispatchOpPattern
   }
 
   static std::array<Value, 3> calculateDispatchWorkgroupCountFromRegion(
-      Location loc, IREE::HAL::ExecutableEntryPointOp entryPointOp,
-      ValueRange workload, OpBuilder &builder) {
+      Location loc, Value device,
+      IREE::HAL::ExecutableEntryPointOp entryPointOp, ValueRange workload,
+      OpBuilder &builder) {
     // TODO(benvanik): replace with region inlining util.
     Block *body = entryPointOp.getBlock();
     BlockAndValueMapping bvm;
     for (auto args : llvm::enumerate(workload)) {
       bvm.map(body->getArgument(args.index()), args.value());
     }
+    // Regions may optionally query the device the dispatch is recorded on.
+    if (body->getNumArguments() > 3) {
+      bvm.map(body->getArgument(3), device);
+    }
     for (Operation &op : body->without_terminator()) {
       builder.clone(op, bvm);
     }
@@ -734,18 +734,24 @@ LogicalResult ExecutableEntryPointOp::verify() {
   if (!llvm::hasSingleElement(*region)) {
     return op.emitOpError() << "expected a single region";
   }
-  if (region->getNumArguments() != 3) {
+  if (region->getNumArguments() != 3 && region->getNumArguments() != 4) {
     return op.emitOpError(
         "expected three arguments for workgroup_count_region for workload "
         "along "
         "x, y, and z");
   }
-  for (BlockArgument &blockArg : region->getArguments()) {
+  for (BlockArgument &blockArg : region->getArguments().take_front(3)) {
     if (!blockArg.getType().isa<IndexType>()) {
       return op.emitOpError(
           "expected arguments to workgroup_count_region be index type");
     }
   }
+  if (region->getNumArguments() == 4 &&
+      !region->getArgument(3).getType().isa<IREE::HAL::DeviceType>()) {
+    return op.emitOpError(
+        "expected optional fourth argument to workgroup_count_region be "
+        "!hal.device type");
+  }
   // Check that the last statement in the block is `hal.yield` operation.
   // TODO(ravishankarm): The SingleBlockImplicitTerminator<"HAL::ReturnOp">
   // should generate this check, but it doesnt.
@@ -59,6 +59,30 @@ hal.executable @ex_with_workgroup_count_region {
 
 // -----
 
+#executable_target_format = #hal.executable.target<"backend", "format">
+
+// CHECK-LABEL: @ex_with_device_workgroup_count_region
+hal.executable @ex_with_device_workgroup_count_region {
+  hal.executable.variant @backend, target = #executable_target_format {
+    // CHECK: hal.executable.entry_point public @entry0
+    hal.executable.entry_point @entry0 ordinal(0) layout(#hal.executable.layout<push_constants = 0, sets = [
+      #hal.descriptor_set.layout<0, bindings = [
+        #hal.descriptor_set.binding<0, storage_buffer>
+      ]>
+    ]>) {
+    // CHECK-NEXT: ^bb0(%[[X:.+]]: index, %{{.+}}: index, %{{.+}}: index, %[[DEVICE:.+]]: !hal.device):
+    ^bb0(%arg0: index, %arg1: index, %arg2: index, %device: !hal.device):
+      // CHECK: hal.device.query<%[[DEVICE]] : !hal.device> key("hal.dispatch" :: "concurrency")
+      %ok, %value = hal.device.query<%device : !hal.device> key("hal.dispatch" :: "concurrency") : i1, i32 = 0 : i32
+      %concurrency = arith.index_cast %value : i32 to index
+      %count = arith.minui %arg0, %concurrency : index
+      hal.return %count, %arg1, %arg2 : index, index, index
+    }
+  }
+}
+
+// -----
+
 // CHECK-LABEL: @executable_create
 // CHECK-SAME: %[[DEVICE:.+]]: !hal.device,
 // CHECK-SAME: %[[LAYOUT0:.+]]: !hal.executable_layout,
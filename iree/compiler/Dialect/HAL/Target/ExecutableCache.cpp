@@ -0,0 +1,141 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/Target/ExecutableCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/Parser/Parser.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Bump when the entry format or key composition changes.
+static constexpr char kExecutableCacheVersion[] = "iree-executable-cache-v2";
+
+// Defined by the build when the revision the compiler is built from is known.
+#if defined(IREE_COMPILER_REVISION)
+static constexpr char kCompilerRevision[] = IREE_COMPILER_REVISION;
+#else
+static constexpr char kCompilerRevision[] = "";
+#endif  // IREE_COMPILER_REVISION
+
+static llvm::cl::opt<std::string> clExecutableCacheRevision(
+    "iree-hal-executable-cache-revision",
+    llvm::cl::desc("Compiler revision used to key executable cache entries. "
+                   "Defaults to the revision the compiler was built from; "
+                   "the cache is disabled if neither is known."),
+    llvm::cl::init(kCompilerRevision));
+
+ExecutableCache::ExecutableCache(StringRef path)
+    : path(path.str()), revision(clExecutableCacheRevision) {}
+
+std::string ExecutableCache::computeKey(
+    StringRef stage, IREE::HAL::ExecutableVariantOp variantOp,
+    const TargetBackend &targetBackend) const {
+  // Elided constants would make distinct IR hash identically.
+  OpPrintingFlags flags;
+  if (flags.getLargeElementsAttrLimit().hasValue()) return "";
+  flags.useLocalScope();
+
+  std::string keyData;
+  llvm::raw_string_ostream os(keyData);
+  os << kExecutableCacheVersion << "\n";
+  os << "iree " << revision << "\n";
+  os << "llvm " << LLVM_VERSION_STRING << "\n";
+  os << stage << "\n";
+  os << targetBackend.name() << "\n";
+  if (failed(targetBackend.appendCacheKey(os))) return "";
+  os << "\n";
+  // Backends may derive symbol and library names from the executable name.
+  auto executableOp = variantOp->getParentOfType<IREE::HAL::ExecutableOp>();
+  os << executableOp.getName() << "\n";
+  variantOp->print(os, flags);
+  os.flush();
+
+  auto hash = llvm::SHA256::hash(llvm::arrayRefFromStringRef(keyData));
+  return llvm::toHex(hash, /*LowerCase=*/true);
+}
+
+std::string ExecutableCache::getEntryPath(StringRef key) const {
+  SmallString<256> entryPath(path);
+  llvm::sys::path::append(entryPath, key + ".mlir");
+  return entryPath.str().str();
+}
+
+OwningOpRef<mlir::ModuleOp> ExecutableCache::lookup(StringRef key,
+                                                    Location loc) const {
+  std::string entryPath = getEntryPath(key);
+  auto fileOr = llvm::MemoryBuffer::getFile(entryPath);
+  if (!fileOr) return {};
+
+  // Entries written by an incompatible compiler may fail to parse. Swallow
+  // only the diagnostics originating from the entry so that those emitted by
+  // other threads sharing the context still reach the user.
+  ScopedDiagnosticHandler diagnosticHandler(
+      loc.getContext(), [&](Diagnostic &diagnostic) {
+        auto fileLoc = diagnostic.getLocation().dyn_cast<FileLineColLoc>();
+        return success(fileLoc && fileLoc.getFilename() == entryPath);
+      });
+  llvm::SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(std::move(*fileOr), llvm::SMLoc());
+  auto moduleOp = parseSourceFile<mlir::ModuleOp>(sourceMgr, loc.getContext());
+  if (!moduleOp) return {};
+  auto executableOps = moduleOp->getOps<IREE::HAL::ExecutableOp>();
+  if (std::distance(executableOps.begin(), executableOps.end()) != 1) {
+    return {};
+  }
+  return moduleOp;
+}
+
+void ExecutableCache::store(StringRef key, Location loc,
+                            ArrayRef<Operation *> ops) const {
+  OwningOpRef<mlir::ModuleOp> moduleOp = mlir::ModuleOp::create(loc);
+  auto builder = OpBuilder::atBlockBegin(moduleOp->getBody());
+  auto executableOp = builder.create<IREE::HAL::ExecutableOp>(loc, "cached");
+  builder.setInsertionPoint(executableOp.getBlock().getTerminator());
+  for (auto *op : ops) builder.clone(*op);
+
+  // Write to a unique temporary file and rename it into place so that
+  // concurrent compilations never observe partially written entries.
+  std::string entryPath = getEntryPath(key);
+  if (llvm::sys::fs::create_directories(path)) return;
+  int fd = -1;
+  SmallString<256> tempPath;
+  if (llvm::sys::fs::createUniqueFile(entryPath + ".%%%%%%%%.tmp", fd,
+                                      tempPath)) {
+    return;
+  }
+  bool hadError = false;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    moduleOp->print(os, OpPrintingFlags().enableDebugInfo());
+    os.close();
+    hadError = os.has_error();
+    os.clear_error();
+  }
+  if (hadError || llvm::sys::fs::rename(tempPath, entryPath)) {
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,74 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_HAL_TARGET_EXECUTABLECACHE_H_
+#define IREE_COMPILER_DIALECT_HAL_TARGET_EXECUTABLECACHE_H_
+
+#include <string>
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
+#include "llvm/ADT/StringRef.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// An on-disk cache of executable translation and serialization results that
+// persists across compiler invocations.
+//
+// Entries are keyed by a hash of the executable variant IR (printed without
+// locations), the stage producing the entry, the target backend name and
+// configuration (see TargetBackend::appendCacheKey), and the compiler revision.
+// Backends are responsible for including the flags read by the passes of their
+// translation pipelines. The cache is disabled when the compiler revision is
+// unknown as entries written by a different compiler build would otherwise be
+// silently reused.
+// Each entry holds the resulting ops as textual IR nested within a placeholder
+// hal.executable so that they can be parsed back and moved into the real
+// executable on a hit.
+//
+// The cache is best-effort: unreadable or unparsable entries are treated as
+// misses and failures to store entries are ignored. Entries are written
+// atomically so that concurrent compiler invocations may share a directory.
+class ExecutableCache {
+ public:
+  explicit ExecutableCache(StringRef path);
+
+  // Returns true if the cache is enabled.
+  bool isEnabled() const { return !path.empty() && !revision.empty(); }
+
+  // Computes the key of the entry for |stage| applied to |variantOp| by
+  // |targetBackend|. Must be called before the stage mutates |variantOp|.
+  // Returns an empty string if the variant cannot be cached.
+  std::string computeKey(StringRef stage,
+                         IREE::HAL::ExecutableVariantOp variantOp,
+                         const TargetBackend &targetBackend) const;
+
+  // Returns a module containing the placeholder hal.executable holding the ops
+  // stored under |key| parsed into the context of |loc| or nullptr if there is
+  // no usable entry.
+  OwningOpRef<mlir::ModuleOp> lookup(StringRef key, Location loc) const;
+
+  // Stores clones of |ops| under |key|, replacing any existing entry.
+  void store(StringRef key, Location loc, ArrayRef<Operation *> ops) const;
+
+ private:
+  std::string getEntryPath(StringRef key) const;
+
+  std::string path;
+  std::string revision;
+};
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_HAL_TARGET_EXECUTABLECACHE_H_
@@ -6,11 +6,14 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMAOTTarget.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <iterator>
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
 #include "iree-dialects/Dialect/LinalgTransform/LinalgTransformOps.h"
 #include "iree/compiler/Codegen/Dialect/IREECodegenDialect.h"
+#include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
 #include "iree/compiler/Codegen/Passes.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/Builtins/Device.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/Builtins/Musl.h"
@@ -19,6 +22,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LinkerTool.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/StaticLibraryGenerator.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -26,11 +30,16 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/PDL/IR/PDL.h"
 #include "mlir/Dialect/PDLInterp/IR/PDLInterp.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
@@ -136,6 +145,67 @@ static LogicalResult linkBuiltinLibrary(
   return success();
 }
 
+// Entry points per partition below which automatic partitioning is not worth
+// the extra bitcode round-trip and the loss of cross-function codegen.
+static constexpr int kMinEntryPointsPerCodegenPartition = 8;
+
+// Upper bound on automatically selected partitions. Fixed instead of derived
+// from the host thread count so that the output is reproducible.
+static constexpr int kMaxAutomaticCodegenPartitions = 16;
+
+// Returns the number of partitions to split code generation of a module with
+// |entryPointCount| entry points into.
+static int selectCodegenPartitionCount(const LLVMTargetOptions &options,
+                                       int entryPointCount) {
+  if (options.codegenPartitions > 0) return options.codegenPartitions;
+  return std::max(1, std::min(kMaxAutomaticCodegenPartitions,
+                              entryPointCount /
+                                  kMinEntryPointsPerCodegenPartition));
+}
+
+// Splits |llvmModule| into |partitionCount| modules and compiles each to an
+// object file in parallel on the |context| thread pool. Object files are
+// returned in partition order so that thread scheduling does not affect the
+// linked output.
+//
+// Each partition round-trips through bitcode into its own llvm::LLVMContext as
+// contexts (and target machines) cannot be shared across threads. Internal
+// symbols referenced across partitions are promoted to hidden symbols and
+// resolved by the linker.
+static LogicalResult emitPartitionedObjectFiles(
+    MLIRContext *context, const LLVMTargetOptions &options,
+    llvm::Module &llvmModule, int partitionCount,
+    SmallVectorImpl<std::string> &objectDatas) {
+  SmallVector<SmallString<0>> partitionBitcodes;
+  llvm::SplitModule(
+      llvmModule, partitionCount,
+      [&](std::unique_ptr<llvm::Module> partitionModule) {
+        SmallString<0> bitcode;
+        llvm::raw_svector_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*partitionModule, os);
+        partitionBitcodes.push_back(std::move(bitcode));
+      },
+      /*PreserveLocals=*/false);
+
+  objectDatas.resize(partitionBitcodes.size());
+  return failableParallelForEachN(
+      context, 0, partitionBitcodes.size(), [&](size_t i) -> LogicalResult {
+        llvm::LLVMContext partitionContext;
+        auto partitionModule = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(partitionBitcodes[i].str(), "partition"),
+            partitionContext);
+        if (!partitionModule) {
+          llvm::consumeError(partitionModule.takeError());
+          return failure();
+        }
+        auto targetMachine = createTargetMachine(options);
+        if (!targetMachine) return failure();
+        return runEmitObjFilePasses(targetMachine.get(),
+                                    partitionModule->get(),
+                                    llvm::CGFT_ObjectFile, &objectDatas[i]);
+      });
+}
+
 class LLVMAOTTargetBackend final : public TargetBackend {
  public:
   explicit LLVMAOTTargetBackend(LLVMTargetOptions options)
@@ -177,6 +247,35 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     buildLLVMCPUCodegenPassPipeline(passManager);
   }
 
+  LogicalResult appendCacheKey(llvm::raw_ostream &os) const override {
+    // Static libraries, kept linker artifacts, and library IR dumps are written
+    // to disk as a side effect of serialization and would be missing on cache
+    // hits.
+    if (options_.linkStatic || options_.keepLinkerArtifacts ||
+        !options_.libraryIRDumpPath.empty()) {
+      return failure();
+    }
+    os << "triple=" << options_.targetTriple << ";";
+    os << "cpu=" << options_.targetCPU << ";";
+    os << "features=" << options_.targetCPUFeatures << ";";
+    os << "abi=" << options_.options.MCOptions.ABIName << ";";
+    os << "float-abi=" << static_cast<int>(options_.options.FloatABIType)
+       << ";";
+    os << "opt=" << options_.optLevel.getSpeedupLevel() << ","
+       << options_.optLevel.getSizeLevel() << ";";
+    const auto &tuning = options_.pipelineTuningOptions;
+    os << "tuning=" << tuning.LoopInterleaving << tuning.LoopVectorization
+       << tuning.SLPVectorization << tuning.LoopUnrolling << ";";
+    os << "debug=" << options_.debugSymbols << ";";
+    os << "sanitizer=" << static_cast<int>(options_.sanitizerKind) << ";";
+    os << "embedded=" << options_.linkEmbedded << ";";
+    os << "partitions=" << options_.codegenPartitions << ";";
+    os << "linkers=" << options_.systemLinkerPath << ","
+       << options_.embeddedLinkerPath << "," << options_.wasmLinkerPath << ";";
+    // Codegen flags are read by the passes of the translation pipeline.
+    return appendCPUCodegenFlagsCacheKey(os);
+  }
+
   LogicalResult linkExecutables(mlir::ModuleOp moduleOp) override {
     OpBuilder builder = OpBuilder::atBlockBegin(moduleOp.getBody());
 
@@ -313,8 +412,30 @@ class LLVMAOTTargetBackend final : public TargetBackend {
                                     .getValueOr(APInt(64, 0))
                                     .getSExtValue();
 
-      libraryBuilder.addExport(entryPointOp.getName(), "",
-                               LibraryBuilder::DispatchAttrs{localMemorySize},
+      LibraryBuilder::DispatchAttrs dispatchAttrs;
+      dispatchAttrs.localMemorySize = localMemorySize;
+
+      // Optional scheduling hints attached to the entry point by codegen.
+      // These let the runtime size work reservations and prefetch inputs but
+      // never change the results of the dispatch.
+      if (auto readBytesAttr = entryPointOp->getAttrOfType<IntegerAttr>(
+              "hal.dispatch.workgroup_read_bytes")) {
+        dispatchAttrs.workgroupReadBytes = readBytesAttr.getInt();
+      }
+      if (auto reuseDistanceAttr = entryPointOp->getAttrOfType<IntegerAttr>(
+              "hal.dispatch.reuse_distance")) {
+        dispatchAttrs.reuseDistance = reuseDistanceAttr.getInt();
+      }
+      if (auto walkOrderAttr = entryPointOp->getAttrOfType<StringAttr>(
+              "hal.dispatch.walk_order")) {
+        if (walkOrderAttr.getValue() == "yxz") {
+          dispatchAttrs.walkOrder = LibraryBuilder::WalkOrder::YXZ;
+        }
+      }
+      dispatchAttrs.streaming =
+          entryPointOp->hasAttr("hal.dispatch.streaming");
+
+      libraryBuilder.addExport(entryPointOp.getName(), "", dispatchAttrs,
                                llvmFunc);
     }
 
@@ -333,6 +454,21 @@ class LLVMAOTTargetBackend final : public TargetBackend {
         llvm::GlobalValue::LinkageTypes::ExternalLinkage);
     queryLibraryFunc->setDSOLocal(false);
 
+    // Optionally dump the library IR before builtins are linked in and
+    // optimizations run such that the library metadata can be inspected.
+    if (!options_.libraryIRDumpPath.empty()) {
+      SmallString<128> dumpPath(options_.libraryIRDumpPath);
+      llvm::sys::path::append(dumpPath, libraryName + ".ll");
+      std::error_code error;
+      llvm::raw_fd_ostream os(dumpPath, error, llvm::sys::fs::OF_Text);
+      if (error) {
+        return variantOp.emitError()
+               << "failed to open library IR dump file '" << dumpPath
+               << "': " << error.message();
+      }
+      llvmModule->print(os, /*AAW=*/nullptr);
+    }
+
     // If linking dynamically, find a suitable linker tool and configure the
     // module with any options that tool requires.
     std::unique_ptr<LinkerTool> linkerTool;
@@ -425,26 +561,48 @@ class LLVMAOTTargetBackend final : public TargetBackend {
 
     SmallVector<Artifact> objectFiles;
 
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
+    // Emit the base object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking
+    // order.
     {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
-      std::string objectData;
-      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
-                                      llvm::CGFT_ObjectFile, &objectData))) {
-        return variantOp.emitError()
-               << "failed to compile LLVM-IR module to an object file";
+      // Large executables (such as those produced by linking all dispatches of
+      // a model together) are split into partitions that are compiled in
+      // parallel. Static library generation only supports one object file per
+      // library and always uses a single partition.
+      int partitionCount = 1;
+      if (!options_.linkStatic) {
+        auto entryPointOps =
+            variantOp.getBlock().getOps<ExecutableEntryPointOp>();
+        int entryPointCount =
+            std::distance(entryPointOps.begin(), entryPointOps.end());
+        partitionCount = selectCodegenPartitionCount(options_, entryPointCount);
+      }
+      SmallVector<std::string> objectDatas;
+      if (partitionCount > 1) {
+        if (failed(emitPartitionedObjectFiles(variantOp.getContext(), options_,
+                                              *llvmModule, partitionCount,
+                                              objectDatas))) {
+          return variantOp.emitError()
+                 << "failed to compile LLVM-IR module partitions to object "
+                    "files";
+        }
+      } else {
+        objectDatas.emplace_back();
+        if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
+                                        llvm::CGFT_ObjectFile,
+                                        &objectDatas.front()))) {
+          return variantOp.emitError()
+                 << "failed to compile LLVM-IR module to an object file";
+        }
+      }
+      for (auto &objectData : objectDatas) {
+        auto objectFile = Artifact::createTemporary(libraryName, "o");
+        auto &os = objectFile.outputFile->os();
+        os << objectData;
+        os.flush();
+        os.close();
+        objectFiles.push_back(std::move(objectFile));
       }
-      auto objectFile = Artifact::createTemporary(libraryName, "o");
-      auto &os = objectFile.outputFile->os();
-      os << objectData;
-      os.flush();
-      os.close();
-      objectFiles.push_back(std::move(objectFile));
     }
 
     // If we are keeping artifacts then let's also add the bitcode and
@@ -191,6 +191,21 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::init(targetOptions.keepLinkerArtifacts));
   targetOptions.keepLinkerArtifacts = clKeepLinkerArtifacts;
 
+  static llvm::cl::opt<std::string> clLibraryIRDumpPath(
+      "iree-llvm-dump-library-ir-path",
+      llvm::cl::desc("Directory to write the unoptimized LLVM IR of each "
+                     "executable library into (as '{libraryName}.ll')"),
+      llvm::cl::init(targetOptions.libraryIRDumpPath));
+  targetOptions.libraryIRDumpPath = clLibraryIRDumpPath;
+
+  static llvm::cl::opt<int> clCodegenPartitions(
+      "iree-llvm-codegen-partitions",
+      llvm::cl::desc("Number of partitions to split each executable into for "
+                     "parallel LLVM code generation (0 = automatic based on "
+                     "the entry point count, 1 = no partitioning)"),
+      llvm::cl::init(targetOptions.codegenPartitions));
+  targetOptions.codegenPartitions = clCodegenPartitions;
+
   static llvm::cl::opt<std::string> clStaticLibraryOutputPath(
       "iree-llvm-static-library-output-path",
       llvm::cl::desc(
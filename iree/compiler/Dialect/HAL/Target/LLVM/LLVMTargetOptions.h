@@ -65,6 +65,18 @@ struct LLVMTargetOptions {
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
 
+  // Directory to write the LLVM IR of each executable library into as
+  // "{libraryName}.ll" after the library metadata has been built and before
+  // builtins are linked in or optimizations run. Empty to disable.
+  std::string libraryIRDumpPath;
+
+  // Number of partitions the linked LLVM module is split into for parallel
+  // code generation. 0 selects a count based on the number of entry points in
+  // the executable and 1 disables partitioning. The partitioning depends only
+  // on this value and the module contents so the output is reproducible
+  // regardless of how many threads are available.
+  int codegenPartitions = 0;
+
   // Build for IREE static library loading using this output path for
   // a "{staticLibraryOutput}.o" object file and "{staticLibraryOutput}.h"
   // header file.
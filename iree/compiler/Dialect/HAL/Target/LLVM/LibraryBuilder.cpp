@@ -7,6 +7,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LibraryBuilder.h"
 
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/Support/MathExtras.h"
 
 // =============================================================================
 //
@@ -328,6 +329,30 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ImportTable(
                        });
 }
 
+// Encodes |value| as a log2(value)+1 hint field clamped to |mask|.
+// Values <= 0 are encoded as 0 to indicate that the hint is not provided.
+static uint16_t encodeLog2Hint(int64_t value, unsigned mask) {
+  if (value <= 0) return 0;
+  uint64_t encoded = llvm::Log2_64(static_cast<uint64_t>(value)) + 1;
+  return static_cast<uint16_t>(std::min<uint64_t>(encoded, mask));
+}
+
+// Packs the scheduling hints of |attrs| into an
+// iree_hal_executable_dispatch_hints_t value.
+static uint16_t encodeDispatchHints(
+    const LibraryBuilder::DispatchAttrs &attrs) {
+  uint16_t hints = 0;
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_READ_BYTES_*
+  hints |= encodeLog2Hint(attrs.workgroupReadBytes, 0x3Fu) << 0;
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_REUSE_DISTANCE_*
+  hints |= encodeLog2Hint(attrs.reuseDistance, 0x1Fu) << 6;
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_WALK_ORDER_*
+  hints |= (static_cast<uint16_t>(attrs.walkOrder) & 0x3u) << 11;
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_STREAMING
+  if (attrs.streaming) hints |= 1u << 13;
+  return hints;
+}
+
 llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
     std::string libraryName) {
   auto &context = module->getContext();
@@ -362,7 +387,7 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
       llvm::find_if(exports, [](const Dispatch &dispatch) {
         return !dispatch.attrs.isDefault();
       }) != exports.end();
-  if (!hasNonDefaultAttrs) {
+  if (hasNonDefaultAttrs) {
     SmallVector<llvm::Constant *, 4> exportAttrValues;
     for (auto dispatch : exports) {
       exportAttrValues.push_back(llvm::ConstantStruct::get(
@@ -373,8 +398,9 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
                   i16Type, RoundUpToAlignment(dispatch.attrs.localMemorySize,
                                               kWorkgroupLocalMemoryPageSize) /
                                kWorkgroupLocalMemoryPageSize),
-              // reserved=
-              llvm::ConstantInt::get(i16Type, 0),
+              // hints=
+              llvm::ConstantInt::get(i16Type,
+                                     encodeDispatchHints(dispatch.attrs)),
           }));
     }
     auto *exportAttrsType =
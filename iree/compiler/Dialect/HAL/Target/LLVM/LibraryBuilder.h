@@ -77,13 +77,36 @@ class LibraryBuilder {
   // IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
   static const int64_t kWorkgroupLocalMemoryPageSize = 4096;
 
+  // IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_*
+  enum class WalkOrder : uint32_t {
+    // IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_XYZ
+    XYZ = 0u,
+    // IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_YXZ
+    YXZ = 1u,
+  };
+
   // iree_hal_executable_dispatch_attrs_v0_t
   struct DispatchAttrs {
     // Required workgroup local memory size, in bytes.
     int64_t localMemorySize = 0;
 
+    // Scheduling hints; see iree_hal_executable_dispatch_hints_t.
+    // Approximate bytes of binding memory read per workgroup or 0 if unknown.
+    int64_t workgroupReadBytes = 0;
+    // Distance in workgroups after which data read by a workgroup is read
+    // again by another or 0 if unknown.
+    int64_t reuseDistance = 0;
+    // Preferred workgroup walk order.
+    WalkOrder walkOrder = WalkOrder::XYZ;
+    // True if each workgroup reads a disjoint contiguous slice of each binding
+    // in walk order.
+    bool streaming = false;
+
     // True if all values are default and the attributes may be omitted.
-    constexpr bool isDefault() const { return localMemorySize == 0; }
+    constexpr bool isDefault() const {
+      return localMemorySize == 0 && workgroupReadBytes == 0 &&
+             reuseDistance == 0 && walkOrder == WalkOrder::XYZ && !streaming;
+    }
   };
 
   LibraryBuilder(llvm::Module *module, Mode mode,
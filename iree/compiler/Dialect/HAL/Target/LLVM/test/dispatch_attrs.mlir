@@ -0,0 +1,51 @@
+// RUN: rm -rf %t && mkdir -p %t && \
+// RUN:   iree-translate -iree-mlir-to-hal-executable \
+// RUN:     -iree-hal-target-backends=dylib-llvm-aot \
+// RUN:     -iree-llvm-target-triple=x86_64-unknown-unknown-eabi-elf \
+// RUN:     -iree-llvm-dump-library-ir-path=%t %s -o=/dev/null && \
+// RUN:   FileCheck %s --input-file=%t/executable.ll
+
+// Tests that the scheduling hints attached to entry points are packed into the
+// iree_hal_executable_dispatch_attrs_v0_t table of the library. Entry points
+// without hints get a zeroed entry as soon as any other entry point has one.
+
+#executable_layout = #hal.executable.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+
+hal.executable.source public @executable {
+  hal.executable.entry_point public @plain layout(#executable_layout)
+  // workgroup_read_bytes: log2(65536)+1 = 17 << 0
+  // reuse_distance:       log2(4)+1     =  3 << 6
+  // walk_order:           yxz           =  1 << 11
+  // streaming:                              1 << 13
+  hal.executable.entry_point public @hinted layout(#executable_layout) {
+    hal.dispatch.workgroup_read_bytes = 65536 : i64,
+    hal.dispatch.reuse_distance = 4 : i64,
+    hal.dispatch.walk_order = "yxz",
+    hal.dispatch.streaming
+  }
+  builtin.module {
+    func.func @plain() {
+      %s0b0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(32) : !flow.dispatch.tensor<readonly:4xf32>
+      %s0b1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(32) : !flow.dispatch.tensor<writeonly:4xf32>
+      %0 = flow.dispatch.tensor.load %s0b0, offsets = [0], sizes = [4], strides = [1] : !flow.dispatch.tensor<readonly:4xf32> -> tensor<4xf32>
+      flow.dispatch.tensor.store %0, %s0b1, offsets = [0], sizes = [4], strides = [1] : tensor<4xf32> -> !flow.dispatch.tensor<writeonly:4xf32>
+      return
+    }
+    func.func @hinted() {
+      %s0b0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(32) : !flow.dispatch.tensor<readonly:4xf32>
+      %s0b1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(32) : !flow.dispatch.tensor<writeonly:4xf32>
+      %0 = flow.dispatch.tensor.load %s0b0, offsets = [0], sizes = [4], strides = [1] : !flow.dispatch.tensor<readonly:4xf32> -> tensor<4xf32>
+      flow.dispatch.tensor.store %0, %s0b1, offsets = [0], sizes = [4], strides = [1] : tensor<4xf32> -> !flow.dispatch.tensor<writeonly:4xf32>
+      return
+    }
+  }
+}
+
+// CHECK: @executable_attrs = private constant [2 x %iree_hal_executable_dispatch_attrs_v0_t]
+// CHECK-SAME: [%iree_hal_executable_dispatch_attrs_v0_t zeroinitializer,
+// CHECK-SAME:  %iree_hal_executable_dispatch_attrs_v0_t { i16 0, i16 10449 }]
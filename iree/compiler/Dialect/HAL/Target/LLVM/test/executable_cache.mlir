@@ -0,0 +1,56 @@
+// Each compilation stores one translation and one serialization entry per
+// executable. Changing a codegen flag must miss and store new entries while
+// repeating a compilation must hit and leave the cache untouched.
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t -iree-hal-executable-cache-revision=test %s -o=/dev/null
+// RUN: ls %t | wc -l | FileCheck %s --check-prefix=ENTRIES-2
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t -iree-hal-executable-cache-revision=test -iree-codegen-llvm-generic-ops-workgroup-size=32 %s -o=/dev/null
+// RUN: ls %t | wc -l | FileCheck %s --check-prefix=ENTRIES-4
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t -iree-hal-executable-cache-revision=test -iree-codegen-llvm-generic-ops-workgroup-size=32 %s -o=/dev/null
+// RUN: ls %t | wc -l | FileCheck %s --check-prefix=ENTRIES-4
+
+// ENTRIES-2: {{^ *2$}}
+// ENTRIES-4: {{^ *4$}}
+
+// Codegen flags that backends cannot key on disable the cache.
+
+// RUN: rm -rf %t.unkeyed && mkdir -p %t.unkeyed
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t.unkeyed -iree-hal-executable-cache-revision=test -iree-codegen-mmt4d-use-intrinsics %s -o=/dev/null
+// RUN: ls %t.unkeyed | wc -l | FileCheck %s --check-prefix=ENTRIES-0
+
+// ENTRIES-0: {{^ *0$}}
+
+module attributes {
+  hal.device.targets = [
+    #hal.device.target<"dylib", {
+      executable_targets = [
+        #hal.executable.target<"llvm", "embedded-elf-x86_64">
+      ]
+    }>
+  ]
+} {
+
+stream.executable public @add_dispatch_0 {
+  stream.executable.export @add_dispatch_0
+  builtin.module  {
+    func.func @add_dispatch_0(%arg0_binding: !stream.binding, %arg1_binding: !stream.binding, %arg2_binding: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      %arg0 = stream.binding.subspan %arg0_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:16xf32>
+      %arg1 = stream.binding.subspan %arg1_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:16xf32>
+      %arg2 = stream.binding.subspan %arg2_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:16xf32>
+      %0 = linalg.init_tensor [16] : tensor<16xf32>
+      %1 = flow.dispatch.tensor.load %arg0, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:16xf32> -> tensor<16xf32>
+      %2 = flow.dispatch.tensor.load %arg1, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:16xf32> -> tensor<16xf32>
+      %3 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%1, %2 : tensor<16xf32>, tensor<16xf32>) outs(%0 : tensor<16xf32>) {
+      ^bb0(%arg3: f32, %arg4: f32, %arg5: f32):
+        %4 = arith.addf %arg3, %arg4 : f32
+        linalg.yield %4 : f32
+      } -> tensor<16xf32>
+      flow.dispatch.tensor.store %3, %arg2, offsets=[0], sizes=[16], strides=[1] : tensor<16xf32> -> !flow.dispatch.tensor<writeonly:16xf32>
+      return
+    }
+  }
+}
+
+}
@@ -1,5 +1,8 @@
 // RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline %s | FileCheck %s
 // RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-link-embedded=false %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-codegen-partitions=2 %s | FileCheck %s
+// RUN: rm -rf %t && iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t -iree-hal-executable-cache-revision=test %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-hal-executable-cache-path=%t -iree-hal-executable-cache-revision=test %s | FileCheck %s
 
 #map = affine_map<(d0) -> (d0)>
 
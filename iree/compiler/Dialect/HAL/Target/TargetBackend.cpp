@@ -35,6 +35,13 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc("Path to write individual hal.executable input "
                      "source listings into (- for stdout)."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-path", executableCachePath,
+      llvm::cl::desc("Directory used to cache translated and serialized "
+                     "executables across compiler invocations (disabled if "
+                     "empty)."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 // Renames |op| within |moduleOp| with a new name that is unique within both
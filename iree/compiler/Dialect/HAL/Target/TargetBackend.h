@@ -17,6 +17,7 @@
 #include "iree/compiler/Utils/OptionUtils.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/Pass/PassManager.h"
 
@@ -34,6 +35,10 @@ struct TargetOptions {
   // A path to write individual executable source listings into.
   std::string sourceListingPath;
 
+  // A directory used to cache executable translation and serialization
+  // results across compiler invocations. Disabled when empty.
+  std::string executableCachePath;
+
   // TODO(benvanik): flags for debug/optimization/etc.
   // The intent is that we can have a global debug/-ON flag that then each
   // target backend can have tickle it's own flags in the right way. Right now
@@ -211,6 +216,18 @@ class TargetBackend {
     return failure();
   }
 
+  // Appends any backend configuration that affects translation or
+  // serialization results but is not captured in the executable IR (such as
+  // options provided by flags, including those read by the passes of the
+  // translation pipeline) to |os|. Used to key the executable cache so that
+  // results are not reused across incompatible configurations. Returns
+  // failure if results must not be cached, such as when serialization has
+  // side effects beyond producing hal.executable.binary ops. Backends that do
+  // not override this are never cached.
+  virtual LogicalResult appendCacheKey(llvm::raw_ostream &os) const {
+    return failure();
+  }
+
  protected:
   // Links all executables for the current target found in |moduleOp| into
   // |linkedExecutableOp|. Functions will be cloned into |linkedModuleOp|.
@@ -137,7 +137,7 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // After this point the executables are opaque blobs and we cannot change
   // their interfaces.
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      createTranslateExecutablesPass());
+      createTranslateExecutablesPass(targetOptions.executableCachePath));
 
   //----------------------------------------------------------------------------
   // Host program conversion
@@ -216,7 +216,7 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // contents not turned into a big base64 string.
   if (transformOptions.serializeExecutables) {
     passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-        createSerializeExecutablesPass());
+        createSerializeExecutablesPass(targetOptions.executableCachePath));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run it
     // if we serialized things.
@@ -85,12 +85,14 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createDumpExecutableSourcesPass(
     StringRef path);
 
 // Translates hal.executable.variant ops via a nested translation pipeline.
+// Results are cached in |cachePath| across compiler invocations if provided.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass();
+createTranslateExecutablesPass(StringRef cachePath = "");
 
 // Translates hal.executable.variant ops for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
-createTranslateTargetExecutableVariantsPass(StringRef target);
+createTranslateTargetExecutableVariantsPass(StringRef target,
+                                            StringRef cachePath = "");
 
 // Calls into each target backend to have it link multiple hal.executables
 // together (if that makes sense). For example, the LLVM AOT backend may combine
@@ -107,12 +109,14 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createResolveEntryPointOrdinalsPass();
 
 // Converts hal.executable.variants to one or more hal.executable.binary ops.
+// Results are cached in |cachePath| across compiler invocations if provided.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeExecutablesPass();
+createSerializeExecutablesPass(StringRef cachePath = "");
 
 // Serializes executables for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeTargetExecutablesPass(StringRef target);
+createSerializeTargetExecutablesPass(StringRef target,
+                                     StringRef cachePath = "");
 
 //===----------------------------------------------------------------------===//
 // Resource initialization, caching, and optimization
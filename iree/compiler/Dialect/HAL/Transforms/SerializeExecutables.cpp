@@ -9,6 +9,7 @@
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Target/ExecutableCache.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "llvm/ADT/StringSet.h"
@@ -23,14 +24,31 @@ namespace iree_compiler {
 namespace IREE {
 namespace HAL {
 
+// Inserts the binaries stored in |cache| under |cacheKey| before |variantOp|.
+// Fails if there is no usable entry.
+static LogicalResult loadCachedBinaries(
+    const ExecutableCache &cache, StringRef cacheKey,
+    IREE::HAL::ExecutableVariantOp variantOp) {
+  auto cachedModuleOp = cache.lookup(cacheKey, variantOp.getLoc());
+  if (!cachedModuleOp) return failure();
+  auto cachedExecutableOp =
+      *cachedModuleOp->getOps<IREE::HAL::ExecutableOp>().begin();
+  auto binaryOps = llvm::to_vector<4>(
+      cachedExecutableOp.getBlock().getOps<IREE::HAL::ExecutableBinaryOp>());
+  if (binaryOps.empty()) return failure();
+  for (auto binaryOp : binaryOps) binaryOp->moveBefore(variantOp);
+  return success();
+}
+
 class SerializeTargetExecutablesPass
     : public PassWrapper<SerializeTargetExecutablesPass,
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   SerializeTargetExecutablesPass() = default;
   SerializeTargetExecutablesPass(const SerializeTargetExecutablesPass &pass) {}
-  SerializeTargetExecutablesPass(StringRef target) {
+  SerializeTargetExecutablesPass(StringRef target, StringRef cachePath) {
     this->target = target.str();
+    this->cachePath = cachePath.str();
   }
 
   StringRef getArgument() const override {
@@ -58,20 +76,44 @@ class SerializeTargetExecutablesPass
       return signalPassFailure();
     }
 
+    ExecutableCache cache(cachePath);
     auto variantOps = llvm::to_vector<4>(
         executableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>());
     for (auto variantOp : variantOps) {
       if (variantOp.target().getBackend().getValue() != target) continue;
+
+      // Reuse the binaries of a prior serialization of identical IR, if any.
+      std::string cacheKey;
+      if (cache.isEnabled()) {
+        cacheKey = cache.computeKey("serialize", variantOp, *targetBackend);
+        if (!cacheKey.empty() &&
+            succeeded(loadCachedBinaries(cache, cacheKey, variantOp))) {
+          variantOp.erase();
+          continue;
+        }
+      }
+
       OpBuilder executableBuilder(variantOp);
       // Ask the target backend to serialize the executable. Note that it
       // may create one or more hal.executable.binary ops in the case of
       // multi-architecture binaries.
+      Operation *prevOp = variantOp->getPrevNode();
       if (failed(targetBackend->serializeExecutable(variantOp,
                                                     executableBuilder))) {
         variantOp.emitError()
             << "failed to serialize executable for target backend " << target;
         return signalPassFailure();
       }
+
+      if (!cacheKey.empty()) {
+        SmallVector<Operation *> binaryOps;
+        for (Operation *op = prevOp ? prevOp->getNextNode()
+                                    : &executableOp.getBlock().front();
+             op != variantOp.getOperation(); op = op->getNextNode()) {
+          binaryOps.push_back(op);
+        }
+        cache.store(cacheKey, variantOp.getLoc(), binaryOps);
+      }
       variantOp.erase();
     }
   }
@@ -82,11 +124,15 @@ class SerializeTargetExecutablesPass
       llvm::cl::desc(
           "Target backend name whose executables will be serialized by "
           "this pass.")};
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Directory used to cache serialized binaries across "
+                     "compiler invocations (disabled if empty).")};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeTargetExecutablesPass(StringRef target) {
-  return std::make_unique<SerializeTargetExecutablesPass>(target);
+createSerializeTargetExecutablesPass(StringRef target, StringRef cachePath) {
+  return std::make_unique<SerializeTargetExecutablesPass>(target, cachePath);
 }
 
 static PassRegistration<SerializeTargetExecutablesPass> linkTargetPass([] {
@@ -98,6 +144,10 @@ class SerializeExecutablesPass
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   SerializeExecutablesPass() = default;
+  SerializeExecutablesPass(const SerializeExecutablesPass &pass) {}
+  SerializeExecutablesPass(StringRef cachePath) {
+    this->cachePath = cachePath.str();
+  }
 
   StringRef getArgument() const override {
     return "iree-hal-serialize-executables";
@@ -111,18 +161,25 @@ class SerializeExecutablesPass
     auto executableOp = getOperation();
     OpPassManager passManager(executableOp.getOperationName());
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
-      passManager.addPass(createSerializeTargetExecutablesPass(targetName));
+      passManager.addPass(
+          createSerializeTargetExecutablesPass(targetName, cachePath));
     }
     if (failed(runPipeline(passManager, executableOp))) {
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
   }
+
+ private:
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Directory used to cache serialized binaries across "
+                     "compiler invocations (disabled if empty).")};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeExecutablesPass() {
-  return std::make_unique<SerializeExecutablesPass>();
+createSerializeExecutablesPass(StringRef cachePath) {
+  return std::make_unique<SerializeExecutablesPass>(cachePath);
 }
 
 static PassRegistration<SerializeExecutablesPass> linkPass([] {
@@ -9,6 +9,7 @@
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Target/ExecutableCache.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "llvm/ADT/StringSet.h"
@@ -24,6 +25,24 @@ namespace iree_compiler {
 namespace IREE {
 namespace HAL {
 
+// Replaces the contents of |variantOp| with a previously translated variant
+// stored in |cache| under |cacheKey|. Fails if there is no usable entry.
+static LogicalResult loadCachedVariant(
+    const ExecutableCache &cache, StringRef cacheKey,
+    IREE::HAL::ExecutableVariantOp variantOp) {
+  auto cachedModuleOp = cache.lookup(cacheKey, variantOp.getLoc());
+  if (!cachedModuleOp) return failure();
+  auto cachedExecutableOp =
+      *cachedModuleOp->getOps<IREE::HAL::ExecutableOp>().begin();
+  auto cachedVariantOps =
+      cachedExecutableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>();
+  if (cachedVariantOps.empty()) return failure();
+  auto cachedVariantOp = *cachedVariantOps.begin();
+  variantOp->setAttrs(cachedVariantOp->getAttrDictionary());
+  variantOp.body().takeBody(cachedVariantOp.body());
+  return success();
+}
+
 class TranslateTargetExecutableVariantsPass
     : public PassWrapper<TranslateTargetExecutableVariantsPass,
                          OperationPass<IREE::HAL::ExecutableVariantOp>> {
@@ -31,8 +50,10 @@ class TranslateTargetExecutableVariantsPass
   TranslateTargetExecutableVariantsPass() = default;
   TranslateTargetExecutableVariantsPass(
       const TranslateTargetExecutableVariantsPass &pass) {}
-  TranslateTargetExecutableVariantsPass(StringRef target) {
+  TranslateTargetExecutableVariantsPass(StringRef target,
+                                        StringRef cachePath) {
     this->target = target.str();
+    this->cachePath = cachePath.str();
   }
 
   StringRef getArgument() const override {
@@ -62,6 +83,17 @@ class TranslateTargetExecutableVariantsPass
       return signalPassFailure();
     }
 
+    // Reuse the results of a prior translation of identical IR, if any.
+    ExecutableCache cache(cachePath);
+    std::string cacheKey;
+    if (cache.isEnabled()) {
+      cacheKey = cache.computeKey("translate", variantOp, *targetBackend);
+      if (!cacheKey.empty() &&
+          succeeded(loadCachedVariant(cache, cacheKey, variantOp))) {
+        return;
+      }
+    }
+
     OpPassManager passManager(variantOp.getOperationName());
     targetBackend->buildTranslationPassPipeline(passManager);
     if (failed(runPipeline(passManager, variantOp))) {
@@ -70,6 +102,10 @@ class TranslateTargetExecutableVariantsPass
                             << variantOp.target();
       return signalPassFailure();
     }
+
+    if (!cacheKey.empty()) {
+      cache.store(cacheKey, variantOp.getLoc(), {variantOp.getOperation()});
+    }
   }
 
  private:
@@ -78,11 +114,17 @@ class TranslateTargetExecutableVariantsPass
       llvm::cl::desc(
           "Target backend name whose executables will be translated by "
           "this pass.")};
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Directory used to cache translation results across "
+                     "compiler invocations (disabled if empty).")};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
-createTranslateTargetExecutableVariantsPass(StringRef target) {
-  return std::make_unique<TranslateTargetExecutableVariantsPass>(target);
+createTranslateTargetExecutableVariantsPass(StringRef target,
+                                            StringRef cachePath) {
+  return std::make_unique<TranslateTargetExecutableVariantsPass>(target,
+                                                                 cachePath);
 }
 
 static PassRegistration<TranslateTargetExecutableVariantsPass> linkTargetPass(
@@ -93,6 +135,10 @@ class TranslateExecutablesPass
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   TranslateExecutablesPass() = default;
+  TranslateExecutablesPass(const TranslateExecutablesPass &pass) {}
+  TranslateExecutablesPass(StringRef cachePath) {
+    this->cachePath = cachePath.str();
+  }
 
   StringRef getArgument() const override {
     return "iree-hal-translate-executables";
@@ -116,18 +162,24 @@ class TranslateExecutablesPass
     OpPassManager passManager(executableOp.getOperationName());
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
-          createTranslateTargetExecutableVariantsPass(targetName));
+          createTranslateTargetExecutableVariantsPass(targetName, cachePath));
     }
     if (failed(runPipeline(passManager, executableOp))) {
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
   }
+
+ private:
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Directory used to cache translation results across "
+                     "compiler invocations (disabled if empty).")};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass() {
-  return std::make_unique<TranslateExecutablesPass>();
+createTranslateExecutablesPass(StringRef cachePath) {
+  return std::make_unique<TranslateExecutablesPass>(cachePath);
 }
 
 static PassRegistration<TranslateExecutablesPass> translatePass([] {
@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXTypes.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
@@ -60,6 +61,26 @@ struct RemoveIdentityConversionCast final
   }
 };
 
+/// Lowers memref.atomic_rmw to a load, the combining operation and a store.
+/// VMVX has no atomics; dispatches that update memory with them are configured
+/// to run those updates in a single workgroup instead.
+struct ConvertAtomicRMWOp final
+    : public OpConversionPattern<memref::AtomicRMWOp> {
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult matchAndRewrite(
+      memref::AtomicRMWOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    Value current =
+        rewriter.create<memref::LoadOp>(loc, op.memref(), op.indices());
+    Value result = arith::getReductionOp(op.kind(), rewriter, loc, op.value(),
+                                         current);
+    rewriter.create<memref::StoreOp>(loc, result, op.memref(), op.indices());
+    rewriter.replaceOp(op, current);
+    return success();
+  }
+};
+
 }  // namespace
 
 void populateStandardToVMVXPatterns(MLIRContext *context,
@@ -68,6 +89,7 @@ void populateStandardToVMVXPatterns(MLIRContext *context,
   // We type/shape erase memrefs as we lower so there is no need for reshapes.
   patterns.insert<FoldAsNoOp<memref::CollapseShapeOp>>(typeConverter, context);
   patterns.insert<FoldAsNoOp<memref::ExpandShapeOp>>(typeConverter, context);
+  patterns.insert<ConvertAtomicRMWOp>(typeConverter, context);
 
   patterns.insert<RemoveIdentityConversionCast>(typeConverter, context);
 }
@@ -2134,10 +2134,21 @@ class ImportOpConversion : public OpConversionPattern<IREE::VM::ImportOp> {
                << "Failed to build size expressions for call struct";
       }
 
+      // Primitive arguments and results are fully written by the argument
+      // packing and the callee respectively, so the buffers only need to be
+      // cleared when they contain refs that are assigned into.
+      auto isRefType = [](Type type) {
+        return type.isa<IREE::VM::RefType>();
+      };
+      bool zeroArguments = llvm::any_of(
+          flattenInputTypes(functionType.getInputs(), numSpans, rewriter),
+          isRefType);
+      bool zeroResults = llvm::any_of(functionType.getResults(), isRefType);
+
       auto importArg = newFuncOp.getArgument(1);
-      auto call =
-          buildIreeVmFunctionCallStruct(importArg, argumentSize.getValue(),
-                                        resultSize.getValue(), rewriter, loc);
+      auto call = buildIreeVmFunctionCallStruct(
+          importArg, argumentSize.getValue(), resultSize.getValue(),
+          zeroArguments, zeroResults, rewriter, loc);
 
       if (failed(call)) {
         return importOp.emitError() << "failed to create call struct";
@@ -2267,8 +2278,9 @@ class ImportOpConversion : public OpConversionPattern<IREE::VM::ImportOp> {
   }
 
   FailureOr<Value> buildIreeVmFunctionCallStruct(
-      Value import, Value argumentSize, Value resultSize,
-      ConversionPatternRewriter &rewriter, Location loc) const {
+      Value import, Value argumentSize, Value resultSize, bool zeroArguments,
+      bool zeroResults, ConversionPatternRewriter &rewriter,
+      Location loc) const {
     auto ctx = rewriter.getContext();
 
     // iree_vm_function_call_t call;
@@ -2303,13 +2315,15 @@ class ImportOpConversion : public OpConversionPattern<IREE::VM::ImportOp> {
         /*templateArgs=*/ArrayAttr{},
         /*operands=*/ArrayRef<Value>{call, importValue});
 
-    allocateByteSpan(call, argumentSize, "arguments", rewriter, loc);
-    allocateByteSpan(call, resultSize, "results", rewriter, loc);
+    allocateByteSpan(call, argumentSize, "arguments", zeroArguments, rewriter,
+                     loc);
+    allocateByteSpan(call, resultSize, "results", zeroResults, rewriter, loc);
 
     return {call};
   }
 
   Value allocateByteSpan(Value call, Value size, StringRef memberName,
+                         bool zeroInitialize,
                          ConversionPatternRewriter &rewriter,
                          Location loc) const {
     auto ctx = rewriter.getContext();
@@ -2381,17 +2395,19 @@ class ImportOpConversion : public OpConversionPattern<IREE::VM::ImportOp> {
         /*templateArgs=*/ArrayAttr{},
         /*operands=*/ArrayRef<Value>{byteSpan, byteSpanData});
 
-    // memset(byteSpanData, 0, SIZE);
-    rewriter.create<emitc::CallOp>(
-        /*location=*/loc,
-        /*type=*/TypeRange{},
-        /*callee=*/StringAttr::get(ctx, "memset"),
-        /*args=*/
-        ArrayAttr::get(ctx,
-                       {rewriter.getIndexAttr(0), rewriter.getI32IntegerAttr(0),
-                        rewriter.getIndexAttr(1)}),
-        /*templateArgs=*/ArrayAttr{},
-        /*operands=*/ArrayRef<Value>{byteSpanData, size});
+    if (zeroInitialize) {
+      // memset(byteSpanData, 0, SIZE);
+      rewriter.create<emitc::CallOp>(
+          /*location=*/loc,
+          /*type=*/TypeRange{},
+          /*callee=*/StringAttr::get(ctx, "memset"),
+          /*args=*/
+          ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
+                               rewriter.getI32IntegerAttr(0),
+                               rewriter.getIndexAttr(1)}),
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/ArrayRef<Value>{byteSpanData, size});
+    }
 
     return byteSpan;
   }
@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 
@@ -20,15 +21,15 @@ namespace VM {
 
 namespace {
 
-// v0 bytecode spec. This is in extreme flux and not guaranteed to be a stable
+// v1 bytecode spec. This is in extreme flux and not guaranteed to be a stable
 // representation. Always generate this from source in tooling and never check
 // in any emitted files!
-class V0BytecodeEncoder : public BytecodeEncoder {
+class V1BytecodeEncoder : public BytecodeEncoder {
  public:
-  V0BytecodeEncoder(llvm::DenseMap<Type, int> *typeTable,
+  V1BytecodeEncoder(llvm::DenseMap<Type, int> *typeTable,
                     RegisterAllocation *registerAllocation)
       : typeTable_(typeTable), registerAllocation_(registerAllocation) {}
-  ~V0BytecodeEncoder() = default;
+  ~V1BytecodeEncoder() = default;
 
   LogicalResult beginBlock(Block *block) override {
     blockOffsets_[block] = bytecode_.size();
@@ -187,19 +188,50 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     // this list is small :)
     auto srcDstRegs = registerAllocation_->remapSuccessorRegisters(
         currentOp_, successorIndex);
-    if (failed(ensureAlignment(2)) || failed(writeUint16(srcDstRegs.size()))) {
-      return failure();
-    }
+
+    // Primitive and ref remappings are emitted as two lists so that the
+    // runtime need not check the register type of each pair. The register
+    // banks are disjoint so splitting preserves the hazard-free ordering.
+    SmallVector<std::pair<Register, Register>, 8> i32SrcDstRegs;
+    SmallVector<std::pair<Register, Register>, 8> refSrcDstRegs;
     for (auto srcDstReg : srcDstRegs) {
-      if (failed(writeUint16(srcDstReg.first.encode())) ||
-          failed(writeUint16(srcDstReg.second.encode()))) {
-        return failure();
+      if (srcDstReg.first.isRef()) {
+        refSrcDstRegs.push_back(srcDstReg);
+      } else {
+        i32SrcDstRegs.push_back(srcDstReg);
       }
     }
+    if (failed(ensureAlignment(2)) || failed(writeRemapList(i32SrcDstRegs)) ||
+        failed(writeRemapList(refSrcDstRegs))) {
+      return failure();
+    }
 
     return success();
   }
 
+  // Encodes a compare op immediately followed by a vm.cond_br on its result as
+  // a single fused superinstruction with |opcode|.
+  LogicalResult encodeCmpCondBranch(Operation *cmpOp, CondBranchOp condBranchOp,
+                                    Opcode opcode) {
+    if (failed(beginOp(cmpOp)) ||
+        failed(encodeOpcode(stringifyOpcode(opcode),
+                            static_cast<int>(opcode))) ||
+        failed(encodeOperand(cmpOp->getOperand(0), 0)) ||
+        failed(encodeOperand(cmpOp->getOperand(1), 1)) ||
+        failed(encodeResult(cmpOp->getResult(0))) || failed(endOp(cmpOp))) {
+      return failure();
+    }
+    if (failed(beginOp(condBranchOp)) ||
+        failed(encodeBranch(condBranchOp.getTrueDest(),
+                            condBranchOp.getTrueOperands(), 0)) ||
+        failed(encodeBranch(condBranchOp.getFalseDest(),
+                            condBranchOp.getFalseOperands(), 1)) ||
+        failed(endOp(condBranchOp))) {
+      return failure();
+    }
+    return success();
+  }
+
   LogicalResult encodeOperand(Value value, int ordinal) override {
     uint16_t reg =
         registerAllocation_->mapUseToRegister(value, currentOp_, ordinal)
@@ -300,6 +332,18 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return writeBytes(&value, sizeof(value));
   }
 
+  LogicalResult writeRemapList(
+      ArrayRef<std::pair<Register, Register>> srcDstRegs) {
+    if (failed(writeUint16(srcDstRegs.size()))) return failure();
+    for (auto srcDstReg : srcDstRegs) {
+      if (failed(writeUint16(srcDstReg.first.encode())) ||
+          failed(writeUint16(srcDstReg.second.encode()))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
   LogicalResult fixupOffsets() {
     for (const auto &fixup : blockOffsetFixups_) {
       auto blockOffset = blockOffsets_.find(fixup.first);
@@ -324,6 +368,31 @@ class V0BytecodeEncoder : public BytecodeEncoder {
   std::vector<std::pair<Block *, size_t>> blockOffsetFixups_;
 };
 
+// Returns the superinstruction opcode fusing |op| with a vm.cond_br that
+// consumes its result, if one exists.
+static Optional<Opcode> getCmpCondBranchOpcode(Operation *op) {
+  return TypeSwitch<Operation *, Optional<Opcode>>(op)
+      .Case([](CmpEQI32Op) { return Opcode::CmpEQI32CondBranch; })
+      .Case([](CmpNEI32Op) { return Opcode::CmpNEI32CondBranch; })
+      .Case([](CmpLTI32SOp) { return Opcode::CmpLTI32SCondBranch; })
+      .Case([](CmpLTI32UOp) { return Opcode::CmpLTI32UCondBranch; })
+      .Default([](Operation *) { return llvm::None; });
+}
+
+// Returns the vm.cond_br that |op| can be fused with, if any.
+// Fusion is only possible when the branch immediately follows |op| and branches
+// on its result. The result is still written by the superinstruction so other
+// uses need not be considered.
+static CondBranchOp getFusableCondBranch(Operation *op) {
+  auto *nextOp = op->getNextNode();
+  auto condBranchOp = dyn_cast_or_null<CondBranchOp>(nextOp);
+  if (!condBranchOp || op->getNumResults() != 1 ||
+      condBranchOp.getCondition() != op->getResult(0)) {
+    return {};
+  }
+  return condBranchOp;
+}
+
 }  // namespace
 
 // static
@@ -342,14 +411,32 @@ Optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
 
   FunctionSourceMap sourceMap;
 
-  V0BytecodeEncoder encoder(&typeTable, &registerAllocation);
+  V1BytecodeEncoder encoder(&typeTable, &registerAllocation);
   for (auto &block : funcOp.getBlocks()) {
     if (failed(encoder.beginBlock(&block))) {
       funcOp.emitError() << "failed to begin block";
       return llvm::None;
     }
 
-    for (auto &op : block.getOperations()) {
+    for (auto opIt = block.begin(); opIt != block.end(); ++opIt) {
+      auto &op = *opIt;
+
+      // Superinstructions: fuse common op sequences into a single dispatch.
+      auto fusedOpcode = getCmpCondBranchOpcode(&op);
+      if (fusedOpcode.hasValue()) {
+        if (auto condBranchOp = getFusableCondBranch(&op)) {
+          sourceMap.locations.push_back(
+              {static_cast<int32_t>(encoder.getOffset()), op.getLoc()});
+          if (failed(encoder.encodeCmpCondBranch(&op, condBranchOp,
+                                                 fusedOpcode.getValue()))) {
+            op.emitOpError() << "failed to encode fused with cond_br";
+            return llvm::None;
+          }
+          ++opIt;
+          continue;
+        }
+      }
+
       auto serializableOp = dyn_cast<IREE::VM::VMSerializableOp>(op);
       if (!serializableOp) {
         op.emitOpError() << "is not serializable";
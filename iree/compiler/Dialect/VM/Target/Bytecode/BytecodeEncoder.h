@@ -31,6 +31,10 @@ struct EncodedBytecodeFunction {
 // Abstract encoder used for function bytecode encoding.
 class BytecodeEncoder : public VMFuncEncoder {
  public:
+  // Version of the bytecode encoding produced by encodeFunction.
+  // Must match IREE_VM_BYTECODE_VERSION in the runtime.
+  static constexpr uint32_t kVersion = 1;
+
   // Encodes a vm.func to bytecode and returns the result.
   // Returns None on failure.
   static Optional<EncodedBytecodeFunction> encodeFunction(
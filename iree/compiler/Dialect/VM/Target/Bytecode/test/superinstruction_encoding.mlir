@@ -0,0 +1,24 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text %s | FileCheck %s
+
+// CHECK: "name": "superinstructions"
+vm.module @superinstructions {
+  vm.export @cmp_lt_cond_br
+  vm.func @cmp_lt_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    %cmp = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+
+  // Fused vm.cmp.lt.i32.s + vm.cond_br (0x58) with its lhs and rhs registers.
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   88,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+
+  // CHECK: "bytecode_version": 1
+}
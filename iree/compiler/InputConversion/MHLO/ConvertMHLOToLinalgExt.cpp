@@ -190,6 +190,151 @@ struct SortOpConversion : public OpConversionPattern<mhlo::SortOp> {
   }
 };
 
+//===----------------------------------------------------------------------===//
+// TopkOp
+//===----------------------------------------------------------------------===//
+
+/// Converts an mhlo.sort whose results are only read through slices of their
+/// first K elements along the sort dimension into an iree_linalg_ext.topk.
+/// This is how top-k reaches us from frontends, and selecting K elements is
+/// far cheaper than sorting all N of them.
+///
+/// The sort may carry a second i32 operand, which becomes the topk indices
+/// input. The comparator must be a single strict mhlo.compare of the first
+/// pair of arguments, which maps directly onto the topk region.
+///
+/// The topk outputs are seeded with the first K elements of every line, sorted,
+/// and the topk merges the remaining elements into them. A topk into outputs
+/// filled with a sentinel would instead never insert inputs that compare equal
+/// to the sentinel (or unordered with it, like NaNs) and return the sentinel
+/// with a bogus index in their place.
+struct TopkOpConversion : public OpConversionPattern<mhlo::SortOp> {
+  using OpConversionPattern<mhlo::SortOp>::OpConversionPattern;
+
+  /// Returns the direction of the comparator if it is a single GT or LT
+  /// compare of the first value pair.
+  static Optional<mhlo::ComparisonDirection> getStrictComparisonDirection(
+      mhlo::SortOp op) {
+    Block &block = op.comparator().front();
+    if (!llvm::hasSingleElement(block.without_terminator())) return llvm::None;
+    auto compareOp = dyn_cast<mhlo::CompareOp>(&block.front());
+    Operation *terminator = block.getTerminator();
+    if (!compareOp || compareOp.lhs() != block.getArgument(0) ||
+        compareOp.rhs() != block.getArgument(1) ||
+        terminator->getNumOperands() != 1 ||
+        terminator->getOperand(0) != compareOp.getResult()) {
+      return llvm::None;
+    }
+    // Total order comparisons of floats don't map onto arith.cmpf.
+    if (compareOp.compare_type() &&
+        *compareOp.compare_type() == mhlo::ComparisonType::TOTALORDER) {
+      return llvm::None;
+    }
+    auto direction = compareOp.comparison_direction();
+    if (direction != mhlo::ComparisonDirection::GT &&
+        direction != mhlo::ComparisonDirection::LT) {
+      return llvm::None;
+    }
+    return direction;
+  }
+
+  /// Returns true if `lhs` orders strictly before `rhs` under `direction`.
+  static Value buildCompare(OpBuilder &b, Location loc, Value lhs, Value rhs,
+                            Type originalElementType,
+                            mhlo::ComparisonDirection direction) {
+    bool greater = direction == mhlo::ComparisonDirection::GT;
+    if (originalElementType.isa<FloatType>()) {
+      return b.create<arith::CmpFOp>(
+          loc, greater ? arith::CmpFPredicate::OGT : arith::CmpFPredicate::OLT,
+          lhs, rhs);
+    }
+    arith::CmpIPredicate predicate;
+    if (originalElementType.isUnsignedInteger()) {
+      predicate =
+          greater ? arith::CmpIPredicate::ugt : arith::CmpIPredicate::ult;
+    } else {
+      predicate =
+          greater ? arith::CmpIPredicate::sgt : arith::CmpIPredicate::slt;
+    }
+    return b.create<arith::CmpIOp>(loc, predicate, lhs, rhs);
+  }
+
+  LogicalResult matchAndRewrite(
+      mhlo::SortOp mhloSortOp, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const final {
+    Location loc = mhloSortOp.getLoc();
+    int64_t numOperands = mhloSortOp.getNumOperands();
+    if (numOperands != 1 && numOperands != 2) return failure();
+    auto valuesType =
+        mhloSortOp.getOperand(0).getType().dyn_cast<RankedTensorType>();
+    if (!valuesType || !valuesType.hasStaticShape()) return failure();
+    Type originalElementType = valuesType.getElementType();
+    if (!originalElementType.isa<FloatType, IntegerType>()) return failure();
+    if (numOperands == 2 &&
+        !getElementTypeOrSelf(mhloSortOp.getOperand(1).getType())
+             .isSignlessInteger(32)) {
+      return failure();
+    }
+
+    auto direction = getStrictComparisonDirection(mhloSortOp);
+    if (!direction) return failure();
+
+    // Every use must read the same leading K elements along the dimension.
+    int64_t dimension = mhloSortOp.dimension();
+    ArrayRef<int64_t> shape = valuesType.getShape();
+    Optional<int64_t> k;
+    SmallVector<std::pair<mhlo::SliceOp, unsigned>> slices;
+    for (OpResult result : mhloSortOp->getResults()) {
+      for (Operation *user : result.getUsers()) {
+        auto sliceOp = dyn_cast<mhlo::SliceOp>(user);
+        if (!sliceOp) return failure();
+        auto starts = extract1DVector(sliceOp.start_indices());
+        auto limits = extract1DVector(sliceOp.limit_indices());
+        auto strides = extract1DVector(sliceOp.strides());
+        for (int64_t dim = 0, e = shape.size(); dim < e; ++dim) {
+          if (starts[dim] != 0 || strides[dim] != 1) return failure();
+          if (dim != dimension && limits[dim] != shape[dim]) return failure();
+        }
+        if (k && *k != limits[dimension]) return failure();
+        k = limits[dimension];
+        slices.emplace_back(sliceOp, result.getResultNumber());
+      }
+    }
+    if (!k || *k <= 0 || *k >= shape[dimension]) return failure();
+
+    auto compare = [&](OpBuilder &b, Location loc, Value lhs, Value rhs) {
+      return buildCompare(b, loc, lhs, rhs, originalElementType, *direction);
+    };
+    Optional<Value> indices;
+    if (numOperands == 2) indices = adaptor.getOperands()[1];
+    SmallVector<Value> inputs, outputs;
+    IREE::LinalgExt::buildSeededTopkOperands(rewriter, loc,
+                                             adaptor.getOperands()[0], indices,
+                                             dimension, *k, compare, inputs,
+                                             outputs);
+
+    auto topkOp = rewriter.create<IREE::LinalgExt::TopkOp>(
+        loc, TypeRange(ValueRange(outputs)), inputs, outputs,
+        mhloSortOp.dimensionAttr());
+    {
+      OpBuilder::InsertionGuard guard(rewriter);
+      Type valueElementType = getElementTypeOrSelf(inputs[0].getType());
+      Block *block = rewriter.createBlock(&topkOp.region(), {},
+                                          {valueElementType, valueElementType},
+                                          {loc, loc});
+      rewriter.create<IREE::LinalgExt::YieldOp>(
+          loc, compare(rewriter, loc, block->getArgument(0),
+                       block->getArgument(1)));
+    }
+
+    for (auto &slice : slices) {
+      rewriter.replaceOp(slice.first, topkOp->getResult(slice.second));
+    }
+    rewriter.eraseOp(mhloSortOp);
+    return success();
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // ScatterOp
 //===----------------------------------------------------------------------===//
@@ -499,6 +644,8 @@ struct ConvertMHLOToLinalgExtPass
     MhloToStdTypeConverter typeConverter;
     patterns.insert<SortOpConversion, ScatterOpConversion, FftOpConversion,
                     ReverseOpConversion>(typeConverter, context);
+    // Prefer topk over a full sort when only a prefix of the result is read.
+    patterns.insert<TopkOpConversion>(typeConverter, context, /*benefit=*/2);
     // FIXME: It shouldn't be necessary to list every matching MHLO op here,
     // especially since they're already listed in
     // populateHLOToLinalgConversionPattern and in HloOpToStdScalarOp. These
@@ -542,3 +542,88 @@ func.func @reverse_multi_dim(%arg0: tensor<?x?xi32>) -> tensor<?x?xi32> {
 // CHECK-SAME:     ins(%[[IN]] : tensor<?x?xi32>)
 // CHECK-SAME:     outs(%[[INIT]] : tensor<?x?xi32>) : tensor<?x?xi32>
 // CHECK:        return %[[REV]]
+
+// -----
+
+func.func @topk_sort_slice(%arg0: tensor<2x16xf32>, %arg1: tensor<2x16xi32>) -> (tensor<2x4xf32>, tensor<2x4xi32>) {
+  %0:2 = "mhlo.sort"(%arg0, %arg1) ({
+  ^bb0(%arg2: tensor<f32>, %arg3: tensor<f32>, %arg4: tensor<i32>, %arg5: tensor<i32>):
+    %1 = "mhlo.compare"(%arg2, %arg3) {comparison_direction = #mhlo<"comparison_direction GT">} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%1) : (tensor<i1>) -> ()
+  }) {dimension = 1 : i64, is_stable = true} : (tensor<2x16xf32>, tensor<2x16xi32>) -> (tensor<2x16xf32>, tensor<2x16xi32>)
+  %2 = "mhlo.slice"(%0#0) {start_indices = dense<0> : tensor<2xi64>, limit_indices = dense<[2, 4]> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<2x16xf32>) -> tensor<2x4xf32>
+  %3 = "mhlo.slice"(%0#1) {start_indices = dense<0> : tensor<2xi64>, limit_indices = dense<[2, 4]> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<2x16xi32>) -> tensor<2x4xi32>
+  return %2, %3 : tensor<2x4xf32>, tensor<2x4xi32>
+}
+// CHECK-LABEL: func @topk_sort_slice(
+// CHECK-SAME:      %[[VALUES:[a-zA-Z0-9]+]]
+// CHECK-SAME:      %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK:         %[[POSITIONS:.+]] = linalg.generic
+// CHECK-SAME:      outs(%{{.+}} : tensor<2x16xi32>)
+// CHECK:           linalg.index 1 : index
+// CHECK-DAG:     %[[SEED_V:.+]] = tensor.extract_slice %[[VALUES]][0, 0] [2, 4] [1, 1]
+// CHECK-DAG:     %[[SEED_P:.+]] = tensor.extract_slice %[[POSITIONS]][0, 0] [2, 4] [1, 1]
+// CHECK-DAG:     %[[SEED_I:.+]] = tensor.extract_slice %[[INDICES]][0, 0] [2, 4] [1, 1]
+// CHECK:         %[[SEEDS:.+]]:3 = iree_linalg_ext.sort
+// CHECK-SAME:      dimension(1)
+// CHECK-SAME:      outs(%[[SEED_V]], %[[SEED_P]], %[[SEED_I]] : tensor<2x4xf32>, tensor<2x4xi32>, tensor<2x4xi32>)
+// CHECK:           ^bb0(%[[LHS:.+]]: f32, %[[RHS:.+]]: f32, %[[LHS_P:.+]]: i32, %[[RHS_P:.+]]: i32, %{{.+}}: i32, %{{.+}}: i32)
+// CHECK-DAG:         %[[BEFORE:.+]] = arith.cmpf ogt, %[[LHS]], %[[RHS]]
+// CHECK-DAG:         %[[AFTER:.+]] = arith.cmpf ogt, %[[RHS]], %[[LHS]]
+// CHECK-DAG:         %[[EARLIER:.+]] = arith.cmpi slt, %[[LHS_P]], %[[RHS_P]]
+// CHECK-DAG:         %[[TIE:.+]] = arith.select %[[AFTER]], %{{.+}}, %[[EARLIER]]
+// CHECK:             %[[ORDERED:.+]] = arith.ori %[[BEFORE]], %[[TIE]]
+// CHECK:             iree_linalg_ext.yield %[[ORDERED]]
+// CHECK-DAG:     %[[REST_V:.+]] = tensor.extract_slice %[[VALUES]][0, 4] [2, 12] [1, 1]
+// CHECK-DAG:     %[[REST_I:.+]] = tensor.extract_slice %[[INDICES]][0, 4] [2, 12] [1, 1]
+// CHECK:         %[[TOPK:.+]]:2 = iree_linalg_ext.topk
+// CHECK-SAME:      dimension(1)
+// CHECK-SAME:      ins(%[[REST_V]], %[[REST_I]] : tensor<2x12xf32>, tensor<2x12xi32>)
+// CHECK-SAME:      outs(%[[SEEDS]]#0, %[[SEEDS]]#2 : tensor<2x4xf32>, tensor<2x4xi32>)
+// CHECK:           ^bb0(%[[ARG2:.+]]: f32, %[[ARG3:.+]]: f32)
+// CHECK:             %[[CMP:.+]] = arith.cmpf ogt, %[[ARG2]], %[[ARG3]]
+// CHECK:             iree_linalg_ext.yield %[[CMP]]
+// CHECK:         return %[[TOPK]]#0, %[[TOPK]]#1
+
+// -----
+
+func.func @topk_sort_slice_positions(%arg0: tensor<16xui32>) -> tensor<4xui32> {
+  %0 = "mhlo.sort"(%arg0) ({
+  ^bb0(%arg1: tensor<ui32>, %arg2: tensor<ui32>):
+    %1 = "mhlo.compare"(%arg1, %arg2) {comparison_direction = #mhlo<"comparison_direction LT">} : (tensor<ui32>, tensor<ui32>) -> tensor<i1>
+    "mhlo.return"(%1) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = true} : (tensor<16xui32>) -> tensor<16xui32>
+  %2 = "mhlo.slice"(%0) {start_indices = dense<0> : tensor<1xi64>, limit_indices = dense<4> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<16xui32>) -> tensor<4xui32>
+  return %2 : tensor<4xui32>
+}
+// Without an indices operand the positions along the dimension are seeded.
+// CHECK-LABEL: func @topk_sort_slice_positions(
+// CHECK-SAME:      %[[VALUES:[a-zA-Z0-9]+]]
+// CHECK:         %[[POSITIONS:.+]] = linalg.generic
+// CHECK-SAME:      outs(%{{.+}} : tensor<16xi32>)
+// CHECK:           %[[POS:.+]] = linalg.index 0 : index
+// CHECK:           %[[POS_I32:.+]] = arith.index_cast %[[POS]] : index to i32
+// CHECK:           linalg.yield %[[POS_I32]]
+// CHECK:         %[[SEEDS:.+]]:2 = iree_linalg_ext.sort
+// CHECK:             arith.cmpi ult
+// CHECK:         %[[TOPK:.+]]:2 = iree_linalg_ext.topk
+// CHECK-SAME:      ins(%{{.+}}, %{{.+}} : tensor<12xi32>, tensor<12xi32>)
+// CHECK-SAME:      outs(%[[SEEDS]]#0, %[[SEEDS]]#1 : tensor<4xi32>, tensor<4xi32>)
+// CHECK:             arith.cmpi ult
+// CHECK:         return %{{.+}}
+
+// -----
+
+func.func @topk_sort_full_read(%arg0: tensor<16xi32>) -> (tensor<16xi32>, tensor<4xi32>) {
+  %0 = "mhlo.sort"(%arg0) ({
+  ^bb0(%arg1: tensor<i32>, %arg2: tensor<i32>):
+    %1 = "mhlo.compare"(%arg1, %arg2) {comparison_direction = #mhlo<"comparison_direction LT">} : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    "mhlo.return"(%1) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = false} : (tensor<16xi32>) -> tensor<16xi32>
+  %2 = "mhlo.slice"(%0) {start_indices = dense<0> : tensor<1xi64>, limit_indices = dense<4> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<16xi32>) -> tensor<4xi32>
+  return %0, %2 : tensor<16xi32>, tensor<4xi32>
+}
+// The full sorted result is also read, so a sort is still needed.
+// CHECK-LABEL: func @topk_sort_full_read(
+// CHECK-NOT:     iree_linalg_ext.topk
+// CHECK:         iree_linalg_ext.sort
@@ -0,0 +1,35 @@
+// RUN: iree-compile -iree-hal-target-backends=vmvx -iree-mlir-to-vm-bytecode-module -print-ir-after=iree-flow-outline-dispatch-regions %s -o=/dev/null 2>&1 | FileCheck %s
+// RUN: iree-compile -iree-hal-target-backends=vmvx -iree-mlir-to-vm-bytecode-module -iree-opt-const-expr-hoisting=false -print-ir-after=iree-flow-outline-dispatch-regions %s -o=/dev/null 2>&1 | FileCheck %s --check-prefix=NO-HOISTING
+
+// The sibling matmuls are fused and their concatenated RHS is evaluated into
+// a global at compile time rather than built on every call.
+
+func.func @qkv_projection(%arg0: tensor<128x64xf32>) -> (tensor<128x32xf32>, tensor<128x32xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %wq = arith.constant dense<1.0> : tensor<64x32xf32>
+  %wk = arith.constant dense<2.0> : tensor<64x32xf32>
+  %init = linalg.init_tensor [128, 32] : tensor<128x32xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %q = linalg.matmul ins(%arg0, %wq : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<128x32xf32>) -> tensor<128x32xf32>
+  %k = linalg.matmul ins(%arg0, %wk : tensor<128x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<128x32xf32>) -> tensor<128x32xf32>
+  return %q, %k : tensor<128x32xf32>, tensor<128x32xf32>
+}
+//      CHECK: util.global private @[[RHS:[a-zA-Z0-9_]+]] {{.*}}= dense<{{.+}}> : tensor<64x64xf32>
+//      CHECK: func.func @qkv_projection(
+//  CHECK-NOT:   tensor.insert_slice
+//      CHECK:   %[[RHS_VALUE:.+]] = util.global.load @[[RHS]] : tensor<64x64xf32>
+//  CHECK-NOT:   tensor.insert_slice
+//      CHECK:   flow.dispatch @{{.+}}(%{{.+}}, %[[RHS_VALUE]])
+//  CHECK-NOT:   flow.dispatch
+//      CHECK:   return
+
+// Without hoisting the siblings are left alone.
+// NO-HOISTING-LABEL: func.func @qkv_projection(
+//   NO-HOISTING-NOT:   tensor.insert_slice
+//       NO-HOISTING:   flow.dispatch
+//   NO-HOISTING-NOT:   tensor.insert_slice
+//       NO-HOISTING:   flow.dispatch
+//   NO-HOISTING-NOT:   tensor.insert_slice
+//       NO-HOISTING:   return
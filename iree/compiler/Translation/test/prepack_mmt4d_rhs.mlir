@@ -0,0 +1,24 @@
+// RUN: iree-compile -iree-hal-target-backends=vmvx -iree-mlir-to-vm-bytecode-module -iree-flow-mmt4d-target-options="arch=aarch64" -print-ir-after=iree-flow-outline-dispatch-regions %s -o=/dev/null 2>&1 | FileCheck %s
+
+// An RHS loaded from an immutable global is packed into the mmt4d layout by
+// ops that are hoisted into an initializer and evaluated at compile time, so
+// the program only loads the pre-packed weights.
+
+util.global private @rhs = dense<[[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]> : tensor<2x3xf32>
+
+func.func @matmul_global_rhs(%arg0: tensor<4x2xf32>) -> tensor<4x3xf32> {
+  %zero = arith.constant 0.0 : f32
+  %rhs = util.global.load @rhs : tensor<2x3xf32>
+  %init = linalg.init_tensor [4, 3] : tensor<4x3xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<4x3xf32>) -> tensor<4x3xf32>
+  %0 = linalg.matmul ins(%arg0, %rhs : tensor<4x2xf32>, tensor<2x3xf32>)
+      outs(%fill : tensor<4x3xf32>) -> tensor<4x3xf32>
+  return %0 : tensor<4x3xf32>
+}
+//      CHECK: util.global private @[[PACKED:[a-zA-Z0-9_]+]] {{.*}}= dense<{{.+}}> : tensor<1x2x8x1xf32>
+//  CHECK-NOT: util.initializer
+//      CHECK: func.func @matmul_global_rhs(
+//  CHECK-NOT:   util.global.load @rhs
+//      CHECK:   %[[RHS:.+]] = util.global.load @[[PACKED]] : tensor<1x2x8x1xf32>
+//      CHECK:   flow.dispatch @{{.+}}(%{{.+}}, %[[RHS]]
+//      CHECK:   return
@@ -285,3 +285,46 @@ iree_hal_device_wait_idle(iree_hal_device_t* device, iree_timeout_t timeout) {
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+IREE_API_EXPORT iree_status_t iree_hal_device_profiling_begin(
+    iree_hal_device_t* device,
+    const iree_hal_device_profiling_options_t* options) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(options);
+  if (!_VTABLE_DISPATCH(device, profiling_begin)) {
+    iree_string_view_t device_id = iree_hal_device_id(device);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "device '%.*s' does not support profiling",
+                            (int)device_id.size, device_id.data);
+  }
+  if (options->mode != IREE_HAL_DEVICE_PROFILING_MODE_NONE &&
+      !options->sink.fn) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "profiling requires a sink to receive results");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      _VTABLE_DISPATCH(device, profiling_begin)(device, options);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_hal_device_profiling_flush(iree_hal_device_t* device) {
+  IREE_ASSERT_ARGUMENT(device);
+  if (!_VTABLE_DISPATCH(device, profiling_flush)) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = _VTABLE_DISPATCH(device, profiling_flush)(device);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_hal_device_profiling_end(iree_hal_device_t* device) {
+  IREE_ASSERT_ARGUMENT(device);
+  if (!_VTABLE_DISPATCH(device, profiling_end)) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = _VTABLE_DISPATCH(device, profiling_end)(device);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -118,6 +118,73 @@ typedef struct iree_hal_semaphore_list_t {
   uint64_t* payload_values;
 } iree_hal_semaphore_list_t;
 
+// Bitfield specifying which profiling information is captured by a device.
+enum iree_hal_device_profiling_mode_bits_t {
+  IREE_HAL_DEVICE_PROFILING_MODE_NONE = 0u,
+
+  // Aggregates per-dispatch execution counters (workgroup counts, wall time,
+  // scheduling information) for each executable entry point dispatched.
+  IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS = 1u << 0,
+};
+typedef uint32_t iree_hal_device_profiling_mode_t;
+
+// Aggregate counters for all dispatches of a single executable entry point.
+// Counters are accumulated from when profiling began or the last flush.
+// Fields that a device cannot measure are left as 0.
+typedef struct iree_hal_device_profiling_dispatch_record_t {
+  // Executable the entry point is defined in. Only valid for the duration of
+  // the sink callback receiving the record and not retained.
+  iree_hal_executable_t* executable;
+  // Ordinal of the entry point within |executable|.
+  int32_t entry_point;
+  // Name of the entry point if the executable has one, otherwise empty.
+  // Only valid for the duration of the sink callback receiving the record.
+  iree_string_view_t entry_point_name;
+
+  // Total number of dispatches that completed.
+  uint64_t dispatch_count;
+  // Total number of workgroups executed across all dispatches.
+  uint64_t workgroup_count;
+  // Total number of units of work the workgroups were scheduled as (such as
+  // CPU worker shards).
+  uint64_t shard_count;
+  // Number of shards that were executed by a worker that stole them from
+  // another worker they were originally scheduled on.
+  uint64_t steal_count;
+  // Total execution time across all shards in nanoseconds. As shards may run
+  // concurrently this is the aggregate compute time and not the latency.
+  uint64_t total_time_ns;
+  // Execution time of the longest running shard in nanoseconds.
+  uint64_t max_shard_time_ns;
+  // Largest amount of workgroup local memory in bytes declared by any dispatch.
+  // This is the size reserved for each workgroup and not its measured usage.
+  uint64_t local_memory_size;
+} iree_hal_device_profiling_dispatch_record_t;
+
+// Receives dispatch records as profiling information is flushed.
+// Records are only valid for the duration of the call. Returning a failure
+// will abort the flush and propagate the status to the caller.
+typedef iree_status_t(IREE_API_PTR* iree_hal_device_profiling_sink_fn_t)(
+    void* user_data, iree_host_size_t record_count,
+    const iree_hal_device_profiling_dispatch_record_t* records);
+
+// Callback used to receive flushed profiling information.
+typedef struct iree_hal_device_profiling_sink_t {
+  // Function called with each batch of flushed records.
+  iree_hal_device_profiling_sink_fn_t fn;
+  // User data passed to |fn| unmodified.
+  void* user_data;
+} iree_hal_device_profiling_sink_t;
+
+// Controls profiling options.
+typedef struct iree_hal_device_profiling_options_t {
+  // Capture mode specifying what information is captured.
+  iree_hal_device_profiling_mode_t mode;
+  // Sink receiving all flushed profiling information. Must remain valid until
+  // profiling has ended.
+  iree_hal_device_profiling_sink_t sink;
+} iree_hal_device_profiling_options_t;
+
 // A single batch of command buffers submitted to a device queue.
 // All of the wait semaphores must reach or exceed the given payload value prior
 // to the batch beginning execution. Each command buffer begins execution in the
@@ -201,6 +268,9 @@ iree_status_t iree_hal_device_trim(iree_hal_device_t* device);
 //   hal.device.feature :: some-pattern-*
 //   hal.device.architecture :: some-pattern-*
 //   hal.executable.format :: some-pattern-*
+//   hal.dispatch :: concurrency
+//     Maximum number of workgroups of a dispatch that may execute
+//     concurrently (such as the worker count of a CPU executor).
 //
 // Returned values must remain the same for the lifetime of the device as
 // callers may cache them to avoid redundant calls.
@@ -349,6 +419,32 @@ IREE_API_EXPORT iree_status_t iree_hal_device_wait_semaphores(
 IREE_API_EXPORT iree_status_t
 iree_hal_device_wait_idle(iree_hal_device_t* device, iree_timeout_t timeout);
 
+// Begins a profile capture on |device| with the given |options|.
+// Information is aggregated on the device without any external tooling (such
+// as Tracy) and delivered to the options sink on flush and when profiling ends.
+// Only one profile capture may be active at a time.
+//
+// Work that is in-flight when profiling begins or ends may be partially
+// included in the results; callers wanting precise captures should wait for
+// the device to become idle first.
+//
+// Returns IREE_STATUS_UNIMPLEMENTED if the device does not support profiling
+// or any of the requested modes.
+IREE_API_EXPORT iree_status_t iree_hal_device_profiling_begin(
+    iree_hal_device_t* device,
+    const iree_hal_device_profiling_options_t* options);
+
+// Flushes all profiling information captured since profiling began or the last
+// flush to the profiling sink and resets the counters. No-op if no profile
+// capture is active.
+IREE_API_EXPORT iree_status_t
+iree_hal_device_profiling_flush(iree_hal_device_t* device);
+
+// Flushes any remaining profiling information and ends the active profile
+// capture. No-op if no profile capture is active.
+IREE_API_EXPORT iree_status_t
+iree_hal_device_profiling_end(iree_hal_device_t* device);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_device_t implementation details
 //===----------------------------------------------------------------------===//
@@ -429,6 +525,13 @@ typedef struct iree_hal_device_vtable_t {
 
   iree_status_t(IREE_API_PTR* wait_idle)(iree_hal_device_t* device,
                                          iree_timeout_t timeout);
+
+  // Optional; devices that do not support profiling may leave these NULL.
+  iree_status_t(IREE_API_PTR* profiling_begin)(
+      iree_hal_device_t* device,
+      const iree_hal_device_profiling_options_t* options);
+  iree_status_t(IREE_API_PTR* profiling_flush)(iree_hal_device_t* device);
+  iree_status_t(IREE_API_PTR* profiling_end)(iree_hal_device_t* device);
 } iree_hal_device_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_device_vtable_t);
 
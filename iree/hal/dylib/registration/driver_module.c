@@ -27,6 +27,16 @@
 
 #define IREE_HAL_DYLIB_DRIVER_ID 0x58444C4Cu  // XDLL
 
+IREE_FLAG(
+    int32_t, dylib_inline_dispatch_max_workgroups, 0,
+    "Dispatches with at most this many workgroups are executed as a single\n"
+    "shard on the thread issuing them instead of being distributed across\n"
+    "all workers. 0 (default) distributes all dispatches.");
+
+IREE_FLAG(
+    int64_t, dylib_inline_dispatch_max_bytes, 256 * 1024,
+    "Maximum total binding length in bytes of a dispatch executed inline.");
+
 static iree_status_t iree_hal_dylib_driver_factory_enumerate(
     void* self, const iree_hal_driver_info_t** out_driver_infos,
     iree_host_size_t* out_driver_info_count) {
@@ -55,6 +65,10 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
 
   iree_hal_task_device_params_t default_params;
   iree_hal_task_device_params_initialize(&default_params);
+  default_params.inline_dispatch.max_workgroup_count =
+      (uint32_t)iree_max(0, FLAG_dylib_inline_dispatch_max_workgroups);
+  default_params.inline_dispatch.max_binding_length =
+      (iree_device_size_t)iree_max(0, FLAG_dylib_inline_dispatch_max_bytes);
 
   iree_status_t status = iree_ok_status();
 
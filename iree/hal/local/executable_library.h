@@ -364,6 +364,38 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+// Scheduling hints packed into iree_hal_executable_dispatch_attrs_v0_t::hints.
+// Hints never change the results of a dispatch and runtimes are free to ignore
+// them. Sizes are encoded as log2 of the value plus one such that 0 always
+// means that the hint is not provided.
+typedef uint16_t iree_hal_executable_dispatch_hints_t;
+
+// Approximate bytes of binding memory read by each workgroup encoded as
+// log2(bytes)+1 in bits [0, 6).
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_READ_BYTES_SHIFT 0
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_READ_BYTES_MASK 0x3Fu
+// Distance in workgroups (in walk order) after which the data read by a
+// workgroup is read again by another workgroup encoded as log2(distance)+1 in
+// bits [6, 11).
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_REUSE_DISTANCE_SHIFT 6
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_REUSE_DISTANCE_MASK 0x1Fu
+// Preferred workgroup walk order in bits [11, 13); one of
+// IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_*.
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_WALK_ORDER_SHIFT 11
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_WALK_ORDER_MASK 0x3u
+// Set when each workgroup reads a disjoint contiguous slice of each binding
+// with slices ordered by the linearized workgroup ID in walk order (such as
+// elementwise dispatches). Allows the runtime to prefetch the data of the
+// workgroups that follow.
+#define IREE_HAL_EXECUTABLE_DISPATCH_HINT_STREAMING (1u << 13)
+// Bits [14, 16) are reserved and must be 0.
+
+// Workgroups are walked with X varying fastest, then Y, then Z (default).
+#define IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_XYZ 0u
+// Workgroups are walked with Y varying fastest, then X, then Z. Useful when
+// workgroups adjacent in Y share the most data.
+#define IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_YXZ 1u
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -372,9 +404,9 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
-  // Must be 0. May be used in the future for flags controlling the dispatch
-  // behavior/synchronization requirements.
-  uint16_t reserved;
+  // Optional scheduling hints as IREE_HAL_EXECUTABLE_DISPATCH_HINT_* fields or
+  // 0 if none are provided. Libraries predating the hints store 0 here.
+  iree_hal_executable_dispatch_hints_t hints;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
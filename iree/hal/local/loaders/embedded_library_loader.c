@@ -288,6 +288,17 @@ static iree_status_t iree_hal_elf_executable_issue_call(
                         ret);
 }
 
+static iree_string_view_t iree_hal_elf_executable_entry_point_name(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal) {
+  iree_hal_elf_executable_t* executable =
+      (iree_hal_elf_executable_t*)base_executable;
+  const iree_hal_executable_library_v0_t* library = executable->library.v0;
+  if (ordinal >= library->exports.count || library->exports.names == NULL) {
+    return iree_string_view_empty();
+  }
+  return iree_make_cstring_view(library->exports.names[ordinal]);
+}
+
 static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
     {
         .base =
@@ -295,6 +306,7 @@ static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
                 .destroy = iree_hal_elf_executable_destroy,
             },
         .issue_call = iree_hal_elf_executable_issue_call,
+        .entry_point_name = iree_hal_elf_executable_entry_point_name,
 };
 
 //===----------------------------------------------------------------------===//
@@ -421,6 +421,14 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
   return status;
 }
 
+static iree_string_view_t iree_hal_vmvx_executable_entry_point_name(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal) {
+  iree_hal_vmvx_executable_t* executable =
+      (iree_hal_vmvx_executable_t*)base_executable;
+  if (ordinal >= executable->entry_fn_count) return iree_string_view_empty();
+  return iree_vm_function_name(&executable->entry_fns[ordinal]);
+}
+
 static const iree_hal_local_executable_vtable_t
     iree_hal_vmvx_executable_vtable = {
         .base =
@@ -428,6 +436,7 @@ static const iree_hal_local_executable_vtable_t
                 .destroy = iree_hal_vmvx_executable_destroy,
             },
         .issue_call = iree_hal_vmvx_executable_issue_call,
+        .entry_point_name = iree_hal_vmvx_executable_entry_point_name,
 };
 
 //===----------------------------------------------------------------------===//
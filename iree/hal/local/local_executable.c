@@ -6,6 +6,8 @@
 
 #include "iree/hal/local/local_executable.h"
 
+#include <string.h>
+
 #include "iree/base/tracing.h"
 #include "iree/hal/local/executable_environment.h"
 
@@ -61,6 +63,43 @@ iree_status_t iree_hal_local_executable_issue_call(
       ->issue_call(executable, ordinal, dispatch_state, workgroup_state);
 }
 
+iree_string_view_t iree_hal_local_executable_entry_point_name(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  IREE_ASSERT_ARGUMENT(executable);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  if (!vtable->entry_point_name) return iree_string_view_empty();
+  return vtable->entry_point_name(executable, ordinal);
+}
+
+// Decodes a log2(value)+1 encoded hint field; 0 indicates no value.
+static uint64_t iree_hal_local_executable_decode_log2_hint(uint32_t value) {
+  return value ? (1ull << (value - 1)) : 0;
+}
+
+iree_hal_local_executable_dispatch_hints_t
+iree_hal_local_executable_dispatch_hints(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  IREE_ASSERT_ARGUMENT(executable);
+  iree_hal_local_executable_dispatch_hints_t hints;
+  memset(&hints, 0, sizeof(hints));
+  if (!executable->dispatch_attrs) return hints;
+  const iree_hal_executable_dispatch_hints_t packed_hints =
+      executable->dispatch_attrs[ordinal].hints;
+  hints.workgroup_read_bytes = iree_hal_local_executable_decode_log2_hint(
+      (packed_hints >> IREE_HAL_EXECUTABLE_DISPATCH_HINT_READ_BYTES_SHIFT) &
+      IREE_HAL_EXECUTABLE_DISPATCH_HINT_READ_BYTES_MASK);
+  hints.reuse_distance = (uint32_t)iree_hal_local_executable_decode_log2_hint(
+      (packed_hints >> IREE_HAL_EXECUTABLE_DISPATCH_HINT_REUSE_DISTANCE_SHIFT) &
+      IREE_HAL_EXECUTABLE_DISPATCH_HINT_REUSE_DISTANCE_MASK);
+  hints.walk_order =
+      (packed_hints >> IREE_HAL_EXECUTABLE_DISPATCH_HINT_WALK_ORDER_SHIFT) &
+      IREE_HAL_EXECUTABLE_DISPATCH_HINT_WALK_ORDER_MASK;
+  hints.streaming =
+      (packed_hints & IREE_HAL_EXECUTABLE_DISPATCH_HINT_STREAMING) != 0;
+  return hints;
+}
+
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -25,7 +25,8 @@ typedef struct iree_hal_local_executable_t {
   // Defines per-entry point how much workgroup local memory is required.
   // Contains entries with 0 to indicate no local memory is required or >0 in
   // units of IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE for the minimum amount
-  // of memory required by the function.
+  // of memory required by the function. Entries also carry optional
+  // scheduling hints; see iree_hal_local_executable_dispatch_hints.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
   // Execution environment.
@@ -39,6 +40,10 @@ typedef struct iree_hal_local_executable_vtable_t {
       iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_executable_workgroup_state_v0_t* workgroup_state);
+
+  // Optional; returns the name of the entry point at |ordinal| if available.
+  iree_string_view_t(IREE_API_PTR* entry_point_name)(
+      iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
 } iree_hal_local_executable_vtable_t;
 
 // Initializes the local executable base type.
@@ -64,6 +69,30 @@ iree_status_t iree_hal_local_executable_issue_call(
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     const iree_hal_executable_workgroup_state_v0_t* workgroup_state);
 
+// Returns the name of the entry point at |ordinal| or an empty string view if
+// the executable does not carry names (or the ordinal is out of range).
+iree_string_view_t iree_hal_local_executable_entry_point_name(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
+// Decoded iree_hal_executable_dispatch_hints_t of an entry point.
+// All fields are 0 if the executable did not provide the hint.
+typedef struct iree_hal_local_executable_dispatch_hints_t {
+  // Approximate bytes of binding memory read by each workgroup.
+  uint64_t workgroup_read_bytes;
+  // Distance in workgroups after which data read by a workgroup is reused.
+  uint32_t reuse_distance;
+  // Preferred IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_* of workgroups.
+  uint32_t walk_order;
+  // True if workgroups stream through disjoint contiguous binding slices; see
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_STREAMING.
+  bool streaming;
+} iree_hal_local_executable_dispatch_hints_t;
+
+// Returns the decoded scheduling hints of the entry point at |ordinal|.
+iree_hal_local_executable_dispatch_hints_t
+iree_hal_local_executable_dispatch_hints(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -28,6 +28,8 @@
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+typedef struct iree_hal_cmd_dispatch_t iree_hal_cmd_dispatch_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
@@ -42,6 +44,12 @@ typedef struct iree_hal_task_command_buffer_t {
 
   iree_task_scope_t* scope;
 
+  // Optional profiler that dispatch statistics are attributed to.
+  iree_hal_task_profiler_t* profiler;
+
+  // Thresholds below which dispatches are executed inline.
+  iree_hal_task_inline_dispatch_params_t inline_dispatch;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -61,6 +69,11 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // All dispatches recorded while a |profiler| is available, most recent
+  // first. Their statistics targets are resolved when the command buffer is
+  // issued so that they are attributed to the capture active at submission.
+  iree_hal_cmd_dispatch_t* dispatch_head;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
@@ -101,6 +114,18 @@ typedef struct iree_hal_task_command_buffer_t {
 static const iree_hal_command_buffer_vtable_t
     iree_hal_task_command_buffer_vtable;
 
+bool iree_hal_task_inline_dispatch_params_allow(
+    const iree_hal_task_inline_dispatch_params_t* params,
+    const uint32_t workgroup_count[3],
+    iree_device_size_t total_binding_length) {
+  const uint64_t total_workgroup_count = (uint64_t)workgroup_count[0] *
+                                         workgroup_count[1] *
+                                         workgroup_count[2];
+  return total_workgroup_count > 0 &&
+         total_workgroup_count <= params->max_workgroup_count &&
+         total_binding_length <= params->max_binding_length;
+}
+
 static iree_hal_task_command_buffer_t* iree_hal_task_command_buffer_cast(
     iree_hal_command_buffer_t* base_value) {
   IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_task_command_buffer_vtable);
@@ -112,7 +137,9 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_arena_block_pool_t* block_pool, iree_hal_task_profiler_t* profiler,
+    iree_hal_task_inline_dispatch_params_t inline_dispatch,
+    iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
@@ -141,9 +168,12 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->profiler = profiler;
+    command_buffer->inline_dispatch = inline_dispatch;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
+    command_buffer->dispatch_head = NULL;
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
@@ -161,6 +191,7 @@ iree_status_t iree_hal_task_command_buffer_create(
 static void iree_hal_task_command_buffer_reset(
     iree_hal_task_command_buffer_t* command_buffer) {
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+  command_buffer->dispatch_head = NULL;
   iree_task_list_discard(&command_buffer->leaf_tasks);
   iree_task_list_discard(&command_buffer->root_tasks);
   iree_hal_resource_set_reset(command_buffer->resource_set);
@@ -351,6 +382,9 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+static iree_status_t iree_hal_task_command_buffer_resolve_statistics(
+    iree_hal_task_command_buffer_t* command_buffer);
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -366,6 +400,9 @@ iree_status_t iree_hal_task_command_buffer_issue(
     return iree_ok_status();
   }
 
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_resolve_statistics(command_buffer));
+
   bool has_leaf_tasks = !iree_task_list_is_empty(&command_buffer->leaf_tasks);
   if (has_leaf_tasks) {
     // Chain the retire task onto the leaf tasks as their completion indicates
@@ -794,11 +831,15 @@ static iree_status_t iree_hal_task_command_buffer_bind_descriptor_set(
 // iree_hal_command_buffer_dispatch
 //===----------------------------------------------------------------------===//
 
-typedef struct iree_hal_cmd_dispatch_t {
+struct iree_hal_cmd_dispatch_t {
   iree_task_dispatch_t task;
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Next dispatch recorded before this one in the command buffer; see
+  // iree_hal_task_command_buffer_t::dispatch_head.
+  iree_hal_cmd_dispatch_t* next_dispatch;
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -807,11 +848,58 @@ typedef struct iree_hal_cmd_dispatch_t {
   // used (known at compile-time).
   uint16_t binding_count;
 
+  // Bytes at the head of the next workgroup's slice of each binding to
+  // prefetch before executing a workgroup or 0 to disable prefetching. Only
+  // set for dispatches that stream through bindings; see
+  // IREE_HAL_EXECUTABLE_DISPATCH_HINT_STREAMING.
+  uint32_t prefetch_length;
+
   // Following this structure in memory there are 3 tables:
   // - const uint32_t push_constants[push_constant_count];
   // - void* binding_ptrs[binding_count];
   // - const size_t binding_lengths[binding_count];
-} iree_hal_cmd_dispatch_t;
+};
+
+// Maximum number of bytes of each binding prefetched for the next workgroup of
+// streaming dispatches. Only the head of each slice is prefetched as that is
+// enough for the hardware prefetchers to pick up the stream.
+#define IREE_HAL_CMD_DISPATCH_MAX_PREFETCH_LENGTH 512
+
+// Prefetches the head of the slice of each binding the workgroup following the
+// one in |tile_context| will read. Streaming dispatches partition bindings
+// evenly across workgroups in walk order so the slice is derived from the
+// binding length. Workers reserve sequential tiles so the next workgroup is
+// usually executed by the same worker immediately after this one.
+static void iree_hal_cmd_dispatch_prefetch_next_workgroup(
+    const iree_hal_cmd_dispatch_t* cmd,
+    const iree_task_tile_context_t* tile_context,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  const uint32_t* xyz = tile_context->workgroup_xyz;
+  const uint32_t* count = tile_context->workgroup_count;
+  const uint64_t workgroup_count = (uint64_t)count[0] * count[1] * count[2];
+  uint64_t workgroup_index = 0;
+  if (cmd->task.header.flags & IREE_TASK_FLAG_DISPATCH_WALK_YXZ) {
+    workgroup_index =
+        ((uint64_t)xyz[2] * count[0] + xyz[0]) * count[1] + xyz[1];
+  } else {
+    workgroup_index =
+        ((uint64_t)xyz[2] * count[1] + xyz[1]) * count[0] + xyz[0];
+  }
+  const uint64_t next_workgroup_index = workgroup_index + 1;
+  if (next_workgroup_index >= workgroup_count) return;
+  for (uint16_t i = 0; i < dispatch_state->binding_count; ++i) {
+    const uint64_t slice_length =
+        dispatch_state->binding_lengths[i] / workgroup_count;
+    const uint8_t* slice_ptr = (const uint8_t*)dispatch_state->binding_ptrs[i] +
+                               next_workgroup_index * slice_length;
+    const uint64_t prefetch_length =
+        iree_min(slice_length, (uint64_t)cmd->prefetch_length);
+    for (uint64_t offset = 0; offset < prefetch_length;
+         offset += iree_hardware_constructive_interference_size) {
+      IREE_PREFETCH_READ(slice_ptr + offset);
+    }
+  }
+}
 
 static iree_status_t iree_hal_cmd_dispatch_tile(
     void* user_context, const iree_task_tile_context_t* tile_context,
@@ -843,6 +931,11 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   dispatch_state.binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += cmd->binding_count * sizeof(*dispatch_state.binding_lengths);
 
+  if (cmd->prefetch_length) {
+    iree_hal_cmd_dispatch_prefetch_next_workgroup(cmd, tile_context,
+                                                  &dispatch_state);
+  }
+
   const iree_alignas(64)
       iree_hal_executable_workgroup_state_v0_t workgroup_state = {
           .workgroup_id_x = tile_context->workgroup_xyz[0],
@@ -860,6 +953,20 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   return status;
 }
 
+// Attributes the statistics of all recorded dispatches to their entry points
+// in the capture active on the profiler, if any. Dispatches issued while no
+// capture is active have no target and skip collecting statistics entirely.
+static iree_status_t iree_hal_task_command_buffer_resolve_statistics(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  for (iree_hal_cmd_dispatch_t* cmd = command_buffer->dispatch_head;
+       cmd != NULL; cmd = cmd->next_dispatch) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_profiler_resolve_statistics(
+        command_buffer->profiler, cmd->executable, cmd->ordinal,
+        &cmd->task.statistics_target));
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -905,6 +1012,14 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
       workgroup_size, workgroup_count, &cmd->task);
 
+  // Track the dispatch so that its statistics can be attributed to the entry
+  // point if a capture is active when the command buffer is issued.
+  cmd->next_dispatch = NULL;
+  if (command_buffer->profiler) {
+    cmd->next_dispatch = command_buffer->dispatch_head;
+    command_buffer->dispatch_head = cmd;
+  }
+
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
   // scratch memory available during execution.
@@ -914,6 +1029,25 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Pass along the scheduling hints of the entry point. These only influence
+  // how workgroups are distributed and never the results of the dispatch.
+  const iree_hal_local_executable_dispatch_hints_t hints =
+      iree_hal_local_executable_dispatch_hints(local_executable, entry_point);
+  cmd->task.tile_read_size =
+      (uint32_t)iree_min(hints.workgroup_read_bytes, UINT32_MAX);
+  cmd->task.tile_reuse_distance = hints.reuse_distance;
+  if (hints.walk_order == IREE_HAL_EXECUTABLE_DISPATCH_WALK_ORDER_YXZ) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_WALK_YXZ;
+  }
+  cmd->prefetch_length = 0;
+  if (hints.streaming) {
+    cmd->prefetch_length = IREE_HAL_CMD_DISPATCH_MAX_PREFETCH_LENGTH;
+    if (hints.workgroup_read_bytes) {
+      cmd->prefetch_length = (uint32_t)iree_min(
+          cmd->prefetch_length, hints.workgroup_read_bytes);
+    }
+  }
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -934,6 +1068,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   size_t* binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += used_binding_count * sizeof(*binding_lengths);
   iree_host_size_t binding_base = 0;
+  iree_device_size_t total_binding_length = 0;
   for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
     int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
     int binding_ordinal = binding_base + mask_offset;
@@ -941,12 +1076,23 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     used_binding_mask = iree_shr(used_binding_mask, mask_offset + 1);
     binding_ptrs[i] = command_buffer->state.bindings[binding_ordinal];
     binding_lengths[i] = command_buffer->state.binding_lengths[binding_ordinal];
+    total_binding_length += binding_lengths[i];
     if (!binding_ptrs[i]) {
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "(flat) binding %d is NULL", binding_ordinal);
     }
   }
 
+  // Small dispatches are executed as a single shard to avoid waking workers for
+  // only a few workgroups. The workgroup count and binding ranges are what the
+  // compiler produced for the dispatch site and approximate the amount of work
+  // performed.
+  if (iree_hal_task_inline_dispatch_params_allow(
+          &command_buffer->inline_dispatch, workgroup_count,
+          total_binding_length)) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  }
+
   *out_cmd = cmd;
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
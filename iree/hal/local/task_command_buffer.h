@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/arena.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/task_profiler.h"
 #include "iree/hal/local/task_queue_state.h"
 #include "iree/task/scope.h"
 #include "iree/task/task.h"
@@ -18,12 +19,39 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Thresholds below which dispatches are executed as a single shard on the
+// thread issuing them instead of being distributed across executor workers.
+// Small dispatches (such as elementwise ops with only a few workgroups) often
+// take less time to execute than it takes to wake workers and hand off shards.
+typedef struct iree_hal_task_inline_dispatch_params_t {
+  // Maximum total workgroup count (x*y*z) of a dispatch executed inline.
+  // 0 disables inline execution.
+  uint32_t max_workgroup_count;
+  // Maximum total length in bytes of all bindings used by a dispatch executed
+  // inline. Used to keep memory-bound dispatches distributed even when they
+  // have few workgroups.
+  iree_device_size_t max_binding_length;
+} iree_hal_task_inline_dispatch_params_t;
+
+// Returns true if a dispatch of |workgroup_count| workgroups accessing
+// |total_binding_length| bytes is within the inline thresholds in |params|.
+bool iree_hal_task_inline_dispatch_params_allow(
+    const iree_hal_task_inline_dispatch_params_t* params,
+    const uint32_t workgroup_count[3], iree_device_size_t total_binding_length);
+
+// Creates a command buffer recording tasks into |scope|.
+// If |profiler| is provided dispatches issued while it has an active capture
+// will have their statistics attributed to their executable entry points.
+// Direct dispatches within the |inline_dispatch| thresholds are executed as a
+// single shard.
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_arena_block_pool_t* block_pool, iree_hal_task_profiler_t* profiler,
+    iree_hal_task_inline_dispatch_params_t inline_dispatch,
+    iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns true if |command_buffer| is a task system command buffer.
@@ -0,0 +1,60 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/task_command_buffer.h"
+
+#include "iree/hal/local/task_device.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(TaskInlineDispatchTest, DisabledByDefault) {
+  iree_hal_task_device_params_t params;
+  iree_hal_task_device_params_initialize(&params);
+  const uint32_t workgroup_count[3] = {1, 1, 1};
+  EXPECT_FALSE(iree_hal_task_inline_dispatch_params_allow(
+      &params.inline_dispatch, workgroup_count, 0));
+}
+
+TEST(TaskInlineDispatchTest, WorkgroupCountThreshold) {
+  iree_hal_task_inline_dispatch_params_t params = {4, 1024};
+  const uint32_t kWithin[][3] = {{1, 1, 1}, {4, 1, 1}, {1, 2, 2}, {1, 1, 4}};
+  for (const auto& workgroup_count : kWithin) {
+    EXPECT_TRUE(iree_hal_task_inline_dispatch_params_allow(
+        &params, workgroup_count, 1024));
+  }
+  const uint32_t kOver[][3] = {{5, 1, 1}, {2, 3, 1}, {1, 1, 5}};
+  for (const auto& workgroup_count : kOver) {
+    EXPECT_FALSE(iree_hal_task_inline_dispatch_params_allow(
+        &params, workgroup_count, 1024));
+  }
+}
+
+TEST(TaskInlineDispatchTest, EmptyDispatch) {
+  iree_hal_task_inline_dispatch_params_t params = {4, 1024};
+  const uint32_t workgroup_count[3] = {0, 1, 1};
+  EXPECT_FALSE(iree_hal_task_inline_dispatch_params_allow(
+      &params, workgroup_count, 0));
+}
+
+// The total workgroup count must not wrap around to a small value.
+TEST(TaskInlineDispatchTest, WorkgroupCountOverflow) {
+  iree_hal_task_inline_dispatch_params_t params = {4, 1024};
+  const uint32_t workgroup_count[3] = {65536, 65536, 1};
+  EXPECT_FALSE(iree_hal_task_inline_dispatch_params_allow(
+      &params, workgroup_count, 0));
+}
+
+TEST(TaskInlineDispatchTest, BindingLengthThreshold) {
+  iree_hal_task_inline_dispatch_params_t params = {4, 1024};
+  const uint32_t workgroup_count[3] = {2, 1, 1};
+  EXPECT_TRUE(iree_hal_task_inline_dispatch_params_allow(
+      &params, workgroup_count, 1024));
+  EXPECT_FALSE(iree_hal_task_inline_dispatch_params_allow(
+      &params, workgroup_count, 1025));
+}
+
+}  // namespace
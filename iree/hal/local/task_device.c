@@ -18,6 +18,7 @@
 #include "iree/hal/local/local_executable_layout.h"
 #include "iree/hal/local/task_command_buffer.h"
 #include "iree/hal/local/task_event.h"
+#include "iree/hal/local/task_profiler.h"
 #include "iree/hal/local/task_queue.h"
 #include "iree/hal/local/task_semaphore.h"
 #include "iree/hal/utils/buffer_transfer.h"
@@ -41,6 +42,12 @@ typedef struct iree_hal_task_device_t {
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
+  // Per-dispatch statistics aggregation used when profiling.
+  iree_hal_task_profiler_t profiler;
+
+  // Thresholds below which dispatches are executed inline.
+  iree_hal_task_inline_dispatch_params_t inline_dispatch;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -57,6 +64,8 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 8;
+  out_params->inline_dispatch.max_workgroup_count = 0;
+  out_params->inline_dispatch.max_binding_length = 256 * 1024;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -105,6 +114,9 @@ iree_status_t iree_hal_task_device_create(
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
 
+    iree_hal_task_profiler_initialize(host_allocator, &device->profiler);
+    device->inline_dispatch = params->inline_dispatch;
+
     iree_arena_block_pool_initialize(4096, host_allocator,
                                      &device->small_block_pool);
     iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
@@ -152,6 +164,7 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
+  iree_hal_task_profiler_deinitialize(&device->profiler);
   iree_task_executor_release(device->executor);
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
   iree_arena_block_pool_deinitialize(&device->small_block_pool);
@@ -201,6 +214,12 @@ static iree_status_t iree_hal_task_device_query_i32(
             ? 1
             : 0;
     return iree_ok_status();
+  } else if (iree_string_view_equal(category,
+                                    iree_make_cstring_view("hal.dispatch"))) {
+    if (iree_string_view_equal(key, iree_make_cstring_view("concurrency"))) {
+      *out_value = (int32_t)iree_task_executor_worker_count(device->executor);
+      return iree_ok_status();
+    }
   }
 
   return iree_make_status(
@@ -233,8 +252,8 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, &device->large_block_pool, device->host_allocator,
-      out_command_buffer);
+      queue_affinity, &device->large_block_pool, &device->profiler,
+      device->inline_dispatch, device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_task_device_create_descriptor_set(
@@ -342,6 +361,25 @@ static iree_status_t iree_hal_task_device_wait_idle(
   return status;
 }
 
+static iree_status_t iree_hal_task_device_profiling_begin(
+    iree_hal_device_t* base_device,
+    const iree_hal_device_profiling_options_t* options) {
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_task_profiler_begin(&device->profiler, options);
+}
+
+static iree_status_t iree_hal_task_device_profiling_flush(
+    iree_hal_device_t* base_device) {
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_task_profiler_flush(&device->profiler);
+}
+
+static iree_status_t iree_hal_task_device_profiling_end(
+    iree_hal_device_t* base_device) {
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_task_profiler_end(&device->profiler);
+}
+
 static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
     .destroy = iree_hal_task_device_destroy,
     .id = iree_hal_task_device_id,
@@ -362,4 +400,7 @@ static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
     .submit_and_wait = iree_hal_task_device_submit_and_wait,
     .wait_semaphores = iree_hal_task_device_wait_semaphores,
     .wait_idle = iree_hal_task_device_wait_idle,
+    .profiling_begin = iree_hal_task_device_profiling_begin,
+    .profiling_flush = iree_hal_task_device_profiling_flush,
+    .profiling_end = iree_hal_task_device_profiling_end,
 };
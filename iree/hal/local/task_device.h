@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/task_command_buffer.h"
 #include "iree/task/executor.h"
 
 #ifdef __cplusplus
@@ -28,6 +29,12 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Thresholds below which dispatches are executed as a single shard on the
+  // thread issuing them instead of being distributed across executor workers.
+  // Disabled (max_workgroup_count of 0) by default as the benefit depends on
+  // the workload and the host core count.
+  iree_hal_task_inline_dispatch_params_t inline_dispatch;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
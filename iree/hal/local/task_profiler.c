@@ -0,0 +1,209 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/task_profiler.h"
+
+#include <string.h>
+
+#include "iree/base/tracing.h"
+
+struct iree_hal_task_profiler_slot_t {
+  iree_hal_task_profiler_slot_t* next;
+  // Retained executable the slot is attributed to or NULL if the slot was
+  // retired by a prior capture and is available for reuse.
+  iree_hal_local_executable_t* executable;
+  int32_t entry_point;
+  // Statistics merged into by all dispatches of the entry point.
+  iree_task_dispatch_statistics_t statistics;
+};
+
+void iree_hal_task_profiler_initialize(iree_allocator_t host_allocator,
+                                       iree_hal_task_profiler_t* out_profiler) {
+  memset(out_profiler, 0, sizeof(*out_profiler));
+  out_profiler->host_allocator = host_allocator;
+  iree_atomic_store_int32(&out_profiler->active, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&out_profiler->mutex);
+}
+
+// Releases the executables referenced by all slots so that they can be reused.
+static void iree_hal_task_profiler_retire_slots(
+    iree_hal_task_profiler_t* profiler) {
+  for (iree_hal_task_profiler_slot_t* slot = profiler->slot_head; slot != NULL;
+       slot = slot->next) {
+    if (slot->executable) {
+      iree_hal_executable_release((iree_hal_executable_t*)slot->executable);
+      slot->executable = NULL;
+    }
+  }
+}
+
+void iree_hal_task_profiler_deinitialize(iree_hal_task_profiler_t* profiler) {
+  iree_hal_task_profiler_retire_slots(profiler);
+  iree_hal_task_profiler_slot_t* slot = profiler->slot_head;
+  while (slot) {
+    iree_hal_task_profiler_slot_t* next_slot = slot->next;
+    iree_allocator_free(profiler->host_allocator, slot);
+    slot = next_slot;
+  }
+  profiler->slot_head = NULL;
+  profiler->slot_count = 0;
+  iree_slim_mutex_deinitialize(&profiler->mutex);
+}
+
+iree_status_t iree_hal_task_profiler_begin(
+    iree_hal_task_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options) {
+  if (iree_any_bit_set(options->mode,
+                       ~IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unsupported profiling mode 0x%08X",
+                            options->mode);
+  }
+#if !IREE_STATISTICS_ENABLE
+  if (options->mode != IREE_HAL_DEVICE_PROFILING_MODE_NONE) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "dispatch counters require IREE_STATISTICS_ENABLE");
+  }
+#endif  // !IREE_STATISTICS_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&profiler->mutex);
+  if (iree_atomic_load_int32(&profiler->active, iree_memory_order_relaxed)) {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "a profile capture is already active");
+  } else if (options->mode != IREE_HAL_DEVICE_PROFILING_MODE_NONE) {
+    profiler->options = *options;
+    iree_atomic_store_int32(&profiler->active, 1, iree_memory_order_release);
+  }
+  iree_slim_mutex_unlock(&profiler->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Flushes all slots to the capture sink. Must be called with the mutex held.
+static iree_status_t iree_hal_task_profiler_flush_locked(
+    iree_hal_task_profiler_t* profiler) {
+  if (!iree_atomic_load_int32(&profiler->active, iree_memory_order_relaxed) ||
+      profiler->slot_count == 0) {
+    return iree_ok_status();
+  }
+
+  iree_hal_device_profiling_dispatch_record_t* records = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      profiler->host_allocator, profiler->slot_count * sizeof(*records),
+      (void**)&records));
+
+  iree_host_size_t record_count = 0;
+  for (iree_hal_task_profiler_slot_t* slot = profiler->slot_head; slot != NULL;
+       slot = slot->next) {
+    if (!slot->executable) continue;
+    iree_task_dispatch_statistics_t statistics;
+    iree_task_dispatch_statistics_consume(&slot->statistics, &statistics);
+#if IREE_STATISTICS_ENABLE
+#define IREE_HAL_TASK_PROFILER_LOAD(field) \
+  (uint64_t)iree_atomic_load_int64(&statistics.field, iree_memory_order_relaxed)
+    if (!IREE_HAL_TASK_PROFILER_LOAD(dispatch_count)) continue;
+    iree_hal_device_profiling_dispatch_record_t* record =
+        &records[record_count++];
+    record->executable = (iree_hal_executable_t*)slot->executable;
+    record->entry_point = slot->entry_point;
+    record->entry_point_name = iree_hal_local_executable_entry_point_name(
+        slot->executable, slot->entry_point);
+    record->dispatch_count = IREE_HAL_TASK_PROFILER_LOAD(dispatch_count);
+    record->workgroup_count = IREE_HAL_TASK_PROFILER_LOAD(tile_count);
+    record->shard_count = IREE_HAL_TASK_PROFILER_LOAD(shard_count);
+    record->steal_count = IREE_HAL_TASK_PROFILER_LOAD(steal_count);
+    record->total_time_ns = IREE_HAL_TASK_PROFILER_LOAD(shard_time_ns);
+    record->max_shard_time_ns = IREE_HAL_TASK_PROFILER_LOAD(shard_time_max_ns);
+    record->local_memory_size = IREE_HAL_TASK_PROFILER_LOAD(local_memory_size);
+#undef IREE_HAL_TASK_PROFILER_LOAD
+#endif  // IREE_STATISTICS_ENABLE
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (record_count > 0) {
+    status = profiler->options.sink.fn(profiler->options.sink.user_data,
+                                       record_count, records);
+  }
+
+  iree_allocator_free(profiler->host_allocator, records);
+  return status;
+}
+
+iree_status_t iree_hal_task_profiler_flush(iree_hal_task_profiler_t* profiler) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status = iree_hal_task_profiler_flush_locked(profiler);
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_task_profiler_end(iree_hal_task_profiler_t* profiler) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status = iree_hal_task_profiler_flush_locked(profiler);
+  iree_atomic_store_int32(&profiler->active, 0, iree_memory_order_release);
+  iree_hal_task_profiler_retire_slots(profiler);
+  memset(&profiler->options, 0, sizeof(profiler->options));
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_task_profiler_resolve_statistics(
+    iree_hal_task_profiler_t* profiler, iree_hal_local_executable_t* executable,
+    int32_t entry_point, iree_task_dispatch_statistics_t** out_statistics) {
+  *out_statistics = NULL;
+  if (!iree_atomic_load_int32(&profiler->active, iree_memory_order_acquire)) {
+    return iree_ok_status();
+  }
+
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&profiler->mutex);
+
+  // Find an existing slot for the entry point or a retired one to reuse.
+  // The number of unique entry points is usually small enough that a linear
+  // scan at issue time is cheaper than maintaining a map.
+  iree_hal_task_profiler_slot_t* slot = NULL;
+  iree_hal_task_profiler_slot_t* free_slot = NULL;
+  for (iree_hal_task_profiler_slot_t* it = profiler->slot_head; it != NULL;
+       it = it->next) {
+    if (it->executable == executable && it->entry_point == entry_point) {
+      slot = it;
+      break;
+    } else if (!it->executable && !free_slot) {
+      free_slot = it;
+    }
+  }
+  if (!slot && free_slot) {
+    slot = free_slot;
+  } else if (!slot) {
+    status = iree_allocator_malloc(profiler->host_allocator, sizeof(*slot),
+                                   (void**)&slot);
+    if (iree_status_is_ok(status)) {
+      slot->next = profiler->slot_head;
+      profiler->slot_head = slot;
+      ++profiler->slot_count;
+    }
+  }
+  if (iree_status_is_ok(status) && !slot->executable) {
+    iree_hal_executable_retain((iree_hal_executable_t*)executable);
+    slot->executable = executable;
+    slot->entry_point = entry_point;
+    iree_task_dispatch_statistics_t discarded_statistics;
+    iree_task_dispatch_statistics_consume(&slot->statistics,
+                                          &discarded_statistics);
+  }
+  if (iree_status_is_ok(status)) {
+    *out_statistics = &slot->statistics;
+  }
+
+  iree_slim_mutex_unlock(&profiler->mutex);
+  return status;
+}
@@ -0,0 +1,82 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_TASK_PROFILER_H_
+#define IREE_HAL_LOCAL_TASK_PROFILER_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/task/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_hal_task_profiler_slot_t iree_hal_task_profiler_slot_t;
+
+// Aggregates iree/task/ dispatch statistics per executable entry point.
+//
+// Command buffers resolve the statistics storage for each dispatch as it is
+// issued and the task system merges the dispatch statistics into it as the
+// dispatch retires. Dispatches issued while no capture is active are not
+// attributed and do not collect statistics. Slot storage is never freed until
+// the profiler is deinitialized so that dispatches still in-flight when a
+// capture ends remain valid; slots are reused by subsequent captures.
+//
+// Thread-safe.
+typedef struct iree_hal_task_profiler_t {
+  iree_allocator_t host_allocator;
+
+  // Nonzero while a capture is active. Checked without the mutex held so that
+  // issuing dispatches has no overhead when not profiling.
+  iree_atomic_int32_t active;
+
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+
+  // Options of the active capture.
+  iree_hal_device_profiling_options_t options;
+
+  // All slots ever allocated, including those retired by prior captures.
+  iree_hal_task_profiler_slot_t* slot_head;
+  iree_host_size_t slot_count;
+} iree_hal_task_profiler_t;
+
+// Initializes |out_profiler| with no active capture.
+void iree_hal_task_profiler_initialize(iree_allocator_t host_allocator,
+                                       iree_hal_task_profiler_t* out_profiler);
+
+// Deinitializes |profiler| and frees all slots. The caller must ensure no
+// dispatches referencing the profiler are in-flight.
+void iree_hal_task_profiler_deinitialize(iree_hal_task_profiler_t* profiler);
+
+// Begins a capture; see iree_hal_device_profiling_begin.
+iree_status_t iree_hal_task_profiler_begin(
+    iree_hal_task_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options);
+
+// Flushes the active capture; see iree_hal_device_profiling_flush.
+iree_status_t iree_hal_task_profiler_flush(iree_hal_task_profiler_t* profiler);
+
+// Ends the active capture; see iree_hal_device_profiling_end.
+iree_status_t iree_hal_task_profiler_end(iree_hal_task_profiler_t* profiler);
+
+// Resolves the statistics storage for |entry_point| of |executable| that
+// dispatches should merge into. Returns NULL in |out_statistics| if no capture
+// is active. The returned storage remains valid until the profiler is
+// deinitialized.
+iree_status_t iree_hal_task_profiler_resolve_statistics(
+    iree_hal_task_profiler_t* profiler, iree_hal_local_executable_t* executable,
+    int32_t entry_point, iree_task_dispatch_statistics_t** out_statistics);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_TASK_PROFILER_H_
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
 #include "iree/base/tracing.h"
@@ -18,22 +19,44 @@
 // Sentinel used the semaphore has failed and an error status is set.
 #define IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE UINT64_MAX
 
+// Number of times a host wait polls the semaphore value before blocking.
+// Signals frequently arrive within microseconds of a host wait beginning (such
+// as when waiting on the tail of a short submission) and spinning briefly
+// avoids the sleep/wake round trip through the kernel.
+#define IREE_HAL_TASK_SEMAPHORE_SPIN_COUNT 512
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_timepoint_t
 //===----------------------------------------------------------------------===//
 
+typedef struct iree_hal_task_semaphore_t iree_hal_task_semaphore_t;
+
+// A group of timepoints across one or more semaphores sharing a single event.
+// Each timepoint reached decrements |pending_count| and the event is signaled
+// when it reaches zero. Waits on all timepoints start with a count equal to
+// the number of timepoints while waits on any start with a count of 1.
+// Sharing the event means that a wait on many semaphores needs only a single
+// event from the pool and a single wait handle.
+typedef struct iree_hal_task_timepoint_group_t {
+  iree_atomic_int32_t pending_count;
+  iree_event_t event;
+} iree_hal_task_timepoint_group_t;
+
 // Represents a point in the timeline that someone is waiting to be reached.
 // When the semaphore is signaled to at least the specified value then the
-// given event will be signaled and the timepoint discarded.
+// timepoint is discarded and its group is notified.
 //
 // Instances are owned and retained by the caller that requested them - usually
 // in the arena associated with the submission, but could be on the stack of a
-// synchronously waiting thread.
+// synchronously waiting thread. Timepoints are notified with the semaphore
+// lock held so after erasing a timepoint (also with the lock held) the caller
+// can be sure no signaler is still referencing it or its group.
 typedef struct iree_hal_task_timepoint_t {
   struct iree_hal_task_timepoint_t* next;
   struct iree_hal_task_timepoint_t* prev;
+  iree_hal_task_semaphore_t* semaphore;
   uint64_t payload_value;
-  iree_event_t event;
+  iree_hal_task_timepoint_group_t* group;
 } iree_hal_task_timepoint_t;
 
 // A doubly-linked FIFO list of timepoints.
@@ -82,6 +105,7 @@ static void iree_hal_task_timepoint_list_erase(
     iree_hal_task_timepoint_list_t* list,
     iree_hal_task_timepoint_t* timepoint) {
   if (timepoint->prev != NULL) timepoint->prev->next = timepoint->next;
+  if (timepoint->next != NULL) timepoint->next->prev = timepoint->prev;
   if (timepoint == list->head) list->head = timepoint->next;
   if (timepoint == list->tail) list->tail = timepoint->prev;
   timepoint->prev = NULL;
@@ -111,8 +135,8 @@ static void iree_hal_task_timepoint_list_take_ready(
 }
 
 // Notifies all of the timepoints in the |ready_list| that their condition has
-// been satisfied. |ready_list| will be reset as ownership of the events is
-// held by the originator.
+// been satisfied. |ready_list| will be reset as ownership of the timepoints is
+// held by the originator. Must be called with the semaphore lock held.
 static void iree_hal_task_timepoint_list_notify_ready(
     iree_hal_task_timepoint_list_t* ready_list) {
   iree_hal_task_timepoint_t* next = ready_list->head;
@@ -121,7 +145,11 @@ static void iree_hal_task_timepoint_list_notify_ready(
     next = timepoint->next;
     timepoint->next = NULL;
     timepoint->prev = NULL;
-    iree_event_set(&timepoint->event);
+    iree_hal_task_timepoint_group_t* group = timepoint->group;
+    if (iree_atomic_fetch_sub_int32(&group->pending_count, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_event_set(&group->event);
+    }
   }
   iree_hal_task_timepoint_list_initialize(ready_list);
 }
@@ -130,7 +158,7 @@ static void iree_hal_task_timepoint_list_notify_ready(
 // iree_hal_task_semaphore_t
 //===----------------------------------------------------------------------===//
 
-typedef struct iree_hal_task_semaphore_t {
+struct iree_hal_task_semaphore_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_event_pool_t* event_pool;
@@ -142,21 +170,22 @@ typedef struct iree_hal_task_semaphore_t {
 
   // Current signaled value. May be IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE to
   // indicate that the semaphore has been signaled for failure and
-  // |failure_status| contains the error.
-  uint64_t current_value;
+  // |failure_status| contains the error. Only modified with |mutex| held but
+  // may be read without it by host waits polling for the value to change.
+  iree_atomic_int64_t current_value;
 
   // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
   iree_status_t failure_status;
 
   // In-process notification signaled when the semaphore value changes. This is
-  // used exclusively for wait-ones to avoid going to the kernel for a full wait
-  // handle operation.
+  // used by host waits to block on a futex (or platform equivalent) instead of
+  // acquiring an event and going through the full wait handle machinery.
   iree_notification_t notification;
 
   // A list of all reserved timepoints waiting for the semaphore to reach a
   // certain payload value.
   iree_hal_task_timepoint_list_t timepoint_list;
-} iree_hal_task_semaphore_t;
+};
 
 static const iree_hal_semaphore_vtable_t iree_hal_task_semaphore_vtable;
 
@@ -166,6 +195,19 @@ static iree_hal_task_semaphore_t* iree_hal_task_semaphore_cast(
   return (iree_hal_task_semaphore_t*)base_value;
 }
 
+static inline uint64_t iree_hal_task_semaphore_load_value(
+    iree_hal_task_semaphore_t* semaphore) {
+  return (uint64_t)iree_atomic_load_int64(&semaphore->current_value,
+                                          iree_memory_order_acquire);
+}
+
+// Stores |value| as the current value. Must be called with the mutex held.
+static inline void iree_hal_task_semaphore_store_value(
+    iree_hal_task_semaphore_t* semaphore, uint64_t value) {
+  iree_atomic_store_int64(&semaphore->current_value, (int64_t)value,
+                          iree_memory_order_release);
+}
+
 iree_status_t iree_hal_task_semaphore_create(
     iree_event_pool_t* event_pool, uint64_t initial_value,
     iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
@@ -184,7 +226,7 @@ iree_status_t iree_hal_task_semaphore_create(
     semaphore->event_pool = event_pool;
 
     iree_slim_mutex_initialize(&semaphore->mutex);
-    semaphore->current_value = initial_value;
+    iree_hal_task_semaphore_store_value(semaphore, initial_value);
     semaphore->failure_status = iree_ok_status();
     iree_notification_initialize(&semaphore->notification);
     iree_hal_task_timepoint_list_initialize(&semaphore->timepoint_list);
@@ -218,7 +260,7 @@ static iree_status_t iree_hal_task_semaphore_query(
 
   iree_slim_mutex_lock(&semaphore->mutex);
 
-  *out_value = semaphore->current_value;
+  *out_value = iree_hal_task_semaphore_load_value(semaphore);
 
   iree_status_t status = iree_ok_status();
   if (*out_value >= IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE) {
@@ -237,8 +279,8 @@ static iree_status_t iree_hal_task_semaphore_signal(
 
   iree_slim_mutex_lock(&semaphore->mutex);
 
-  if (new_value <= semaphore->current_value) {
-    uint64_t current_value IREE_ATTRIBUTE_UNUSED = semaphore->current_value;
+  uint64_t current_value = iree_hal_task_semaphore_load_value(semaphore);
+  if (new_value <= current_value) {
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
                             "semaphore values must be monotonically "
@@ -247,21 +289,19 @@ static iree_status_t iree_hal_task_semaphore_signal(
                             current_value, new_value);
   }
 
-  semaphore->current_value = new_value;
+  iree_hal_task_semaphore_store_value(semaphore, new_value);
 
-  // Scan for all timepoints that are now satisfied and move them to our local
-  // ready list. This way we can notify them without needing to continue holding
-  // the semaphore lock.
+  // Notify all timepoints that are now satisfied. This happens with the lock
+  // held so that waiters erasing their timepoints can't race with us; only the
+  // last timepoint of each group performs a syscall to signal the event.
   iree_hal_task_timepoint_list_t ready_list;
   iree_hal_task_timepoint_list_take_ready(&semaphore->timepoint_list, new_value,
                                           &ready_list);
+  iree_hal_task_timepoint_list_notify_ready(&ready_list);
 
   iree_notification_post(&semaphore->notification, IREE_ALL_WAITERS);
   iree_slim_mutex_unlock(&semaphore->mutex);
 
-  // Notify all waiters - note that this must happen outside the lock.
-  iree_hal_task_timepoint_list_notify_ready(&ready_list);
-
   return iree_ok_status();
 }
 
@@ -282,7 +322,8 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   }
 
   // Signal to our failure sentinel value.
-  semaphore->current_value = IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE;
+  iree_hal_task_semaphore_store_value(semaphore,
+                                      IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE);
   semaphore->failure_status = status;
 
   // Take the whole timepoint list as we'll be signaling all of them. Since
@@ -290,86 +331,181 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   // up.
   iree_hal_task_timepoint_list_t ready_list;
   iree_hal_task_timepoint_list_move(&semaphore->timepoint_list, &ready_list);
+  iree_hal_task_timepoint_list_notify_ready(&ready_list);
 
   iree_notification_post(&semaphore->notification, IREE_ALL_WAITERS);
   iree_slim_mutex_unlock(&semaphore->mutex);
-
-  // Notify all waiters - note that this must happen outside the lock.
-  iree_hal_task_timepoint_list_notify_ready(&ready_list);
 }
 
-// Acquires a timepoint waiting for the given value.
+// Acquires a timepoint waiting for the given value that notifies |group|.
 // |out_timepoint| is owned by the caller and must be kept live until the
-// timepoint has been reached (or it is cancelled by the caller).
-static iree_status_t iree_hal_task_semaphore_acquire_timepoint(
+// timepoint has been reached or erased. Must be called with the lock held.
+static void iree_hal_task_semaphore_acquire_timepoint(
     iree_hal_task_semaphore_t* semaphore, uint64_t minimum_value,
+    iree_hal_task_timepoint_group_t* group,
     iree_hal_task_timepoint_t* out_timepoint) {
   memset(out_timepoint, 0, sizeof(*out_timepoint));
+  out_timepoint->semaphore = semaphore;
   out_timepoint->payload_value = minimum_value;
-  IREE_RETURN_IF_ERROR(
-      iree_event_pool_acquire(semaphore->event_pool, 1, &out_timepoint->event));
+  out_timepoint->group = group;
   iree_hal_task_timepoint_list_append(&semaphore->timepoint_list,
                                       out_timepoint);
-  return iree_ok_status();
+}
+
+// Erases |timepoint| from its semaphore if it has not yet been reached.
+// Upon return no signaler references the timepoint or its group.
+static void iree_hal_task_semaphore_erase_timepoint(
+    iree_hal_task_timepoint_t* timepoint) {
+  iree_hal_task_semaphore_t* semaphore = timepoint->semaphore;
+  iree_slim_mutex_lock(&semaphore->mutex);
+  iree_hal_task_timepoint_list_erase(&semaphore->timepoint_list, timepoint);
+  iree_slim_mutex_unlock(&semaphore->mutex);
 }
 
 typedef struct iree_hal_task_semaphore_wait_cmd_t {
   iree_task_wait_t task;
-  iree_hal_task_semaphore_t* semaphore;
-  iree_hal_task_timepoint_t timepoint;
+  iree_event_pool_t* event_pool;
+  iree_hal_task_timepoint_group_t group;
+  iree_host_size_t timepoint_count;
+  iree_hal_task_timepoint_t timepoints[];
 } iree_hal_task_semaphore_wait_cmd_t;
 
 // Cleans up a wait task by returning the event used to the pool and - if the
-// task failed - ensuring we scrub it from the timepoint list.
+// task failed - ensuring we scrub its timepoints from the semaphores.
 static void iree_hal_task_semaphore_wait_cmd_cleanup(
     iree_task_t* task, iree_status_code_t status_code) {
   iree_hal_task_semaphore_wait_cmd_t* cmd =
       (iree_hal_task_semaphore_wait_cmd_t*)task;
-  iree_event_pool_release(cmd->semaphore->event_pool, 1, &cmd->timepoint.event);
   if (IREE_UNLIKELY(status_code != IREE_STATUS_OK)) {
-    // Abort the timepoint. Note that this is not designed to be fast as
+    // Abort the timepoints. Note that this is not designed to be fast as
     // semaphore failure is an exceptional case.
-    iree_slim_mutex_lock(&cmd->semaphore->mutex);
-    iree_hal_task_timepoint_list_erase(&cmd->semaphore->timepoint_list,
-                                       &cmd->timepoint);
-    iree_slim_mutex_unlock(&cmd->semaphore->mutex);
+    for (iree_host_size_t i = 0; i < cmd->timepoint_count; ++i) {
+      iree_hal_task_semaphore_erase_timepoint(&cmd->timepoints[i]);
+    }
   }
+  iree_event_pool_release(cmd->event_pool, 1, &cmd->group.event);
 }
 
-iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
-    iree_hal_semaphore_t* base_semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission) {
-  iree_hal_task_semaphore_t* semaphore =
-      iree_hal_task_semaphore_cast(base_semaphore);
-
-  iree_slim_mutex_lock(&semaphore->mutex);
-
-  iree_status_t status = iree_ok_status();
-  if (semaphore->current_value >= minimum_value) {
-    // Fast path: already satisfied.
-  } else {
-    // Slow path: acquire a system wait handle and perform a full wait.
-    iree_hal_task_semaphore_wait_cmd_t* cmd = NULL;
-    status = iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd);
-    if (iree_status_is_ok(status)) {
-      status = iree_hal_task_semaphore_acquire_timepoint(
-          semaphore, minimum_value, &cmd->timepoint);
+iree_status_t iree_hal_task_semaphore_enqueue_timepoints(
+    const iree_hal_semaphore_list_t* semaphore_list, iree_task_t* issue_task,
+    iree_arena_allocator_t* arena, iree_task_submission_t* submission) {
+  // Fast path: all already satisfied. As values only ever increase the count
+  // of unsatisfied semaphores is an upper bound on the timepoints required.
+  iree_host_size_t unsatisfied_count = 0;
+  iree_hal_task_semaphore_t* first_semaphore = NULL;
+  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    iree_hal_task_semaphore_t* semaphore =
+        iree_hal_task_semaphore_cast(semaphore_list->semaphores[i]);
+    if (iree_hal_task_semaphore_load_value(semaphore) <
+        semaphore_list->payload_values[i]) {
+      if (!first_semaphore) first_semaphore = semaphore;
+      ++unsatisfied_count;
     }
-    if (iree_status_is_ok(status)) {
-      iree_task_wait_initialize(issue_task->scope,
-                                iree_event_await(&cmd->timepoint.event),
-                                IREE_TIME_INFINITE_FUTURE, &cmd->task);
-      iree_task_set_cleanup_fn(&cmd->task.header,
-                               iree_hal_task_semaphore_wait_cmd_cleanup);
-      iree_task_set_completion_task(&cmd->task.header, issue_task);
-      cmd->semaphore = semaphore;
-      iree_task_submission_enqueue(submission, &cmd->task.header);
+  }
+  if (!unsatisfied_count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, unsatisfied_count);
+
+  // Slow path: reserve a timepoint on each unsatisfied semaphore that all share
+  // a single event and a single wait task.
+  iree_hal_task_semaphore_wait_cmd_t* cmd = NULL;
+  iree_host_size_t total_cmd_size =
+      sizeof(*cmd) + unsatisfied_count * sizeof(cmd->timepoints[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(arena, total_cmd_size, (void**)&cmd));
+  cmd->event_pool = first_semaphore->event_pool;
+  cmd->timepoint_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_event_pool_acquire(cmd->event_pool, 1, &cmd->group.event));
+
+  // Hold an extra count while reserving so that timepoints reached before we
+  // have finished can't signal the event early.
+  iree_atomic_store_int32(&cmd->group.pending_count, 1,
+                          iree_memory_order_relaxed);
+  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    iree_hal_task_semaphore_t* semaphore =
+        iree_hal_task_semaphore_cast(semaphore_list->semaphores[i]);
+    iree_slim_mutex_lock(&semaphore->mutex);
+    if (iree_hal_task_semaphore_load_value(semaphore) <
+        semaphore_list->payload_values[i]) {
+      iree_atomic_fetch_add_int32(&cmd->group.pending_count, 1,
+                                  iree_memory_order_relaxed);
+      iree_hal_task_semaphore_acquire_timepoint(
+          semaphore, semaphore_list->payload_values[i], &cmd->group,
+          &cmd->timepoints[cmd->timepoint_count++]);
     }
+    iree_slim_mutex_unlock(&semaphore->mutex);
+  }
+  if (iree_atomic_fetch_sub_int32(&cmd->group.pending_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    // All timepoints were reached while reserving them; no need to wait.
+    iree_event_pool_release(cmd->event_pool, 1, &cmd->group.event);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
   }
 
-  iree_slim_mutex_unlock(&semaphore->mutex);
-  return status;
+  iree_task_wait_initialize(issue_task->scope,
+                            iree_event_await(&cmd->group.event),
+                            IREE_TIME_INFINITE_FUTURE, &cmd->task);
+  iree_task_set_cleanup_fn(&cmd->task.header,
+                           iree_hal_task_semaphore_wait_cmd_cleanup);
+  iree_task_set_completion_task(&cmd->task.header, issue_task);
+  iree_task_submission_enqueue(submission, &cmd->task.header);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+typedef struct iree_hal_task_semaphore_wait_condition_t {
+  iree_hal_task_semaphore_t* semaphore;
+  uint64_t value;
+} iree_hal_task_semaphore_wait_condition_t;
+
+// Returns true if the semaphore has reached the value or failed.
+static bool iree_hal_task_semaphore_wait_condition_is_met(void* arg) {
+  iree_hal_task_semaphore_wait_condition_t* condition =
+      (iree_hal_task_semaphore_wait_condition_t*)arg;
+  return iree_hal_task_semaphore_load_value(condition->semaphore) >=
+         condition->value;
+}
+
+// Blocks the calling thread until |semaphore| reaches |value|, fails, or
+// |deadline_ns| elapses. Host waits only involve the local semaphore so we
+// avoid the event pool and wait handles entirely: after a short spin the
+// thread blocks on the semaphore notification which is posted on each signal.
+static iree_status_t iree_hal_task_semaphore_wait_until(
+    iree_hal_task_semaphore_t* semaphore, uint64_t value,
+    iree_time_t deadline_ns) {
+  iree_hal_task_semaphore_wait_condition_t condition = {
+      .semaphore = semaphore,
+      .value = value,
+  };
+
+  // Spin for a bit in case the signal is imminent. Polls check only once.
+  const int spin_count = deadline_ns == IREE_TIME_INFINITE_PAST
+                             ? 1
+                             : IREE_HAL_TASK_SEMAPHORE_SPIN_COUNT;
+  bool is_met = false;
+  for (int i = 0; i < spin_count && !is_met; ++i) {
+    is_met = iree_hal_task_semaphore_wait_condition_is_met(&condition);
+  }
+
+  // Block until signaled.
+  if (!is_met) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    is_met = iree_notification_await(
+        &semaphore->notification, iree_hal_task_semaphore_wait_condition_is_met,
+        &condition, iree_make_deadline(deadline_ns));
+    IREE_TRACE_ZONE_END(z0);
+  }
+
+  if (!is_met) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  } else if (iree_hal_task_semaphore_load_value(semaphore) ==
+             IREE_HAL_TASK_SEMAPHORE_FAILURE_VALUE) {
+    return iree_status_from_code(IREE_STATUS_ABORTED);
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_task_semaphore_wait(
@@ -384,39 +520,56 @@ static iree_status_t iree_hal_task_semaphore_wait(
     // Fastest path: failed; return an error to tell callers to query for it.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_ABORTED);
-  } else if (semaphore->current_value >= value) {
+  } else if (iree_hal_task_semaphore_load_value(semaphore) >= value) {
     // Fast path: already satisfied.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_ok_status();
   } else if (iree_timeout_is_immediate(timeout)) {
-    // Not satisfied but a poll, so can avoid the expensive wait handle work.
+    // Not satisfied but a poll, so can avoid the expensive wait work.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
-  // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status =
-      iree_hal_task_semaphore_acquire_timepoint(semaphore, value, &timepoint);
-
   iree_slim_mutex_unlock(&semaphore->mutex);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
 
-  // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_slim_mutex_lock(&semaphore->mutex);
-    iree_hal_task_timepoint_list_erase(&semaphore->timepoint_list, &timepoint);
-    iree_slim_mutex_unlock(&semaphore->mutex);
+  // Slow path: spin and then block on the semaphore notification.
+  return iree_hal_task_semaphore_wait_until(
+      semaphore, value, iree_timeout_as_deadline_ns(timeout));
+}
+
+// Waits for all semaphores in |semaphore_list| to reach their payload values.
+// As all semaphores must be reached we can wait on each in turn with the same
+// deadline and avoid acquiring any wait handles.
+static iree_status_t iree_hal_task_semaphore_multi_wait_all(
+    const iree_hal_semaphore_list_t* semaphore_list, iree_time_t deadline_ns) {
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    iree_hal_task_semaphore_t* semaphore =
+        iree_hal_task_semaphore_cast(semaphore_list->semaphores[i]);
+    status = iree_hal_task_semaphore_wait_until(
+        semaphore, semaphore_list->payload_values[i], deadline_ns);
+    if (!iree_status_is_ok(status)) break;
   }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
   return status;
 }
 
+// Returns true if any semaphore in |semaphore_list| has reached its payload
+// value (or failed) after polling all of them up to |spin_count| times.
+static bool iree_hal_task_semaphore_multi_spin_any(
+    const iree_hal_semaphore_list_t* semaphore_list, int spin_count) {
+  for (int i = 0; i < spin_count; ++i) {
+    for (iree_host_size_t j = 0; j < semaphore_list->count; ++j) {
+      iree_hal_task_semaphore_t* semaphore =
+          iree_hal_task_semaphore_cast(semaphore_list->semaphores[j]);
+      if (iree_hal_task_semaphore_load_value(semaphore) >=
+          semaphore_list->payload_values[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 iree_status_t iree_hal_task_semaphore_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t* semaphore_list, iree_timeout_t timeout,
@@ -430,66 +583,68 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
                                    semaphore_list->payload_values[0], timeout);
   }
 
-  IREE_TRACE_ZONE_BEGIN(z0);
-
   iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+    // Fast-path for wait-all that only needs the semaphore notifications.
+    return iree_hal_task_semaphore_multi_wait_all(semaphore_list, deadline_ns);
+  } else if (iree_hal_task_semaphore_multi_spin_any(
+                 semaphore_list, iree_timeout_is_immediate(timeout)
+                                     ? 1
+                                     : IREE_HAL_TASK_SEMAPHORE_SPIN_COUNT)) {
+    // Fast-path for wait-any when any semaphore was reached during the spin.
+    // Failed semaphores satisfy the spin and are reported by later queries.
+    return iree_ok_status();
+  }
+
+  // Slow path for wait-any: there is no way to block on multiple notifications
+  // so we reserve a timepoint on each semaphore sharing a single event and
+  // wait on that. The first timepoint reached signals the event.
+  IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Avoid heap allocations by using the device block pool for the wait set.
+  // Avoid heap allocations by using the device block pool for the timepoints.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
-  iree_wait_set_t* wait_set = NULL;
-  iree_status_t status = iree_wait_set_allocate(
-      semaphore_list->count, iree_arena_allocator(&arena), &wait_set);
-
-  // Acquire a wait handle for each semaphore timepoint we are to wait on.
-  // TODO(benvanik): flip this API around so we can batch request events from
-  // the event pool. We should be acquiring all required time points in one
-  // call.
+  iree_hal_task_timepoint_group_t group;
+  iree_atomic_store_int32(&group.pending_count, 1, iree_memory_order_relaxed);
   iree_host_size_t timepoint_count = 0;
   iree_hal_task_timepoint_t* timepoints = NULL;
-  iree_host_size_t total_timepoint_size =
-      semaphore_list->count * sizeof(timepoints[0]);
-  status =
-      iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
+  iree_status_t status = iree_arena_allocate(
+      &arena, semaphore_list->count * sizeof(timepoints[0]),
+      (void**)&timepoints);
   if (iree_status_is_ok(status)) {
-    memset(timepoints, 0, total_timepoint_size);
+    status = iree_event_pool_acquire(event_pool, 1, &group.event);
+  }
+  if (iree_status_is_ok(status)) {
+    bool any_satisfied = false;
     for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
       iree_hal_task_semaphore_t* semaphore =
           iree_hal_task_semaphore_cast(semaphore_list->semaphores[i]);
       iree_slim_mutex_lock(&semaphore->mutex);
-      if (semaphore->current_value >= semaphore_list->payload_values[i]) {
+      if (iree_hal_task_semaphore_load_value(semaphore) >=
+          semaphore_list->payload_values[i]) {
         // Fast path: already satisfied.
+        any_satisfied = true;
       } else {
-        // Slow path: get a native wait handle for the timepoint.
-        iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
-        status = iree_hal_task_semaphore_acquire_timepoint(
-            semaphore, semaphore_list->payload_values[i], timepoint);
-        if (iree_status_is_ok(status)) {
-          status = iree_wait_set_insert(wait_set, timepoint->event);
-        }
+        iree_hal_task_semaphore_acquire_timepoint(
+            semaphore, semaphore_list->payload_values[i], &group,
+            &timepoints[timepoint_count++]);
       }
       iree_slim_mutex_unlock(&semaphore->mutex);
-      if (!iree_status_is_ok(status)) break;
+      if (any_satisfied) break;
     }
-  }
 
-  // Perform the wait.
-  if (iree_status_is_ok(status)) {
-    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
-    } else {
-      status = iree_wait_all(wait_set, deadline_ns);
+    // Perform the wait.
+    if (!any_satisfied) {
+      status = iree_wait_one(&group.event, deadline_ns);
     }
-  }
 
-  if (timepoints != NULL) {
-    // TODO(benvanik): if we flip the API to multi-acquire events from the pool
-    // above then we can multi-release here too.
+    // Scrub all timepoints that were not reached. After this no signaler
+    // references the group and the event can be returned to the pool.
     for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
-      iree_event_pool_release(event_pool, 1, &timepoints[i].event);
+      iree_hal_task_semaphore_erase_timepoint(&timepoints[i]);
     }
+    iree_event_pool_release(event_pool, 1, &group.event);
   }
-  iree_wait_set_free(wait_set);
   iree_arena_deinitialize(&arena);
 
   IREE_TRACE_ZONE_END(z0);
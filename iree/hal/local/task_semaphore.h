@@ -26,15 +26,17 @@ iree_status_t iree_hal_task_semaphore_create(
     iree_event_pool_t* event_pool, uint64_t initial_value,
     iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore);
 
-// Reserves a new timepoint in the timeline for the given minimum payload value.
-// |issue_task| will wait until the timeline semaphore is signaled to at least
-// |minimum_value| before proceeding, with a possible wait task generated and
-// appended to the |submission|. Allocations for any intermediates will be made
-// from |arena| whose lifetime must be tied to the submission.
-iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
-    iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission);
+// Reserves new timepoints in the timelines of all semaphores in
+// |semaphore_list| for their given minimum payload values.
+// |issue_task| will wait until all semaphores are signaled to at least their
+// payload values before proceeding, with a possible wait task generated and
+// appended to the |submission|. All timepoints share a single event and wait
+// task regardless of how many semaphores are waited on. Allocations for any
+// intermediates will be made from |arena| whose lifetime must be tied to the
+// submission.
+iree_status_t iree_hal_task_semaphore_enqueue_timepoints(
+    const iree_hal_semaphore_list_t* semaphore_list, iree_task_t* issue_task,
+    iree_arena_allocator_t* arena, iree_task_submission_t* submission);
 
 // Performs a multi-wait on one or more semaphores.
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait does not complete before
@@ -0,0 +1,188 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/dispatch_hotspots.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/tracing.h"
+
+void iree_hal_dispatch_hotspots_initialize(
+    iree_allocator_t host_allocator,
+    iree_hal_dispatch_hotspots_t* out_hotspots) {
+  memset(out_hotspots, 0, sizeof(*out_hotspots));
+  out_hotspots->host_allocator = host_allocator;
+}
+
+void iree_hal_dispatch_hotspots_deinitialize(
+    iree_hal_dispatch_hotspots_t* hotspots) {
+  for (iree_host_size_t i = 0; i < hotspots->count; ++i) {
+    iree_allocator_free(hotspots->host_allocator,
+                        (void*)hotspots->records[i].entry_point_name.data);
+  }
+  iree_allocator_free(hotspots->host_allocator, hotspots->records);
+  memset(hotspots, 0, sizeof(*hotspots));
+}
+
+// Returns the existing entry matching |record| or NULL if none exists.
+static iree_hal_device_profiling_dispatch_record_t*
+iree_hal_dispatch_hotspots_find(
+    iree_hal_dispatch_hotspots_t* hotspots,
+    const iree_hal_device_profiling_dispatch_record_t* record) {
+  for (iree_host_size_t i = 0; i < hotspots->count; ++i) {
+    iree_hal_device_profiling_dispatch_record_t* entry = &hotspots->records[i];
+    if (entry->executable == record->executable &&
+        entry->entry_point == record->entry_point) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Inserts a new entry for |record| with a copy of its entry point name.
+static iree_status_t iree_hal_dispatch_hotspots_insert(
+    iree_hal_dispatch_hotspots_t* hotspots,
+    const iree_hal_device_profiling_dispatch_record_t* record) {
+  if (hotspots->count == hotspots->capacity) {
+    iree_host_size_t new_capacity = iree_max(16, hotspots->capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        hotspots->host_allocator, new_capacity * sizeof(*hotspots->records),
+        (void**)&hotspots->records));
+    hotspots->capacity = new_capacity;
+  }
+  char* name = NULL;
+  if (!iree_string_view_is_empty(record->entry_point_name)) {
+    IREE_RETURN_IF_ERROR(
+        iree_allocator_clone(hotspots->host_allocator,
+                             iree_make_const_byte_span(
+                                 record->entry_point_name.data,
+                                 record->entry_point_name.size),
+                             (void**)&name));
+  }
+  iree_hal_device_profiling_dispatch_record_t* entry =
+      &hotspots->records[hotspots->count++];
+  *entry = *record;
+  entry->entry_point_name =
+      iree_make_string_view(name, name ? record->entry_point_name.size : 0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_dispatch_hotspots_append(
+    iree_hal_dispatch_hotspots_t* hotspots, iree_host_size_t record_count,
+    const iree_hal_device_profiling_dispatch_record_t* records) {
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_device_profiling_dispatch_record_t* record = &records[i];
+    iree_hal_device_profiling_dispatch_record_t* entry =
+        iree_hal_dispatch_hotspots_find(hotspots, record);
+    if (!entry) {
+      IREE_RETURN_IF_ERROR(iree_hal_dispatch_hotspots_insert(hotspots, record));
+      continue;
+    }
+    entry->dispatch_count += record->dispatch_count;
+    entry->workgroup_count += record->workgroup_count;
+    entry->shard_count += record->shard_count;
+    entry->steal_count += record->steal_count;
+    entry->total_time_ns += record->total_time_ns;
+    entry->max_shard_time_ns =
+        iree_max(entry->max_shard_time_ns, record->max_shard_time_ns);
+    entry->local_memory_size =
+        iree_max(entry->local_memory_size, record->local_memory_size);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_dispatch_hotspots_sink_fn(
+    void* user_data, iree_host_size_t record_count,
+    const iree_hal_device_profiling_dispatch_record_t* records) {
+  return iree_hal_dispatch_hotspots_append(
+      (iree_hal_dispatch_hotspots_t*)user_data, record_count, records);
+}
+
+iree_hal_device_profiling_sink_t iree_hal_dispatch_hotspots_sink(
+    iree_hal_dispatch_hotspots_t* hotspots) {
+  iree_hal_device_profiling_sink_t sink = {
+      iree_hal_dispatch_hotspots_sink_fn,
+      hotspots,
+  };
+  return sink;
+}
+
+static int iree_hal_dispatch_hotspots_compare(const void* lhs_ptr,
+                                              const void* rhs_ptr) {
+  const iree_hal_device_profiling_dispatch_record_t* lhs =
+      *(const iree_hal_device_profiling_dispatch_record_t* const*)lhs_ptr;
+  const iree_hal_device_profiling_dispatch_record_t* rhs =
+      *(const iree_hal_device_profiling_dispatch_record_t* const*)rhs_ptr;
+  if (lhs->total_time_ns != rhs->total_time_ns) {
+    return lhs->total_time_ns > rhs->total_time_ns ? -1 : 1;
+  }
+  return (int)(lhs->entry_point - rhs->entry_point);
+}
+
+iree_status_t iree_hal_dispatch_hotspots_fprint(
+    FILE* file, const iree_hal_dispatch_hotspots_t* hotspots,
+    iree_host_size_t max_rows) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Sort indirectly so that the table itself is left unmodified.
+  const iree_hal_device_profiling_dispatch_record_t** sorted = NULL;
+  if (hotspots->count > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(hotspots->host_allocator,
+                                  hotspots->count * sizeof(*sorted),
+                                  (void**)&sorted));
+  }
+  uint64_t total_time_ns = 0;
+  for (iree_host_size_t i = 0; i < hotspots->count; ++i) {
+    sorted[i] = &hotspots->records[i];
+    total_time_ns += hotspots->records[i].total_time_ns;
+  }
+  if (hotspots->count > 0) {
+    qsort((void*)sorted, hotspots->count, sizeof(*sorted),
+          iree_hal_dispatch_hotspots_compare);
+  }
+
+  iree_host_size_t row_count =
+      max_rows ? iree_min(max_rows, hotspots->count) : hotspots->count;
+  fprintf(file, "[[ iree_hal_device_t dispatch hotspots ]]\n");
+  fprintf(file, "%7s %12s %10s %12s %12s %8s %8s %12s %10s  %s\n", "time%",
+          "total_ms", "dispatches", "avg_us", "workgroups", "shards", "steals",
+          "max_shard_us", "local_mem", "entry point");
+  for (iree_host_size_t i = 0; i < row_count; ++i) {
+    const iree_hal_device_profiling_dispatch_record_t* record = sorted[i];
+    double percent = total_time_ns
+                         ? 100.0 * record->total_time_ns / total_time_ns
+                         : 0.0;
+    double avg_us = record->dispatch_count
+                        ? record->total_time_ns / 1000.0 /
+                              record->dispatch_count
+                        : 0.0;
+    fprintf(file,
+            "%6.2f%% %12.3f %10" PRIu64 " %12.3f %12" PRIu64 " %8" PRIu64
+            " %8" PRIu64 " %12.3f %10" PRIu64 "  ",
+            percent, record->total_time_ns / 1000000.0, record->dispatch_count,
+            avg_us, record->workgroup_count, record->shard_count,
+            record->steal_count, record->max_shard_time_ns / 1000.0,
+            record->local_memory_size);
+    if (iree_string_view_is_empty(record->entry_point_name)) {
+      fprintf(file, "<executable %p>:%d\n", (void*)record->executable,
+              record->entry_point);
+    } else {
+      fprintf(file, "%.*s\n", (int)record->entry_point_name.size,
+              record->entry_point_name.data);
+    }
+  }
+  if (row_count < hotspots->count) {
+    fprintf(file, "  ... %" PRIhsz " more entry points elided\n",
+            hotspots->count - row_count);
+  }
+
+  iree_allocator_free(hotspots->host_allocator, (void*)sorted);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
@@ -0,0 +1,64 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_DISPATCH_HOTSPOTS_H_
+#define IREE_HAL_UTILS_DISPATCH_HOTSPOTS_H_
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Accumulates iree_hal_device_profiling_dispatch_record_t records flushed from
+// one or more devices into a per-entry point hotspot table.
+//
+// Records are merged by executable and entry point and the entry point names
+// are copied so that the table remains printable after the executables have
+// been released. The executable pointers are only used as keys and are never
+// dereferenced.
+//
+// Thread-compatible; devices flushing concurrently into the same table must be
+// externally synchronized.
+typedef struct iree_hal_dispatch_hotspots_t {
+  iree_allocator_t host_allocator;
+  iree_host_size_t count;
+  iree_host_size_t capacity;
+  iree_hal_device_profiling_dispatch_record_t* records;
+} iree_hal_dispatch_hotspots_t;
+
+// Initializes an empty hotspot table.
+void iree_hal_dispatch_hotspots_initialize(
+    iree_allocator_t host_allocator,
+    iree_hal_dispatch_hotspots_t* out_hotspots);
+
+// Deinitializes |hotspots| and frees all records.
+void iree_hal_dispatch_hotspots_deinitialize(
+    iree_hal_dispatch_hotspots_t* hotspots);
+
+// Merges |record_count| |records| into |hotspots|.
+iree_status_t iree_hal_dispatch_hotspots_append(
+    iree_hal_dispatch_hotspots_t* hotspots, iree_host_size_t record_count,
+    const iree_hal_device_profiling_dispatch_record_t* records);
+
+// Returns a profiling sink that appends all flushed records to |hotspots|.
+iree_hal_device_profiling_sink_t iree_hal_dispatch_hotspots_sink(
+    iree_hal_dispatch_hotspots_t* hotspots);
+
+// Prints up to |max_rows| entries of the hotspot table to |file| ordered by
+// descending total execution time. A |max_rows| of 0 prints all entries.
+iree_status_t iree_hal_dispatch_hotspots_fprint(
+    FILE* file, const iree_hal_dispatch_hotspots_t* hotspots,
+    iree_host_size_t max_rows);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_DISPATCH_HOTSPOTS_H_
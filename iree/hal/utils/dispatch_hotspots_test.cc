@@ -0,0 +1,81 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/dispatch_hotspots.h"
+
+#include <cstdint>
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+static iree_hal_device_profiling_dispatch_record_t MakeRecord(
+    uintptr_t executable_key, int32_t entry_point, const char* name,
+    uint64_t total_time_ns, uint64_t max_shard_time_ns) {
+  iree_hal_device_profiling_dispatch_record_t record = {};
+  record.executable = reinterpret_cast<iree_hal_executable_t*>(executable_key);
+  record.entry_point = entry_point;
+  record.entry_point_name = iree_make_cstring_view(name);
+  record.dispatch_count = 1;
+  record.workgroup_count = 4;
+  record.shard_count = 2;
+  record.total_time_ns = total_time_ns;
+  record.max_shard_time_ns = max_shard_time_ns;
+  return record;
+}
+
+TEST(DispatchHotspotsTest, Empty) {
+  iree_hal_dispatch_hotspots_t hotspots;
+  iree_hal_dispatch_hotspots_initialize(iree_allocator_system(), &hotspots);
+  EXPECT_EQ(0, hotspots.count);
+  IREE_EXPECT_OK(iree_hal_dispatch_hotspots_fprint(stderr, &hotspots, 0));
+  iree_hal_dispatch_hotspots_deinitialize(&hotspots);
+}
+
+// Records for the same entry point merge across flushes and names are copied
+// so they outlive the flushed records.
+TEST(DispatchHotspotsTest, MergeAcrossFlushes) {
+  iree_hal_dispatch_hotspots_t hotspots;
+  iree_hal_dispatch_hotspots_initialize(iree_allocator_system(), &hotspots);
+  iree_hal_device_profiling_sink_t sink =
+      iree_hal_dispatch_hotspots_sink(&hotspots);
+
+  std::string name_a = "dispatch_a";
+  iree_hal_device_profiling_dispatch_record_t flush0[2] = {
+      MakeRecord(0x10, 0, name_a.c_str(), 1000, 600),
+      MakeRecord(0x10, 1, "dispatch_b", 5000, 2500),
+  };
+  IREE_ASSERT_OK(sink.fn(sink.user_data, IREE_ARRAYSIZE(flush0), flush0));
+  name_a = "clobbered!";
+  iree_hal_device_profiling_dispatch_record_t flush1[1] = {
+      MakeRecord(0x10, 0, "dispatch_a", 3000, 900),
+  };
+  IREE_ASSERT_OK(sink.fn(sink.user_data, IREE_ARRAYSIZE(flush1), flush1));
+
+  ASSERT_EQ(2, hotspots.count);
+  const iree_hal_device_profiling_dispatch_record_t* entry_a =
+      &hotspots.records[0];
+  EXPECT_TRUE(iree_string_view_equal(entry_a->entry_point_name,
+                                     IREE_SV("dispatch_a")));
+  EXPECT_EQ(2, entry_a->dispatch_count);
+  EXPECT_EQ(8, entry_a->workgroup_count);
+  EXPECT_EQ(4, entry_a->shard_count);
+  EXPECT_EQ(4000, entry_a->total_time_ns);
+  EXPECT_EQ(900, entry_a->max_shard_time_ns);
+
+  IREE_EXPECT_OK(iree_hal_dispatch_hotspots_fprint(stderr, &hotspots, 1));
+  iree_hal_dispatch_hotspots_deinitialize(&hotspots);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
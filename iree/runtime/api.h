@@ -14,6 +14,7 @@
 
 // Runtime API:
 #include "iree/runtime/call.h"      // IWYU pragma: export
+#include "iree/runtime/capture.h"   // IWYU pragma: export
 #include "iree/runtime/instance.h"  // IWYU pragma: export
 #include "iree/runtime/session.h"   // IWYU pragma: export
 
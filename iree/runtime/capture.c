@@ -0,0 +1,809 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/capture.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/file_path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/base/string_builder.h"
+#include "iree/base/tracing.h"
+#include "iree/modules/hal/module.h"
+
+// Maximum tensor rank that can be captured. Matches the trace replay limit.
+#define IREE_RUNTIME_CAPTURE_MAX_RANK 16
+
+// Alignment of tensor contents snapshotted within a record.
+#define IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT 16
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_capture_options_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_runtime_capture_options_initialize(
+    iree_runtime_capture_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->output_path = iree_make_cstring_view(".");
+  out_options->sample_interval = 1;
+  out_options->ring_capacity = 64;
+  out_options->max_call_bytes = 0;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_capture_record_t
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_runtime_capture_record_type_e {
+  IREE_RUNTIME_CAPTURE_RECORD_TYPE_CONTEXT_LOAD = 0,
+  IREE_RUNTIME_CAPTURE_RECORD_TYPE_MODULE_LOAD,
+  IREE_RUNTIME_CAPTURE_RECORD_TYPE_CALL,
+} iree_runtime_capture_record_type_t;
+
+// A snapshot of a single call argument.
+typedef struct iree_runtime_capture_arg_t {
+  // Primitive value or null when |contents| is unused.
+  iree_vm_variant_t value;
+  // Tensor metadata and a host copy of the buffer view contents.
+  iree_hal_element_type_t element_type;
+  iree_host_size_t shape_rank;
+  iree_hal_dim_t shape[IREE_RUNTIME_CAPTURE_MAX_RANK];
+  iree_byte_span_t contents;
+} iree_runtime_capture_arg_t;
+
+// A pending event stored in a single allocation along with its strings and
+// argument contents.
+typedef struct iree_runtime_capture_record_t {
+  iree_runtime_capture_record_type_t type;
+  // Ordinal of the call or module used to form unique side-file names.
+  uint64_t ordinal;
+  // MODULE_LOAD: module name; CALL: fully-qualified function name.
+  iree_string_view_t name;
+  // MODULE_LOAD: bytecode module contents to be written as a side-file.
+  iree_const_byte_span_t contents;
+  // CALL: snapshotted arguments.
+  iree_host_size_t arg_count;
+  iree_runtime_capture_arg_t args[];
+} iree_runtime_capture_record_t;
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_capture_t
+//===----------------------------------------------------------------------===//
+
+struct iree_runtime_capture_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Options copied from the creation parameters.
+  iree_string_view_t output_path;
+  uint32_t sample_interval;
+  iree_device_size_t max_call_bytes;
+
+  // Trace file receiving the YAML events. Only used by the writer thread.
+  FILE* trace_file;
+
+  // Total calls observed used to select samples.
+  iree_atomic_int64_t call_counter;
+  // Total modules loaded used to form unique side-file names.
+  iree_atomic_int64_t module_counter;
+  // Statistics reported by iree_runtime_capture_query_statistics.
+  iree_atomic_int64_t captured_count;
+  iree_atomic_int64_t dropped_count;
+
+  // Guards the ring and counters below.
+  iree_slim_mutex_t mutex;
+  // Total records ever enqueued and written for use by flushes.
+  uint64_t enqueued_count IREE_GUARDED_BY(mutex);
+  uint64_t written_count IREE_GUARDED_BY(mutex);
+  // Set when the writer thread should exit after draining the ring.
+  bool exit_requested IREE_GUARDED_BY(mutex);
+  // Fixed-capacity ring of pending records.
+  iree_host_size_t ring_capacity;
+  iree_host_size_t ring_head IREE_GUARDED_BY(mutex);
+  iree_host_size_t ring_count IREE_GUARDED_BY(mutex);
+  iree_runtime_capture_record_t** ring IREE_GUARDED_BY(mutex);
+
+  // Posted when records are enqueued or exit is requested.
+  iree_notification_t pending_notification;
+  // Posted when records have been written and ring space is available.
+  iree_notification_t written_notification;
+
+  // Thread draining the ring and performing all file I/O.
+  iree_thread_t* writer_thread;
+};
+
+static iree_status_t iree_runtime_capture_write_record(
+    iree_runtime_capture_t* capture, iree_runtime_capture_record_t* record);
+
+static bool iree_runtime_capture_has_pending_work(void* arg) {
+  iree_runtime_capture_t* capture = (iree_runtime_capture_t*)arg;
+  iree_slim_mutex_lock(&capture->mutex);
+  bool has_work = capture->ring_count > 0 || capture->exit_requested;
+  iree_slim_mutex_unlock(&capture->mutex);
+  return has_work;
+}
+
+static int iree_runtime_capture_writer_main(void* arg) {
+  iree_runtime_capture_t* capture = (iree_runtime_capture_t*)arg;
+  for (;;) {
+    iree_notification_await(&capture->pending_notification,
+                            iree_runtime_capture_has_pending_work, capture,
+                            iree_infinite_timeout());
+
+    iree_slim_mutex_lock(&capture->mutex);
+    iree_runtime_capture_record_t* record = NULL;
+    if (capture->ring_count > 0) {
+      record = capture->ring[capture->ring_head];
+      capture->ring_head = (capture->ring_head + 1) % capture->ring_capacity;
+      --capture->ring_count;
+    }
+    bool should_exit = !record && capture->exit_requested;
+    iree_slim_mutex_unlock(&capture->mutex);
+    if (should_exit) break;
+
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_runtime_capture_write_record");
+    iree_status_t status = iree_runtime_capture_write_record(capture, record);
+    if (!iree_status_is_ok(status)) {
+      // Nowhere to report the failure; the record is lost.
+      iree_atomic_fetch_add_int64(&capture->dropped_count, 1,
+                                  iree_memory_order_relaxed);
+      iree_status_ignore(status);
+    }
+    iree_allocator_free(capture->host_allocator, record);
+
+    // Flush each record so that iree_runtime_capture_flush observes it on disk
+    // and a crashing application still leaves a usable trace behind.
+    fflush(capture->trace_file);
+
+    iree_slim_mutex_lock(&capture->mutex);
+    ++capture->written_count;
+    iree_slim_mutex_unlock(&capture->mutex);
+    iree_notification_post(&capture->written_notification, IREE_ALL_WAITERS);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  return 0;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_capture_create(
+    const iree_runtime_capture_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_capture_t** out_capture) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_capture);
+  *out_capture = NULL;
+#if !IREE_FILE_IO_ENABLE
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "invocation capture requires file I/O");
+#else
+  if (options->ring_capacity == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "capture ring capacity must be non-zero");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Allocate the capture with the ring and output path stored inline.
+  iree_runtime_capture_t* capture = NULL;
+  iree_host_size_t ring_size = options->ring_capacity * sizeof(*capture->ring);
+  iree_host_size_t total_size =
+      sizeof(*capture) + ring_size + options->output_path.size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&capture));
+  memset(capture, 0, total_size);
+  iree_atomic_ref_count_init(&capture->ref_count);
+  capture->host_allocator = host_allocator;
+  capture->sample_interval = options->sample_interval;
+  capture->max_call_bytes = options->max_call_bytes;
+  capture->ring_capacity = options->ring_capacity;
+  capture->ring = (iree_runtime_capture_record_t**)((uint8_t*)capture +
+                                                    sizeof(*capture));
+  char* output_path_buffer = (char*)capture->ring + ring_size;
+  memcpy(output_path_buffer, options->output_path.data,
+         options->output_path.size);
+  capture->output_path =
+      iree_make_string_view(output_path_buffer, options->output_path.size);
+  iree_slim_mutex_initialize(&capture->mutex);
+  iree_notification_initialize(&capture->pending_notification);
+  iree_notification_initialize(&capture->written_notification);
+
+  // Open the trace file; this truncates any existing trace.
+  char* trace_path = NULL;
+  iree_status_t status =
+      iree_file_path_join(capture->output_path,
+                          iree_make_cstring_view("calls.yaml"), host_allocator,
+                          &trace_path);
+  if (iree_status_is_ok(status)) {
+    capture->trace_file = fopen(trace_path, "wb");
+    if (!capture->trace_file) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to open capture trace file '%s'",
+                                trace_path);
+    }
+    iree_allocator_free(host_allocator, trace_path);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = iree_make_cstring_view("iree-capture");
+    params.priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+    status = iree_thread_create(iree_runtime_capture_writer_main, capture,
+                                params, host_allocator,
+                                &capture->writer_thread);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_capture = capture;
+  } else {
+    iree_runtime_capture_release(capture);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#endif  // !IREE_FILE_IO_ENABLE
+}
+
+static void iree_runtime_capture_destroy(iree_runtime_capture_t* capture) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Request the writer exit and join it; it will drain the ring first.
+  if (capture->writer_thread) {
+    iree_slim_mutex_lock(&capture->mutex);
+    capture->exit_requested = true;
+    iree_slim_mutex_unlock(&capture->mutex);
+    iree_notification_post(&capture->pending_notification, IREE_ALL_WAITERS);
+    iree_thread_release(capture->writer_thread);
+  }
+
+  // Free any records left if the writer never started.
+  for (iree_host_size_t i = 0; i < capture->ring_count; ++i) {
+    iree_allocator_free(
+        capture->host_allocator,
+        capture->ring[(capture->ring_head + i) % capture->ring_capacity]);
+  }
+
+  if (capture->trace_file) fclose(capture->trace_file);
+  iree_notification_deinitialize(&capture->written_notification);
+  iree_notification_deinitialize(&capture->pending_notification);
+  iree_slim_mutex_deinitialize(&capture->mutex);
+  iree_allocator_free(capture->host_allocator, capture);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_runtime_capture_retain(
+    iree_runtime_capture_t* capture) {
+  if (capture) {
+    iree_atomic_ref_count_inc(&capture->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_runtime_capture_release(
+    iree_runtime_capture_t* capture) {
+  if (capture && iree_atomic_ref_count_dec(&capture->ref_count) == 1) {
+    iree_runtime_capture_destroy(capture);
+  }
+}
+
+typedef struct iree_runtime_capture_flush_state_t {
+  iree_runtime_capture_t* capture;
+  uint64_t target_count;
+} iree_runtime_capture_flush_state_t;
+
+static bool iree_runtime_capture_is_flushed(void* arg) {
+  iree_runtime_capture_flush_state_t* state =
+      (iree_runtime_capture_flush_state_t*)arg;
+  iree_slim_mutex_lock(&state->capture->mutex);
+  bool is_flushed = state->capture->written_count >= state->target_count;
+  iree_slim_mutex_unlock(&state->capture->mutex);
+  return is_flushed;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_runtime_capture_flush(iree_runtime_capture_t* capture) {
+  IREE_ASSERT_ARGUMENT(capture);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_runtime_capture_flush_state_t state = {
+      .capture = capture,
+  };
+  iree_slim_mutex_lock(&capture->mutex);
+  state.target_count = capture->enqueued_count;
+  iree_slim_mutex_unlock(&capture->mutex);
+  iree_notification_await(&capture->written_notification,
+                          iree_runtime_capture_is_flushed, &state,
+                          iree_infinite_timeout());
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void iree_runtime_capture_query_statistics(
+    iree_runtime_capture_t* capture, uint64_t* out_captured_count,
+    uint64_t* out_dropped_count) {
+  IREE_ASSERT_ARGUMENT(capture);
+  if (out_captured_count) {
+    *out_captured_count = (uint64_t)iree_atomic_load_int64(
+        &capture->captured_count, iree_memory_order_relaxed);
+  }
+  if (out_dropped_count) {
+    *out_dropped_count = (uint64_t)iree_atomic_load_int64(
+        &capture->dropped_count, iree_memory_order_relaxed);
+  }
+}
+
+static bool iree_runtime_capture_has_ring_space(void* arg) {
+  iree_runtime_capture_t* capture = (iree_runtime_capture_t*)arg;
+  iree_slim_mutex_lock(&capture->mutex);
+  bool has_space = capture->ring_count < capture->ring_capacity;
+  iree_slim_mutex_unlock(&capture->mutex);
+  return has_space;
+}
+
+// Enqueues |record| for writing, transferring ownership to the capture.
+// If the ring is full and |may_block| is false then the record is freed and
+// IREE_STATUS_RESOURCE_EXHAUSTED is returned. Otherwise the caller blocks until
+// the writer has made space.
+static iree_status_t iree_runtime_capture_enqueue(
+    iree_runtime_capture_t* capture, iree_runtime_capture_record_t* record,
+    bool may_block) {
+  for (;;) {
+    iree_slim_mutex_lock(&capture->mutex);
+    if (capture->ring_count < capture->ring_capacity) {
+      iree_host_size_t tail = (capture->ring_head + capture->ring_count) %
+                              capture->ring_capacity;
+      capture->ring[tail] = record;
+      ++capture->ring_count;
+      ++capture->enqueued_count;
+      iree_slim_mutex_unlock(&capture->mutex);
+      iree_notification_post(&capture->pending_notification, 1);
+      return iree_ok_status();
+    }
+    iree_slim_mutex_unlock(&capture->mutex);
+    if (!may_block) {
+      iree_allocator_free(capture->host_allocator, record);
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "capture ring full");
+    }
+    iree_notification_await(&capture->written_notification,
+                            iree_runtime_capture_has_ring_space, capture,
+                            iree_infinite_timeout());
+  }
+}
+
+// Allocates a record with |extra_size| bytes of trailing storage for
+// |arg_count| args followed by strings and contents.
+static iree_status_t iree_runtime_capture_allocate_record(
+    iree_runtime_capture_t* capture, iree_runtime_capture_record_type_t type,
+    iree_host_size_t arg_count, iree_host_size_t extra_size,
+    iree_runtime_capture_record_t** out_record, uint8_t** out_storage) {
+  iree_runtime_capture_record_t* record = NULL;
+  iree_host_size_t header_size =
+      iree_host_align(sizeof(*record) + arg_count * sizeof(record->args[0]),
+                      IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT);
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      capture->host_allocator, header_size + extra_size, (void**)&record));
+  memset(record, 0, header_size);
+  record->type = type;
+  record->arg_count = arg_count;
+  *out_record = record;
+  *out_storage = (uint8_t*)record + header_size;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t
+iree_runtime_capture_record_context_load(iree_runtime_capture_t* capture) {
+  IREE_ASSERT_ARGUMENT(capture);
+  iree_runtime_capture_record_t* record = NULL;
+  uint8_t* storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_runtime_capture_allocate_record(
+      capture, IREE_RUNTIME_CAPTURE_RECORD_TYPE_CONTEXT_LOAD, 0, 0, &record,
+      &storage));
+  return iree_runtime_capture_enqueue(capture, record, /*may_block=*/true);
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_capture_record_module_load(
+    iree_runtime_capture_t* capture, iree_vm_module_t* module,
+    iree_const_byte_span_t flatbuffer_data) {
+  IREE_ASSERT_ARGUMENT(capture);
+  IREE_ASSERT_ARGUMENT(module);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_string_view_t module_name = iree_vm_module_name(module);
+
+  uint64_t ordinal = (uint64_t)iree_atomic_fetch_add_int64(
+      &capture->module_counter, 1, iree_memory_order_relaxed);
+
+  // Module loads are infrequent and the data may not outlive the call so the
+  // module contents are copied into the record and written as a side-file by
+  // the writer thread. This keeps the trace self-contained.
+  iree_runtime_capture_record_t* record = NULL;
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_runtime_capture_allocate_record(
+              capture, IREE_RUNTIME_CAPTURE_RECORD_TYPE_MODULE_LOAD, 0,
+              iree_host_align(flatbuffer_data.data_length,
+                              IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT) +
+                  module_name.size,
+              &record, &storage));
+  record->ordinal = ordinal;
+  memcpy(storage, flatbuffer_data.data, flatbuffer_data.data_length);
+  record->contents =
+      iree_make_const_byte_span(storage, flatbuffer_data.data_length);
+  storage += iree_host_align(flatbuffer_data.data_length,
+                             IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT);
+  memcpy(storage, module_name.data, module_name.size);
+  record->name = iree_make_string_view((const char*)storage, module_name.size);
+
+  iree_status_t status =
+      iree_runtime_capture_enqueue(capture, record, /*may_block=*/true);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Snapshots the inputs of a call into a new record.
+static iree_status_t iree_runtime_capture_snapshot_call(
+    iree_runtime_capture_t* capture, const iree_vm_function_t* function,
+    iree_vm_list_t* input_list, uint64_t ordinal,
+    iree_runtime_capture_record_t** out_record) {
+  *out_record = NULL;
+  iree_string_view_t module_name = iree_vm_module_name(function->module);
+  iree_string_view_t function_name = iree_vm_function_name(function);
+  iree_host_size_t arg_count = input_list ? iree_vm_list_size(input_list) : 0;
+
+  // Compute the storage required for the names and tensor contents.
+  iree_host_size_t contents_size = 0;
+  for (iree_host_size_t i = 0; i < arg_count; ++i) {
+    iree_vm_variant_t variant = iree_vm_variant_empty();
+    IREE_RETURN_IF_ERROR(iree_vm_list_get_variant(input_list, i, &variant));
+    if (iree_vm_variant_is_ref(variant) &&
+        iree_hal_buffer_view_isa(variant.ref)) {
+      iree_hal_buffer_view_t* buffer_view =
+          iree_hal_buffer_view_deref(variant.ref);
+      contents_size +=
+          iree_host_align(iree_hal_buffer_view_byte_length(buffer_view),
+                          IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT);
+    }
+  }
+  if (capture->max_call_bytes > 0 && contents_size > capture->max_call_bytes) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "call inputs exceed the capture limit");
+  }
+  iree_host_size_t name_size = module_name.size + 1 + function_name.size;
+
+  iree_runtime_capture_record_t* record = NULL;
+  uint8_t* storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_runtime_capture_allocate_record(
+      capture, IREE_RUNTIME_CAPTURE_RECORD_TYPE_CALL, arg_count,
+      contents_size + name_size, &record, &storage));
+  record->ordinal = ordinal;
+
+  // Copy tensor contents first to keep them aligned.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < arg_count && iree_status_is_ok(status);
+       ++i) {
+    iree_runtime_capture_arg_t* arg = &record->args[i];
+    iree_vm_variant_t variant = iree_vm_variant_empty();
+    status = iree_vm_list_get_variant(input_list, i, &variant);
+    if (!iree_status_is_ok(status)) break;
+    if (iree_vm_variant_is_value(variant)) {
+      arg->value = variant;
+    } else if (iree_vm_variant_is_ref(variant) &&
+               iree_hal_buffer_view_isa(variant.ref)) {
+      iree_hal_buffer_view_t* buffer_view =
+          iree_hal_buffer_view_deref(variant.ref);
+      iree_host_size_t shape_rank =
+          iree_hal_buffer_view_shape_rank(buffer_view);
+      if (shape_rank > IREE_ARRAYSIZE(arg->shape)) {
+        status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                  "capture shape rank overflow (>%zu)",
+                                  IREE_ARRAYSIZE(arg->shape));
+        break;
+      }
+      arg->element_type = iree_hal_buffer_view_element_type(buffer_view);
+      arg->shape_rank = shape_rank;
+      memcpy(arg->shape, iree_hal_buffer_view_shape_dims(buffer_view),
+             shape_rank * sizeof(arg->shape[0]));
+      iree_host_size_t byte_length =
+          (iree_host_size_t)iree_hal_buffer_view_byte_length(buffer_view);
+      arg->contents = iree_make_byte_span(storage, byte_length);
+      storage += iree_host_align(byte_length,
+                                 IREE_RUNTIME_CAPTURE_CONTENTS_ALIGNMENT);
+      status = iree_hal_buffer_map_read(
+          iree_hal_buffer_view_buffer(buffer_view), 0, arg->contents.data,
+          byte_length);
+    } else {
+      // Unsupported types (lists, custom refs) are recorded as null.
+      memset(&arg->value, 0, sizeof(arg->value));
+    }
+  }
+
+  // Fully-qualified function name: `module.function`.
+  char* name_buffer = (char*)storage;
+  memcpy(name_buffer, module_name.data, module_name.size);
+  name_buffer[module_name.size] = '.';
+  memcpy(name_buffer + module_name.size + 1, function_name.data,
+         function_name.size);
+  record->name = iree_make_string_view(name_buffer, name_size);
+
+  if (iree_status_is_ok(status)) {
+    *out_record = record;
+  } else {
+    iree_allocator_free(capture->host_allocator, record);
+  }
+  return status;
+}
+
+IREE_API_EXPORT void iree_runtime_capture_record_call(
+    iree_runtime_capture_t* capture, const iree_vm_function_t* function,
+    iree_vm_list_t* input_list) {
+  IREE_ASSERT_ARGUMENT(capture);
+  IREE_ASSERT_ARGUMENT(function);
+  if (capture->sample_interval == 0) return;
+  uint64_t ordinal = (uint64_t)iree_atomic_fetch_add_int64(
+      &capture->call_counter, 1, iree_memory_order_relaxed);
+  if (ordinal % capture->sample_interval != 0) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_runtime_capture_record_t* record = NULL;
+  iree_status_t status = iree_runtime_capture_snapshot_call(
+      capture, function, input_list, ordinal, &record);
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_capture_enqueue(capture, record,
+                                          /*may_block=*/false);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_atomic_fetch_add_int64(&capture->captured_count, 1,
+                                iree_memory_order_relaxed);
+  } else {
+    iree_atomic_fetch_add_int64(&capture->dropped_count, 1,
+                                iree_memory_order_relaxed);
+    iree_status_ignore(status);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// Trace writing (writer thread only)
+//===----------------------------------------------------------------------===//
+
+// Returns the .npy dtype descriptor for |element_type| or NULL if it has no
+// equivalent, in which case the contents are written as raw binary.
+static const char* iree_runtime_capture_npy_descr(
+    iree_hal_element_type_t element_type) {
+  switch (element_type) {
+#if defined(IREE_ENDIANNESS_LITTLE)
+#define IREE_CAPTURE_NPY_ENDIAN "<"
+#else
+#define IREE_CAPTURE_NPY_ENDIAN ">"
+#endif  // IREE_ENDIANNESS_LITTLE
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+      return IREE_CAPTURE_NPY_ENDIAN "f2";
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+      return IREE_CAPTURE_NPY_ENDIAN "f4";
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+      return IREE_CAPTURE_NPY_ENDIAN "f8";
+    case IREE_HAL_ELEMENT_TYPE_INT_8:
+    case IREE_HAL_ELEMENT_TYPE_SINT_8:
+      return "|i1";
+    case IREE_HAL_ELEMENT_TYPE_UINT_8:
+      return "|u1";
+    case IREE_HAL_ELEMENT_TYPE_INT_16:
+    case IREE_HAL_ELEMENT_TYPE_SINT_16:
+      return IREE_CAPTURE_NPY_ENDIAN "i2";
+    case IREE_HAL_ELEMENT_TYPE_UINT_16:
+      return IREE_CAPTURE_NPY_ENDIAN "u2";
+    case IREE_HAL_ELEMENT_TYPE_INT_32:
+    case IREE_HAL_ELEMENT_TYPE_SINT_32:
+      return IREE_CAPTURE_NPY_ENDIAN "i4";
+    case IREE_HAL_ELEMENT_TYPE_UINT_32:
+      return IREE_CAPTURE_NPY_ENDIAN "u4";
+    case IREE_HAL_ELEMENT_TYPE_INT_64:
+    case IREE_HAL_ELEMENT_TYPE_SINT_64:
+      return IREE_CAPTURE_NPY_ENDIAN "i8";
+    case IREE_HAL_ELEMENT_TYPE_UINT_64:
+      return IREE_CAPTURE_NPY_ENDIAN "u8";
+#undef IREE_CAPTURE_NPY_ENDIAN
+    default:
+      return NULL;
+  }
+}
+
+// Writes |arg| contents to a new side-file at |path|.
+// When |npy_descr| is provided a version 1.0 .npy header is emitted first.
+static iree_status_t iree_runtime_capture_write_side_file(
+    const char* path, const char* npy_descr,
+    const iree_runtime_capture_arg_t* arg) {
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open capture side-file '%s'", path);
+  }
+
+  bool did_write = true;
+  if (npy_descr) {
+    // The header dictionary is padded with spaces and terminated with a
+    // newline such that the data starts on a 64 byte boundary.
+    char header[512];
+    int header_length = snprintf(header, sizeof(header),
+                                 "{'descr': '%s', 'fortran_order': False, "
+                                 "'shape': (",
+                                 npy_descr);
+    for (iree_host_size_t i = 0; i < arg->shape_rank; ++i) {
+      header_length += snprintf(header + header_length,
+                                sizeof(header) - header_length, "%" PRIu64 ",",
+                                (uint64_t)arg->shape[i]);
+    }
+    header_length += snprintf(header + header_length,
+                              sizeof(header) - header_length, "), }");
+    iree_host_size_t padded_length =
+        iree_host_align(10 + header_length + 1, 64) - 10;
+    memset(header + header_length, ' ', padded_length - header_length - 1);
+    header[padded_length - 1] = '\n';
+    const uint8_t preamble[10] = {
+        0x93,
+        'N',
+        'U',
+        'M',
+        'P',
+        'Y',
+        1,
+        0,
+        (uint8_t)(padded_length & 0xFF),
+        (uint8_t)((padded_length >> 8) & 0xFF),
+    };
+    did_write = fwrite(preamble, sizeof(preamble), 1, file) == 1 &&
+                fwrite(header, padded_length, 1, file) == 1;
+  }
+  if (did_write && arg->contents.data_length > 0) {
+    did_write = fwrite(arg->contents.data, arg->contents.data_length, 1,
+                       file) == 1;
+  }
+
+  fclose(file);
+  return did_write ? iree_ok_status()
+                   : iree_make_status(IREE_STATUS_DATA_LOSS,
+                                      "failed to write capture side-file '%s'",
+                                      path);
+}
+
+// Writes a captured argument as a trace item into |builder|, emitting its
+// side-file if needed.
+static iree_status_t iree_runtime_capture_write_arg(
+    iree_runtime_capture_t* capture, uint64_t call_ordinal,
+    iree_host_size_t arg_index, const iree_runtime_capture_arg_t* arg,
+    iree_string_builder_t* builder) {
+  if (arg->element_type == IREE_HAL_ELEMENT_TYPE_NONE) {
+    switch (arg->value.type.value_type) {
+      case IREE_VM_VALUE_TYPE_I8:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  i8: %" PRIi8 "\n", arg->value.i8);
+      case IREE_VM_VALUE_TYPE_I16:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  i16: %" PRIi16 "\n", arg->value.i16);
+      case IREE_VM_VALUE_TYPE_I32:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  i32: %" PRIi32 "\n", arg->value.i32);
+      case IREE_VM_VALUE_TYPE_I64:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  i64: %" PRIi64 "\n", arg->value.i64);
+      case IREE_VM_VALUE_TYPE_F32:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  f32: %.9g\n", arg->value.f32);
+      case IREE_VM_VALUE_TYPE_F64:
+        return iree_string_builder_append_format(
+            builder, "- type: value\n  f64: %.17g\n", arg->value.f64);
+      default:
+        return iree_string_builder_append_cstring(builder, "- type: null\n");
+    }
+  }
+
+  // Tensors are written as side-files with the metadata duplicated in the
+  // trace so that element types without a .npy equivalent still replay.
+  const char* npy_descr = iree_runtime_capture_npy_descr(arg->element_type);
+  char side_file_name[128];
+  snprintf(side_file_name, sizeof(side_file_name),
+           "call_%06" PRIu64 "_arg%zu.%s", call_ordinal, arg_index,
+           npy_descr ? "npy" : "bin");
+  char* full_path = NULL;
+  IREE_RETURN_IF_ERROR(iree_file_path_join(
+      capture->output_path, iree_make_cstring_view(side_file_name),
+      capture->host_allocator, &full_path));
+  iree_status_t status =
+      iree_runtime_capture_write_side_file(full_path, npy_descr, arg);
+  iree_allocator_free(capture->host_allocator, full_path);
+  IREE_RETURN_IF_ERROR(status);
+
+  char element_type_str[32];
+  iree_host_size_t element_type_length = 0;
+  IREE_RETURN_IF_ERROR(iree_hal_format_element_type(
+      arg->element_type, sizeof(element_type_str), element_type_str,
+      &element_type_length));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "- type: hal.buffer_view\n  element_type: %.*s\n  shape: [",
+      (int)element_type_length, element_type_str));
+  for (iree_host_size_t i = 0; i < arg->shape_rank; ++i) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, i > 0 ? ", %" PRIu64 : "%" PRIu64, (uint64_t)arg->shape[i]));
+  }
+  return iree_string_builder_append_format(
+      builder, "]\n  contents_file: %s\n", side_file_name);
+}
+
+// Formats the YAML document for |record| into |builder| and writes any
+// side-files it references.
+static iree_status_t iree_runtime_capture_format_record(
+    iree_runtime_capture_t* capture, iree_runtime_capture_record_t* record,
+    iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, "---\n"));
+  switch (record->type) {
+    case IREE_RUNTIME_CAPTURE_RECORD_TYPE_CONTEXT_LOAD:
+      return iree_string_builder_append_cstring(builder,
+                                                "type: context_load\n");
+    case IREE_RUNTIME_CAPTURE_RECORD_TYPE_MODULE_LOAD: {
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+          builder, "type: module_load\nmodule:\n  name: %.*s\n",
+          (int)record->name.size, record->name.data));
+      if (record->contents.data_length == 0) {
+        // Only the HAL module can be reconstructed by replay; other native
+        // modules are recorded so that the trace fails clearly when replayed.
+        if (iree_string_view_equal(record->name,
+                                   iree_make_cstring_view("hal"))) {
+          return iree_string_builder_append_cstring(builder,
+                                                    "  type: builtin\n");
+        }
+        return iree_string_builder_append_cstring(builder, "  type: native\n");
+      }
+      char side_file_name[128];
+      snprintf(side_file_name, sizeof(side_file_name),
+               "module_%" PRIu64 ".vmfb", record->ordinal);
+      char* full_path = NULL;
+      IREE_RETURN_IF_ERROR(iree_file_path_join(
+          capture->output_path, iree_make_cstring_view(side_file_name),
+          capture->host_allocator, &full_path));
+      iree_status_t status =
+          iree_file_write_contents(full_path, record->contents);
+      iree_allocator_free(capture->host_allocator, full_path);
+      IREE_RETURN_IF_ERROR(status);
+      return iree_string_builder_append_format(
+          builder, "  type: bytecode\n  path: %s\n", side_file_name);
+    }
+    case IREE_RUNTIME_CAPTURE_RECORD_TYPE_CALL:
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+          builder, "type: call\nfunction: %.*s\nargs:%s\n",
+          (int)record->name.size, record->name.data,
+          record->arg_count ? "" : " []"));
+      for (iree_host_size_t i = 0; i < record->arg_count; ++i) {
+        IREE_RETURN_IF_ERROR(iree_runtime_capture_write_arg(
+            capture, record->ordinal, i, &record->args[i], builder));
+      }
+      return iree_ok_status();
+  }
+  return iree_ok_status();
+}
+
+// Writes |record| to the trace. The document is buffered and only appended
+// once all of its side-files have been written so that a failure never leaves
+// a partial document or a reference to a missing file in the trace.
+static iree_status_t iree_runtime_capture_write_record(
+    iree_runtime_capture_t* capture, iree_runtime_capture_record_t* record) {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(capture->host_allocator, &builder);
+  iree_status_t status =
+      iree_runtime_capture_format_record(capture, record, &builder);
+  if (iree_status_is_ok(status) &&
+      fwrite(iree_string_builder_buffer(&builder),
+             iree_string_builder_size(&builder), 1,
+             capture->trace_file) != 1) {
+    status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "failed to write capture trace");
+  }
+  iree_string_builder_deinitialize(&builder);
+  return status;
+}
@@ -0,0 +1,125 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_RUNTIME_CAPTURE_H_
+#define IREE_RUNTIME_CAPTURE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_capture_options_t
+//===----------------------------------------------------------------------===//
+
+// Options used to configure invocation capture.
+typedef struct iree_runtime_capture_options_t {
+  // Directory the trace and its side-files are written into. Must exist.
+  // The trace itself is written to `calls.yaml` in the iree-run-trace format
+  // with tensor contents stored as `.npy` side-files next to it.
+  iree_string_view_t output_path;
+
+  // Captures one out of every |sample_interval| calls. 1 captures every call
+  // and 0 disables call capture while still recording module loads.
+  uint32_t sample_interval;
+
+  // Maximum number of captured events pending write. When the ring is full new
+  // call samples are dropped instead of blocking the caller.
+  iree_host_size_t ring_capacity;
+
+  // Calls with total tensor contents larger than this are dropped instead of
+  // captured. 0 indicates no limit.
+  iree_device_size_t max_call_bytes;
+} iree_runtime_capture_options_t;
+
+// Initializes |out_options| to its default values.
+IREE_API_EXPORT void iree_runtime_capture_options_initialize(
+    iree_runtime_capture_options_t* out_options);
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_capture_t
+//===----------------------------------------------------------------------===//
+
+// Captures runtime session activity into a replayable trace.
+//
+// Attach a capture to a session with iree_runtime_session_options_t::capture
+// and module loads and sampled calls through iree_runtime_session_call (and the
+// iree_runtime_call_t and by-name wrappers of it) are recorded. The output can
+// be replayed with iree-run-trace and iree-benchmark-trace to reproduce the
+// exact call sequence and inputs observed in the application.
+//
+// Inputs of sampled calls are copied into host memory on the calling thread
+// before the call is issued and pushed into a fixed-capacity ring; module
+// contents are copied the same way on load. A background thread drains the
+// ring and writes the trace and all side-files so that file I/O never happens
+// on the calling thread. Each event is appended to the trace only after all of
+// its side-files have been written. Calls that are not sampled pay only for an
+// atomic increment.
+//
+// Direct calls made with iree_runtime_session_call_direct are not captured.
+//
+// Thread-safe; multiple sessions may share the same capture though their
+// events will be interleaved in a single trace.
+typedef struct iree_runtime_capture_t iree_runtime_capture_t;
+
+// Creates a new capture writing into |options|.output_path and starts its
+// writer thread. |out_capture| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_runtime_capture_create(
+    const iree_runtime_capture_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_capture_t** out_capture);
+
+// Retains the given |capture| for the caller.
+IREE_API_EXPORT void iree_runtime_capture_retain(
+    iree_runtime_capture_t* capture);
+
+// Releases the given |capture| from the caller.
+// All pending events are written before the capture is destroyed.
+IREE_API_EXPORT void iree_runtime_capture_release(
+    iree_runtime_capture_t* capture);
+
+// Blocks until all events captured prior to the call have been written.
+IREE_API_EXPORT iree_status_t
+iree_runtime_capture_flush(iree_runtime_capture_t* capture);
+
+// Returns the total number of calls captured and the number of sampled calls
+// that were dropped because the ring was full or the call was too large.
+IREE_API_EXPORT void iree_runtime_capture_query_statistics(
+    iree_runtime_capture_t* capture, uint64_t* out_captured_count,
+    uint64_t* out_dropped_count);
+
+// Records a new context with no modules loaded.
+IREE_API_EXPORT iree_status_t
+iree_runtime_capture_record_context_load(iree_runtime_capture_t* capture);
+
+// Records a module load of |module|.
+// If |flatbuffer_data| is non-empty it is copied and written as a new `.vmfb`
+// side-file. Otherwise the `hal` module is recorded as a builtin and any other
+// module as a native module. Native modules cannot be reconstructed and
+// replaying a trace fails when it reaches their load; capturing never fails
+// because of them.
+IREE_API_EXPORT iree_status_t iree_runtime_capture_record_module_load(
+    iree_runtime_capture_t* capture, iree_vm_module_t* module,
+    iree_const_byte_span_t flatbuffer_data);
+
+// Records a call to |function| with the given |input_list| if sampled.
+// Must be called prior to issuing the call so that the inputs are captured
+// before the callee has an opportunity to modify them. Failing to capture is
+// never fatal to the call and is reported via the statistics.
+IREE_API_EXPORT void iree_runtime_capture_record_call(
+    iree_runtime_capture_t* capture, const iree_vm_function_t* function,
+    iree_vm_list_t* input_list);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_RUNTIME_CAPTURE_H_
@@ -61,6 +61,9 @@ struct iree_runtime_session_t {
   // lookup. An application directly using the API may never need this, or could
   // perform VM calls into HAL module exports to gain more portability.
   iree_vm_module_state_t* hal_module_state;
+
+  // Optional capture receiving module loads and calls made on the session.
+  iree_runtime_capture_t* capture;
 };
 
 IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
@@ -85,10 +88,16 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
   session->instance = instance;
   iree_runtime_instance_retain(session->instance);
 
+  session->capture = options->capture;
+  iree_runtime_capture_retain(session->capture);
+
   // Create the context empty so that we can add our modules to it.
   iree_status_t status = iree_vm_context_create(
       /*instance=*/NULL, options->context_flags, host_allocator,
       &session->context);
+  if (iree_status_is_ok(status) && session->capture) {
+    status = iree_runtime_capture_record_context_load(session->capture);
+  }
 
   // Add the HAL module; it is always required when using the runtime API.
   // Lower-level usage of the VM can avoid the HAL if it's not required.
@@ -99,6 +108,10 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_create_with_device(
   if (iree_status_is_ok(status)) {
     status = iree_vm_context_register_modules(session->context, &hal_module, 1);
   }
+  if (iree_status_is_ok(status) && session->capture) {
+    status = iree_runtime_capture_record_module_load(
+        session->capture, hal_module, iree_const_byte_span_empty());
+  }
   if (iree_status_is_ok(status)) {
     status = iree_vm_context_resolve_module_state(session->context, hal_module,
                                                   &session->hal_module_state);
@@ -119,6 +132,7 @@ static void iree_runtime_session_destroy(iree_runtime_session_t* session) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_vm_context_release(session->context);
+  iree_runtime_capture_release(session->capture);
   iree_runtime_instance_release(session->instance);
 
   iree_allocator_free(session->host_allocator, session);
@@ -181,21 +195,35 @@ iree_runtime_session_trim(iree_runtime_session_t* session) {
   return status;
 }
 
-IREE_API_EXPORT iree_status_t iree_runtime_session_append_module(
-    iree_runtime_session_t* session, iree_vm_module_t* module) {
-  IREE_ASSERT_ARGUMENT(session);
-  IREE_ASSERT_ARGUMENT(module);
+// Registers |module| with the session context and records the load with the
+// session capture, if any. |flatbuffer_data| is the bytecode module contents
+// the module was loaded from or empty if the module was built in.
+static iree_status_t iree_runtime_session_register_module(
+    iree_runtime_session_t* session, iree_vm_module_t* module,
+    iree_const_byte_span_t flatbuffer_data) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, iree_vm_module_name(module).data,
                               iree_vm_module_name(module).size);
 
   iree_status_t status = iree_vm_context_register_modules(
       iree_runtime_session_context(session), &module, 1);
+  if (iree_status_is_ok(status) && session->capture) {
+    status = iree_runtime_capture_record_module_load(session->capture, module,
+                                                     flatbuffer_data);
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_session_append_module(
+    iree_runtime_session_t* session, iree_vm_module_t* module) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(module);
+  return iree_runtime_session_register_module(session, module,
+                                              iree_const_byte_span_empty());
+}
+
 IREE_API_EXPORT iree_status_t
 iree_runtime_session_append_bytecode_module_from_memory(
     iree_runtime_session_t* session, iree_const_byte_span_t flatbuffer_data,
@@ -208,7 +236,8 @@ iree_runtime_session_append_bytecode_module_from_memory(
       flatbuffer_data, flatbuffer_allocator,
       iree_runtime_session_host_allocator(session), &module);
   if (iree_status_is_ok(status)) {
-    status = iree_runtime_session_append_module(session, module);
+    status =
+        iree_runtime_session_register_module(session, module, flatbuffer_data);
   }
   iree_vm_module_release(module);
 
@@ -264,6 +293,10 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call(
   IREE_ASSERT_ARGUMENT(function);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (session->capture) {
+    iree_runtime_capture_record_call(session->capture, function, input_list);
+  }
+
   iree_status_t status =
       iree_vm_invoke(iree_runtime_session_context(session), *function,
                      IREE_VM_INVOCATION_FLAG_NONE,
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/runtime/capture.h"
 #include "iree/vm/api.h"
 
 #ifdef __cplusplus
@@ -61,6 +62,10 @@ typedef struct iree_runtime_session_options_t {
   // Session creation will fail if a requested module is not built into the
   // runtime binary.
   iree_runtime_session_builtins_t builtin_modules;
+
+  // Optional capture recording module loads and calls made on the session
+  // into a replayable trace. The session retains the capture for its lifetime.
+  iree_runtime_capture_t* capture;
 } iree_runtime_session_options_t;
 
 // Initializes |out_options| to its default values.
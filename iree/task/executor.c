@@ -92,8 +92,10 @@ iree_status_t iree_task_executor_create(
   // we minimize the number of live events and reduce overheads in
   // high-frequency transient parking operations.
   if (iree_status_is_ok(status)) {
-    status = iree_event_pool_allocate(IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY,
-                                      allocator, &executor->event_pool);
+    status = iree_event_pool_allocate(
+        IREE_TASK_EXECUTOR_EVENT_POOL_INITIAL_CAPACITY,
+        IREE_TASK_EXECUTOR_EVENT_POOL_MAX_CAPACITY, allocator,
+        &executor->event_pool);
   }
 
   // Pool used for all fanout tasks. These only live within the executor and
@@ -227,6 +229,11 @@ void iree_task_executor_trim(iree_task_executor_t* executor) {
   // iree_task_pool_trim(&executor->transient_task_pool);
 }
 
+iree_host_size_t iree_task_executor_worker_count(
+    iree_task_executor_t* executor) {
+  return executor->worker_count;
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
@@ -372,13 +379,53 @@ void iree_task_executor_submit(iree_task_executor_t* executor,
   IREE_TRACE_ZONE_END(z0);
 }
 
+static void iree_task_executor_coordinate_impl(
+    iree_task_executor_t* executor, iree_task_worker_t* current_worker,
+    iree_task_list_t* caller_tasks);
+
+// Executes |caller_tasks| produced by coordination on the calling thread and
+// submits any tasks they made ready. Only dispatch shards without local memory
+// requirements are routed to the caller.
+static void iree_task_executor_execute_caller_tasks(
+    iree_task_executor_t* executor, iree_task_list_t* caller_tasks) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_task_submission_t pending_submission;
+  iree_task_submission_initialize(&pending_submission);
+  const iree_cpu_processor_id_t processor_id = iree_cpu_query_processor_id();
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(caller_tasks)) != NULL) {
+    IREE_ASSERT_EQ(task->type, IREE_TASK_TYPE_DISPATCH_SHARD);
+    iree_task_dispatch_shard_execute((iree_task_dispatch_shard_t*)task,
+                                     processor_id, iree_byte_span_empty(),
+                                     &pending_submission);
+  }
+  if (!iree_task_submission_is_empty(&pending_submission)) {
+    iree_task_executor_merge_submission(executor, &pending_submission);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 void iree_task_executor_flush(iree_task_executor_t* executor) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Mostly a no-op today as we aren't deferring submission with the scheduling
   // mode. Instead, we'll just run the coordinator inline to ensure all tasks
   // are pushed to workers. This will not wait - but may block.
-  iree_task_executor_coordinate(executor, /*current_worker=*/NULL);
+  //
+  // Small dispatches flagged IREE_TASK_FLAG_DISPATCH_INLINE are handed back to
+  // us and executed on this thread after the coordinator lock is released. Any
+  // tasks they make ready are coordinated again so that chains of small
+  // dispatches continue running here.
+  iree_task_list_t caller_tasks;
+  iree_task_list_initialize(&caller_tasks);
+  do {
+    iree_task_executor_coordinate_impl(executor, /*current_worker=*/NULL,
+                                       &caller_tasks);
+    if (iree_task_list_is_empty(&caller_tasks)) break;
+    iree_task_executor_execute_caller_tasks(executor, &caller_tasks);
+  } while (true);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -393,6 +440,16 @@ void iree_task_executor_flush(iree_task_executor_t* executor) {
 // posted to it.
 void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker) {
+  iree_task_executor_coordinate_impl(executor, current_worker,
+                                     /*caller_tasks=*/NULL);
+}
+
+// Coordinates as with iree_task_executor_coordinate. If |caller_tasks| is
+// provided then tasks that should run on the calling thread are appended to it
+// for the caller to execute after the coordinator lock has been released.
+static void iree_task_executor_coordinate_impl(
+    iree_task_executor_t* executor, iree_task_worker_t* current_worker,
+    iree_task_list_t* caller_tasks) {
   iree_slim_mutex_lock(&executor->coordinator_mutex);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -431,6 +488,7 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
         iree_alloca(sizeof(iree_task_post_batch_t) +
                     executor->worker_count * sizeof(iree_task_list_t));
     iree_task_post_batch_initialize(executor, current_worker, post_batch);
+    post_batch->caller_tasks = caller_tasks;
 
     // Schedule all ready tasks in this batch. Some may complete inline (such
     // as ready barriers with all their dependencies resolved) while others may
@@ -313,6 +313,11 @@ void iree_task_executor_release(iree_task_executor_t* executor);
 // Trims pools and caches used by the executor and its workers.
 void iree_task_executor_trim(iree_task_executor_t* executor);
 
+// Returns the total number of workers in the executor. This is the maximum
+// number of tiles of a dispatch that may execute concurrently.
+iree_host_size_t iree_task_executor_worker_count(
+    iree_task_executor_t* executor);
+
 // Returns an iree_event_t pool managed by the executor.
 // Users of the task system should acquire their transient events from this.
 // Long-lived events should be allocated on their own in order to avoid
@@ -29,6 +29,7 @@ TEST(ExecutorTest, Lifetime) {
     IREE_ASSERT_OK(iree_task_executor_create(
         scheduling_mode, &topology, worker_local_memory_size,
         iree_allocator_system(), &executor));
+    EXPECT_EQ(4, iree_task_executor_worker_count(executor));
     // -- idle --
     iree_task_executor_release(executor);
   }
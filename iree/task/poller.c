@@ -488,7 +488,9 @@ static void iree_task_poller_pump_until_exit(iree_task_poller_t* poller) {
                                   &earliest_deadline_ns);
     if (!iree_task_submission_is_empty(&pending_submission)) {
       iree_task_executor_submit(poller->executor, &pending_submission);
-      iree_task_executor_flush(poller->executor);
+      // Coordinate without executing any tasks on the poller thread; those
+      // would delay the wait handling.
+      iree_task_executor_coordinate(poller->executor, /*current_worker=*/NULL);
     }
 
     // Enter the system multi-wait API.
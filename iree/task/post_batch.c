@@ -22,6 +22,7 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
                                      iree_task_post_batch_t* out_post_batch) {
   out_post_batch->executor = executor;
   out_post_batch->current_worker = current_worker;
+  out_post_batch->caller_tasks = NULL;
   out_post_batch->worker_pending_mask = 0;
   memset(&out_post_batch->worker_pending_lifos, 0,
          executor->worker_count * sizeof(iree_task_list_t));
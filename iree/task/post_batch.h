@@ -35,6 +35,12 @@ typedef struct iree_task_post_batch_t {
   // May be NULL if not being posted from a worker (such as a submission).
   iree_task_worker_t* current_worker;
 
+  // Tasks to be executed by the calling thread once coordination has completed
+  // and the coordinator lock has been released.
+  // May be NULL if the calling thread cannot execute tasks (such as when
+  // posting from a worker or the poller).
+  iree_task_list_t* caller_tasks;
+
   // A bitmask of workers indicating which have pending tasks in their lists.
   // Used to quickly scan the lists and perform the posts only when required.
   iree_task_affinity_set_t worker_pending_mask;
@@ -81,6 +81,10 @@ iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
   // Add any stolen tasks to the target queue and pop off the head for return.
   iree_task_t* next_task = NULL;
   if (!iree_task_list_is_empty(&stolen_tasks)) {
+    for (iree_task_t* task = stolen_tasks.head; task != NULL;
+         task = task->next_task) {
+      task->flags |= IREE_TASK_FLAG_STOLEN;
+    }
     iree_slim_mutex_lock(&target_queue->mutex);
     iree_task_list_append(&target_queue->list, &stolen_tasks);
     next_task = iree_task_list_pop_front(&target_queue->list);
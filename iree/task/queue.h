@@ -155,6 +155,8 @@ iree_task_t* iree_task_queue_pop_front(iree_task_queue_t* queue);
 //
 // It's expected this is not called from the queue's owning worker, though it's
 // valid to do so.
+//
+// All stolen tasks are marked with IREE_TASK_FLAG_STOLEN.
 iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
                                        iree_task_queue_t* target_queue,
                                        iree_host_size_t max_tasks);
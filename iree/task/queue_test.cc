@@ -204,6 +204,7 @@ TEST(QueueTest, TryStealLast) {
 
   EXPECT_EQ(&task_a,
             iree_task_queue_try_steal(&source_queue, &target_queue, 100));
+  EXPECT_TRUE(iree_all_bits_set(task_a.flags, IREE_TASK_FLAG_STOLEN));
   EXPECT_TRUE(iree_task_queue_is_empty(&target_queue));
   EXPECT_TRUE(iree_task_queue_is_empty(&source_queue));
 
@@ -55,9 +55,10 @@ typedef struct iree_task_scope_t {
   // to completion.
   iree_atomic_intptr_t permanent_status;
 
-  // Dispatch statistics aggregated from all dispatches in this scope. Updated
-  // relatively infrequently and must not be used for task control as values
-  // are undefined in the case of failure and may tear.
+  // Dispatch statistics aggregated from all dispatches in this scope that have
+  // a statistics_target and thus collect statistics. Updated relatively
+  // infrequently and must not be used for task control as values are undefined
+  // in the case of failure and may tear.
   iree_task_dispatch_statistics_t dispatch_statistics;
 
   // A mutex used to guard the pending_submissions.
@@ -512,12 +512,79 @@ static uint32_t iree_task_tile_to_color(
 
 #endif  // IREE_TASK_TRACING_PER_TILE_COLORS
 
+#if IREE_STATISTICS_ENABLE
+
+// Atomically raises |target| to at least |value|.
+static void iree_task_statistics_max_int64(iree_atomic_int64_t* target,
+                                           int64_t value) {
+  int64_t current = iree_atomic_load_int64(target, iree_memory_order_relaxed);
+  while (value > current) {
+    if (iree_atomic_compare_exchange_weak_int64(target, &current, value,
+                                                iree_memory_order_relaxed,
+                                                iree_memory_order_relaxed)) {
+      break;
+    }
+  }
+}
+
 void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target) {
-  // TODO(benvanik): statistics.
+#define IREE_TASK_STATISTICS_ADD(field)                            \
+  iree_atomic_fetch_add_int64(                                     \
+      &target->field,                                              \
+      iree_atomic_load_int64((iree_atomic_int64_t*)&source->field, \
+                             iree_memory_order_relaxed),           \
+      iree_memory_order_relaxed)
+#define IREE_TASK_STATISTICS_MAX(field)                            \
+  iree_task_statistics_max_int64(                                  \
+      &target->field,                                              \
+      iree_atomic_load_int64((iree_atomic_int64_t*)&source->field, \
+                             iree_memory_order_relaxed))
+  IREE_TASK_STATISTICS_ADD(dispatch_count);
+  IREE_TASK_STATISTICS_ADD(tile_count);
+  IREE_TASK_STATISTICS_ADD(shard_count);
+  IREE_TASK_STATISTICS_ADD(steal_count);
+  IREE_TASK_STATISTICS_ADD(shard_time_ns);
+  IREE_TASK_STATISTICS_MAX(shard_time_max_ns);
+  IREE_TASK_STATISTICS_MAX(local_memory_size);
+#undef IREE_TASK_STATISTICS_ADD
+#undef IREE_TASK_STATISTICS_MAX
+}
+
+void iree_task_dispatch_statistics_consume(
+    iree_task_dispatch_statistics_t* source,
+    iree_task_dispatch_statistics_t* out_target) {
+#define IREE_TASK_STATISTICS_CONSUME(field)               \
+  iree_atomic_store_int64(&out_target->field,             \
+                          iree_atomic_exchange_int64(     \
+                              &source->field, 0,          \
+                              iree_memory_order_relaxed), \
+                          iree_memory_order_relaxed)
+  IREE_TASK_STATISTICS_CONSUME(dispatch_count);
+  IREE_TASK_STATISTICS_CONSUME(tile_count);
+  IREE_TASK_STATISTICS_CONSUME(shard_count);
+  IREE_TASK_STATISTICS_CONSUME(steal_count);
+  IREE_TASK_STATISTICS_CONSUME(shard_time_ns);
+  IREE_TASK_STATISTICS_CONSUME(shard_time_max_ns);
+  IREE_TASK_STATISTICS_CONSUME(local_memory_size);
+#undef IREE_TASK_STATISTICS_CONSUME
+}
+
+#else
+
+void iree_task_dispatch_statistics_merge(
+    const iree_task_dispatch_statistics_t* source,
+    iree_task_dispatch_statistics_t* target) {}
+
+void iree_task_dispatch_statistics_consume(
+    iree_task_dispatch_statistics_t* source,
+    iree_task_dispatch_statistics_t* out_target) {
+  memset(out_target, 0, sizeof(*out_target));
 }
 
+#endif  // IREE_STATISTICS_ENABLE
+
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
@@ -530,8 +597,11 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->local_memory_size = 0;
+  out_task->tile_read_size = 0;
+  out_task->tile_reuse_distance = 0;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
+  out_task->statistics_target = NULL;
 
   IREE_TRACE({
     static iree_atomic_int64_t next_dispatch_id = IREE_ATOMIC_VAR_INIT(0);
@@ -559,6 +629,171 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
+// Executes tiles of |dispatch_task| on the calling thread until all have been
+// reserved. Failures are propagated to the dispatch status and the statistics
+// of the tiles executed are merged into the dispatch.
+static void iree_task_dispatch_execute_tiles(
+    iree_task_dispatch_t* dispatch_task, iree_cpu_processor_id_t processor_id,
+    iree_byte_span_t local_memory, bool stolen,
+    iree_task_submission_t* pending_submission) {
+  // Prepare context shared for all tiles in the shard.
+  iree_task_tile_context_t tile_context;
+  memcpy(&tile_context.workgroup_size, dispatch_task->workgroup_size,
+         sizeof(tile_context.workgroup_size));
+  memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
+         sizeof(tile_context.workgroup_count));
+  tile_context.local_memory = local_memory;
+
+  // We perform all our shard statistics work locally here and only push back to
+  // the dispatch at the end; this avoids contention from each shard trying to
+  // update the statistics together.
+  iree_task_dispatch_statistics_t shard_statistics;
+  memset(&shard_statistics, 0, sizeof(shard_statistics));
+  tile_context.statistics = &shard_statistics;
+
+  // Hint as to which processor we are running on.
+  tile_context.processor_id = processor_id;
+
+  // Tiles are walked with the inner dimension varying fastest.
+  const int inner =
+      (dispatch_task->header.flags & IREE_TASK_FLAG_DISPATCH_WALK_YXZ) ? 1 : 0;
+  const int outer = 1 - inner;
+  const uint32_t workgroup_count_inner = tile_context.workgroup_count[inner];
+  const uint32_t workgroup_count_outer = tile_context.workgroup_count[outer];
+
+  // Statistics are only gathered for dispatches that have somewhere to report
+  // them so that shards otherwise skip the timing and the atomic merges.
+  const bool collect_statistics = dispatch_task->statistics_target != NULL;
+#if IREE_STATISTICS_ENABLE
+  const iree_time_t shard_start_time_ns =
+      collect_statistics ? iree_time_now() : 0;
+#endif  // IREE_STATISTICS_ENABLE
+
+  // Loop over all tiles until they are all processed.
+  uint32_t shard_tile_count = 0;
+  const uint32_t tile_count = dispatch_task->tile_count;
+  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
+                                                   tiles_per_reservation,
+                                                   iree_memory_order_relaxed);
+  while (tile_base < tile_count) {
+    const uint32_t tile_range =
+        iree_min(tile_base + tiles_per_reservation, tile_count);
+    // Counted before execution such that failing tiles are included.
+    shard_tile_count += tile_range - tile_base;
+    for (uint32_t tile_index = tile_base; tile_index < tile_range;
+         ++tile_index) {
+      // TODO(benvanik): faster math here, especially knowing we pull off N
+      // sequential indices per reservation.
+      uint32_t tile_i = tile_index;
+      tile_context.workgroup_xyz[inner] = tile_i % workgroup_count_inner;
+      tile_i /= workgroup_count_inner;
+      tile_context.workgroup_xyz[outer] = tile_i % workgroup_count_outer;
+      tile_i /= workgroup_count_outer;
+      tile_context.workgroup_xyz[2] = tile_i;
+
+      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
+                                  "iree_task_dispatch_shard_execute_tile");
+      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
+
+      // NOTE: these are useful for debugging but dramatically increase our
+      // cost here; only enable if needed for tracking work distribution:
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[0]);
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[1]);
+      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[2]);
+      // IREE_TRACE_ZONE_APPEND_VALUE(z_tile, (uint64_t)task->closure.fn);
+
+      iree_status_t status =
+          dispatch_task->closure.fn(dispatch_task->closure.user_context,
+                                    &tile_context, pending_submission);
+
+      IREE_TRACE_ZONE_END(z_tile);
+
+      // If any tile fails we bail early from the loop. This doesn't match
+      // what an accelerator would do but saves some unneeded work.
+      // Note that other shards may have completed execution, be executing
+      // concurrently with this one, or still be pending - this does not
+      // have any influence on them and they may continue to execute even
+      // after we bail from here.
+      if (!iree_status_is_ok(status)) {
+        // Propagate failures to the dispatch task.
+        iree_task_try_set_status(&dispatch_task->status, status);
+        goto abort_shard;  // out of the while-for nest
+      }
+    }
+
+    // Try to grab the next slice of tiles.
+    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
+                                            tiles_per_reservation,
+                                            iree_memory_order_relaxed);
+  }
+abort_shard:
+  if (!collect_statistics) return;
+
+#if IREE_STATISTICS_ENABLE
+  // Shards that found all tiles already reserved by others did no work and
+  // are not counted so that shard times reflect actual execution.
+  if (shard_tile_count > 0) {
+    const int64_t shard_time_ns = iree_time_now() - shard_start_time_ns;
+    iree_atomic_store_int64(&shard_statistics.tile_count, shard_tile_count,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&shard_statistics.shard_count, 1,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&shard_statistics.steal_count, stolen ? 1 : 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&shard_statistics.shard_time_ns, shard_time_ns,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&shard_statistics.shard_time_max_ns,
+                            shard_time_ns, iree_memory_order_relaxed);
+    iree_atomic_store_int64(&shard_statistics.local_memory_size,
+                            (int64_t)local_memory.data_length,
+                            iree_memory_order_relaxed);
+  }
+#else
+  (void)shard_tile_count;
+#endif  // IREE_STATISTICS_ENABLE
+
+  // Push aggregate statistics up to the dispatch.
+  // Note that we may have partial information here if we errored out of the
+  // loop but that's still useful to know.
+  iree_task_dispatch_statistics_merge(&shard_statistics,
+                                      &dispatch_task->statistics);
+}
+
+// Computes how many tiles we want each shard to reserve at a time from the
+// larger grid. A higher number reduces overhead and improves locality while
+// a lower number reduces maximum worst-case latency (coarser work stealing).
+static uint32_t iree_task_dispatch_select_tiles_per_reservation(
+    const iree_task_dispatch_t* dispatch_task, iree_host_size_t worker_count) {
+  if (dispatch_task->tile_count <
+      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+    // Grid is small - allow it to be eagerly sliced up.
+    return 1;
+  }
+  uint32_t tiles_per_reservation =
+      IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+  if (dispatch_task->tile_read_size > 0) {
+    // Keep the data read by the reserved tiles within the worker cache so that
+    // tiles do not evict each other before they have run.
+    const uint32_t cache_tile_count =
+        IREE_TASK_DISPATCH_RESERVATION_CACHE_SIZE /
+        dispatch_task->tile_read_size;
+    tiles_per_reservation =
+        iree_max(1, iree_min(tiles_per_reservation, cache_tile_count));
+  }
+  if (dispatch_task->tile_reuse_distance > 1 &&
+      dispatch_task->tile_reuse_distance <=
+          IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+    // Reserve whole multiples of the reuse distance so that tiles reading the
+    // same data run back-to-back on the same worker.
+    tiles_per_reservation = iree_max(
+        dispatch_task->tile_reuse_distance,
+        tiles_per_reservation / dispatch_task->tile_reuse_distance *
+            dispatch_task->tile_reuse_distance);
+  }
+  return tiles_per_reservation;
+}
+
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
                               iree_task_submission_t* pending_submission,
@@ -605,16 +840,30 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   iree_host_size_t shard_count =
       iree_min(dispatch_task->tile_count, worker_count);
 
-  // Compute how many tiles we want each shard to reserve at a time from the
-  // larger grid. A higher number reduces overhead and improves locality while
-  // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (dispatch_task->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
-    // Grid is small - allow it to be eagerly sliced up.
-    dispatch_task->tiles_per_reservation = 1;
+  if (dispatch_task->header.flags & IREE_TASK_FLAG_DISPATCH_INLINE) {
+    // Small dispatches that opted in are issued as a single shard holding all
+    // tiles. For a handful of tiles the cost of waking workers dominates the
+    // execution time. The shard runs on the thread issuing the dispatch once
+    // coordination has completed (outside of the coordinator lock):
+    //  - a non-worker thread flushing the executor executes it directly when
+    //    it requires no worker local memory;
+    //  - a worker coordinating has the post batch select itself so the shard
+    //    is queued locally without a mailbox post or wake.
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "inline");
+    dispatch_task->tiles_per_reservation = dispatch_task->tile_count;
+    if (dispatch_task->tile_count > 0 && post_batch->caller_tasks &&
+        dispatch_task->local_memory_size == 0) {
+      iree_task_dispatch_shard_t* shard_task =
+          iree_task_dispatch_shard_allocate(dispatch_task, shard_task_pool);
+      iree_task_list_push_back(post_batch->caller_tasks, &shard_task->header);
+      IREE_TRACE_ZONE_END(z0);
+      return;
+    }
+    shard_count = iree_min(shard_count, 1);
   } else {
     dispatch_task->tiles_per_reservation =
-        IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+        iree_task_dispatch_select_tiles_per_reservation(dispatch_task,
+                                                        worker_count);
   }
 
   // Randomize starting worker.
@@ -655,10 +904,19 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
   // TODO(benvanik): attach statistics to the tracy zone.
 
   // Merge the statistics from the dispatch into the scope so we can track all
-  // of the work without tracking all the dispatches at a global level.
-  iree_task_dispatch_statistics_merge(
-      &dispatch_task->statistics,
-      &dispatch_task->header.scope->dispatch_statistics);
+  // of the work without tracking all the dispatches at a global level. Only
+  // dispatches with a statistics target collected any.
+  if (dispatch_task->statistics_target) {
+#if IREE_STATISTICS_ENABLE
+    iree_atomic_store_int64(&dispatch_task->statistics.dispatch_count, 1,
+                            iree_memory_order_relaxed);
+#endif  // IREE_STATISTICS_ENABLE
+    iree_task_dispatch_statistics_merge(
+        &dispatch_task->statistics,
+        &dispatch_task->header.scope->dispatch_statistics);
+    iree_task_dispatch_statistics_merge(&dispatch_task->statistics,
+                                        dispatch_task->statistics_target);
+  }
 
   // Consume the status of the dispatch that may have been set from a workgroup
   // and notify the scope. We need to do this here so that each shard retires
@@ -736,88 +994,10 @@ void iree_task_dispatch_shard_execute(
   iree_byte_span_t local_memory = iree_make_byte_span(
       worker_local_memory.data, dispatch_task->local_memory_size);
 
-  // Prepare context shared for all tiles in the shard.
-  iree_task_tile_context_t tile_context;
-  memcpy(&tile_context.workgroup_size, dispatch_task->workgroup_size,
-         sizeof(tile_context.workgroup_size));
-  memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
-         sizeof(tile_context.workgroup_count));
-  uint32_t workgroup_count_x = tile_context.workgroup_count[0];
-  uint32_t workgroup_count_y = tile_context.workgroup_count[1];
-  tile_context.local_memory = local_memory;
-
-  // We perform all our shard statistics work locally here and only push back to
-  // the dispatch at the end; this avoids contention from each shard trying to
-  // update the statistics together.
-  iree_task_dispatch_statistics_t shard_statistics;
-  memset(&shard_statistics, 0, sizeof(shard_statistics));
-  tile_context.statistics = &shard_statistics;
-
-  // Hint as to which processor we are running on.
-  tile_context.processor_id = processor_id;
-
-  // Loop over all tiles until they are all processed.
-  const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
-  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                                   tiles_per_reservation,
-                                                   iree_memory_order_relaxed);
-  while (tile_base < tile_count) {
-    const uint32_t tile_range =
-        iree_min(tile_base + tiles_per_reservation, tile_count);
-    for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
-      // TODO(benvanik): faster math here, especially knowing we pull off N
-      // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
-      tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
-      tile_i /= workgroup_count_x;
-      tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
-      tile_i /= workgroup_count_y;
-      tile_context.workgroup_xyz[2] = tile_i;
-
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
-                                  "iree_task_dispatch_shard_execute_tile");
-      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
-
-      // NOTE: these are useful for debugging but dramatically increase our
-      // cost here; only enable if needed for tracking work distribution:
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[0]);
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[1]);
-      IREE_TRACE_ZONE_APPEND_VALUE(z_tile, tile_context.workgroup_xyz[2]);
-      // IREE_TRACE_ZONE_APPEND_VALUE(z_tile, (uint64_t)task->closure.fn);
-
-      iree_status_t status =
-          dispatch_task->closure.fn(dispatch_task->closure.user_context,
-                                    &tile_context, pending_submission);
-
-      IREE_TRACE_ZONE_END(z_tile);
-
-      // If any tile fails we bail early from the loop. This doesn't match
-      // what an accelerator would do but saves some unneeded work.
-      // Note that other shards may have completed execution, be executing
-      // concurrently with this one, or still be pending - this does not
-      // have any influence on them and they may continue to execute even
-      // after we bail from here.
-      if (!iree_status_is_ok(status)) {
-        // Propagate failures to the dispatch task.
-        iree_task_try_set_status(&dispatch_task->status, status);
-        goto abort_shard;  // out of the while-for nest
-      }
-    }
-
-    // Try to grab the next slice of tiles.
-    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                            tiles_per_reservation,
-                                            iree_memory_order_relaxed);
-  }
-abort_shard:
-
-  // Push aggregate statistics up to the dispatch.
-  // Note that we may have partial information here if we errored out of the
-  // loop but that's still useful to know.
-  iree_task_dispatch_statistics_merge(&shard_statistics,
-                                      &dispatch_task->statistics);
+  iree_task_dispatch_execute_tiles(
+      dispatch_task, processor_id, local_memory,
+      iree_all_bits_set(task->header.flags, IREE_TASK_FLAG_STOLEN),
+      pending_submission);
 
   // NOTE: even if an error was hit we retire OK - the error has already been
   // propagated to the dispatch and it'll clean up after all shards are joined.
@@ -117,6 +117,21 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // The task was stolen by a worker from the queue of another worker.
+  // Set by the thief and used only for statistics.
+  IREE_TASK_FLAG_STOLEN = 1u << 6,
+
+  // The dispatch is small enough that all of its tiles should execute as a
+  // single shard on the thread issuing it instead of being distributed across
+  // workers. Non-worker threads flushing the executor execute the shard
+  // themselves unless it requires worker local memory.
+  IREE_TASK_FLAG_DISPATCH_INLINE = 1u << 7,
+
+  // Tiles of the dispatch are walked with Y varying fastest instead of X such
+  // that tiles adjacent in Y are reserved together and execute on the same
+  // worker. Useful when those tiles share the most data.
+  IREE_TASK_FLAG_DISPATCH_WALK_YXZ = 1u << 8,
 };
 typedef uint16_t iree_task_flags_t;
 
@@ -492,10 +507,29 @@ void iree_task_wait_set_wait_any(iree_task_wait_t* task,
 // generic ones like 'l2 cache misses' or 'ipc') then we can sprinkle in some
 // #ifdefs.
 typedef struct iree_task_dispatch_statistics_t {
-  // TODO(benvanik): statistics counters.
   // NOTE: each of these increases the command buffer storage requirements; we
   // should always guard these with IREE_STATISTICS_ENABLE.
+#if IREE_STATISTICS_ENABLE
+  // Total number of dispatches that have retired.
+  iree_atomic_int64_t dispatch_count;
+  // Total number of tiles (workgroups) executed.
+  iree_atomic_int64_t tile_count;
+  // Total number of shards that executed at least one tile.
+  iree_atomic_int64_t shard_count;
+  // Total number of shards that executed on a worker that stole them from the
+  // worker they were originally scheduled on.
+  iree_atomic_int64_t steal_count;
+  // Sum of the wall time of all shards in nanoseconds. As shards execute
+  // concurrently this is the total worker time spent and not the latency.
+  iree_atomic_int64_t shard_time_ns;
+  // Wall time of the longest running shard in nanoseconds.
+  iree_atomic_int64_t shard_time_max_ns;
+  // Largest local_memory_size in bytes declared by any dispatch. This is the
+  // size reserved for each tile and not the amount the tile actually touched.
+  iree_atomic_int64_t local_memory_size;
+#else
   iree_atomic_int32_t reserved;
+#endif  // IREE_STATISTICS_ENABLE
 } iree_task_dispatch_statistics_t;
 
 // Merges statistics from |source| to |target| atomically per-field.
@@ -505,6 +539,13 @@ void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target);
 
+// Moves all statistics from |source| into |out_target| and resets |source|.
+// Each field is exchanged independently such that concurrent merges into
+// |source| are either included in the result or left for the next call.
+void iree_task_dispatch_statistics_consume(
+    iree_task_dispatch_statistics_t* source,
+    iree_task_dispatch_statistics_t* out_target);
+
 typedef struct iree_task_tile_storage_t {
   // TODO(benvanik): coroutine storage.
   // Ideally we'll be able to have a fixed coroutine storage size per dispatch
@@ -625,6 +666,17 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // dispatch closure.
   uint32_t local_memory_size;
 
+  // Optional approximate bytes of memory read by each tile or 0 if unknown.
+  // Used to size tile reservations such that the data of all tiles reserved
+  // at a time by a worker fits in its cache.
+  uint32_t tile_read_size;
+
+  // Optional distance in tiles (in walk order) after which the data read by a
+  // tile is read again by another tile or 0 if unknown or not reused. Tiles
+  // within the distance are reserved together when possible so that the reuse
+  // happens on the same worker.
+  uint32_t tile_reuse_distance;
+
   // Resulting status from the dispatch available once all workgroups have
   // completed (or would have completed). If multiple shards processing the
   // workgroups hit an error the first will be taken and the result ignored. A
@@ -635,12 +687,21 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // Statistics storage used for aggregating counters across all shards.
   iree_task_dispatch_statistics_t statistics;
 
+  // Optional statistics storage the dispatch statistics are merged into when
+  // the dispatch retires in addition to the parent scope. Used to attribute
+  // statistics to whatever the dispatch represents (such as an executable
+  // entry point) and must remain valid until the dispatch has retired.
+  // Statistics are only collected when this is set: dispatches without a
+  // target do not time their shards or merge any counters.
+  iree_task_dispatch_statistics_t* statistics_target;
+
   // The total number of tiles in the dispatch bounding tile_index.
   uint32_t tile_count;
 
   // Maximum number of tiles to fetch per tile reservation from the grid.
   // Bounded by IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a
-  // reasonable number chosen based on the tile and shard counts.
+  // reasonable number chosen based on the tile and shard counts and the tile
+  // read size and reuse distance hints.
   uint32_t tiles_per_reservation;
 
   // The tail tile index; the next reservation will start from here.
@@ -6,9 +6,12 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <thread>
 
 #include "iree/base/api.h"
+#include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
@@ -67,6 +70,12 @@ class GridCoverage {
   std::unique_ptr<iree_atomic_int32_t[]> storage_;
 };
 
+#if IREE_STATISTICS_ENABLE
+static int64_t Load(iree_atomic_int64_t* value) {
+  return iree_atomic_load_int64(value, iree_memory_order_relaxed);
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 class TaskDispatchTest : public TaskTest {
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
@@ -113,6 +122,164 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+TEST_F(TaskDispatchTest, IssueInline111) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {1, 1, 1};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_INLINE);
+}
+
+TEST_F(TaskDispatchTest, IssueInline345) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_INLINE);
+}
+
+// Inline dispatches submitted from a non-worker thread run on that thread.
+TEST_F(TaskDispatchTest, IssueInlineOnCaller) {
+  IREE_TRACE_SCOPE();
+  struct TileThreads {
+    std::thread::id caller_id = std::this_thread::get_id();
+    iree_atomic_int32_t other_count = IREE_ATOMIC_VAR_INIT(0);
+  } tile_threads;
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {2, 2, 1};
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          +[](void* user_context, const iree_task_tile_context_t* tile_context,
+              iree_task_submission_t* pending_submission) {
+            auto* tile_threads = reinterpret_cast<TileThreads*>(user_context);
+            if (std::this_thread::get_id() != tile_threads->caller_id) {
+              iree_atomic_fetch_add_int32(&tile_threads->other_count, 1,
+                                          iree_memory_order_seq_cst);
+            }
+            return iree_ok_status();
+          },
+          (void*)&tile_threads),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_EQ(0, iree_atomic_load_int32(&tile_threads.other_count,
+                                      iree_memory_order_seq_cst));
+}
+
+TEST_F(TaskDispatchTest, IssueWalkYXZ) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_WALK_YXZ);
+}
+
+// Tile read size and reuse distance hints change how tiles are reserved but
+// all tiles must still execute exactly once.
+TEST_F(TaskDispatchTest, IssueReservationHints) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 7, 3};
+  const uint32_t kHints[][2] = {
+      {1, 0}, {64 * 1024, 0}, {16 * 1024 * 1024, 0}, {0, 3}, {64 * 1024, 4},
+  };
+  for (const auto& hint : kHints) {
+    GridCoverage coverage(kWorkgroupCount);
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+        kWorkgroupSize, kWorkgroupCount, &task);
+    task.tile_read_size = hint[0];
+    task.tile_reuse_distance = hint[1];
+    IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+    EXPECT_TRUE(coverage.Verify());
+  }
+}
+
+#if IREE_STATISTICS_ENABLE
+TEST_F(TaskDispatchTest, Statistics) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  GridCoverage coverage(kWorkgroupCount);
+  iree_task_dispatch_statistics_t target_statistics;
+  memset(&target_statistics, 0, sizeof(target_statistics));
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  task.statistics_target = &target_statistics;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_TRUE(coverage.Verify());
+
+  iree_task_dispatch_statistics_t statistics;
+  iree_task_dispatch_statistics_consume(&target_statistics, &statistics);
+  EXPECT_EQ(1, Load(&statistics.dispatch_count));
+  EXPECT_EQ(3 * 4 * 5, Load(&statistics.tile_count));
+  EXPECT_GE(Load(&statistics.shard_count), 1);
+  EXPECT_LE(Load(&statistics.steal_count), Load(&statistics.shard_count));
+  EXPECT_GE(Load(&statistics.shard_time_ns),
+            Load(&statistics.shard_time_max_ns));
+  EXPECT_EQ(0, Load(&statistics.local_memory_size));
+  EXPECT_EQ(0, Load(&target_statistics.tile_count));
+
+  // The scope receives the statistics of all dispatches within it.
+  iree_task_dispatch_statistics_t scope_statistics =
+      iree_task_scope_consume_statistics(&scope_);
+  EXPECT_EQ(1, Load(&scope_statistics.dispatch_count));
+  EXPECT_EQ(3 * 4 * 5, Load(&scope_statistics.tile_count));
+}
+
+// Dispatches without a statistics target do not collect statistics.
+TEST_F(TaskDispatchTest, StatisticsRequireTarget) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  GridCoverage coverage(kWorkgroupCount);
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_TRUE(coverage.Verify());
+
+  iree_task_dispatch_statistics_t scope_statistics =
+      iree_task_scope_consume_statistics(&scope_);
+  EXPECT_EQ(0, Load(&scope_statistics.dispatch_count));
+  EXPECT_EQ(0, Load(&scope_statistics.tile_count));
+  EXPECT_EQ(0, Load(&scope_statistics.shard_time_ns));
+}
+
+// Inline dispatches run all tiles in a single shard.
+TEST_F(TaskDispatchTest, StatisticsInline) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  GridCoverage coverage(kWorkgroupCount);
+  iree_task_dispatch_statistics_t target_statistics;
+  memset(&target_statistics, 0, sizeof(target_statistics));
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  task.statistics_target = &target_statistics;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_TRUE(coverage.Verify());
+
+  iree_task_dispatch_statistics_t statistics;
+  iree_task_dispatch_statistics_consume(&target_statistics, &statistics);
+  EXPECT_EQ(3 * 4 * 5, Load(&statistics.tile_count));
+  EXPECT_EQ(1, Load(&statistics.shard_count));
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -173,6 +340,30 @@ TEST_F(TaskDispatchTest, IssueFailure) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+TEST_F(TaskDispatchTest, IssueInlineFailure) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 1, 1};
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    return tile_context->workgroup_xyz[0] == 2
+               ? iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!")
+               : iree_ok_status();
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, NULL),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  task.header.flags |= IREE_TASK_FLAG_DISPATCH_INLINE;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
 TEST_F(TaskDispatchTest, IssueFailureChained) {
   IREE_TRACE_SCOPE();
 
@@ -23,8 +23,14 @@ extern "C" {
 // at the cost of a higher minimum memory consumption.
 #define IREE_TASK_EXECUTOR_INITIAL_SHARD_RESERVATION_PER_WORKER (4)
 
-// Maximum number of events retained by the executor event pool.
-#define IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY 64
+// Initial number of events allocated in the executor event pool.
+#define IREE_TASK_EXECUTOR_EVENT_POOL_INITIAL_CAPACITY 64
+
+// Maximum number of events retained by the executor event pool. The pool grows
+// up to this size as more waits are outstanding at once. Events are usually
+// backed by file descriptors or kernel handles and the limit keeps us from
+// retaining a large share of the process quota after a burst of waits.
+#define IREE_TASK_EXECUTOR_EVENT_POOL_MAX_CAPACITY 1024
 
 // Maximum number of simultaneous waits an executor may perform as part of a
 // wait-any operation. A larger value may enable better wake coalescing by the
@@ -93,6 +99,12 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Bytes of cache per worker that the data read by all tiles in a reservation
+// should fit within. Only used when dispatches provide a tile read size hint.
+// This approximates a per-core L2; tiles reading more than this are reserved
+// one at a time.
+#define IREE_TASK_DISPATCH_RESERVATION_CACHE_SIZE (256 * 1024)
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
@@ -163,7 +163,10 @@ iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
 
   // If we still didn't steal any tasks then let's try the slist instead.
   task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
-  if (task) return task;
+  if (task) {
+    task->flags |= IREE_TASK_FLAG_STOLEN;
+    return task;
+  }
 
   return NULL;
 }
@@ -0,0 +1,67 @@
+// Checks a 16-point iree_linalg_ext.fft built from its four butterfly stages
+// against a naive DFT of the same signal.
+func.func @fft_1d_matches_dft() {
+  %input = util.unfoldable_constant dense<[
+    0.5, -0.25, 1.0, 0.75, -1.0, 0.125, 0.0, -0.5,
+    0.25, 0.625, -0.75, 0.375, -0.125, 1.0, -0.375, 0.5]> : tensor<16xf32>
+  // The fft expects its input in bit-reversed order.
+  %real = util.unfoldable_constant dense<[
+    0.5, 0.25, -1.0, -0.125, 1.0, -0.75, 0.0, -0.375,
+    -0.25, 0.625, 0.125, 1.0, 0.75, 0.375, -0.5, 0.5]> : tensor<16xf32>
+  %imag = util.unfoldable_constant dense<0.0> : tensor<16xf32>
+
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  %c4 = arith.constant 4 : index
+  %s1:2 = iree_linalg_ext.fft
+    ins(%c1 : index)
+    outs(%real, %imag : tensor<16xf32>, tensor<16xf32>)
+  : tensor<16xf32>, tensor<16xf32>
+  %s2:2 = iree_linalg_ext.fft
+    ins(%c2 : index)
+    outs(%s1#0, %s1#1 : tensor<16xf32>, tensor<16xf32>)
+  : tensor<16xf32>, tensor<16xf32>
+  %s3:2 = iree_linalg_ext.fft
+    ins(%c3 : index)
+    outs(%s2#0, %s2#1 : tensor<16xf32>, tensor<16xf32>)
+  : tensor<16xf32>, tensor<16xf32>
+  %fft:2 = iree_linalg_ext.fft
+    ins(%c4 : index)
+    outs(%s3#0, %s3#1 : tensor<16xf32>, tensor<16xf32>)
+  : tensor<16xf32>, tensor<16xf32>
+
+  // X[k] = sum_n x[n] * exp(-2 * PI * k * n / 16 * I)
+  %c16 = arith.constant 16 : index
+  %coeff = arith.constant -0.392699081698724 : f32
+  %zero = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [16] : tensor<16xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<16xf32>) -> tensor<16xf32>
+  %dft:2 = linalg.generic {
+      indexing_maps = [affine_map<(k, n) -> (n)>,
+                       affine_map<(k, n) -> (k)>,
+                       affine_map<(k, n) -> (k)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%input : tensor<16xf32>)
+      outs(%fill, %fill : tensor<16xf32>, tensor<16xf32>) {
+    ^bb0(%x: f32, %re: f32, %im: f32):
+      %k = linalg.index 0 : index
+      %n = linalg.index 1 : index
+      %kn = arith.muli %k, %n : index
+      %phase = arith.remui %kn, %c16 : index
+      %phase_i32 = arith.index_cast %phase : index to i32
+      %phase_f32 = arith.sitofp %phase_i32 : i32 to f32
+      %w = arith.mulf %phase_f32, %coeff : f32
+      %cos = math.cos %w : f32
+      %sin = math.sin %w : f32
+      %x_re = arith.mulf %x, %cos : f32
+      %x_im = arith.mulf %x, %sin : f32
+      %sum_re = arith.addf %re, %x_re : f32
+      %sum_im = arith.addf %im, %x_im : f32
+      linalg.yield %sum_re, %sum_im : f32, f32
+  } -> (tensor<16xf32>, tensor<16xf32>)
+
+  check.expect_almost_eq(%fft#0, %dft#0) : tensor<16xf32>
+  check.expect_almost_eq(%fft#1, %dft#1) : tensor<16xf32>
+  return
+}
@@ -134,3 +134,45 @@ func.func @scan_2d_dim1_inclusive_sum() {
 
   return
 }
+
+// Long enough for the scan dimension to be split into blocks that are scanned
+// in parallel and then combined.
+func.func @scan_1d_dim0_inclusive_sum_large() {
+  %input = util.unfoldable_constant dense<1> : tensor<1024xi32>
+
+  %init = linalg.init_tensor [1024] : tensor<1024xi32>
+  %t0 = util.unfoldable_constant dense<0> : tensor<i32>
+  %0:2 = iree_linalg_ext.scan
+         dimension(0) inclusive(true)
+         ins(%input : tensor<1024xi32>)
+         outs(%init, %t0 : tensor<1024xi32>, tensor<i32>) {
+           ^bb0(%arg0 : i32, %arg1 : i32):
+             %sum = arith.addi %arg0, %arg1 : i32
+             iree_linalg_ext.yield %sum : i32
+         } -> tensor<1024xi32>, tensor<i32>
+
+  %head = tensor.extract_slice %0#0[0] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %head,
+      dense<[1, 2, 3, 4]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  %boundary = tensor.extract_slice %0#0[126] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %boundary,
+      dense<[127, 128, 129, 130]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  %tail = tensor.extract_slice %0#0[1020] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %tail,
+      dense<[1021, 1022, 1023, 1024]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  check.expect_eq_const(
+      %0#1,
+      dense<1024> : tensor<i32>
+  ) : tensor<i32>
+
+  return
+}
@@ -0,0 +1,41 @@
+func.func @scatter_repeated_indices_addf() {
+  %original = util.unfoldable_constant dense<0.0> : tensor<4xf32>
+  %updates = util.unfoldable_constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0]> : tensor<6xf32>
+  %indices = util.unfoldable_constant dense<[[0], [2], [0], [2], [3], [0]]> : tensor<6x1xi32>
+  %0 = iree_linalg_ext.scatter
+         unique_indices(false)
+         ins(%updates, %indices : tensor<6xf32>, tensor<6x1xi32>)
+         outs(%original : tensor<4xf32>) {
+         ^bb0(%arg0 : f32, %arg1 : f32):
+           %sum = arith.addf %arg1, %arg0 : f32
+           iree_linalg_ext.yield %sum : f32
+         } -> tensor<4xf32>
+
+  check.expect_almost_eq_const(
+      %0,
+      dense<[10.0, 0.0, 6.0, 5.0]> : tensor<4xf32>
+  ) : tensor<4xf32>
+
+  return
+}
+
+func.func @scatter_repeated_indices_addi() {
+  %original = util.unfoldable_constant dense<100> : tensor<3x2xi32>
+  %updates = util.unfoldable_constant dense<[[1, 2], [3, 4], [5, 6], [7, 8], [9, 10]]> : tensor<5x2xi32>
+  %indices = util.unfoldable_constant dense<[[1], [1], [0], [1], [2]]> : tensor<5x1xi32>
+  %0 = iree_linalg_ext.scatter
+         unique_indices(false)
+         ins(%updates, %indices : tensor<5x2xi32>, tensor<5x1xi32>)
+         outs(%original : tensor<3x2xi32>) {
+         ^bb0(%arg0 : i32, %arg1 : i32):
+           %sum = arith.addi %arg1, %arg0 : i32
+           iree_linalg_ext.yield %sum : i32
+         } -> tensor<3x2xi32>
+
+  check.expect_eq_const(
+      %0,
+      dense<[[105, 106], [111, 114], [109, 110]]> : tensor<3x2xi32>
+  ) : tensor<3x2xi32>
+
+  return
+}
@@ -0,0 +1,72 @@
+func.func @sort_1d() {
+  %input = util.unfoldable_constant dense<[3, 1, 4, 1, 5, 9, 2, 6]> : tensor<8xi32>
+
+  %0 = iree_linalg_ext.sort
+         dimension(0)
+         outs(%input : tensor<8xi32>) {
+           ^bb0(%arg0 : i32, %arg1 : i32):
+             %cmp = arith.cmpi slt, %arg0, %arg1 : i32
+             iree_linalg_ext.yield %cmp : i1
+         } -> tensor<8xi32>
+
+  check.expect_eq_const(
+      %0,
+      dense<[1, 1, 2, 3, 4, 5, 6, 9]> : tensor<8xi32>
+  ) : tensor<8xi32>
+
+  return
+}
+
+// Long enough to be split into per-block sorts merged by rank.
+func.func @sort_1d_large() {
+  %seed = util.unfoldable_constant dense<0> : tensor<1024xi32>
+
+  // Builds the permutation (i * 389) mod 1024 of [0, 1024) along with the
+  // negated keys as a second operand.
+  %init = linalg.init_tensor [1024] : tensor<1024xi32>
+  %keys, %values = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>,
+                       affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%seed : tensor<1024xi32>)
+      outs(%init, %init : tensor<1024xi32>, tensor<1024xi32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32, %arg2 : i32):
+      %index = linalg.index 0 : index
+      %i = arith.index_cast %index : index to i32
+      %c389 = arith.constant 389 : i32
+      %c1023 = arith.constant 1023 : i32
+      %mul = arith.muli %i, %c389 : i32
+      %mod = arith.andi %mul, %c1023 : i32
+      %key = arith.addi %arg0, %mod : i32
+      %value = arith.subi %arg0, %key : i32
+      linalg.yield %key, %value : i32, i32
+  } -> (tensor<1024xi32>, tensor<1024xi32>)
+
+  %0:2 = iree_linalg_ext.sort
+         dimension(0)
+         outs(%keys, %values : tensor<1024xi32>, tensor<1024xi32>) {
+           ^bb0(%arg0 : i32, %arg1 : i32, %arg2 : i32, %arg3 : i32):
+             %cmp = arith.cmpi slt, %arg0, %arg1 : i32
+             iree_linalg_ext.yield %cmp : i1
+         } -> tensor<1024xi32>, tensor<1024xi32>
+
+  %head = tensor.extract_slice %0#0[0] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %head,
+      dense<[0, 1, 2, 3]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  %boundary = tensor.extract_slice %0#0[126] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %boundary,
+      dense<[126, 127, 128, 129]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  %tail = tensor.extract_slice %0#1[1020] [4] [1] : tensor<1024xi32> to tensor<4xi32>
+  check.expect_eq_const(
+      %tail,
+      dense<[-1020, -1021, -1022, -1023]> : tensor<4xi32>
+  ) : tensor<4xi32>
+
+  return
+}
@@ -0,0 +1,94 @@
+func.func @topk_1d_dim0_max() {
+  %input_values = util.unfoldable_constant dense<[4.0, 5.0, 8.0, 1.0, 2.0, 10.0, 7.0, 3.0, 9.0, 6.0]> : tensor<10xf32>
+
+  %out_values_empty = linalg.init_tensor [3] : tensor<3xf32>
+  %out_indices_empty = linalg.init_tensor [3] : tensor<3xi32>
+  %neg_inf = arith.constant 0xFF800000 : f32
+  %c0 = arith.constant 0 : i32
+  %out_values = linalg.fill ins(%neg_inf : f32) outs(%out_values_empty : tensor<3xf32>) -> tensor<3xf32>
+  %out_indices = linalg.fill ins(%c0 : i32) outs(%out_indices_empty : tensor<3xi32>) -> tensor<3xi32>
+  %0:2 = iree_linalg_ext.topk
+        dimension(0)
+        ins(%input_values : tensor<10xf32>)
+        outs(%out_values, %out_indices : tensor<3xf32>, tensor<3xi32>) {
+        ^bb0(%arg0 : f32, %arg1 : f32):
+          %cmp = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %cmp : i1
+        } -> tensor<3xf32>, tensor<3xi32>
+
+  check.expect_almost_eq_const(
+      %0#0,
+      dense<[10.0, 9.0, 8.0]> : tensor<3xf32>
+  ) : tensor<3xf32>
+
+  check.expect_eq_const(
+      %0#1,
+      dense<[5, 8, 2]> : tensor<3xi32>
+  ) : tensor<3xi32>
+
+  return
+}
+
+// The outputs hold real elements, as the mhlo.sort + slice lowering seeds
+// them; inputs equal to -inf must still fill the remaining slots.
+func.func @topk_1d_dim0_max_neg_inf_inputs() {
+  %input_values = util.unfoldable_constant dense<[0xFF800000, 1.0, 0xFF800000, 2.0, 0xFF800000]> : tensor<5xf32>
+  %input_indices = util.unfoldable_constant dense<[3, 4, 5, 6, 7]> : tensor<5xi32>
+
+  %out_values = util.unfoldable_constant dense<[3.0, 0xFF800000, 0xFF800000]> : tensor<3xf32>
+  %out_indices = util.unfoldable_constant dense<[1, 0, 2]> : tensor<3xi32>
+  %0:2 = iree_linalg_ext.topk
+        dimension(0)
+        ins(%input_values, %input_indices : tensor<5xf32>, tensor<5xi32>)
+        outs(%out_values, %out_indices : tensor<3xf32>, tensor<3xi32>) {
+        ^bb0(%arg0 : f32, %arg1 : f32):
+          %cmp = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %cmp : i1
+        } -> tensor<3xf32>, tensor<3xi32>
+
+  check.expect_almost_eq_const(
+      %0#0,
+      dense<[3.0, 2.0, 1.0]> : tensor<3xf32>
+  ) : tensor<3xf32>
+
+  check.expect_eq_const(
+      %0#1,
+      dense<[1, 6, 4]> : tensor<3xi32>
+  ) : tensor<3xi32>
+
+  return
+}
+
+func.func @topk_2d_dim1_min_int_min_inputs() {
+  %input_values = util.unfoldable_constant dense<[[-2147483648, 6, -2147483648, 4],
+                                                  [3, -2147483648, 2, 2147483647]]> : tensor<2x4xi32>
+  %input_indices = util.unfoldable_constant dense<[[2, 3, 4, 5],
+                                                   [2, 3, 4, 5]]> : tensor<2x4xi32>
+
+  %out_values = util.unfoldable_constant dense<[[2147483647, 2147483647],
+                                                [5, 2147483647]]> : tensor<2x2xi32>
+  %out_indices = util.unfoldable_constant dense<[[0, 1],
+                                                 [1, 0]]> : tensor<2x2xi32>
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values, %input_indices : tensor<2x4xi32>, tensor<2x4xi32>)
+        outs(%out_values, %out_indices : tensor<2x2xi32>, tensor<2x2xi32>) {
+        ^bb0(%arg0 : i32, %arg1 : i32):
+          %cmp = arith.cmpi slt, %arg0, %arg1 : i32
+          iree_linalg_ext.yield %cmp : i1
+        } -> tensor<2x2xi32>, tensor<2x2xi32>
+
+  check.expect_eq_const(
+      %0#0,
+      dense<[[-2147483648, -2147483648],
+             [-2147483648, 2]]> : tensor<2x2xi32>
+  ) : tensor<2x2xi32>
+
+  check.expect_eq_const(
+      %0#1,
+      dense<[[2, 4],
+             [3, 4]]> : tensor<2x2xi32>
+  ) : tensor<2x2xi32>
+
+  return
+}
@@ -51,3 +51,22 @@ func.func @sort_to_decreasing_seq() {
   check.expect_eq_const(%sort, dense<[4, 3, 2, 1]> : tensor<4xi32>) : tensor<4xi32>
   return
 }
+
+// Only the first 3 elements are read, so this becomes a topk. Inputs equal to
+// -inf must still be selected once the larger ones run out.
+func.func @sort_slice_neg_inf() {
+  %values = util.unfoldable_constant dense<[0xFF800000, 1.0, 0xFF800000, 0xFF800000, 2.0, 0xFF800000, 0xFF800000, 0xFF800000]> : tensor<8xf32>
+  %indices = util.unfoldable_constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi32>
+
+  %sort:2 = "mhlo.sort"(%values, %indices) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>, %arg3: tensor<i32>, %arg4: tensor<i32>):  // no predecessors
+    %compare = "mhlo.compare"(%arg1, %arg2) {comparison_direction = #mhlo<"comparison_direction GT">} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%compare) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = true} : (tensor<8xf32>, tensor<8xi32>) -> (tensor<8xf32>, tensor<8xi32>)
+  %top_values = "mhlo.slice"(%sort#0) {start_indices = dense<0> : tensor<1xi64>, limit_indices = dense<3> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8xf32>) -> tensor<3xf32>
+  %top_indices = "mhlo.slice"(%sort#1) {start_indices = dense<0> : tensor<1xi64>, limit_indices = dense<3> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8xi32>) -> tensor<3xi32>
+
+  check.expect_almost_eq_const(%top_values, dense<[2.0, 1.0, 0xFF800000]> : tensor<3xf32>) : tensor<3xf32>
+  check.expect_eq_const(%top_indices, dense<[4, 1, 0]> : tensor<3xi32>) : tensor<3xi32>
+  return
+}
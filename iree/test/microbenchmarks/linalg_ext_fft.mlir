@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+// iree_linalg_ext.fft ops against a naive DFT reference.
+//===----------------------------------------------------------------------===//
+
+// 1024-point fft of 6 lines built from its 10 butterfly stages. The stages
+// carry no coefficients, so the twiddle tables are materialized as constants.
+func.func @fft_6x1024() -> (tensor<6x1024xf32>, tensor<6x1024xf32>) {
+    %real = util.unfoldable_constant dense<1.0> : tensor<6x1024xf32>
+    %imag = util.unfoldable_constant dense<0.0> : tensor<6x1024xf32>
+    %c1 = arith.constant 1 : index
+    %s1:2 = iree_linalg_ext.fft ins(%c1 : index) outs(%real, %imag : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c2 = arith.constant 2 : index
+    %s2:2 = iree_linalg_ext.fft ins(%c2 : index) outs(%s1#0, %s1#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c3 = arith.constant 3 : index
+    %s3:2 = iree_linalg_ext.fft ins(%c3 : index) outs(%s2#0, %s2#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c4 = arith.constant 4 : index
+    %s4:2 = iree_linalg_ext.fft ins(%c4 : index) outs(%s3#0, %s3#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c5 = arith.constant 5 : index
+    %s5:2 = iree_linalg_ext.fft ins(%c5 : index) outs(%s4#0, %s4#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c6 = arith.constant 6 : index
+    %s6:2 = iree_linalg_ext.fft ins(%c6 : index) outs(%s5#0, %s5#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c7 = arith.constant 7 : index
+    %s7:2 = iree_linalg_ext.fft ins(%c7 : index) outs(%s6#0, %s6#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c8 = arith.constant 8 : index
+    %s8:2 = iree_linalg_ext.fft ins(%c8 : index) outs(%s7#0, %s7#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c9 = arith.constant 9 : index
+    %s9:2 = iree_linalg_ext.fft ins(%c9 : index) outs(%s8#0, %s8#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    %c10 = arith.constant 10 : index
+    %s10:2 = iree_linalg_ext.fft ins(%c10 : index) outs(%s9#0, %s9#1 : tensor<6x1024xf32>, tensor<6x1024xf32>) : tensor<6x1024xf32>, tensor<6x1024xf32>
+    return %s10#0, %s10#1 : tensor<6x1024xf32>, tensor<6x1024xf32>
+}
+
+// X[k] = sum_n x[n] * exp(-2 * PI * k * n / 1024 * I) over the same lines.
+func.func @dft_6x1024() -> (tensor<6x1024xf32>, tensor<6x1024xf32>) {
+    %input = util.unfoldable_constant dense<1.0> : tensor<6x1024xf32>
+    %c1024 = arith.constant 1024 : index
+    %coeff = arith.constant -0.00613592315154256 : f32
+    %zero = arith.constant 0.0 : f32
+    %init = linalg.init_tensor [6, 1024] : tensor<6x1024xf32>
+    %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<6x1024xf32>) -> tensor<6x1024xf32>
+    %0:2 = linalg.generic {
+        indexing_maps = [affine_map<(b, k, n) -> (b, n)>,
+                         affine_map<(b, k, n) -> (b, k)>,
+                         affine_map<(b, k, n) -> (b, k)>],
+        iterator_types = ["parallel", "parallel", "reduction"]}
+        ins(%input : tensor<6x1024xf32>)
+        outs(%fill, %fill : tensor<6x1024xf32>, tensor<6x1024xf32>) {
+      ^bb0(%x: f32, %re: f32, %im: f32):
+        %k = linalg.index 1 : index
+        %n = linalg.index 2 : index
+        %kn = arith.muli %k, %n : index
+        %phase = arith.remui %kn, %c1024 : index
+        %phase_i32 = arith.index_cast %phase : index to i32
+        %phase_f32 = arith.sitofp %phase_i32 : i32 to f32
+        %w = arith.mulf %phase_f32, %coeff : f32
+        %cos = math.cos %w : f32
+        %sin = math.sin %w : f32
+        %x_re = arith.mulf %x, %cos : f32
+        %x_im = arith.mulf %x, %sin : f32
+        %sum_re = arith.addf %re, %x_re : f32
+        %sum_im = arith.addf %im, %x_im : f32
+        linalg.yield %sum_re, %sum_im : f32, f32
+    } -> (tensor<6x1024xf32>, tensor<6x1024xf32>)
+    return %0#0, %0#1 : tensor<6x1024xf32>, tensor<6x1024xf32>
+}
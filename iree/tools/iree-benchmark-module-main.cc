@@ -21,6 +21,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/init.h"
+#include "iree/hal/utils/dispatch_hotspots.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tools/utils/vm_util.h"
 #include "iree/vm/api.h"
@@ -48,6 +49,11 @@ IREE_FLAG(string, driver, "vmvx", "Backend driver to use.");
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(bool, print_dispatch_hotspots, false,
+          "Profiles all dispatches across all benchmark iterations and prints "
+          "a per-dispatch hotspot table to stderr on exit. Requires a device "
+          "that supports profiling.");
+
 static iree_status_t parse_function_input(iree_string_view_t flag_name,
                                           void* storage,
                                           iree_string_view_t value) {
@@ -154,7 +160,10 @@ iree_status_t GetModuleContentsFromFlags(iree_file_contents_t** out_contents) {
 // benchmarking.
 class IREEBenchmark {
  public:
-  IREEBenchmark() = default;
+  IREEBenchmark() {
+    iree_hal_dispatch_hotspots_initialize(iree_allocator_system(),
+                                          &hotspots_);
+  }
 
   ~IREEBenchmark() {
     IREE_TRACE_SCOPE0("IREEBenchmark::dtor");
@@ -168,6 +177,14 @@ class IREEBenchmark {
       IREE_IGNORE_ERROR(iree_hal_allocator_statistics_fprint(
           stderr, iree_hal_device_allocator(device_)));
     }
+    if (FLAG_print_dispatch_hotspots && device_) {
+      // Benchmarks wait for the device to idle after each run so all dispatches
+      // have retired by now.
+      IREE_IGNORE_ERROR(iree_hal_device_profiling_end(device_));
+      IREE_IGNORE_ERROR(iree_hal_dispatch_hotspots_fprint(stderr, &hotspots_,
+                                                          /*max_rows=*/0));
+    }
+    iree_hal_dispatch_hotspots_deinitialize(&hotspots_);
     iree_hal_device_release(device_);
     iree_vm_instance_release(instance_);
   };
@@ -203,6 +220,14 @@ class IREEBenchmark {
 
     // Create IREE's device and module.
     IREE_RETURN_IF_ERROR(iree::CreateDevice(FLAG_driver, &device_));
+    if (FLAG_print_dispatch_hotspots) {
+      iree_hal_device_profiling_options_t profiling_options = {};
+      profiling_options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+      profiling_options.sink = iree_hal_dispatch_hotspots_sink(&hotspots_);
+      IREE_RETURN_IF_ERROR(
+          iree_hal_device_profiling_begin(device_, &profiling_options),
+          "beginning dispatch profiling");
+    }
     IREE_RETURN_IF_ERROR(
         iree_hal_module_create(device_, iree_allocator_system(), &hal_module_));
     IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
@@ -290,6 +315,7 @@ class IREEBenchmark {
   iree_vm_context_t* context_ = nullptr;
   iree_vm_module_t* input_module_ = nullptr;
   iree::vm::ref<iree_vm_list_t> inputs_;
+  iree_hal_dispatch_hotspots_t hotspots_;
 };
 }  // namespace
 }  // namespace iree
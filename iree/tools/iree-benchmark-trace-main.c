@@ -118,8 +118,10 @@ static iree_status_t iree_replay_benchmark_prepare_call(
 // Processes a trace event by either setting up the |replay| or appending a call
 // to the |call_list|.
 static iree_status_t iree_replay_benchmark_process_event(
-    iree_trace_replay_t* replay, yaml_document_t* document,
-    yaml_node_t* event_node, iree_replay_benchmark_call_list_t* call_list) {
+    void* user_data, iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* event_node) {
+  iree_replay_benchmark_call_list_t* call_list =
+      (iree_replay_benchmark_call_list_t*)user_data;
   if (event_node->type != YAML_MAPPING_NODE) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "(%zu): expected mapping node",
@@ -158,34 +160,10 @@ static iree_status_t iree_replay_benchmark_load_trace(
                             (int)file_path.size, file_path.data);
   }
 
-  // One-pass parsing through the file.
-  yaml_parser_t parser;
-  if (!yaml_parser_initialize(&parser)) {
-    return iree_make_status(IREE_STATUS_INTERNAL,
-                            "yaml_parser_initialize failed");
-  }
-  yaml_parser_set_input_file(&parser, file);
-
-  // Read each event document in the file until EOF.
-  iree_status_t status = iree_ok_status();
-  for (bool document_eof = false; !document_eof;) {
-    yaml_document_t document;
-    if (!yaml_parser_load(&parser, &document)) {
-      status = iree_status_from_yaml_parser_error(&parser);
-      break;
-    }
-    yaml_node_t* event_node = yaml_document_get_root_node(&document);
-    if (event_node) {
-      status = iree_replay_benchmark_process_event(replay, &document,
-                                                   event_node, call_list);
-    } else {
-      document_eof = true;
-    }
-    yaml_document_delete(&document);
-    if (!iree_status_is_ok(status)) break;
-  }
+  // One-pass streaming through the file.
+  iree_status_t status = iree_trace_replay_stream_file(
+      replay, file, iree_replay_benchmark_process_event, call_list);
 
-  yaml_parser_delete(&parser);
   fclose(file);
   return status;
 }
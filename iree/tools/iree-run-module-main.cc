@@ -19,6 +19,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/init.h"
+#include "iree/hal/utils/dispatch_hotspots.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tools/utils/vm_util.h"
 #include "iree/vm/api.h"
@@ -44,6 +45,10 @@ IREE_FLAG(int32_t, print_max_element_count, 1024,
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(bool, print_dispatch_hotspots, false,
+          "Profiles all dispatches and prints a per-dispatch hotspot table "
+          "to stderr on exit. Requires a device that supports profiling.");
+
 static iree_status_t parse_function_input(iree_string_view_t flag_name,
                                           void* storage,
                                           iree_string_view_t value) {
@@ -149,6 +154,17 @@ iree_status_t Run() {
   IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr, 16,
                                            iree_allocator_system(), &outputs));
 
+  iree_hal_dispatch_hotspots_t hotspots;
+  iree_hal_dispatch_hotspots_initialize(iree_allocator_system(), &hotspots);
+  if (FLAG_print_dispatch_hotspots) {
+    iree_hal_device_profiling_options_t profiling_options = {};
+    profiling_options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+    profiling_options.sink = iree_hal_dispatch_hotspots_sink(&hotspots);
+    IREE_RETURN_IF_ERROR(
+        iree_hal_device_profiling_begin(device, &profiling_options),
+        "beginning dispatch profiling");
+  }
+
   std::cout << "EXEC @" << function_name << "\n";
   IREE_RETURN_IF_ERROR(
       iree_vm_invoke(context, function, IREE_VM_INVOCATION_FLAG_NONE,
@@ -156,6 +172,15 @@ iree_status_t Run() {
                      iree_allocator_system()),
       "invoking function '%s'", function_name.c_str());
 
+  if (FLAG_print_dispatch_hotspots) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_device_wait_idle(device, iree_infinite_timeout()));
+    IREE_RETURN_IF_ERROR(iree_hal_device_profiling_end(device));
+    IREE_IGNORE_ERROR(
+        iree_hal_dispatch_hotspots_fprint(stderr, &hotspots, /*max_rows=*/0));
+  }
+  iree_hal_dispatch_hotspots_deinitialize(&hotspots);
+
   IREE_RETURN_IF_ERROR(
       PrintVariantList(outputs.get(), (size_t)FLAG_print_max_element_count),
       "printing results");
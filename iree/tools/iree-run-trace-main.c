@@ -24,6 +24,14 @@ IREE_FLAG(bool, print_statistics, false,
 
 IREE_FLAG(string, driver, "vmvx", "Backend driver to use.");
 
+// Replays a single trace event and prints the results of any calls.
+static iree_status_t iree_run_trace_event(void* user_data,
+                                          iree_trace_replay_t* replay,
+                                          yaml_document_t* document,
+                                          yaml_node_t* event_node) {
+  return iree_trace_replay_event(replay, document, event_node);
+}
+
 // Runs the trace in |file| using |root_path| as the base for any path lookups
 // required for external files referenced in |file|.
 static iree_status_t iree_run_trace_file(iree_string_view_t root_path,
@@ -38,32 +46,9 @@ static iree_status_t iree_run_trace_file(iree_string_view_t root_path,
   iree_trace_replay_set_hal_driver_override(
       &replay, iree_make_cstring_view(FLAG_driver));
 
-  yaml_parser_t parser;
-  if (!yaml_parser_initialize(&parser)) {
-    iree_trace_replay_deinitialize(&replay, IREE_TRACE_REPLAY_SHUTDOWN_QUIET);
-    return iree_make_status(IREE_STATUS_INTERNAL,
-                            "yaml_parser_initialize failed");
-  }
-  yaml_parser_set_input_file(&parser, file);
-
-  iree_status_t status = iree_ok_status();
-  for (bool document_eof = false; !document_eof;) {
-    yaml_document_t document;
-    if (!yaml_parser_load(&parser, &document)) {
-      status = iree_status_from_yaml_parser_error(&parser);
-      break;
-    }
-    yaml_node_t* event_node = yaml_document_get_root_node(&document);
-    if (event_node) {
-      status = iree_trace_replay_event(&replay, &document, event_node);
-    } else {
-      document_eof = true;
-    }
-    yaml_document_delete(&document);
-    if (!iree_status_is_ok(status)) break;
-  }
+  iree_status_t status = iree_trace_replay_stream_file(
+      &replay, file, iree_run_trace_event, /*user_data=*/NULL);
 
-  yaml_parser_delete(&parser);
   iree_trace_replay_deinitialize(
       &replay, FLAG_print_statistics
                    ? IREE_TRACE_REPLAY_SHUTDOWN_PRINT_STATISTICS
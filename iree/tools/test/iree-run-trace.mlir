@@ -0,0 +1,39 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: iree-compile --iree-hal-target-backends=vmvx -iree-mlir-to-vm-bytecode-module %s -o %t/module.vmfb
+// RUN: printf "type: context_load\n---\ntype: module_load\nmodule:\n  type: builtin\n  name: hal\n---\ntype: module_load\nmodule:\n  type: bytecode\n  path: module.vmfb\n---\ntype: call\nfunction: module.double\nargs:\n- type: hal.buffer_view\n" > %t/prefix.yml
+
+// A .npy side-file provides the shape and element type.
+// RUN: printf "\223NUMPY\001\000\072\000{'descr': '<f4', 'fortran_order': False, 'shape': (4,), }\n\000\000\200\077\000\000\000\100\000\000\100\100\000\000\200\100" > %t/f32.npy
+// RUN: cat %t/prefix.yml > %t/npy.yml && printf "  contents_file: f32.npy\n" >> %t/npy.yml
+// RUN: iree-run-trace %t/npy.yml | FileCheck %s --check-prefix=NPY
+// NPY: --- CALL[module.double] ---
+// NPY: 4xf32=2 4 6 8
+
+// Metadata given in the trace must agree with the .npy header.
+// RUN: printf "\223NUMPY\001\000\072\000{'descr': '<f8', 'fortran_order': False, 'shape': (2,), }\n\000\000\000\000\000\000\360\077\000\000\000\000\000\000\000\100" > %t/f64.npy
+// RUN: cat %t/prefix.yml > %t/npy_mismatch.yml && printf "  contents_file: f64.npy\n  shape: 4\n  element_type: f32\n" >> %t/npy_mismatch.yml
+// RUN: (iree-run-trace %t/npy_mismatch.yml 2>&1 || true) | FileCheck %s --check-prefix=NPY-MISMATCH
+// NPY-MISMATCH: does not match the npy element type
+
+// Element sizes of 10 bytes or more are parsed in full.
+// RUN: printf "\223NUMPY\001\000\073\000{'descr': '<f16', 'fortran_order': False, 'shape': (1,), }\n\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000" > %t/f128.npy
+// RUN: cat %t/prefix.yml > %t/npy_wide.yml && printf "  contents_file: f128.npy\n  shape: 4\n  element_type: f32\n" >> %t/npy_wide.yml
+// RUN: (iree-run-trace %t/npy_wide.yml 2>&1 || true) | FileCheck %s --check-prefix=NPY-WIDE
+// NPY-WIDE: element_type {{.+}} does not match the npy element type
+
+// Raw side-files take their metadata from the trace and may skip a header.
+// RUN: printf "\377\377\377\377\000\000\200\077\000\000\000\100\000\000\100\100\000\000\200\100" > %t/f32.bin
+// RUN: cat %t/prefix.yml > %t/raw.yml && printf "  contents_file: f32.bin\n  contents_offset: 4\n  shape: 4\n  element_type: f32\n" >> %t/raw.yml
+// RUN: iree-run-trace %t/raw.yml | FileCheck %s --check-prefix=RAW
+// RAW: --- CALL[module.double] ---
+// RAW: 4xf32=2 4 6 8
+
+// Side-files larger than the buffer are rejected.
+// RUN: cat %t/prefix.yml > %t/raw_size.yml && printf "  contents_file: f32.bin\n  shape: 4\n  element_type: f32\n" >> %t/raw_size.yml
+// RUN: (iree-run-trace %t/raw_size.yml 2>&1 || true) | FileCheck %s --check-prefix=RAW-SIZE
+// RAW-SIZE: contents_file has 20 bytes but the buffer requires 16
+
+func.func @double(%input : tensor<4xf32>) -> (tensor<4xf32>) {
+  %result = arith.addf %input, %input : tensor<4xf32>
+  return %result : tensor<4xf32>
+}
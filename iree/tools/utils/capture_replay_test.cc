@@ -0,0 +1,258 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Captures calls made through a runtime session and replays the resulting
+// trace to ensure the two stay in sync.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/hal/api.h"
+#include "iree/modules/hal/module.h"
+#include "iree/runtime/api.h"
+#include "iree/runtime/testdata/simple_mul_module_c.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/tools/utils/trace_replay.h"
+#include "iree/tools/utils/yaml_util.h"
+#include "iree/vm/api.h"
+#include "iree/vm/native_module_test.h"
+
+namespace {
+
+std::string GetTestTempDir() {
+  char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) {
+    test_tmpdir = getenv("TMPDIR");
+  }
+  if (!test_tmpdir) {
+    test_tmpdir = getenv("TEMP");
+  }
+  IREE_CHECK(test_tmpdir) << "TEST_TMPDIR/TMPDIR/TEMP not defined";
+  return test_tmpdir;
+}
+
+// Calls `module.simple_mul` with |lhs| and |rhs| and returns the result.
+std::vector<float> CallSimpleMul(iree_runtime_session_t* session,
+                                 const std::vector<float>& lhs,
+                                 const std::vector<float>& rhs) {
+  iree_runtime_call_t call;
+  IREE_CHECK_OK(iree_runtime_call_initialize_by_name(
+      session, iree_make_cstring_view("module.simple_mul"), &call));
+  for (const auto* values : {&lhs, &rhs}) {
+    iree_hal_dim_t shape[1] = {(iree_hal_dim_t)values->size()};
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    params.usage = IREE_HAL_BUFFER_USAGE_ALL;
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    IREE_CHECK_OK(iree_hal_buffer_view_allocate_buffer(
+        iree_runtime_session_device_allocator(session), shape,
+        IREE_ARRAYSIZE(shape), IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, params,
+        iree_make_const_byte_span(values->data(),
+                                  values->size() * sizeof(float)),
+        &buffer_view));
+    IREE_CHECK_OK(
+        iree_runtime_call_inputs_push_back_buffer_view(&call, buffer_view));
+    iree_hal_buffer_view_release(buffer_view);
+  }
+  IREE_CHECK_OK(iree_runtime_call_invoke(&call, /*flags=*/0));
+  iree_hal_buffer_view_t* result = NULL;
+  IREE_CHECK_OK(
+      iree_runtime_call_outputs_pop_front_buffer_view(&call, &result));
+  std::vector<float> values(iree_hal_buffer_view_element_count(result));
+  IREE_CHECK_OK(iree_hal_buffer_map_read(iree_hal_buffer_view_buffer(result),
+                                         0, values.data(),
+                                         values.size() * sizeof(float)));
+  iree_hal_buffer_view_release(result);
+  iree_runtime_call_deinitialize(&call);
+  return values;
+}
+
+// Replays each event and stashes the f32 results of calls in |user_data|.
+iree_status_t ReplayAndCollectResults(void* user_data,
+                                      iree_trace_replay_t* replay,
+                                      yaml_document_t* document,
+                                      yaml_node_t* event_node) {
+  auto* results = reinterpret_cast<std::vector<std::vector<float>>*>(user_data);
+  yaml_node_t* type_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_find(
+      document, event_node, iree_make_cstring_view("type"), &type_node));
+  if (!iree_yaml_string_equal(type_node, iree_make_cstring_view("call"))) {
+    return iree_trace_replay_event(replay, document, event_node);
+  }
+  iree_vm_list_t* output_list = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_trace_replay_event_call(replay, document, event_node, &output_list));
+  iree_hal_buffer_view_t* result =
+      iree_vm_list_get_buffer_view_assign(output_list, 0);
+  iree_status_t status = iree_ok_status();
+  if (result) {
+    std::vector<float> values(iree_hal_buffer_view_element_count(result));
+    status = iree_hal_buffer_map_read(iree_hal_buffer_view_buffer(result), 0,
+                                      values.data(),
+                                      values.size() * sizeof(float));
+    results->push_back(std::move(values));
+  } else {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "expected a buffer view result");
+  }
+  iree_vm_list_release(output_list);
+  return status;
+}
+
+TEST(CaptureReplayTest, RoundTrip) {
+  std::string output_path = GetTestTempDir();
+
+  iree_runtime_instance_options_t instance_options;
+  iree_runtime_instance_options_initialize(IREE_API_VERSION_LATEST,
+                                           &instance_options);
+  iree_runtime_instance_options_use_all_available_drivers(&instance_options);
+  iree_runtime_instance_t* instance = NULL;
+  IREE_ASSERT_OK(iree_runtime_instance_create(
+      &instance_options, iree_allocator_system(), &instance));
+
+  iree_runtime_capture_options_t capture_options;
+  iree_runtime_capture_options_initialize(&capture_options);
+  capture_options.output_path = iree_make_cstring_view(output_path.c_str());
+  iree_runtime_capture_t* capture = NULL;
+  IREE_ASSERT_OK(iree_runtime_capture_create(
+      &capture_options, iree_allocator_system(), &capture));
+
+  // Make a few calls through a captured session and remember their results.
+  iree_hal_device_t* device = NULL;
+  IREE_ASSERT_OK(iree_runtime_instance_try_create_default_device(
+      instance, iree_make_cstring_view("vmvx"), &device));
+  iree_runtime_session_options_t session_options;
+  iree_runtime_session_options_initialize(&session_options);
+  session_options.capture = capture;
+  iree_runtime_session_t* session = NULL;
+  IREE_ASSERT_OK(iree_runtime_session_create_with_device(
+      instance, &session_options, device,
+      iree_runtime_instance_host_allocator(instance), &session));
+  iree_hal_device_release(device);
+  const iree_file_toc_t* module_file =
+      iree_runtime_testdata_simple_mul_module_create();
+  IREE_ASSERT_OK(iree_runtime_session_append_bytecode_module_from_memory(
+      session, iree_make_const_byte_span(module_file->data, module_file->size),
+      iree_allocator_null()));
+  std::vector<std::vector<float>> expected_results;
+  expected_results.push_back(CallSimpleMul(session, {1.0f, 2.0f, 3.0f, 4.0f},
+                                           {2.0f, 2.0f, 2.0f, 2.0f}));
+  expected_results.push_back(CallSimpleMul(session, {-1.5f, 0.0f, 8.0f, 0.25f},
+                                           {4.0f, 9.0f, -0.5f, 16.0f}));
+  iree_runtime_session_release(session);
+
+  IREE_ASSERT_OK(iree_runtime_capture_flush(capture));
+  uint64_t captured_count = 0;
+  uint64_t dropped_count = 0;
+  iree_runtime_capture_query_statistics(capture, &captured_count,
+                                        &dropped_count);
+  EXPECT_EQ(captured_count, expected_results.size());
+  EXPECT_EQ(dropped_count, 0u);
+  iree_runtime_capture_release(capture);
+  iree_runtime_instance_release(instance);
+
+  // Replay the trace in a fresh instance and compare results.
+  iree_vm_instance_t* vm_instance = NULL;
+  IREE_ASSERT_OK(
+      iree_vm_instance_create(iree_allocator_system(), &vm_instance));
+  iree_trace_replay_t replay;
+  IREE_ASSERT_OK(iree_trace_replay_initialize(
+      iree_make_cstring_view(output_path.c_str()), vm_instance,
+      IREE_VM_CONTEXT_FLAG_NONE, iree_allocator_system(), &replay));
+  iree_trace_replay_set_hal_driver_override(&replay,
+                                            iree_make_cstring_view("vmvx"));
+  std::string trace_path = output_path + "/calls.yaml";
+  FILE* file = fopen(trace_path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<std::vector<float>> replayed_results;
+  iree_status_t status = iree_trace_replay_stream_file(
+      &replay, file, ReplayAndCollectResults, &replayed_results);
+  fclose(file);
+  iree_trace_replay_deinitialize(&replay, IREE_TRACE_REPLAY_SHUTDOWN_QUIET);
+  iree_vm_instance_release(vm_instance);
+  IREE_ASSERT_OK(status);
+
+  EXPECT_EQ(replayed_results, expected_results);
+}
+
+// Native modules cannot be replayed but must not prevent capturing sessions
+// that use them.
+TEST(CaptureReplayTest, NativeModule) {
+  std::string output_path = GetTestTempDir();
+
+  iree_runtime_instance_options_t instance_options;
+  iree_runtime_instance_options_initialize(IREE_API_VERSION_LATEST,
+                                           &instance_options);
+  iree_runtime_instance_options_use_all_available_drivers(&instance_options);
+  iree_runtime_instance_t* instance = NULL;
+  IREE_ASSERT_OK(iree_runtime_instance_create(
+      &instance_options, iree_allocator_system(), &instance));
+
+  iree_runtime_capture_options_t capture_options;
+  iree_runtime_capture_options_initialize(&capture_options);
+  capture_options.output_path = iree_make_cstring_view(output_path.c_str());
+  iree_runtime_capture_t* capture = NULL;
+  IREE_ASSERT_OK(iree_runtime_capture_create(
+      &capture_options, iree_allocator_system(), &capture));
+
+  iree_hal_device_t* device = NULL;
+  IREE_ASSERT_OK(iree_runtime_instance_try_create_default_device(
+      instance, iree_make_cstring_view("vmvx"), &device));
+  iree_runtime_session_options_t session_options;
+  iree_runtime_session_options_initialize(&session_options);
+  session_options.capture = capture;
+  iree_runtime_session_t* session = NULL;
+  IREE_ASSERT_OK(iree_runtime_session_create_with_device(
+      instance, &session_options, device,
+      iree_runtime_instance_host_allocator(instance), &session));
+  iree_hal_device_release(device);
+  iree_vm_module_t* module = NULL;
+  IREE_ASSERT_OK(module_a_create(iree_allocator_system(), &module));
+  IREE_EXPECT_OK(iree_runtime_session_append_module(session, module));
+  iree_vm_module_release(module);
+  iree_runtime_session_release(session);
+  IREE_ASSERT_OK(iree_runtime_capture_flush(capture));
+  iree_runtime_capture_release(capture);
+  iree_runtime_instance_release(instance);
+
+  // Replaying fails once it reaches the native module.
+  iree_vm_instance_t* vm_instance = NULL;
+  IREE_ASSERT_OK(
+      iree_vm_instance_create(iree_allocator_system(), &vm_instance));
+  iree_trace_replay_t replay;
+  IREE_ASSERT_OK(iree_trace_replay_initialize(
+      iree_make_cstring_view(output_path.c_str()), vm_instance,
+      IREE_VM_CONTEXT_FLAG_NONE, iree_allocator_system(), &replay));
+  iree_trace_replay_set_hal_driver_override(&replay,
+                                            iree_make_cstring_view("vmvx"));
+  std::string trace_path = output_path + "/calls.yaml";
+  FILE* file = fopen(trace_path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  iree_status_t status = iree_trace_replay_stream_file(
+      &replay, file,
+      [](void* user_data, iree_trace_replay_t* replay,
+         yaml_document_t* document, yaml_node_t* event_node) {
+        return iree_trace_replay_event(replay, document, event_node);
+      },
+      NULL);
+  fclose(file);
+  iree_trace_replay_deinitialize(&replay, IREE_TRACE_REPLAY_SHUTDOWN_QUIET);
+  iree_vm_instance_release(vm_instance);
+  EXPECT_THAT(iree::Status(std::move(status)),
+              iree::testing::status::StatusIs(
+                  iree::StatusCode::kUnimplemented));
+}
+
+}  // namespace
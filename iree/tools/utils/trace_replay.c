@@ -180,6 +180,17 @@ iree_status_t iree_trace_replay_event_module_load(iree_trace_replay_t* replay,
   } else if (iree_string_view_equal(type, iree_make_cstring_view("bytecode"))) {
     return iree_trace_replay_load_bytecode_module(replay, document,
                                                   module_node);
+  } else if (iree_string_view_equal(type, iree_make_cstring_view("native"))) {
+    // Native modules other than builtins are recorded by captures but their
+    // implementation is not part of the trace.
+    yaml_node_t* name_node = NULL;
+    IREE_RETURN_IF_ERROR(iree_yaml_mapping_find(
+        document, module_node, iree_make_cstring_view("name"), &name_node));
+    iree_string_view_t name = iree_yaml_node_as_string(name_node);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "native module '%.*s' was not captured and cannot "
+                            "be replayed",
+                            (int)name.size, name.data);
   }
 
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
@@ -670,6 +681,372 @@ static iree_status_t iree_trace_replay_generate_hal_buffer_callback(
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Binary side-files
+//===----------------------------------------------------------------------===//
+
+// A binary file referenced by a trace event holding buffer contents.
+// The file is memory-mapped and when possible imported directly into the HAL
+// buffer without copying.
+typedef struct iree_trace_replay_side_file_t {
+  // Mapped file contents; owned until released or transferred to a buffer.
+  iree_file_contents_t* contents;
+  // Payload data within |contents| (excluding any file header).
+  iree_const_byte_span_t data;
+  // Element type and shape parsed from the file header, if present.
+  // Raw binary files have no metadata and leave these NONE/0.
+  iree_hal_element_type_t element_type;
+  iree_host_size_t shape_rank;
+  iree_hal_dim_t shape[16];
+} iree_trace_replay_side_file_t;
+
+static void iree_trace_replay_side_file_deinitialize(
+    iree_trace_replay_side_file_t* side_file) {
+  iree_file_contents_free(side_file->contents);
+  memset(side_file, 0, sizeof(*side_file));
+}
+
+// Finds the quoted value of the given |key| in a Python dictionary literal
+// such as those used in .npy headers: `{'key': value, ...}`.
+static iree_string_view_t iree_trace_replay_npy_find_value(
+    iree_string_view_t header, iree_string_view_t key) {
+  for (iree_host_size_t i = 0; i + key.size + 2 < header.size; ++i) {
+    iree_string_view_t remaining = iree_string_view_substr(
+        header, i, IREE_STRING_VIEW_NPOS);
+    if (remaining.data[0] != '\'' ||
+        !iree_string_view_starts_with(
+            iree_string_view_substr(remaining, 1, IREE_STRING_VIEW_NPOS),
+            key) ||
+        remaining.data[1 + key.size] != '\'') {
+      continue;
+    }
+    iree_string_view_t value = iree_string_view_trim(iree_string_view_substr(
+        remaining, 1 + key.size + 1, IREE_STRING_VIEW_NPOS));
+    if (!iree_string_view_consume_prefix(&value, iree_make_cstring_view(":"))) {
+      return iree_string_view_empty();
+    }
+    return iree_string_view_trim(value);
+  }
+  return iree_string_view_empty();
+}
+
+// Parses a .npy dtype descriptor such as `'<f4'` into an element type.
+static iree_status_t iree_trace_replay_parse_npy_descr(
+    iree_string_view_t value, iree_hal_element_type_t* out_element_type) {
+  // Quoted string of [byte order][kind][byte count], e.g. '<f4'.
+  iree_string_view_t descr = iree_string_view_empty();
+  if (value.size >= 5 && value.data[0] == '\'') {
+    descr = iree_string_view_substr(
+        value, 1, iree_string_view_find_char(value, '\'', 1) - 1);
+  }
+  if (descr.size < 3) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed npy descr '%.*s'", (int)value.size,
+                            value.data);
+  }
+  char byte_order = descr.data[0];
+  char kind = descr.data[1];
+  // The byte count may have several digits (e.g. '<c16'); the element bit
+  // count must fit in the low 24 bits of the element type.
+  uint32_t byte_count = 0;
+  for (iree_host_size_t i = 2; i < descr.size; ++i) {
+    char c = descr.data[i];
+    if (c < '0' || c > '9' || byte_count > 0x1FFFFFu / 10) {
+      byte_count = 0;
+      break;
+    }
+    byte_count = byte_count * 10 + (uint32_t)(c - '0');
+  }
+  if (byte_count == 0 || byte_count > 0x1FFFFFu) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unsupported npy descr '%.*s'", (int)descr.size,
+                            descr.data);
+  }
+  if (byte_order == '>' && byte_count > 1) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "big-endian npy data not supported ('%.*s')",
+                            (int)descr.size, descr.data);
+  }
+  iree_hal_numerical_type_t numerical_type = IREE_HAL_NUMERICAL_TYPE_UNKNOWN;
+  switch (kind) {
+    case 'f':
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_FLOAT_IEEE;
+      break;
+    case 'i':
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_INTEGER_SIGNED;
+      break;
+    case 'b':  // bool stored as i8
+    case 'u':
+      numerical_type = IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported npy dtype kind '%c'", kind);
+  }
+  *out_element_type =
+      IREE_HAL_ELEMENT_TYPE_VALUE(numerical_type, byte_count * 8);
+  return iree_ok_status();
+}
+
+// Parses a .npy shape tuple such as `(4, 8)` or `(16,)`.
+static iree_status_t iree_trace_replay_parse_npy_shape(
+    iree_string_view_t value, iree_host_size_t shape_capacity,
+    iree_hal_dim_t* shape, iree_host_size_t* out_shape_rank) {
+  *out_shape_rank = 0;
+  if (!iree_string_view_consume_prefix(&value, iree_make_cstring_view("("))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed npy shape '%.*s'", (int)value.size,
+                            value.data);
+  }
+  value = iree_string_view_substr(value, 0,
+                                  iree_string_view_find_char(value, ')', 0));
+  iree_host_size_t shape_rank = 0;
+  while (!iree_string_view_is_empty(value)) {
+    iree_string_view_t dim_str = iree_string_view_empty();
+    iree_string_view_split(value, ',', &dim_str, &value);
+    dim_str = iree_string_view_trim(dim_str);
+    if (iree_string_view_is_empty(dim_str)) continue;
+    int64_t dim = 0;
+    if (!iree_string_view_atoi_int64(dim_str, &dim)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid npy shape dimension '%.*s'",
+                              (int)dim_str.size, dim_str.data);
+    }
+    if (shape_rank >= shape_capacity) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "npy shape rank overflow (>%zu)", shape_capacity);
+    }
+    shape[shape_rank++] = (iree_hal_dim_t)dim;
+  }
+  *out_shape_rank = shape_rank;
+  return iree_ok_status();
+}
+
+// Parses the header of a NumPy .npy file in |side_file| and updates the
+// payload data range and metadata.
+// See https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html.
+static iree_status_t iree_trace_replay_parse_npy_header(
+    iree_trace_replay_side_file_t* side_file) {
+  iree_const_byte_span_t file_data = side_file->contents->const_buffer;
+  if (file_data.data_length < 10) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npy file truncated");
+  }
+  uint8_t major_version = file_data.data[6];
+  iree_host_size_t header_offset = 0;
+  iree_host_size_t header_length = 0;
+  if (major_version == 1) {
+    header_offset = 10;
+    header_length = (iree_host_size_t)file_data.data[8] |
+                    ((iree_host_size_t)file_data.data[9] << 8);
+  } else if (major_version == 2 || major_version == 3) {
+    if (file_data.data_length < 12) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "npy file truncated");
+    }
+    header_offset = 12;
+    header_length = (iree_host_size_t)file_data.data[8] |
+                    ((iree_host_size_t)file_data.data[9] << 8) |
+                    ((iree_host_size_t)file_data.data[10] << 16) |
+                    ((iree_host_size_t)file_data.data[11] << 24);
+  } else {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unsupported npy version %u", major_version);
+  }
+  if (header_offset + header_length > file_data.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npy header extends past end of file");
+  }
+  iree_string_view_t header = iree_make_string_view(
+      (const char*)file_data.data + header_offset, header_length);
+
+  IREE_RETURN_IF_ERROR(iree_trace_replay_parse_npy_descr(
+      iree_trace_replay_npy_find_value(header, iree_make_cstring_view("descr")),
+      &side_file->element_type));
+  if (iree_string_view_starts_with(
+          iree_trace_replay_npy_find_value(
+              header, iree_make_cstring_view("fortran_order")),
+          iree_make_cstring_view("True"))) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "fortran-ordered npy data not supported");
+  }
+  IREE_RETURN_IF_ERROR(iree_trace_replay_parse_npy_shape(
+      iree_trace_replay_npy_find_value(header, iree_make_cstring_view("shape")),
+      IREE_ARRAYSIZE(side_file->shape), side_file->shape,
+      &side_file->shape_rank));
+
+  iree_host_size_t data_offset = header_offset + header_length;
+  side_file->data = iree_make_const_byte_span(
+      file_data.data + data_offset, file_data.data_length - data_offset);
+  return iree_ok_status();
+}
+
+// Maps the side-file referenced by |file_node| into |out_side_file|.
+// Files starting with the .npy magic have their header parsed for the element
+// type and shape; all others are treated as raw binary data starting at the
+// optional |offset_node| byte offset.
+//
+// ```yaml
+// contents_file: weights.npy
+// ```
+// or
+// ```yaml
+// contents_file: activations.bin
+// contents_offset: 4096
+// ```
+static iree_status_t iree_trace_replay_open_side_file(
+    iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* file_node, yaml_node_t* offset_node,
+    iree_trace_replay_side_file_t* out_side_file) {
+  memset(out_side_file, 0, sizeof(*out_side_file));
+  if (file_node->type != YAML_SCALAR_NODE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "(%zu): expected scalar node for contents_file",
+                            file_node->start_mark.line);
+  }
+
+  char* full_path = NULL;
+  IREE_RETURN_IF_ERROR(iree_file_path_join(
+      replay->root_path, iree_yaml_node_as_string(file_node),
+      replay->host_allocator, &full_path));
+  iree_status_t status = iree_file_map_contents(
+      full_path, replay->host_allocator, &out_side_file->contents);
+  iree_allocator_free(replay->host_allocator, full_path);
+  IREE_RETURN_IF_ERROR(status);
+  out_side_file->data = out_side_file->contents->const_buffer;
+
+  static const uint8_t kNpyMagic[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+  if (out_side_file->data.data_length >= sizeof(kNpyMagic) &&
+      memcmp(out_side_file->data.data, kNpyMagic, sizeof(kNpyMagic)) == 0) {
+    if (offset_node) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "(%zu): contents_offset not allowed with npy",
+                                offset_node->start_mark.line);
+    } else {
+      status = iree_trace_replay_parse_npy_header(out_side_file);
+    }
+  } else if (offset_node) {
+    uint64_t offset = 0;
+    if (!iree_string_view_atoi_uint64(iree_yaml_node_as_string(offset_node),
+                                      &offset) ||
+        offset > out_side_file->data.data_length) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "(%zu): invalid contents_offset",
+                                offset_node->start_mark.line);
+    } else {
+      out_side_file->data = iree_make_const_byte_span(
+          out_side_file->data.data + offset,
+          out_side_file->data.data_length - (iree_host_size_t)offset);
+    }
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_trace_replay_side_file_deinitialize(out_side_file);
+    status = iree_status_annotate_f(
+        status, "(%zu): loading contents_file", file_node->start_mark.line);
+  }
+  return status;
+}
+
+// Returns true if npy elements of |npy_element_type| can be read as
+// |element_type|. Signless integer types accept both signed and unsigned data
+// of the same width.
+static bool iree_trace_replay_npy_element_type_matches(
+    iree_hal_element_type_t npy_element_type,
+    iree_hal_element_type_t element_type) {
+  if (npy_element_type == element_type) return true;
+  return iree_hal_element_numerical_type(element_type) ==
+             IREE_HAL_NUMERICAL_TYPE_INTEGER &&
+         iree_hal_element_numerical_type_is_integer(npy_element_type) &&
+         iree_hal_element_bit_count(npy_element_type) ==
+             iree_hal_element_bit_count(element_type);
+}
+
+// Verifies that the |shape| and |element_type| of a buffer view agree with the
+// header of the .npy |side_file| providing its contents.
+static iree_status_t iree_trace_replay_verify_npy_metadata(
+    const iree_trace_replay_side_file_t* side_file, const iree_hal_dim_t* shape,
+    iree_host_size_t shape_rank, iree_hal_element_type_t element_type,
+    yaml_node_t* value_node) {
+  if (!iree_trace_replay_npy_element_type_matches(side_file->element_type,
+                                                  element_type)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "(%zu): element_type %08X does not match the npy "
+                            "element type %08X",
+                            value_node->start_mark.line, element_type,
+                            side_file->element_type);
+  }
+  bool shape_matches = shape_rank == side_file->shape_rank;
+  for (iree_host_size_t i = 0; shape_matches && i < shape_rank; ++i) {
+    shape_matches = shape[i] == side_file->shape[i];
+  }
+  if (!shape_matches) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "(%zu): shape does not match the npy shape",
+                            value_node->start_mark.line);
+  }
+  return iree_ok_status();
+}
+
+static void iree_trace_replay_release_side_file_contents(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
+// Creates a buffer of |allocation_size| with the contents of |side_file|.
+// The mapped file is imported directly when the device allocator supports
+// host allocations and otherwise copied into a new allocation. On return the
+// side-file contents have either been transferred to the buffer or released.
+static iree_status_t iree_trace_replay_import_side_file(
+    iree_trace_replay_t* replay, iree_trace_replay_side_file_t* side_file,
+    iree_hal_buffer_params_t buffer_params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  // Trailing data is as likely to be a shape or type mistake as truncated data
+  // is so both are rejected.
+  if (side_file->data.data_length != allocation_size) {
+    iree_host_size_t data_length = side_file->data.data_length;
+    iree_trace_replay_side_file_deinitialize(side_file);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "contents_file has %zu bytes but the buffer "
+                            "requires %" PRIu64,
+                            data_length, (uint64_t)allocation_size);
+  }
+
+  iree_hal_allocator_t* device_allocator =
+      iree_hal_device_allocator(replay->device);
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = allocation_size,
+      .handle.host_allocation.ptr = (void*)side_file->data.data,
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_trace_replay_release_side_file_contents,
+      .user_data = side_file->contents,
+  };
+  iree_status_t status =
+      iree_hal_allocator_import_buffer(device_allocator, buffer_params,
+                                       &external_buffer, release_callback,
+                                       out_buffer);
+  if (iree_status_is_ok(status)) {
+    // Ownership of the mapping was transferred to the buffer.
+    side_file->contents = NULL;
+  } else if (iree_status_is_unavailable(status) ||
+             iree_status_is_out_of_range(status)) {
+    // Import not supported by the device (or the data is not suitably aligned);
+    // fall back to copying from the mapping.
+    iree_status_ignore(status);
+    status = iree_hal_allocator_allocate_buffer(
+        device_allocator, buffer_params, allocation_size,
+        iree_make_const_byte_span(side_file->data.data,
+                                  (iree_host_size_t)allocation_size),
+        out_buffer);
+  }
+  iree_trace_replay_side_file_deinitialize(side_file);
+  return status;
+}
+
 // Parses a !hal.buffer and appends it to |target_list|.
 //
 // ```yaml
@@ -734,50 +1111,139 @@ static iree_status_t iree_trace_replay_parse_hal_buffer(
 // contents: !!binary |
 //   AACAPwAAAEAAAEBAAACAQA==
 // ```
+// or, with the contents in a binary side-file relative to the trace file:
+// ```yaml
+// contents_file: input0.npy
+// ```
+// The element type and shape may be omitted when the side-file is a .npy file;
+// when given they must match its header. The side-file data must be exactly the
+// size of the buffer view.
 static iree_status_t iree_trace_replay_parse_hal_buffer_view(
     iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* value_node, iree_vm_list_t* target_list) {
-  yaml_node_t* shape_node = NULL;
+  yaml_node_t* contents_node = NULL;
   IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
-      document, value_node, iree_make_cstring_view("shape"), &shape_node));
+      document, value_node, iree_make_cstring_view("contents"),
+      &contents_node));
+
+  yaml_node_t* generator_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
+      document, value_node, iree_make_cstring_view("contents_generator"),
+      &generator_node));
+
+  yaml_node_t* file_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
+      document, value_node, iree_make_cstring_view("contents_file"),
+      &file_node));
+  yaml_node_t* file_offset_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
+      document, value_node, iree_make_cstring_view("contents_offset"),
+      &file_offset_node));
+
+  if ((contents_node ? 1 : 0) + (generator_node ? 1 : 0) +
+          (file_node ? 1 : 0) >
+      1) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "(%zu): only one of contents, contents_generator, or contents_file "
+        "may be specified",
+        value_node->start_mark.line);
+  }
+
+  // Map the side-file first so that its header can provide the metadata.
+  iree_trace_replay_side_file_t side_file;
+  memset(&side_file, 0, sizeof(side_file));
+  if (file_node) {
+    IREE_RETURN_IF_ERROR(iree_trace_replay_open_side_file(
+        replay, document, file_node, file_offset_node, &side_file));
+  }
+
+  yaml_node_t* shape_node = NULL;
   iree_hal_dim_t shape[16];
   iree_host_size_t shape_rank = 0;
-  IREE_RETURN_IF_ERROR(iree_trace_replay_parse_hal_shape(
-      replay, document, shape_node, IREE_ARRAYSIZE(shape), shape, &shape_rank));
+  iree_status_t status = iree_yaml_mapping_try_find(
+      document, value_node, iree_make_cstring_view("shape"), &shape_node);
+  if (iree_status_is_ok(status) && !shape_node &&
+      side_file.element_type != IREE_HAL_ELEMENT_TYPE_NONE) {
+    shape_rank = side_file.shape_rank;
+    memcpy(shape, side_file.shape, shape_rank * sizeof(*shape));
+  } else if (iree_status_is_ok(status)) {
+    status = iree_trace_replay_parse_hal_shape(replay, document, shape_node,
+                                               IREE_ARRAYSIZE(shape), shape,
+                                               &shape_rank);
+  }
 
   yaml_node_t* element_type_node = NULL;
-  IREE_RETURN_IF_ERROR(iree_yaml_mapping_find(
-      document, value_node, iree_make_cstring_view("element_type"),
-      &element_type_node));
-  iree_hal_element_type_t element_type = IREE_HAL_ELEMENT_TYPE_NONE;
-  IREE_RETURN_IF_ERROR(iree_trace_replay_parse_hal_element_type(
-      replay, document, element_type_node, &element_type));
+  iree_hal_element_type_t element_type = side_file.element_type;
+  if (iree_status_is_ok(status)) {
+    status = iree_yaml_mapping_try_find(document, value_node,
+                                        iree_make_cstring_view("element_type"),
+                                        &element_type_node);
+  }
+  if (iree_status_is_ok(status) && element_type_node) {
+    status = iree_trace_replay_parse_hal_element_type(
+        replay, document, element_type_node, &element_type);
+  } else if (iree_status_is_ok(status) &&
+             element_type == IREE_HAL_ELEMENT_TYPE_NONE) {
+    status = iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "(%zu): element_type not found",
+                              value_node->start_mark.line);
+  }
 
   yaml_node_t* encoding_type_node = NULL;
-  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
-      document, value_node, iree_make_cstring_view("encoding_type"),
-      &encoding_type_node));
   iree_hal_encoding_type_t encoding_type =
       IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
-  IREE_RETURN_IF_ERROR(iree_trace_replay_parse_hal_encoding_type(
-      replay, document, encoding_type_node, &encoding_type));
+  if (iree_status_is_ok(status)) {
+    status = iree_yaml_mapping_try_find(
+        document, value_node, iree_make_cstring_view("encoding_type"),
+        &encoding_type_node);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_trace_replay_parse_hal_encoding_type(
+        replay, document, encoding_type_node, &encoding_type);
+  }
 
-  yaml_node_t* contents_node = NULL;
-  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
-      document, value_node, iree_make_cstring_view("contents"),
-      &contents_node));
+  // Metadata given alongside a .npy side-file must agree with its header so
+  // that the data is never reinterpreted (such as f64 data read as f32).
+  if (iree_status_is_ok(status) &&
+      side_file.element_type != IREE_HAL_ELEMENT_TYPE_NONE) {
+    status = iree_trace_replay_verify_npy_metadata(
+        &side_file, shape, shape_rank, element_type, value_node);
+  }
 
-  yaml_node_t* generator_node = NULL;
-  IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
-      document, value_node, iree_make_cstring_view("contents_generator"),
-      &generator_node));
+  if (!iree_status_is_ok(status)) {
+    iree_trace_replay_side_file_deinitialize(&side_file);
+    return status;
+  }
 
+  const iree_hal_buffer_params_t buffer_params = {
+      .type =
+          IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      .usage = IREE_HAL_BUFFER_USAGE_DISPATCH | IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
   iree_hal_buffer_view_t* buffer_view = NULL;
-  if (contents_node && generator_node) {
-    return iree_make_status(
-        IREE_STATUS_INVALID_ARGUMENT,
-        "(%zu): cannot have both contents and contents_generator",
-        generator_node->start_mark.line);
+  if (file_node) {
+    // Import the mapped side-file directly, bypassing YAML entirely.
+    iree_device_size_t allocation_size = 0;
+    iree_hal_buffer_t* buffer = NULL;
+    status = iree_hal_buffer_compute_view_size(
+        shape, shape_rank, element_type, encoding_type, &allocation_size);
+    if (iree_status_is_ok(status)) {
+      status = iree_trace_replay_import_side_file(
+          replay, &side_file, buffer_params, allocation_size, &buffer);
+    } else {
+      iree_trace_replay_side_file_deinitialize(&side_file);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_view_create(buffer, shape, shape_rank,
+                                           element_type, encoding_type,
+                                           replay->host_allocator,
+                                           &buffer_view);
+    }
+    iree_hal_buffer_release(buffer);
+    IREE_RETURN_IF_ERROR(status, "(%zu): importing contents_file",
+                         file_node->start_mark.line);
   } else if (contents_node || generator_node) {
     iree_trace_replay_generation_params_t params = {
         .replay = replay,
@@ -790,32 +1256,17 @@ static iree_status_t iree_trace_replay_parse_hal_buffer_view(
     };
     IREE_RETURN_IF_ERROR(iree_hal_buffer_view_generate_buffer(
         iree_hal_device_allocator(replay->device), shape, shape_rank,
-        element_type, encoding_type,
-        (iree_hal_buffer_params_t){
-            .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
-                    IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
-            .usage = IREE_HAL_BUFFER_USAGE_DISPATCH |
-                     IREE_HAL_BUFFER_USAGE_TRANSFER |
-                     IREE_HAL_BUFFER_USAGE_MAPPING,
-        },
+        element_type, encoding_type, buffer_params,
         iree_trace_replay_generate_hal_buffer_callback, &params, &buffer_view));
   } else {
     IREE_RETURN_IF_ERROR(iree_hal_buffer_view_allocate_buffer(
         iree_hal_device_allocator(replay->device), shape, shape_rank,
-        element_type, encoding_type,
-        (iree_hal_buffer_params_t){
-            .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
-                    IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
-            .usage = IREE_HAL_BUFFER_USAGE_DISPATCH |
-                     IREE_HAL_BUFFER_USAGE_TRANSFER |
-                     IREE_HAL_BUFFER_USAGE_MAPPING,
-        },
+        element_type, encoding_type, buffer_params,
         iree_const_byte_span_empty(), &buffer_view));
   }
 
   iree_vm_ref_t buffer_view_ref = iree_hal_buffer_view_move_ref(buffer_view);
-  iree_status_t status =
-      iree_vm_list_push_ref_move(target_list, &buffer_view_ref);
+  status = iree_vm_list_push_ref_move(target_list, &buffer_view_ref);
   iree_vm_ref_release(&buffer_view_ref);
   return status;
 }
@@ -1130,3 +1581,39 @@ iree_status_t iree_trace_replay_event(iree_trace_replay_t* replay,
       event_node->start_mark.line, (int)type_node->data.scalar.length,
       type_node->data.scalar.value);
 }
+
+iree_status_t iree_trace_replay_stream_file(
+    iree_trace_replay_t* replay, FILE* file,
+    iree_trace_replay_event_callback_fn_t callback, void* user_data) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  yaml_parser_t parser;
+  if (!yaml_parser_initialize(&parser)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "yaml_parser_initialize failed");
+  }
+  yaml_parser_set_input_file(&parser, file);
+
+  // Read each event document in the file until EOF.
+  iree_status_t status = iree_ok_status();
+  for (bool document_eof = false; !document_eof;) {
+    yaml_document_t document;
+    if (!yaml_parser_load(&parser, &document)) {
+      status = iree_status_from_yaml_parser_error(&parser);
+      break;
+    }
+    yaml_node_t* event_node = yaml_document_get_root_node(&document);
+    if (event_node) {
+      status = callback(user_data, replay, &document, event_node);
+    } else {
+      document_eof = true;
+    }
+    yaml_document_delete(&document);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  yaml_parser_delete(&parser);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -7,6 +7,8 @@
 #ifndef IREE_TOOLS_UTILS_TRACE_REPLAY_H_
 #define IREE_TOOLS_UTILS_TRACE_REPLAY_H_
 
+#include <stdio.h>
+
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/tools/utils/yaml_util.h"
@@ -49,6 +51,21 @@ void iree_trace_replay_deinitialize(iree_trace_replay_t* replay,
 void iree_trace_replay_set_hal_driver_override(iree_trace_replay_t* replay,
                                                iree_string_view_t driver);
 
+// Callback issued for each event parsed from a trace stream.
+typedef iree_status_t (*iree_trace_replay_event_callback_fn_t)(
+    void* user_data, iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* event_node);
+
+// Reads events from the trace |file| and issues |callback| for each.
+// Each event document is parsed, handled, and released before the next is read
+// so memory consumption is bounded by the largest single event and not the
+// total trace size. An event with large inline contents is still loaded whole;
+// large tensors should be referenced as `contents_file` side-files instead so
+// that they are mapped directly.
+iree_status_t iree_trace_replay_stream_file(
+    iree_trace_replay_t* replay, FILE* file,
+    iree_trace_replay_event_callback_fn_t callback, void* user_data);
+
 // Replays the given |event_node| against the replay context.
 // Automatically switches between the default iree_trace_replay_event_* methods.
 iree_status_t iree_trace_replay_event(iree_trace_replay_t* replay,
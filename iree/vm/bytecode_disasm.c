@@ -208,12 +208,12 @@ static iree_status_t iree_vm_bytecode_disasm_emit_result_list(
   iree_vm_bytecode_disasm_emit_result_list(reg_list, format, b)
 static iree_status_t iree_vm_bytecode_disasm_emit_remap_list(
     const iree_vm_registers_t* regs,
-    const iree_vm_register_remap_list_t* remap_list,
+    const iree_vm_register_remap_list_t* remap_list, bool needs_separator,
     iree_vm_bytecode_disasm_format_t format, iree_string_builder_t* b) {
   bool include_values =
       regs && (format & IREE_VM_BYTECODE_DISASM_FORMAT_INLINE_VALUES);
   for (uint16_t i = 0; i < remap_list->size; ++i) {
-    if (i > 0) {
+    if (i > 0 || needs_separator) {
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", "));
     }
     EMIT_REG_NAME(remap_list->pairs[i].src_reg);
@@ -227,8 +227,18 @@ static iree_status_t iree_vm_bytecode_disasm_emit_remap_list(
   }
   return iree_ok_status();
 }
-#define EMIT_REMAP_LIST(remap_list) \
-  iree_vm_bytecode_disasm_emit_remap_list(regs, remap_list, format, b)
+static iree_status_t iree_vm_bytecode_disasm_emit_remap_lists(
+    const iree_vm_registers_t* regs,
+    const iree_vm_register_remap_lists_t remap_lists,
+    iree_vm_bytecode_disasm_format_t format, iree_string_builder_t* b) {
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_disasm_emit_remap_list(
+      regs, remap_lists.i32, /*needs_separator=*/false, format, b));
+  return iree_vm_bytecode_disasm_emit_remap_list(
+      regs, remap_lists.ref, /*needs_separator=*/remap_lists.i32->size > 0,
+      format, b);
+}
+#define EMIT_REMAP_LIST(remap_lists) \
+  iree_vm_bytecode_disasm_emit_remap_lists(regs, remap_lists, format, b)
 
 #define EMIT_OPTIONAL_VALUE_I32(expr)                                          \
   if (regs && (format & IREE_VM_BYTECODE_DISASM_FORMAT_INLINE_VALUES)) {       \
@@ -290,6 +300,38 @@ static iree_status_t iree_vm_bytecode_disasm_emit_remap_list(
     break;                                                             \
   }
 
+#define DISASM_OP_CORE_CMP_COND_BRANCH_I32(op_name, op_mnemonic)          \
+  DISASM_OP(CORE, op_name) {                                              \
+    uint16_t lhs_reg = VM_ParseOperandRegI32("lhs");                      \
+    uint16_t rhs_reg = VM_ParseOperandRegI32("rhs");                      \
+    uint16_t result_reg = VM_ParseResultRegI32("result");                 \
+    int32_t true_block_pc = VM_ParseBranchTarget("true_dest");            \
+    iree_vm_register_remap_lists_t true_remap_lists =                     \
+        VM_ParseBranchOperands("true_operands");                          \
+    int32_t false_block_pc = VM_ParseBranchTarget("false_dest");          \
+    iree_vm_register_remap_lists_t false_remap_lists =                    \
+        VM_ParseBranchOperands("false_operands");                         \
+    EMIT_I32_REG_NAME(result_reg);                                        \
+    IREE_RETURN_IF_ERROR(                                                 \
+        iree_string_builder_append_format(b, " = %s ", op_mnemonic));     \
+    EMIT_I32_REG_NAME(lhs_reg);                                           \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[lhs_reg]);                          \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", "));    \
+    EMIT_I32_REG_NAME(rhs_reg);                                           \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[rhs_reg]);                          \
+    IREE_RETURN_IF_ERROR(                                                 \
+        iree_string_builder_append_cstring(b, "; vm.cond_br "));          \
+    EMIT_I32_REG_NAME(result_reg);                                        \
+    IREE_RETURN_IF_ERROR(                                                 \
+        iree_string_builder_append_format(b, ", ^%08X(", true_block_pc)); \
+    EMIT_REMAP_LIST(true_remap_lists);                                    \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(               \
+        b, "), ^%08X(", false_block_pc));                                 \
+    EMIT_REMAP_LIST(false_remap_lists);                                   \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));     \
+    break;                                                                \
+  }
+
 #define DISASM_OP_CORE_TERNARY_I32(op_name, op_mnemonic)               \
   DISASM_OP(CORE, op_name) {                                           \
     uint16_t a_reg = VM_ParseOperandRegI32("a");                       \
@@ -1225,11 +1267,11 @@ iree_status_t iree_vm_bytecode_disasm_op(
 
     DISASM_OP(CORE, Branch) {
       int32_t block_pc = VM_ParseBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_ParseBranchOperands("operands");
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, "vm.br ^%08X(", block_pc));
-      EMIT_REMAP_LIST(remap_list);
+      EMIT_REMAP_LIST(remap_lists);
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
       break;
     }
@@ -1237,10 +1279,10 @@ iree_status_t iree_vm_bytecode_disasm_op(
     DISASM_OP(CORE, CondBranch) {
       uint16_t condition_reg = VM_ParseOperandRegI32("condition");
       int32_t true_block_pc = VM_ParseBranchTarget("true_dest");
-      const iree_vm_register_remap_list_t* true_remap_list =
+      iree_vm_register_remap_lists_t true_remap_lists =
           VM_ParseBranchOperands("true_operands");
       int32_t false_block_pc = VM_ParseBranchTarget("false_dest");
-      const iree_vm_register_remap_list_t* false_remap_list =
+      iree_vm_register_remap_lists_t false_remap_lists =
           VM_ParseBranchOperands("false_operands");
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_cstring(b, "vm.cond_br "));
@@ -1248,14 +1290,23 @@ iree_status_t iree_vm_bytecode_disasm_op(
       EMIT_OPTIONAL_VALUE_I32(regs->i32[condition_reg]);
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, ", ^%08X(", true_block_pc));
-      EMIT_REMAP_LIST(true_remap_list);
+      EMIT_REMAP_LIST(true_remap_lists);
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, "), ^%08X(", false_block_pc));
-      EMIT_REMAP_LIST(false_remap_list);
+      EMIT_REMAP_LIST(false_remap_lists);
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
       break;
     }
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpEQI32CondBranch, "vm.cmp.eq.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpNEI32CondBranch, "vm.cmp.ne.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch, "vm.cmp.lt.i32.s");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch, "vm.cmp.lt.i32.u");
+
     DISASM_OP(CORE, Call) {
       int32_t function_ordinal = VM_ParseFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
@@ -1364,11 +1415,11 @@ iree_status_t iree_vm_bytecode_disasm_op(
 
     DISASM_OP(CORE, Yield) {
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_ParseBranchOperands("operands");
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, "vm.yield ^%08X(", block_pc));
-      EMIT_REMAP_LIST(remap_list);
+      EMIT_REMAP_LIST(remap_lists);
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
       break;
     }
@@ -1403,11 +1454,11 @@ iree_status_t iree_vm_bytecode_disasm_op(
 
     DISASM_OP(CORE, Break) {
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_ParseBranchOperands("operands");
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, "vm.break ^%08X(", block_pc));
-      EMIT_REMAP_LIST(remap_list);
+      EMIT_REMAP_LIST(remap_lists);
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
       break;
     }
@@ -1415,7 +1466,7 @@ iree_status_t iree_vm_bytecode_disasm_op(
     DISASM_OP(CORE, CondBreak) {
       uint16_t condition_reg = VM_ParseOperandRegI32("condition");
       int32_t block_pc = VM_ParseBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_ParseBranchOperands("operands");
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_cstring(b, "vm.cond_break "));
@@ -1423,7 +1474,7 @@ iree_status_t iree_vm_bytecode_disasm_op(
       EMIT_OPTIONAL_VALUE_I32(regs->i32[condition_reg]);
       IREE_RETURN_IF_ERROR(
           iree_string_builder_append_format(b, ", ^%08X(", block_pc));
-      EMIT_REMAP_LIST(remap_list);
+      EMIT_REMAP_LIST(remap_lists);
       IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
       break;
     }
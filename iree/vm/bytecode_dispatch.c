@@ -14,6 +14,7 @@
 #include "iree/vm/bytecode_disasm.h"
 #include "iree/vm/bytecode_dispatch_util.h"
 #include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_threaded.h"
 #include "iree/vm/ops.h"
 
 //===----------------------------------------------------------------------===//
@@ -24,24 +25,28 @@
 // frame. This is a way to perform a conditional multi-mov sequence instead of
 // requiring the additional bytecode representation of the conditional movs.
 //
-// This assumes that the remapping list is properly ordered such that there are
-// no swapping hazards (such as 0->1,1->0). The register allocator in the
-// compiler should ensure this is the case when it can occur.
+// This assumes that the remapping lists are properly ordered such that there
+// are no swapping hazards (such as 0->1,1->0). The register allocator in the
+// compiler should ensure this is the case when it can occur. As i32 and ref
+// registers are disjoint the two lists can be processed independently.
 static void iree_vm_bytecode_dispatch_remap_branch_registers(
     const iree_vm_registers_t regs,
-    const iree_vm_register_remap_list_t* IREE_RESTRICT remap_list) {
-  for (int i = 0; i < remap_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = remap_list->pairs[i].src_reg;
-    uint16_t dst_reg = remap_list->pairs[i].dst_reg;
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
-                                 &regs.ref[src_reg & regs.ref_mask],
-                                 &regs.ref[dst_reg & regs.ref_mask]);
-    } else {
-      regs.i32[dst_reg & regs.i32_mask] = regs.i32[src_reg & regs.i32_mask];
-    }
+    const iree_vm_register_remap_lists_t remap_lists) {
+  const iree_vm_register_remap_list_t* IREE_RESTRICT i32_list =
+      remap_lists.i32;
+  for (int i = 0; i < i32_list->size; ++i) {
+    uint16_t src_reg = i32_list->pairs[i].src_reg;
+    uint16_t dst_reg = i32_list->pairs[i].dst_reg;
+    regs.i32[dst_reg & regs.i32_mask] = regs.i32[src_reg & regs.i32_mask];
+  }
+  const iree_vm_register_remap_list_t* IREE_RESTRICT ref_list =
+      remap_lists.ref;
+  for (int i = 0; i < ref_list->size; ++i) {
+    uint16_t src_reg = ref_list->pairs[i].src_reg;
+    uint16_t dst_reg = ref_list->pairs[i].dst_reg;
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &regs.ref[src_reg & regs.ref_mask],
+                               &regs.ref[dst_reg & regs.ref_mask]);
   }
 }
 
@@ -643,6 +648,17 @@ iree_status_t iree_vm_bytecode_dispatch(
   iree_vm_source_offset_t pc = current_frame->pc;
   const int32_t entry_frame_depth = current_frame->depth;
 
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+  // Hot functions run from their entry in the threaded-code tier until they
+  // reach an op the tier cannot handle and then continue here.
+  const iree_vm_invocation_flags_t invocation_flags =
+      iree_vm_stack_invocation_flags(stack);
+  if (pc == 0) {
+    pc = iree_vm_bytecode_threaded_enter(
+        module, current_frame->function.ordinal, invocation_flags, regs);
+  }
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
     // Globals
@@ -1365,30 +1381,29 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, Branch, {
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_DecBranchOperands("operands");
       pc = block_pc;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_lists);
     });
 
     DISPATCH_OP(CORE, CondBranch, {
       int32_t condition = VM_DecOperandRegI32("condition");
-      int32_t true_block_pc = VM_DecBranchTarget("true_dest");
-      const iree_vm_register_remap_list_t* true_remap_list =
-          VM_DecBranchOperands("true_operands");
-      int32_t false_block_pc = VM_DecBranchTarget("false_dest");
-      const iree_vm_register_remap_list_t* false_remap_list =
-          VM_DecBranchOperands("false_operands");
-      if (condition) {
-        pc = true_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list);
-      } else {
-        pc = false_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs,
-                                                         false_remap_list);
-      }
+      DISPATCH_COND_BRANCH_BODY(condition);
     });
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+    // Fused compare-and-branch sequences emitted by the compiler in place of a
+    // vm.cmp.* immediately followed by a vm.cond_br on its result. The compare
+    // result is still written so that any other uses observe the same value.
+
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpEQI32CondBranch, vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpNEI32CondBranch, vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch, vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch, vm_cmp_lt_i32u);
+
     DISPATCH_OP(CORE, Call, {
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
@@ -1415,6 +1430,10 @@ iree_status_t iree_vm_bytecode_dispatch(
             module->bytecode_data.data +
             module->function_descriptor_table[function_ordinal].bytecode_offset;
         pc = current_frame->pc;
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+        pc = iree_vm_bytecode_threaded_enter(module, function_ordinal,
+                                             invocation_flags, regs);
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
       }
     });
 
@@ -1489,9 +1508,9 @@ iree_status_t iree_vm_bytecode_dispatch(
       // Perform branch before yielding; in this way we will resume at the
       // target without needing to retain any information about the yield.
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_lists);
       pc = block_pc;
 
       // Return magic status code indicating a yield.
@@ -1525,9 +1544,9 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, Break, {
       // TODO(benvanik): break unconditionally.
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_lists);
       pc = block_pc;
     });
 
@@ -1537,9 +1556,9 @@ iree_status_t iree_vm_bytecode_dispatch(
         // TODO(benvanik): cond break.
       }
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      iree_vm_register_remap_lists_t remap_lists =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_lists);
       pc = block_pc;
     });
 
@@ -92,15 +92,42 @@ class VMBytecodeDispatchTest
     iree_vm_instance_release(instance_);
   }
 
-  iree_status_t RunFunction(const char* function_name) {
+  iree_status_t RunFunction(
+      const char* function_name,
+      iree_vm_invocation_flags_t flags = IREE_VM_INVOCATION_FLAG_NONE) {
     iree_vm_function_t function;
     IREE_CHECK_OK(bytecode_module_->lookup_function(
         bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
         iree_make_cstring_view(function_name), &function));
 
-    return iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
-                          /*policy=*/nullptr, /*inputs=*/nullptr,
-                          /*outputs=*/nullptr, iree_allocator_system());
+    return iree_vm_invoke(context_, function, flags, /*policy=*/nullptr,
+                          /*inputs=*/nullptr, /*outputs=*/nullptr,
+                          iree_allocator_system());
+  }
+
+  // Runs the test function with the given invocation |flags| and checks that
+  // it succeeds or fails as expected based on its name.
+  void CheckFunction(iree_vm_invocation_flags_t flags) {
+    const auto& test_params = GetParam();
+    bool expect_failure = test_params.function_name.find("fail_") == 0;
+
+    iree_status_t status =
+        RunFunction(test_params.function_name.c_str(), flags);
+    if (iree_status_is_ok(status)) {
+      if (expect_failure) {
+        GTEST_FAIL() << "Function expected failure but succeeded";
+      } else {
+        GTEST_SUCCEED();
+      }
+    } else {
+      if (expect_failure) {
+        iree_status_ignore(status);
+        GTEST_SUCCEED();
+      } else {
+        GTEST_FAIL() << "Function expected success but failed with error: "
+                     << iree::Status(std::move(status));
+      }
+    }
   }
 
   iree_vm_instance_t* instance_ = nullptr;
@@ -109,25 +136,13 @@ class VMBytecodeDispatchTest
 };
 
 TEST_P(VMBytecodeDispatchTest, Check) {
-  const auto& test_params = GetParam();
-  bool expect_failure = test_params.function_name.find("fail_") == 0;
+  CheckFunction(IREE_VM_INVOCATION_FLAG_DISABLE_TIERING);
+}
 
-  iree_status_t status = RunFunction(test_params.function_name.c_str());
-  if (iree_status_is_ok(status)) {
-    if (expect_failure) {
-      GTEST_FAIL() << "Function expected failure but succeeded";
-    } else {
-      GTEST_SUCCEED();
-    }
-  } else {
-    if (expect_failure) {
-      iree_status_ignore(status);
-      GTEST_SUCCEED();
-    } else {
-      GTEST_FAIL() << "Function expected success but failed with error: "
-                   << iree::Status(std::move(status));
-    }
-  }
+// Translates every function into the threaded-code tier on first call so that
+// the ops with tier templates are checked against the same expectations.
+TEST_P(VMBytecodeDispatchTest, CheckThreadedTier) {
+  CheckFunction(IREE_VM_INVOCATION_FLAG_EAGER_TIERING);
 }
 
 INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMBytecodeDispatchTest,
@@ -107,6 +107,14 @@ static_assert(iree_alignof(iree_vm_register_remap_list_t) == 2,
 static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
               "Expect no padding in the struct");
 
+// Branch operand remappings split by register class.
+// The bytecode contains the i32 remap list immediately followed by the ref
+// remap list so that the remapping loops need not branch on register type.
+typedef struct iree_vm_register_remap_lists_t {
+  const iree_vm_register_remap_list_t* i32;
+  const iree_vm_register_remap_list_t* ref;
+} iree_vm_register_remap_lists_t;
+
 // Maps a type ID to a type def with clamping for out of bounds values.
 static inline const iree_vm_type_def_t* iree_vm_map_type(
     iree_vm_bytecode_module_t* module, int32_t type_id) {
@@ -210,13 +218,15 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecBranchTarget(block_name) VM_DecConstI32(name)
 #define VM_DecBranchOperands(operands_name) \
   VM_DecBranchOperandsImpl(bytecode_data, &pc)
-static inline const iree_vm_register_remap_list_t* VM_DecBranchOperandsImpl(
+static inline iree_vm_register_remap_lists_t VM_DecBranchOperandsImpl(
     const uint8_t* IREE_RESTRICT bytecode_data, iree_vm_source_offset_t* pc) {
   VM_AlignPC(*pc, kRegSize);
-  const iree_vm_register_remap_list_t* list =
-      (const iree_vm_register_remap_list_t*)&bytecode_data[*pc];
-  *pc = *pc + kRegSize + list->size * 2 * kRegSize;
-  return list;
+  iree_vm_register_remap_lists_t lists;
+  lists.i32 = (const iree_vm_register_remap_list_t*)&bytecode_data[*pc];
+  *pc = *pc + kRegSize + lists.i32->size * 2 * kRegSize;
+  lists.ref = (const iree_vm_register_remap_list_t*)&bytecode_data[*pc];
+  *pc = *pc + kRegSize + lists.ref->size * 2 * kRegSize;
+  return lists;
 }
 #define VM_DecOperandRegI32(name)      \
   regs.i32[OP_I16(0) & regs.i32_mask]; \
@@ -425,6 +435,35 @@ static inline const iree_vm_register_list_t* VM_DecVariadicOperandsImpl(
     *result = op_func(a, b, c);                        \
   });
 
+// Decodes the true/false targets of a conditional branch and jumps to the one
+// selected by |condition| after remapping its operands.
+#define DISPATCH_COND_BRANCH_BODY(condition)                             \
+  int32_t true_block_pc = VM_DecBranchTarget("true_dest");               \
+  iree_vm_register_remap_lists_t true_remap_lists =                      \
+      VM_DecBranchOperands("true_operands");                             \
+  int32_t false_block_pc = VM_DecBranchTarget("false_dest");             \
+  iree_vm_register_remap_lists_t false_remap_lists =                     \
+      VM_DecBranchOperands("false_operands");                            \
+  if (condition) {                                                       \
+    pc = true_block_pc;                                                  \
+    iree_vm_bytecode_dispatch_remap_branch_registers(regs,               \
+                                                     true_remap_lists);  \
+  } else {                                                               \
+    pc = false_block_pc;                                                 \
+    iree_vm_bytecode_dispatch_remap_branch_registers(regs,               \
+                                                     false_remap_lists); \
+  }
+
+#define DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(op_name, op_func) \
+  DISPATCH_OP(CORE, op_name, {                                 \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                  \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                  \
+    int32_t* result = VM_DecResultRegI32("result");            \
+    int32_t condition = op_func(lhs, rhs);                     \
+    *result = condition;                                       \
+    DISPATCH_COND_BRANCH_BODY(condition);                      \
+  });
+
 #define DISPATCH_OP_EXT_I64_UNARY_I64(op_name, op_func) \
   DISPATCH_OP(EXT_I64, op_name, {                       \
     int64_t operand = VM_DecOperandRegI64("operand");   \
@@ -14,6 +14,7 @@
 #include "iree/base/tracing.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_threaded.h"
 
 // Perform an strcmp between a flatbuffers string and an IREE string view.
 static bool iree_vm_flatbuffer_strcmp(flatbuffers_string_t lhs,
@@ -133,6 +134,16 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
                             "module missing name field");
   }
 
+  uint32_t bytecode_version =
+      iree_vm_BytecodeModuleDef_bytecode_version(module_def);
+  if (bytecode_version != IREE_VM_BYTECODE_VERSION) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "module bytecode version %u not supported by this runtime (expected "
+        "%u); recompile the module with a matching compiler",
+        bytecode_version, IREE_VM_BYTECODE_VERSION);
+  }
+
   iree_vm_TypeDef_vec_t types = iree_vm_BytecodeModuleDef_types(module_def);
   for (size_t i = 0; i < iree_vm_TypeDef_vec_len(types); ++i) {
     iree_vm_TypeDef_table_t type_def = iree_vm_TypeDef_vec_at(types, i);
@@ -275,6 +286,10 @@ static void iree_vm_bytecode_module_destroy(void* self) {
   module->flatbuffer_data = iree_make_const_byte_span(NULL, 0);
   module->flatbuffer_allocator = iree_allocator_null();
 
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+  iree_vm_bytecode_threaded_deinitialize(module);
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
   iree_allocator_free(module->allocator, module);
 
   IREE_TRACE_ZONE_END(z0);
@@ -906,6 +921,15 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     return resolve_status;
   }
 
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+  iree_status_t threaded_status = iree_vm_bytecode_threaded_initialize(module);
+  if (!iree_status_is_ok(threaded_status)) {
+    iree_allocator_free(allocator, module);
+    IREE_TRACE_ZONE_END(z0);
+    return threaded_status;
+  }
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
   iree_vm_module_initialize(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -66,10 +66,10 @@ static iree_status_t native_import_module_create(
 }
 
 // Benchmarks the given exported function, optionally passing in arguments.
-static iree_status_t RunFunction(benchmark::State& state,
-                                 iree_string_view_t function_name,
-                                 std::vector<int32_t> i32_args,
-                                 int result_count, int64_t batch_size = 1) {
+static iree_status_t RunFunction(
+    benchmark::State& state, iree_string_view_t function_name,
+    std::vector<int32_t> i32_args, int result_count, int64_t batch_size = 1,
+    iree_vm_invocation_flags_t flags = IREE_VM_INVOCATION_FLAG_NONE) {
   iree_vm_instance_t* instance = NULL;
   IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
 
@@ -106,7 +106,7 @@ static iree_status_t RunFunction(benchmark::State& state,
       iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
                           result_count * sizeof(int32_t));
 
-  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, flags,
                                   iree_vm_context_state_resolver(context),
                                   iree_allocator_system());
   while (state.KeepRunningBatch(batch_size)) {
@@ -298,6 +298,55 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+// Same as BM_LoopSumBytecode but without the threaded-code tier.
+static void BM_LoopSumBytecodeInterpreted(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.loop_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0), IREE_VM_INVOCATION_FLAG_DISABLE_TIERING));
+}
+BENCHMARK(BM_LoopSumBytecodeInterpreted)->Arg(100000);
+
+static void BM_BranchHeavyReference(benchmark::State& state) {
+  static auto work = +[](int i, int acc) {
+    benchmark::DoNotOptimize(i);
+    return (i % 3) == 0 ? acc + 3 : acc - 1;
+  };
+  static auto loop = +[](int count) {
+    int acc = 0;
+    for (int i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(acc = work(i, acc));
+    }
+    return acc;
+  };
+  while (state.KeepRunningBatch(state.range(0))) {
+    int ret = loop(static_cast<int>(state.range(0)));
+    benchmark::DoNotOptimize(ret);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_BranchHeavyReference)->Arg(100000);
+
+static void BM_BranchHeavyBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.branch_heavy"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_BranchHeavyBytecode)->Arg(100000);
+
+// Same as BM_BranchHeavyBytecode but without the threaded-code tier.
+static void BM_BranchHeavyBytecodeInterpreted(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.branch_heavy"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0), IREE_VM_INVOCATION_FLAG_DISABLE_TIERING));
+}
+BENCHMARK(BM_BranchHeavyBytecodeInterpreted)->Arg(100000);
+
 static void BM_BufferReduceReference(benchmark::State& state) {
   static auto work = +[](int32_t* buffer, int i, int sum) {
     int new_sum = buffer[i] + sum;
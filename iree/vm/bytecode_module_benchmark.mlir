@@ -77,6 +77,34 @@ vm.module @bytecode_module_benchmark {
     vm.return %ie : i32
   }
 
+  // Measures the cost of control-heavy code with both i32 and ref values
+  // carried across branches. Each iteration performs two compare-and-branch
+  // sequences and remaps registers of both types.
+  vm.export @branch_heavy
+  vm.func @branch_heavy(%count : i32) -> i32 {
+    %c0 = vm.const.i32.zero
+    %c1 = vm.const.i32 1
+    %c3 = vm.const.i32 3
+    %list = vm.list.alloc %c1 : (i32) -> !vm.list<i32>
+    vm.br ^loop(%c0, %c0, %list : i32, i32, !vm.list<i32>)
+  ^loop(%i : i32, %acc : i32, %l : !vm.list<i32>):
+    %rem = vm.rem.i32.s %i, %c3 : i32
+    %is_zero = vm.cmp.eq.i32 %rem, %c0 : i32
+    vm.cond_br %is_zero, ^then(%acc, %l : i32, !vm.list<i32>), ^else(%acc, %l : i32, !vm.list<i32>)
+  ^then(%then_acc : i32, %then_l : !vm.list<i32>):
+    %then_next = vm.add.i32 %then_acc, %c3 : i32
+    vm.br ^latch(%then_next, %then_l : i32, !vm.list<i32>)
+  ^else(%else_acc : i32, %else_l : !vm.list<i32>):
+    %else_next = vm.sub.i32 %else_acc, %c1 : i32
+    vm.br ^latch(%else_next, %else_l : i32, !vm.list<i32>)
+  ^latch(%latch_acc : i32, %latch_l : !vm.list<i32>):
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %latch_acc, %latch_l : i32, i32, !vm.list<i32>), ^loop_exit(%latch_acc : i32)
+  ^loop_exit(%result : i32):
+    vm.return %result : i32
+  }
+
   // Measures the cost of lots of buffer loads.
   vm.export @buffer_reduce
   vm.func @buffer_reduce(%count : i32) -> i32 {
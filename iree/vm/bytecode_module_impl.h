@@ -30,6 +30,13 @@ extern "C" {
 #define VMMAX(a, b) (((a) > (b)) ? (a) : (b))
 #define VMMIN(a, b) (((a) < (b)) ? (a) : (b))
 
+// Version of the bytecode encoding supported by the dispatcher.
+// Must match the version emitted by the compiler BytecodeEncoder.
+//   0: initial encoding.
+//   1: branch remap lists split into i32 and ref lists; fused
+//      compare-and-branch superinstructions.
+#define IREE_VM_BYTECODE_VERSION 1u
+
 // Maximum register count per bank.
 // This determines the bits required to reference registers in the VM bytecode.
 #define IREE_I32_REGISTER_COUNT 0x7FFF
@@ -65,6 +72,12 @@ typedef struct iree_vm_bytecode_module_t {
   iree_allocator_t flatbuffer_allocator;
   iree_vm_BytecodeModuleDef_table_t def;
 
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+  // Per-function threaded-code tier state indexed by internal function ordinal.
+  // See iree/vm/bytecode_threaded.h.
+  struct iree_vm_bytecode_threaded_function_t* threaded_functions;
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t type_table[];
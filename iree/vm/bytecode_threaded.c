@@ -0,0 +1,651 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/bytecode_threaded.h"
+
+#include <string.h>
+
+#include "iree/base/internal/math.h"
+#include "iree/base/tracing.h"
+#include "iree/vm/ops.h"
+
+#if IREE_VM_BYTECODE_THREADED_TIER_ENABLE
+
+// Maximum number of instructions in a translated function. Functions larger
+// than this are left to the interpreter.
+#define IREE_VM_BYTECODE_THREADED_MAX_INSNS 8192
+
+// Maximum number of basic blocks in a translated function.
+#define IREE_VM_BYTECODE_THREADED_MAX_BLOCKS 512
+
+//===----------------------------------------------------------------------===//
+// Translated program representation
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_vm_threaded_insn_t iree_vm_threaded_insn_t;
+
+// Executes |insn| against the i32 register storage |regs| and returns the next
+// instruction to execute or NULL if execution must return to the interpreter.
+typedef const iree_vm_threaded_insn_t* (*iree_vm_threaded_handler_fn_t)(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs);
+
+// A control flow edge to a block with its pre-masked i32 register remappings.
+typedef struct iree_vm_threaded_edge_t {
+  const iree_vm_threaded_insn_t* target;
+  // |remap_count| pairs of (src_reg, dst_reg).
+  const uint16_t* remap;
+  uint16_t remap_count;
+} iree_vm_threaded_edge_t;
+
+struct iree_vm_threaded_insn_t {
+  iree_vm_threaded_handler_fn_t handler;
+  // Pre-masked register ordinals.
+  uint16_t result;
+  uint16_t operands[3];
+  // Constant value or, for exits, the bytecode pc to resume interpreting at.
+  int32_t value;
+  // [0] is the unconditional or true edge and [1] is the false edge.
+  iree_vm_threaded_edge_t edges[2];
+};
+
+typedef struct iree_vm_bytecode_threaded_program_t {
+  // Register mask all register ordinals were pre-masked with. Matches the mask
+  // of any frame of the function.
+  uint16_t i32_mask;
+  iree_host_size_t insn_count;
+  iree_vm_threaded_insn_t* insns;
+  uint16_t* remap_pool;
+  // + trailing insns and remap pool storage
+} iree_vm_bytecode_threaded_program_t;
+
+//===----------------------------------------------------------------------===//
+// Op templates
+//===----------------------------------------------------------------------===//
+
+static const iree_vm_threaded_insn_t* iree_vm_threaded_Exit(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs) {
+  return NULL;
+}
+
+static const iree_vm_threaded_insn_t* iree_vm_threaded_ConstI32(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs) {
+  regs[insn->result] = insn->value;
+  return insn + 1;
+}
+
+static const iree_vm_threaded_insn_t* iree_vm_threaded_SelectI32(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs) {
+  regs[insn->result] =
+      vm_select_i32(regs[insn->operands[0]], regs[insn->operands[1]],
+                    regs[insn->operands[2]]);
+  return insn + 1;
+}
+
+#define IREE_VM_THREADED_UNARY_I32(op_name, op_func)                \
+  static const iree_vm_threaded_insn_t* iree_vm_threaded_##op_name( \
+      const iree_vm_threaded_insn_t* IREE_RESTRICT insn,            \
+      int32_t* IREE_RESTRICT regs) {                                \
+    regs[insn->result] = op_func(regs[insn->operands[0]]);          \
+    return insn + 1;                                                \
+  }
+
+#define IREE_VM_THREADED_BINARY_I32(op_name, op_func)               \
+  static const iree_vm_threaded_insn_t* iree_vm_threaded_##op_name( \
+      const iree_vm_threaded_insn_t* IREE_RESTRICT insn,            \
+      int32_t* IREE_RESTRICT regs) {                                \
+    regs[insn->result] =                                            \
+        op_func(regs[insn->operands[0]], regs[insn->operands[1]]);  \
+    return insn + 1;                                                \
+  }
+
+#define IREE_VM_THREADED_TERNARY_I32(op_name, op_func)              \
+  static const iree_vm_threaded_insn_t* iree_vm_threaded_##op_name( \
+      const iree_vm_threaded_insn_t* IREE_RESTRICT insn,            \
+      int32_t* IREE_RESTRICT regs) {                                \
+    regs[insn->result] =                                            \
+        op_func(regs[insn->operands[0]], regs[insn->operands[1]],   \
+                regs[insn->operands[2]]);                           \
+    return insn + 1;                                                \
+  }
+
+IREE_VM_THREADED_BINARY_I32(AddI32, vm_add_i32);
+IREE_VM_THREADED_BINARY_I32(SubI32, vm_sub_i32);
+IREE_VM_THREADED_BINARY_I32(MulI32, vm_mul_i32);
+IREE_VM_THREADED_BINARY_I32(DivI32S, vm_div_i32s);
+IREE_VM_THREADED_BINARY_I32(DivI32U, vm_div_i32u);
+IREE_VM_THREADED_BINARY_I32(RemI32S, vm_rem_i32s);
+IREE_VM_THREADED_BINARY_I32(RemI32U, vm_rem_i32u);
+IREE_VM_THREADED_TERNARY_I32(FMAI32, vm_fma_i32);
+IREE_VM_THREADED_UNARY_I32(NotI32, vm_not_i32);
+IREE_VM_THREADED_BINARY_I32(AndI32, vm_and_i32);
+IREE_VM_THREADED_BINARY_I32(OrI32, vm_or_i32);
+IREE_VM_THREADED_BINARY_I32(XorI32, vm_xor_i32);
+IREE_VM_THREADED_UNARY_I32(TruncI32I8, vm_trunc_i32i8);
+IREE_VM_THREADED_UNARY_I32(TruncI32I16, vm_trunc_i32i16);
+IREE_VM_THREADED_UNARY_I32(ExtI8I32S, vm_ext_i8i32s);
+IREE_VM_THREADED_UNARY_I32(ExtI8I32U, vm_ext_i8i32u);
+IREE_VM_THREADED_UNARY_I32(ExtI16I32S, vm_ext_i16i32s);
+IREE_VM_THREADED_UNARY_I32(ExtI16I32U, vm_ext_i16i32u);
+IREE_VM_THREADED_BINARY_I32(ShlI32, vm_shl_i32);
+IREE_VM_THREADED_BINARY_I32(ShrI32S, vm_shr_i32s);
+IREE_VM_THREADED_BINARY_I32(ShrI32U, vm_shr_i32u);
+IREE_VM_THREADED_BINARY_I32(CmpEQI32, vm_cmp_eq_i32);
+IREE_VM_THREADED_BINARY_I32(CmpNEI32, vm_cmp_ne_i32);
+IREE_VM_THREADED_BINARY_I32(CmpLTI32S, vm_cmp_lt_i32s);
+IREE_VM_THREADED_BINARY_I32(CmpLTI32U, vm_cmp_lt_i32u);
+IREE_VM_THREADED_UNARY_I32(CmpNZI32, vm_cmp_nz_i32);
+
+// Performs the register remapping of |edge| and returns its target.
+static inline const iree_vm_threaded_insn_t* iree_vm_threaded_take_edge(
+    const iree_vm_threaded_edge_t* IREE_RESTRICT edge,
+    int32_t* IREE_RESTRICT regs) {
+  const uint16_t* IREE_RESTRICT remap = edge->remap;
+  for (uint16_t i = 0; i < edge->remap_count; ++i) {
+    regs[remap[i * 2 + 1]] = regs[remap[i * 2 + 0]];
+  }
+  return edge->target;
+}
+
+static const iree_vm_threaded_insn_t* iree_vm_threaded_Branch(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs) {
+  return iree_vm_threaded_take_edge(&insn->edges[0], regs);
+}
+
+static const iree_vm_threaded_insn_t* iree_vm_threaded_CondBranch(
+    const iree_vm_threaded_insn_t* IREE_RESTRICT insn,
+    int32_t* IREE_RESTRICT regs) {
+  return iree_vm_threaded_take_edge(
+      &insn->edges[regs[insn->operands[0]] ? 0 : 1], regs);
+}
+
+#define IREE_VM_THREADED_CMP_COND_BRANCH_I32(op_name, op_func)         \
+  static const iree_vm_threaded_insn_t* iree_vm_threaded_##op_name(    \
+      const iree_vm_threaded_insn_t* IREE_RESTRICT insn,               \
+      int32_t* IREE_RESTRICT regs) {                                   \
+    int32_t condition =                                                \
+        op_func(regs[insn->operands[0]], regs[insn->operands[1]]);     \
+    regs[insn->result] = condition;                                    \
+    return iree_vm_threaded_take_edge(&insn->edges[condition ? 0 : 1], \
+                                      regs);                           \
+  }
+
+IREE_VM_THREADED_CMP_COND_BRANCH_I32(CmpEQI32CondBranch, vm_cmp_eq_i32);
+IREE_VM_THREADED_CMP_COND_BRANCH_I32(CmpNEI32CondBranch, vm_cmp_ne_i32);
+IREE_VM_THREADED_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch, vm_cmp_lt_i32s);
+IREE_VM_THREADED_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch, vm_cmp_lt_i32u);
+
+//===----------------------------------------------------------------------===//
+// Translation
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_vm_threaded_translator_t {
+  const uint8_t* IREE_RESTRICT bytecode_data;
+  iree_vm_source_offset_t bytecode_length;
+  uint16_t i32_mask;
+
+  iree_vm_threaded_insn_t* insns;
+  iree_host_size_t insn_count;
+  iree_host_size_t insn_capacity;
+  // Branch target pcs of each insn edge resolved once all blocks are known.
+  uint32_t* edge_pcs;
+
+  uint16_t* remap_pool;
+  iree_host_size_t remap_pool_size;
+  iree_host_size_t remap_pool_capacity;
+
+  // Blocks discovered so far in discovery order along with the index of their
+  // first instruction. Blocks at or after |translated_block_count| have not
+  // yet been translated.
+  iree_host_size_t block_count;
+  iree_host_size_t translated_block_count;
+  uint32_t block_pcs[IREE_VM_BYTECODE_THREADED_MAX_BLOCKS];
+  uint32_t block_insns[IREE_VM_BYTECODE_THREADED_MAX_BLOCKS];
+} iree_vm_threaded_translator_t;
+
+// Adds a block starting at |block_pc| to the translation worklist if it has
+// not already been discovered.
+static iree_status_t iree_vm_threaded_translator_add_block(
+    iree_vm_threaded_translator_t* translator, uint32_t block_pc) {
+  for (iree_host_size_t i = 0; i < translator->block_count; ++i) {
+    if (translator->block_pcs[i] == block_pc) return iree_ok_status();
+  }
+  if (IREE_UNLIKELY(translator->block_count >=
+                    IREE_VM_BYTECODE_THREADED_MAX_BLOCKS)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "function has too many blocks to translate");
+  }
+  translator->block_pcs[translator->block_count++] = block_pc;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_threaded_translator_append(
+    iree_vm_threaded_translator_t* translator,
+    iree_vm_threaded_handler_fn_t handler,
+    iree_vm_threaded_insn_t** out_insn) {
+  if (IREE_UNLIKELY(translator->insn_count >= translator->insn_capacity)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "function too large to translate");
+  }
+  iree_vm_threaded_insn_t* insn = &translator->insns[translator->insn_count++];
+  memset(insn, 0, sizeof(*insn));
+  insn->handler = handler;
+  *out_insn = insn;
+  return iree_ok_status();
+}
+
+// Decodes the branch operands at |*pc| into |edge|, advancing |*pc| past them.
+// Returns false if the operands cannot be handled by the tier (ref remapping
+// or truncated bytecode).
+static bool iree_vm_threaded_translator_decode_remap(
+    iree_vm_threaded_translator_t* translator, iree_vm_source_offset_t* pc,
+    iree_vm_threaded_edge_t* edge) {
+  const uint8_t* IREE_RESTRICT bytecode_data = translator->bytecode_data;
+  VM_AlignPC(*pc, kRegSize);
+  if (*pc + kRegSize > translator->bytecode_length) return false;
+  const iree_vm_register_remap_list_t* i32_list =
+      (const iree_vm_register_remap_list_t*)&bytecode_data[*pc];
+  iree_vm_source_offset_t ref_list_pc =
+      *pc + kRegSize + i32_list->size * 2 * kRegSize;
+  if (ref_list_pc + kRegSize > translator->bytecode_length) return false;
+  const iree_vm_register_remap_list_t* ref_list =
+      (const iree_vm_register_remap_list_t*)&bytecode_data[ref_list_pc];
+  if (ref_list->size != 0) return false;
+  if (translator->remap_pool_size + i32_list->size * 2 >
+      translator->remap_pool_capacity) {
+    return false;
+  }
+  uint16_t* remap = &translator->remap_pool[translator->remap_pool_size];
+  for (uint16_t i = 0; i < i32_list->size; ++i) {
+    remap[i * 2 + 0] = i32_list->pairs[i].src_reg & translator->i32_mask;
+    remap[i * 2 + 1] = i32_list->pairs[i].dst_reg & translator->i32_mask;
+  }
+  translator->remap_pool_size += i32_list->size * 2;
+  edge->remap = remap;
+  edge->remap_count = i32_list->size;
+  *pc = ref_list_pc + kRegSize;
+  return true;
+}
+
+// Register operand decoding with the ordinal pre-masked to the frame size.
+#define VM_TrnRegI32(name)                      \
+  (uint16_t)(OP_I16(0) & translator->i32_mask); \
+  pc += kRegSize;
+
+// Translates the block starting at |pc| until its terminator or the first op
+// without a template, which is emitted as an exit back to the interpreter.
+static iree_status_t iree_vm_threaded_translator_translate_block(
+    iree_vm_threaded_translator_t* translator, iree_vm_source_offset_t pc) {
+  const uint8_t* IREE_RESTRICT bytecode_data = translator->bytecode_data;
+  const iree_vm_source_offset_t bytecode_length = translator->bytecode_length;
+  while (true) {
+    const iree_vm_source_offset_t op_pc = pc;
+    iree_vm_threaded_handler_fn_t handler = NULL;
+    iree_host_size_t op_length = 0;
+    uint8_t opcode = pc < bytecode_length ? OP_I8(0) : IREE_VM_OP_CORE_Fail;
+    switch (opcode) {
+#define TRN_OP(op_name, length)           \
+  case IREE_VM_OP_CORE_##op_name:         \
+    handler = iree_vm_threaded_##op_name; \
+    op_length = 1 + (length);             \
+    break;
+      case IREE_VM_OP_CORE_ConstI32Zero:
+        // Shares the ConstI32 template with a zero value.
+        handler = iree_vm_threaded_ConstI32;
+        op_length = 1 + kRegSize;
+        break;
+      TRN_OP(ConstI32, 4 + kRegSize);
+      TRN_OP(SelectI32, 4 * kRegSize);
+      TRN_OP(AddI32, 3 * kRegSize);
+      TRN_OP(SubI32, 3 * kRegSize);
+      TRN_OP(MulI32, 3 * kRegSize);
+      TRN_OP(DivI32S, 3 * kRegSize);
+      TRN_OP(DivI32U, 3 * kRegSize);
+      TRN_OP(RemI32S, 3 * kRegSize);
+      TRN_OP(RemI32U, 3 * kRegSize);
+      TRN_OP(FMAI32, 4 * kRegSize);
+      TRN_OP(NotI32, 2 * kRegSize);
+      TRN_OP(AndI32, 3 * kRegSize);
+      TRN_OP(OrI32, 3 * kRegSize);
+      TRN_OP(XorI32, 3 * kRegSize);
+      TRN_OP(TruncI32I8, 2 * kRegSize);
+      TRN_OP(TruncI32I16, 2 * kRegSize);
+      TRN_OP(ExtI8I32S, 2 * kRegSize);
+      TRN_OP(ExtI8I32U, 2 * kRegSize);
+      TRN_OP(ExtI16I32S, 2 * kRegSize);
+      TRN_OP(ExtI16I32U, 2 * kRegSize);
+      TRN_OP(ShlI32, 3 * kRegSize);
+      TRN_OP(ShrI32S, 3 * kRegSize);
+      TRN_OP(ShrI32U, 3 * kRegSize);
+      TRN_OP(CmpEQI32, 3 * kRegSize);
+      TRN_OP(CmpNEI32, 3 * kRegSize);
+      TRN_OP(CmpLTI32S, 3 * kRegSize);
+      TRN_OP(CmpLTI32U, 3 * kRegSize);
+      TRN_OP(CmpNZI32, 2 * kRegSize);
+      TRN_OP(Branch, 4);
+      TRN_OP(CondBranch, kRegSize + 4);
+      TRN_OP(CmpEQI32CondBranch, 3 * kRegSize + 4);
+      TRN_OP(CmpNEI32CondBranch, 3 * kRegSize + 4);
+      TRN_OP(CmpLTI32SCondBranch, 3 * kRegSize + 4);
+      TRN_OP(CmpLTI32UCondBranch, 3 * kRegSize + 4);
+#undef TRN_OP
+      default:
+        break;
+    }
+
+    iree_vm_threaded_insn_t* insn = NULL;
+    if (!handler || op_pc + op_length > bytecode_length) {
+      IREE_RETURN_IF_ERROR(iree_vm_threaded_translator_append(
+          translator, iree_vm_threaded_Exit, &insn));
+      insn->value = (int32_t)op_pc;
+      return iree_ok_status();
+    }
+    IREE_RETURN_IF_ERROR(
+        iree_vm_threaded_translator_append(translator, handler, &insn));
+    ++pc;  // opcode
+
+    switch (opcode) {
+      case IREE_VM_OP_CORE_ConstI32Zero: {
+        insn->result = VM_TrnRegI32("result");
+        insn->value = 0;
+        break;
+      }
+      case IREE_VM_OP_CORE_ConstI32: {
+        insn->value = VM_DecIntAttr32("value");
+        insn->result = VM_TrnRegI32("result");
+        break;
+      }
+      case IREE_VM_OP_CORE_SelectI32:
+      case IREE_VM_OP_CORE_FMAI32: {
+        insn->operands[0] = VM_TrnRegI32("a");
+        insn->operands[1] = VM_TrnRegI32("b");
+        insn->operands[2] = VM_TrnRegI32("c");
+        insn->result = VM_TrnRegI32("result");
+        break;
+      }
+      case IREE_VM_OP_CORE_NotI32:
+      case IREE_VM_OP_CORE_TruncI32I8:
+      case IREE_VM_OP_CORE_TruncI32I16:
+      case IREE_VM_OP_CORE_ExtI8I32S:
+      case IREE_VM_OP_CORE_ExtI8I32U:
+      case IREE_VM_OP_CORE_ExtI16I32S:
+      case IREE_VM_OP_CORE_ExtI16I32U:
+      case IREE_VM_OP_CORE_CmpNZI32: {
+        insn->operands[0] = VM_TrnRegI32("operand");
+        insn->result = VM_TrnRegI32("result");
+        break;
+      }
+      case IREE_VM_OP_CORE_Branch:
+      case IREE_VM_OP_CORE_CondBranch:
+      case IREE_VM_OP_CORE_CmpEQI32CondBranch:
+      case IREE_VM_OP_CORE_CmpNEI32CondBranch:
+      case IREE_VM_OP_CORE_CmpLTI32SCondBranch:
+      case IREE_VM_OP_CORE_CmpLTI32UCondBranch: {
+        int edge_count = 2;
+        if (opcode == IREE_VM_OP_CORE_Branch) {
+          edge_count = 1;
+        } else if (opcode == IREE_VM_OP_CORE_CondBranch) {
+          insn->operands[0] = VM_TrnRegI32("condition");
+        } else {
+          insn->operands[0] = VM_TrnRegI32("lhs");
+          insn->operands[1] = VM_TrnRegI32("rhs");
+          insn->result = VM_TrnRegI32("result");
+        }
+        const iree_host_size_t insn_ordinal = insn - translator->insns;
+        const iree_host_size_t remap_pool_size = translator->remap_pool_size;
+        bool supported = true;
+        for (int i = 0; i < edge_count && supported; ++i) {
+          if (pc + 4 > bytecode_length) {
+            supported = false;
+            break;
+          }
+          uint32_t block_pc = VM_DecBranchTarget("dest");
+          translator->edge_pcs[insn_ordinal * 2 + i] = block_pc;
+          supported = iree_vm_threaded_translator_decode_remap(
+              translator, &pc, &insn->edges[i]);
+        }
+        if (!supported) {
+          // Branches carrying refs are left to the interpreter.
+          translator->remap_pool_size = remap_pool_size;
+          memset(insn, 0, sizeof(*insn));
+          insn->handler = iree_vm_threaded_Exit;
+          insn->value = (int32_t)op_pc;
+          return iree_ok_status();
+        }
+        for (int i = 0; i < edge_count; ++i) {
+          IREE_RETURN_IF_ERROR(iree_vm_threaded_translator_add_block(
+              translator, translator->edge_pcs[insn_ordinal * 2 + i]));
+        }
+        return iree_ok_status();
+      }
+      default: {
+        // Binary ops (including shifts and comparisons).
+        insn->operands[0] = VM_TrnRegI32("lhs");
+        insn->operands[1] = VM_TrnRegI32("rhs");
+        insn->result = VM_TrnRegI32("result");
+        break;
+      }
+    }
+  }
+}
+
+// Packs the translated program into a single allocation and patches all branch
+// edges to point at their target instructions.
+static iree_status_t iree_vm_threaded_translator_finalize(
+    iree_vm_threaded_translator_t* translator, iree_allocator_t allocator,
+    iree_vm_bytecode_threaded_program_t** out_program) {
+  iree_host_size_t insns_offset =
+      iree_host_align(sizeof(iree_vm_bytecode_threaded_program_t),
+                      iree_alignof(iree_vm_threaded_insn_t));
+  iree_host_size_t remap_pool_offset =
+      insns_offset + translator->insn_count * sizeof(iree_vm_threaded_insn_t);
+  iree_host_size_t total_size =
+      remap_pool_offset + translator->remap_pool_size * sizeof(uint16_t);
+  iree_vm_bytecode_threaded_program_t* program = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, total_size, (void**)&program));
+  program->i32_mask = translator->i32_mask;
+  program->insn_count = translator->insn_count;
+  program->insns = (iree_vm_threaded_insn_t*)((uint8_t*)program + insns_offset);
+  program->remap_pool = (uint16_t*)((uint8_t*)program + remap_pool_offset);
+  memcpy(program->insns, translator->insns,
+         translator->insn_count * sizeof(iree_vm_threaded_insn_t));
+  memcpy(program->remap_pool, translator->remap_pool,
+         translator->remap_pool_size * sizeof(uint16_t));
+
+  for (iree_host_size_t i = 0; i < program->insn_count; ++i) {
+    iree_vm_threaded_insn_t* insn = &program->insns[i];
+    for (int j = 0; j < IREE_ARRAYSIZE(insn->edges); ++j) {
+      iree_vm_threaded_edge_t* edge = &insn->edges[j];
+      // Only decoded branch edges reference the remap pool.
+      if (!edge->remap) continue;
+      edge->remap =
+          program->remap_pool + (edge->remap - translator->remap_pool);
+      uint32_t block_pc = translator->edge_pcs[i * 2 + j];
+      for (iree_host_size_t k = 0; k < translator->block_count; ++k) {
+        if (translator->block_pcs[k] == block_pc) {
+          edge->target = &program->insns[translator->block_insns[k]];
+          break;
+        }
+      }
+    }
+  }
+
+  *out_program = program;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_bytecode_threaded_translate(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal,
+    iree_vm_bytecode_threaded_program_t** out_program) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  *out_program = NULL;
+
+  const iree_vm_FunctionDescriptor_t* descriptor =
+      &module->function_descriptor_table[function_ordinal];
+  iree_host_size_t bytecode_length = descriptor->bytecode_length;
+
+  // Each instruction maps to a unique op and each op is at least 1 byte so the
+  // bytecode length bounds the instruction count. Each remap pair is 4 bytes of
+  // bytecode and 2 entries in the pool.
+  iree_vm_threaded_translator_t* translator = NULL;
+  iree_host_size_t insn_capacity =
+      iree_min(bytecode_length, IREE_VM_BYTECODE_THREADED_MAX_INSNS);
+  iree_host_size_t remap_pool_capacity = bytecode_length / 2;
+  iree_host_size_t total_size =
+      sizeof(*translator) +
+      insn_capacity * (sizeof(iree_vm_threaded_insn_t) + 2 * sizeof(uint32_t)) +
+      remap_pool_capacity * sizeof(uint16_t);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(module->allocator, total_size,
+                                (void**)&translator));
+  translator->bytecode_data =
+      module->bytecode_data.data + descriptor->bytecode_offset;
+  translator->bytecode_length = bytecode_length;
+  translator->i32_mask = (uint16_t)(
+      iree_math_round_up_to_pow2_u32(
+          iree_max(1, descriptor->i32_register_count)) -
+      1);
+  translator->insns = (iree_vm_threaded_insn_t*)(translator + 1);
+  translator->insn_capacity = insn_capacity;
+  translator->edge_pcs = (uint32_t*)(translator->insns + insn_capacity);
+  translator->remap_pool =
+      (uint16_t*)(translator->edge_pcs + insn_capacity * 2);
+  translator->remap_pool_capacity = remap_pool_capacity;
+
+  // Translate all blocks reachable from the entry block. Blocks containing ops
+  // without templates are truncated at that op and exit to the interpreter so
+  // any blocks only reachable from them are never visited.
+  iree_status_t status = iree_vm_threaded_translator_add_block(translator, 0);
+  while (iree_status_is_ok(status) &&
+         translator->translated_block_count < translator->block_count) {
+    iree_host_size_t block_ordinal = translator->translated_block_count++;
+    translator->block_insns[block_ordinal] =
+        (uint32_t)translator->insn_count;
+    status = iree_vm_threaded_translator_translate_block(
+        translator, translator->block_pcs[block_ordinal]);
+  }
+
+  // Translating a function that immediately exits would only add overhead.
+  if (iree_status_is_ok(status) &&
+      translator->insns[0].handler == iree_vm_threaded_Exit) {
+    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "function entry op has no threaded template");
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_threaded_translator_finalize(translator, module->allocator,
+                                                  out_program);
+  }
+
+  iree_allocator_free(module->allocator, translator);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Execution
+//===----------------------------------------------------------------------===//
+
+// Runs |program| until an exit and returns the pc to resume interpreting at.
+static iree_vm_source_offset_t iree_vm_bytecode_threaded_run(
+    const iree_vm_bytecode_threaded_program_t* program,
+    int32_t* IREE_RESTRICT regs) {
+  const iree_vm_threaded_insn_t* insn = NULL;
+  const iree_vm_threaded_insn_t* next_insn = program->insns;
+  do {
+    insn = next_insn;
+    next_insn = insn->handler(insn, regs);
+  } while (next_insn);
+  return insn->value;
+}
+
+// Translates |function_ordinal| and publishes the result (or the unsupported
+// sentinel) for all future calls. If another thread raced and published first
+// its program is used instead.
+static IREE_ATTRIBUTE_NOINLINE intptr_t iree_vm_bytecode_threaded_tier_up(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal) {
+  iree_vm_bytecode_threaded_function_t* function =
+      &module->threaded_functions[function_ordinal];
+  iree_vm_bytecode_threaded_program_t* program = NULL;
+  iree_status_t status =
+      iree_vm_bytecode_threaded_translate(module, function_ordinal, &program);
+  intptr_t program_ptr = iree_status_is_ok(status)
+                             ? (intptr_t)program
+                             : IREE_VM_BYTECODE_THREADED_PROGRAM_UNSUPPORTED;
+  iree_status_ignore(status);
+  intptr_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_intptr(
+          &function->program, &expected, program_ptr,
+          iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+    iree_allocator_free(module->allocator, program);
+    program_ptr = expected;
+  }
+  return program_ptr;
+}
+
+iree_vm_source_offset_t iree_vm_bytecode_threaded_enter(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal,
+    iree_vm_invocation_flags_t invocation_flags, iree_vm_registers_t regs) {
+  // Tracing requires the interpreter to observe every op.
+  if (invocation_flags & (IREE_VM_INVOCATION_FLAG_DISABLE_TIERING |
+                          IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION)) {
+    return 0;
+  }
+  iree_vm_bytecode_threaded_function_t* function =
+      &module->threaded_functions[function_ordinal];
+  intptr_t program_ptr =
+      iree_atomic_load_intptr(&function->program, iree_memory_order_acquire);
+  if (IREE_UNLIKELY(program_ptr == 0)) {
+    int32_t call_count = iree_atomic_fetch_add_int32(
+                             &function->call_count, 1,
+                             iree_memory_order_relaxed) +
+                         1;
+    if (call_count < IREE_VM_BYTECODE_THREADED_TIER_THRESHOLD &&
+        !(invocation_flags & IREE_VM_INVOCATION_FLAG_EAGER_TIERING)) {
+      return 0;
+    }
+    program_ptr = iree_vm_bytecode_threaded_tier_up(module, function_ordinal);
+  }
+  if (program_ptr == IREE_VM_BYTECODE_THREADED_PROGRAM_UNSUPPORTED) return 0;
+  const iree_vm_bytecode_threaded_program_t* program =
+      (const iree_vm_bytecode_threaded_program_t*)program_ptr;
+  if (IREE_UNLIKELY(program->i32_mask != regs.i32_mask)) return 0;
+  return iree_vm_bytecode_threaded_run(program, regs.i32);
+}
+
+//===----------------------------------------------------------------------===//
+// Module lifetime
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_vm_bytecode_threaded_initialize(
+    iree_vm_bytecode_module_t* module) {
+  return iree_allocator_malloc(
+      module->allocator,
+      module->function_descriptor_count *
+          sizeof(iree_vm_bytecode_threaded_function_t),
+      (void**)&module->threaded_functions);
+}
+
+void iree_vm_bytecode_threaded_deinitialize(iree_vm_bytecode_module_t* module) {
+  if (!module->threaded_functions) return;
+  for (iree_host_size_t i = 0; i < module->function_descriptor_count; ++i) {
+    intptr_t program_ptr = iree_atomic_load_intptr(
+        &module->threaded_functions[i].program, iree_memory_order_acquire);
+    if (program_ptr != 0 &&
+        program_ptr != IREE_VM_BYTECODE_THREADED_PROGRAM_UNSUPPORTED) {
+      iree_allocator_free(module->allocator, (void*)program_ptr);
+    }
+  }
+  iree_allocator_free(module->allocator, module->threaded_functions);
+  module->threaded_functions = NULL;
+}
+
+#endif  // IREE_VM_BYTECODE_THREADED_TIER_ENABLE
@@ -0,0 +1,76 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_VM_BYTECODE_THREADED_H_
+#define IREE_VM_BYTECODE_THREADED_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/vm/bytecode_dispatch_util.h"
+#include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Threaded-code execution tier
+//===----------------------------------------------------------------------===//
+//
+// Hot bytecode functions are translated into a flat array of pre-decoded
+// instructions each pointing at a precompiled handler template. Executing the
+// translated form skips all opcode decoding, operand alignment, and register
+// masking as those are resolved once at translation time and branch targets
+// are patched to point directly at the destination instruction.
+//
+// Only the pure i32 subset of the core ops (constants, arithmetic, bitwise,
+// shifts, comparisons, selects, and branches without ref operands) have
+// templates. Translation stops at the first op without one and emits an exit
+// instruction carrying its pc: when the tier reaches it control returns to the
+// interpreter which continues executing from that pc with the register state
+// produced by the tier. Because the tier and interpreter share the same frame
+// register storage there is no state to marshal on either transition.
+//
+// Functions are translated once their call count reaches
+// IREE_VM_BYTECODE_THREADED_TIER_THRESHOLD (or on first call with
+// IREE_VM_INVOCATION_FLAG_EAGER_TIERING) and the translated program is shared
+// by all contexts using the module.
+
+// Sentinel program value used to mark functions that cannot be translated.
+#define IREE_VM_BYTECODE_THREADED_PROGRAM_UNSUPPORTED ((intptr_t)-1)
+
+// Per-function tiering state.
+typedef struct iree_vm_bytecode_threaded_function_t {
+  // Number of times the function has been entered prior to translation.
+  iree_atomic_int32_t call_count;
+  // iree_vm_bytecode_threaded_program_t* once translated, 0 if not yet
+  // translated, or IREE_VM_BYTECODE_THREADED_PROGRAM_UNSUPPORTED.
+  iree_atomic_intptr_t program;
+} iree_vm_bytecode_threaded_function_t;
+
+// Allocates the per-function tiering state for all functions in |module|.
+iree_status_t iree_vm_bytecode_threaded_initialize(
+    iree_vm_bytecode_module_t* module);
+
+// Frees the tiering state and all translated programs of |module|.
+void iree_vm_bytecode_threaded_deinitialize(iree_vm_bytecode_module_t* module);
+
+// Executes the function |function_ordinal| from its entry using the threaded
+// tier if it is (or has now become) hot and returns the pc the interpreter must
+// resume at. Returns 0 when the tier did not run and the interpreter should
+// start from the function entry.
+//
+// |regs| must be the freshly entered frame registers of the function.
+iree_vm_source_offset_t iree_vm_bytecode_threaded_enter(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal,
+    iree_vm_invocation_flags_t invocation_flags, iree_vm_registers_t regs);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_BYTECODE_THREADED_H_
@@ -93,10 +93,10 @@ typedef enum {
   IREE_VM_OP_CORE_CallVariadic = 0x53,
   IREE_VM_OP_CORE_Return = 0x54,
   IREE_VM_OP_CORE_Fail = 0x55,
-  IREE_VM_OP_CORE_RSV_0x56,
-  IREE_VM_OP_CORE_RSV_0x57,
-  IREE_VM_OP_CORE_RSV_0x58,
-  IREE_VM_OP_CORE_RSV_0x59,
+  IREE_VM_OP_CORE_CmpEQI32CondBranch = 0x56,
+  IREE_VM_OP_CORE_CmpNEI32CondBranch = 0x57,
+  IREE_VM_OP_CORE_CmpLTI32SCondBranch = 0x58,
+  IREE_VM_OP_CORE_CmpLTI32UCondBranch = 0x59,
   IREE_VM_OP_CORE_RSV_0x5A,
   IREE_VM_OP_CORE_RSV_0x5B,
   IREE_VM_OP_CORE_RSV_0x5C,
@@ -352,10 +352,10 @@ typedef enum {
     OPC(0x53, CallVariadic) \
     OPC(0x54, Return) \
     OPC(0x55, Fail) \
-    RSV(0x56) \
-    RSV(0x57) \
-    RSV(0x58) \
-    RSV(0x59) \
+    OPC(0x56, CmpEQI32CondBranch) \
+    OPC(0x57, CmpNEI32CondBranch) \
+    OPC(0x58, CmpLTI32SCondBranch) \
+    OPC(0x59, CmpLTI32UCondBranch) \
     RSV(0x5A) \
     RSV(0x5B) \
     RSV(0x5C) \
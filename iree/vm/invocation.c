@@ -224,3 +224,148 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invoker_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invoker_t {
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+
+  // Stack initialized once and reused across invocations. It is empty between
+  // invocations and retains any storage it grows into until the invoker is
+  // freed.
+  iree_vm_stack_t* stack;
+
+  // Statically-allocated lists with capacity for all arguments/results.
+  iree_vm_list_t* inputs;
+  iree_vm_list_t* outputs;
+
+  // + trailing stack storage
+  // + trailing inputs list storage
+  // + trailing outputs list storage
+};
+
+IREE_API_EXPORT iree_status_t iree_vm_invoker_allocate(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_host_size_t stack_size,
+    iree_allocator_t allocator, iree_vm_invoker_t** out_invoker) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invoker);
+  *out_invoker = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Force tracing if specified on the context.
+  if (iree_vm_context_flags(context) & IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION) {
+    flags |= IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION;
+  }
+  if (stack_size == 0) stack_size = IREE_VM_STACK_DEFAULT_SIZE;
+
+  // Size the lists to exactly the function signature.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+  iree_host_size_t input_capacity = cconv_arguments.size;
+  iree_host_size_t output_capacity = cconv_results.size;
+
+  iree_host_size_t stack_offset =
+      iree_host_align(sizeof(iree_vm_invoker_t), 16);
+  iree_host_size_t inputs_offset =
+      stack_offset + iree_host_align(stack_size, 16);
+  iree_host_size_t inputs_size =
+      iree_vm_list_storage_size(/*element_type=*/NULL, input_capacity);
+  iree_host_size_t outputs_offset =
+      inputs_offset + iree_host_align(inputs_size, 16);
+  iree_host_size_t outputs_size =
+      iree_vm_list_storage_size(/*element_type=*/NULL, output_capacity);
+  iree_host_size_t total_size = outputs_offset + outputs_size;
+
+  iree_vm_invoker_t* invoker = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&invoker));
+  invoker->allocator = allocator;
+  invoker->context = context;
+  iree_vm_context_retain(context);
+  invoker->function = function;
+
+  uint8_t* base_ptr = (uint8_t*)invoker;
+  iree_status_t status = iree_vm_stack_initialize(
+      iree_make_byte_span(base_ptr + stack_offset, stack_size), flags,
+      iree_vm_context_state_resolver(context), allocator, &invoker->stack);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_initialize(
+        iree_make_byte_span(base_ptr + inputs_offset, inputs_size),
+        /*element_type=*/NULL, input_capacity, &invoker->inputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_initialize(
+        iree_make_byte_span(base_ptr + outputs_offset, outputs_size),
+        /*element_type=*/NULL, output_capacity, &invoker->outputs);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_invoker = invoker;
+  } else {
+    iree_vm_invoker_free(invoker);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_vm_invoker_free(iree_vm_invoker_t* invoker) {
+  if (!invoker) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (invoker->inputs) iree_vm_list_deinitialize(invoker->inputs);
+  if (invoker->outputs) iree_vm_list_deinitialize(invoker->outputs);
+  if (invoker->stack) iree_vm_stack_deinitialize(invoker->stack);
+  iree_vm_context_release(invoker->context);
+  iree_allocator_free(invoker->allocator, invoker);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_inputs(
+    iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  return invoker->inputs;
+}
+
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_outputs(
+    iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  return invoker->outputs;
+}
+
+IREE_API_EXPORT void iree_vm_invoker_reset(iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  iree_status_ignore(iree_vm_list_resize(invoker->inputs, 0));
+  iree_status_ignore(iree_vm_list_resize(invoker->outputs, 0));
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invoker_invoke(
+    iree_vm_invoker_t* invoker, const iree_vm_invocation_policy_t* policy) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_vm_invoke_within(
+      invoker->context, invoker->stack, invoker->function, policy,
+      invoker->inputs, invoker->outputs);
+  if (!iree_status_is_ok(status)) {
+    status =
+        IREE_VM_STACK_ANNOTATE_BACKTRACE_IF_ENABLED(invoker->stack, status);
+
+    // Unwind any frames left on the stack by the failure so that it is empty
+    // for the next invocation. Storage is retained.
+    while (iree_vm_stack_current_frame(invoker->stack)) {
+      iree_status_ignore(iree_vm_stack_function_leave(invoker->stack));
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
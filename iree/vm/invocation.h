@@ -40,6 +40,62 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     iree_vm_list_t* inputs, iree_vm_list_t* outputs,
     iree_allocator_t allocator);
 
+//===----------------------------------------------------------------------===//
+// iree_vm_invoker_t
+//===----------------------------------------------------------------------===//
+
+// Reusable state for repeatedly invoking a single function.
+//
+// iree_vm_invoke initializes a new VM stack for every call that spills to the
+// heap when the call tree exceeds the inline storage and callers usually create
+// new input and output lists per call. An invoker instead owns a stack and a
+// pair of input/output lists sized to the function signature that persist
+// across invocations: any stack growth is retained and the lists are reset
+// between calls such that steady-state invocations perform no heap
+// allocations.
+//
+// The input and output lists are statically allocated within the invoker and
+// must not be retained beyond its lifetime. Inputs may only be pushed up to the
+// argument count of the function.
+//
+// Thread-compatible; use one invoker per thread issuing calls.
+typedef struct iree_vm_invoker_t iree_vm_invoker_t;
+
+// Allocates an invoker for |function| within |context|.
+// |stack_size| bytes of stack storage are preallocated; 0 uses
+// IREE_VM_STACK_DEFAULT_SIZE. |flags| apply to all invocations.
+// |out_invoker| must be freed with iree_vm_invoker_free.
+IREE_API_EXPORT iree_status_t iree_vm_invoker_allocate(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_host_size_t stack_size,
+    iree_allocator_t allocator, iree_vm_invoker_t** out_invoker);
+
+// Frees |invoker| and releases any values remaining in its lists.
+IREE_API_EXPORT void iree_vm_invoker_free(iree_vm_invoker_t* invoker);
+
+// Returns the list that must be populated with the function inputs prior to
+// calling iree_vm_invoker_invoke. Contents are retained until reset.
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_inputs(
+    iree_vm_invoker_t* invoker);
+
+// Returns the list populated with the function outputs after a successful
+// iree_vm_invoker_invoke. Contents are retained until reset or the next call.
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_outputs(
+    iree_vm_invoker_t* invoker);
+
+// Resets the input and output lists back to 0-length in preparation for
+// another invocation. Retains all storage.
+IREE_API_EXPORT void iree_vm_invoker_reset(iree_vm_invoker_t* invoker);
+
+// Synchronously invokes the function with the current contents of the inputs
+// list and populates the outputs list. See iree_vm_invoke for details.
+IREE_API_EXPORT iree_status_t iree_vm_invoker_invoke(
+    iree_vm_invoker_t* invoker, const iree_vm_invocation_policy_t* policy);
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
 // TODO(benvanik): document and implement.
 IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
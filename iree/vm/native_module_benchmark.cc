@@ -4,16 +4,166 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <array>
+#include <cstdint>
+
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
 #include "iree/vm/module.h"
 #include "iree/vm/native_module.h"
 #include "iree/vm/native_module_test.h"
 #include "iree/vm/stack.h"
+#include "iree/vm/value.h"
 
 namespace {
 
-// TODO(benvanik): native module benchmarks.
+// Host allocator wrapping the system allocator that counts allocations.
+// Used to verify that steady-state invocations do not hit the heap.
+struct CountingAllocator {
+  int64_t allocation_count = 0;
+
+  iree_allocator_t allocator() { return {this, Ctl}; }
+
+  static iree_status_t Ctl(void* self, iree_allocator_command_t command,
+                           const void* params, void** inout_ptr) {
+    if (command != IREE_ALLOCATOR_COMMAND_FREE) {
+      ++reinterpret_cast<CountingAllocator*>(self)->allocation_count;
+    }
+    return iree_allocator_system_ctl(/*self=*/NULL, command, params,
+                                     inout_ptr);
+  }
+};
+
+// Context containing module_a and module_b from native_module_test.h with the
+// module_b.entry function resolved.
+struct NativeModuleContext {
+  explicit NativeModuleContext(iree_allocator_t allocator) {
+    IREE_CHECK_OK(iree_vm_instance_create(allocator, &instance));
+    iree_vm_module_t* module_a = nullptr;
+    IREE_CHECK_OK(module_a_create(allocator, &module_a));
+    iree_vm_module_t* module_b = nullptr;
+    IREE_CHECK_OK(module_b_create(allocator, &module_b));
+    std::array<iree_vm_module_t*, 2> modules = {module_a, module_b};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance, IREE_VM_CONTEXT_FLAG_NONE, modules.data(), modules.size(),
+        allocator, &context));
+    iree_vm_module_release(module_a);
+    iree_vm_module_release(module_b);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context, iree_make_cstring_view("module_b.entry"), &function));
+  }
+  ~NativeModuleContext() {
+    iree_vm_context_release(context);
+    iree_vm_instance_release(instance);
+  }
+
+  iree_vm_instance_t* instance = nullptr;
+  iree_vm_context_t* context = nullptr;
+  iree_vm_function_t function;
+};
+
+// Invokes through iree_vm_invoke with new lists for every call.
+static void BM_InvokeNewLists(benchmark::State& state) {
+  CountingAllocator counting_allocator;
+  iree_allocator_t allocator = counting_allocator.allocator();
+  NativeModuleContext module_context(allocator);
+
+  int64_t allocation_count = counting_allocator.allocation_count;
+  for (auto _ : state) {
+    iree_vm_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1, allocator,
+                                      &inputs));
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(1);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    iree_vm_list_t* outputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1, allocator,
+                                      &outputs));
+    IREE_CHECK_OK(iree_vm_invoke(module_context.context,
+                                 module_context.function,
+                                 IREE_VM_INVOCATION_FLAG_NONE,
+                                 /*policy=*/nullptr, inputs, outputs,
+                                 allocator));
+    iree_vm_list_release(inputs);
+    iree_vm_list_release(outputs);
+  }
+  state.counters["allocs_per_call"] = benchmark::Counter(
+      counting_allocator.allocation_count - allocation_count,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_InvokeNewLists);
+
+// Invokes through iree_vm_invoke reusing the same lists for every call.
+static void BM_InvokeReusedLists(benchmark::State& state) {
+  CountingAllocator counting_allocator;
+  iree_allocator_t allocator = counting_allocator.allocator();
+  NativeModuleContext module_context(allocator);
+
+  iree_vm_list_t* inputs = nullptr;
+  IREE_CHECK_OK(
+      iree_vm_list_create(/*element_type=*/nullptr, 1, allocator, &inputs));
+  iree_vm_list_t* outputs = nullptr;
+  IREE_CHECK_OK(
+      iree_vm_list_create(/*element_type=*/nullptr, 1, allocator, &outputs));
+
+  int64_t allocation_count = counting_allocator.allocation_count;
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_vm_list_resize(inputs, 0));
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(1);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    IREE_CHECK_OK(iree_vm_invoke(module_context.context,
+                                 module_context.function,
+                                 IREE_VM_INVOCATION_FLAG_NONE,
+                                 /*policy=*/nullptr, inputs, outputs,
+                                 allocator));
+  }
+  state.counters["allocs_per_call"] = benchmark::Counter(
+      counting_allocator.allocation_count - allocation_count,
+      benchmark::Counter::kAvgIterations);
+
+  iree_vm_list_release(inputs);
+  iree_vm_list_release(outputs);
+}
+BENCHMARK(BM_InvokeReusedLists);
+
+// Invokes through a reusable iree_vm_invoker_t. Fails if any call after the
+// first performs a heap allocation.
+static void BM_InvokerReused(benchmark::State& state) {
+  CountingAllocator counting_allocator;
+  iree_allocator_t allocator = counting_allocator.allocator();
+  NativeModuleContext module_context(allocator);
+
+  iree_vm_invoker_t* invoker = nullptr;
+  IREE_CHECK_OK(iree_vm_invoker_allocate(
+      module_context.context, module_context.function,
+      IREE_VM_INVOCATION_FLAG_NONE, /*stack_size=*/0, allocator, &invoker));
+  iree_vm_list_t* inputs = iree_vm_invoker_inputs(invoker);
+
+  // Warm up once so that any lazily-grown storage is in place.
+  iree_vm_value_t arg0 = iree_vm_value_make_i32(1);
+  IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+  IREE_CHECK_OK(iree_vm_invoker_invoke(invoker, /*policy=*/nullptr));
+
+  int64_t allocation_count = counting_allocator.allocation_count;
+  for (auto _ : state) {
+    iree_vm_invoker_reset(invoker);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    IREE_CHECK_OK(iree_vm_invoker_invoke(invoker, /*policy=*/nullptr));
+  }
+  int64_t steady_state_allocations =
+      counting_allocator.allocation_count - allocation_count;
+  state.counters["allocs_per_call"] = benchmark::Counter(
+      steady_state_allocations, benchmark::Counter::kAvgIterations);
+  if (steady_state_allocations != 0) {
+    state.SkipWithError("steady-state invocations allocated");
+  }
+
+  iree_vm_invoker_free(invoker);
+}
+BENCHMARK(BM_InvokerReused);
 
 }  // namespace
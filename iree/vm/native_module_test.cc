@@ -6,6 +6,7 @@
 
 #include "iree/vm/native_module_test.h"
 
+#include <utility>
 #include <vector>
 
 #include "iree/base/status_cc.h"
@@ -89,7 +90,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -106,5 +107,32 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Tests that a single invoker can be reused across multiple invocations.
+TEST_F(VMNativeModuleTest, Invoker) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_b.entry"), &function));
+  iree_vm_invoker_t* invoker = nullptr;
+  IREE_ASSERT_OK(iree_vm_invoker_allocate(
+      context_, function, IREE_VM_INVOCATION_FLAG_NONE, /*stack_size=*/0,
+      iree_allocator_system(), &invoker));
+
+  const std::pair<int32_t, int32_t> arg_results[] = {{1, 1}, {2, 4}, {3, 8}};
+  for (const auto& arg_result : arg_results) {
+    iree_vm_invoker_reset(invoker);
+    auto arg0_value = iree_vm_value_make_i32(arg_result.first);
+    IREE_ASSERT_OK(
+        iree_vm_list_push_value(iree_vm_invoker_inputs(invoker), &arg0_value));
+    IREE_ASSERT_OK(iree_vm_invoker_invoke(invoker, /*policy=*/nullptr));
+    iree_vm_list_t* outputs = iree_vm_invoker_outputs(invoker);
+    ASSERT_EQ(iree_vm_list_size(outputs), 1);
+    iree_vm_value_t ret0_value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &ret0_value));
+    EXPECT_EQ(ret0_value.i32, arg_result.second);
+  }
+
+  iree_vm_invoker_free(invoker);
+}
+
 }  // namespace
 }  // namespace iree
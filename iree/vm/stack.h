@@ -49,6 +49,15 @@ enum iree_vm_invocation_flag_bits_t {
   // functionality is available; specifically:
   //   -DIREE_VM_EXECUTION_TRACING_ENABLE=1
   IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION = 1u << 0,
+
+  // Translates bytecode functions into the threaded-code tier on their first
+  // call instead of waiting for them to become hot.
+  // See iree/vm/bytecode_threaded.h for details.
+  IREE_VM_INVOCATION_FLAG_EAGER_TIERING = 1u << 1,
+
+  // Executes bytecode functions only with the interpreter even if they have
+  // already been translated into the threaded-code tier.
+  IREE_VM_INVOCATION_FLAG_DISABLE_TIERING = 1u << 2,
 };
 typedef uint32_t iree_vm_invocation_flags_t;
 
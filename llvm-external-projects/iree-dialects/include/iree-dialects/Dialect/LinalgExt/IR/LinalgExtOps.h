@@ -30,6 +30,22 @@ Value getDimValue(OpBuilder &builder, Location loc, Value v, int64_t dim);
 /// `dim`. If the shape is constant, returns the shape as an `IntegerAttr`.
 OpFoldResult getDim(OpBuilder &builder, Location loc, Value v, int64_t dim);
 
+/// Builds the operands of a `topk` selecting `k` elements along `dimension` of
+/// the statically shaped `values` and optional i32 `indices`, such that its
+/// outputs hold real inputs from the start instead of a value that must order
+/// after every input:
+///   - `outputs` are the first `k` elements of every line and their indices,
+///     sorted with `buildCompare` and then by position,
+///   - `inputs` are the remaining elements of every line and their indices.
+/// Without `indices`, the positions along `dimension` are used. `buildCompare`
+/// returns an i1 that is true if its first value orders strictly before its
+/// second, as the `topk` region does.
+void buildSeededTopkOperands(
+    OpBuilder &builder, Location loc, Value values, Optional<Value> indices,
+    int64_t dimension, int64_t k,
+    function_ref<Value(OpBuilder &, Location, Value, Value)> buildCompare,
+    SmallVectorImpl<Value> &inputs, SmallVectorImpl<Value> &outputs);
+
 } // namespace LinalgExt
 } // namespace IREE
 } // namespace iree_compiler
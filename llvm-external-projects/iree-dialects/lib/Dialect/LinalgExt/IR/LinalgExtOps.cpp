@@ -101,6 +101,95 @@ OpFoldResult IREE::LinalgExt::getDim(OpBuilder &builder, Location loc, Value v,
   return builder.getI64IntegerAttr(t.getDimSize(dim));
 }
 
+void IREE::LinalgExt::buildSeededTopkOperands(
+    OpBuilder &builder, Location loc, Value values, Optional<Value> indices,
+    int64_t dimension, int64_t k,
+    function_ref<Value(OpBuilder &, Location, Value, Value)> buildCompare,
+    SmallVectorImpl<Value> &inputs, SmallVectorImpl<Value> &outputs) {
+  auto valuesType = values.getType().cast<RankedTensorType>();
+  int64_t rank = valuesType.getRank();
+  int64_t size = valuesType.getDimSize(dimension);
+  Type valueElementType = valuesType.getElementType();
+  Type indexElementType = builder.getI32Type();
+
+  // The positions along `dimension` break ties between the seeds, as the
+  // sort is not stable, and stand in for the indices if none are given.
+  Value positions;
+  {
+    Value init = builder.create<linalg::InitTensorOp>(
+        loc, ValueRange{}, valuesType.getShape(), indexElementType);
+    positions =
+        builder
+            .create<linalg::GenericOp>(
+                loc, init.getType(), ValueRange{}, init,
+                AffineMap::getMultiDimIdentityMap(rank, builder.getContext()),
+                SmallVector<StringRef>(rank, getParallelIteratorTypeName()),
+                [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                  Value position =
+                      b.create<linalg::IndexOp>(nestedLoc, dimension);
+                  b.create<linalg::YieldOp>(
+                      nestedLoc,
+                      b.create<arith::IndexCastOp>(nestedLoc, indexElementType,
+                                                   position)
+                          .getResult());
+                })
+            .getResult(0);
+  }
+
+  auto extractLines = [&](Value source, int64_t offset,
+                          int64_t length) -> Value {
+    auto sourceType = source.getType().cast<RankedTensorType>();
+    SmallVector<int64_t> shape(sourceType.getShape().begin(),
+                               sourceType.getShape().end());
+    shape[dimension] = length;
+    SmallVector<OpFoldResult> offsets(rank, builder.getIndexAttr(0));
+    offsets[dimension] = builder.getIndexAttr(offset);
+    SmallVector<OpFoldResult> sizes;
+    for (int64_t dimSize : shape) {
+      sizes.push_back(builder.getIndexAttr(dimSize));
+    }
+    SmallVector<OpFoldResult> strides(rank, builder.getIndexAttr(1));
+    return builder.create<tensor::ExtractSliceOp>(
+        loc, RankedTensorType::get(shape, sourceType.getElementType()), source,
+        offsets, sizes, strides);
+  };
+
+  // Sort the first `k` elements of every line into the outputs. Equivalent
+  // elements keep their order, like later inputs that compare equal to an
+  // output do in the `topk`.
+  SmallVector<Value> seeds = {extractLines(values, 0, k),
+                              extractLines(positions, 0, k)};
+  if (indices) seeds.push_back(extractLines(*indices, 0, k));
+  auto sortOp = builder.create<SortOp>(loc, TypeRange(ValueRange(seeds)),
+                                       /*inputs=*/ValueRange{}, seeds,
+                                       builder.getI64IntegerAttr(dimension));
+  {
+    OpBuilder::InsertionGuard guard(builder);
+    SmallVector<Type> argTypes = {valueElementType, valueElementType,
+                                  indexElementType, indexElementType};
+    if (indices) argTypes.append(2, indexElementType);
+    SmallVector<Location> argLocs(argTypes.size(), loc);
+    Block *block = builder.createBlock(&sortOp.region(), {}, argTypes, argLocs);
+    Value lhs = block->getArgument(0);
+    Value rhs = block->getArgument(1);
+    Value isBefore = buildCompare(builder, loc, lhs, rhs);
+    Value isAfter = buildCompare(builder, loc, rhs, lhs);
+    Value isEarlier = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::slt, block->getArgument(2),
+        block->getArgument(3));
+    Value isTieBefore = builder.create<arith::SelectOp>(
+        loc, isAfter, builder.create<arith::ConstantIntOp>(loc, 0, 1),
+        isEarlier);
+    Value isOrdered = builder.create<arith::OrIOp>(loc, isBefore, isTieBefore);
+    builder.create<YieldOp>(loc, isOrdered);
+  }
+  outputs.push_back(sortOp->getResult(0));
+  outputs.push_back(sortOp->getResult(indices ? 2 : 1));
+
+  inputs.push_back(extractLines(values, k, size - k));
+  inputs.push_back(extractLines(indices ? *indices : positions, k, size - k));
+}
+
 //===----------------------------------------------------------------------===//
 // ScatterOp
 //===----------------------------------------------------------------------===//
@@ -219,10 +308,44 @@ LogicalResult ScatterOp::verify() {
   return success();
 }
 
+/// Returns the kind of atomic read-modify-write equivalent to the region of
+/// `op`, if the region combines the update with the original value using a
+/// single commutative operation supported by memref.atomic_rmw.
+///
+/// Only 32-bit integer kinds are used: those are native atomics on every
+/// target with atomics (SPIR-V has no core float atomics and emulates
+/// narrower types with wider read-modify-writes).
+static Optional<arith::AtomicRMWKind> getAtomicCombinerKind(ScatterOp op) {
+  if (!op.getOriginalType().getElementType().isSignlessInteger(32)) {
+    return llvm::None;
+  }
+  Block &block = op.region().front();
+  if (!llvm::hasSingleElement(block.without_terminator())) return llvm::None;
+  Operation &combiner = block.front();
+  if (combiner.getNumOperands() != 2 || combiner.getNumResults() != 1 ||
+      block.getTerminator()->getOperand(0) != combiner.getResult(0) ||
+      !llvm::is_contained(combiner.getOperands(), block.getArgument(0)) ||
+      !llvm::is_contained(combiner.getOperands(), block.getArgument(1))) {
+    return llvm::None;
+  }
+  return llvm::TypeSwitch<Operation *, Optional<arith::AtomicRMWKind>>(
+             &combiner)
+      .Case<arith::AddIOp>([](auto) { return arith::AtomicRMWKind::addi; })
+      .Case<arith::MaxSIOp>([](auto) { return arith::AtomicRMWKind::maxs; })
+      .Case<arith::MaxUIOp>([](auto) { return arith::AtomicRMWKind::maxu; })
+      .Case<arith::MinSIOp>([](auto) { return arith::AtomicRMWKind::mins; })
+      .Case<arith::MinUIOp>([](auto) { return arith::AtomicRMWKind::minu; })
+      .Case<arith::AndIOp>([](auto) { return arith::AtomicRMWKind::andi; })
+      .Case<arith::OrIOp>([](auto) { return arith::AtomicRMWKind::ori; })
+      .Default([](Operation *) { return llvm::None; });
+}
+
 SmallVector<StringRef> ScatterOp::getLoopIteratorTypes() {
   SmallVector<StringRef> iteratorTypes(getUpdateType().getRank(),
                                        getParallelIteratorTypeName());
-  if (!unique_indices()) {
+  // Repeated indices are combined with atomics when the region allows it, so
+  // the updates can still be processed in parallel.
+  if (!unique_indices() && !getAtomicCombinerKind(*this)) {
     iteratorTypes[0] = getReductionIteratorTypeName();
   }
   return iteratorTypes;
@@ -335,6 +458,16 @@ LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
     starts[i] = cast;
   }
 
+  // Updates with repeated indices may run concurrently; apply them with an
+  // atomic read-modify-write instead of a load/store pair.
+  if (!unique_indices()) {
+    if (Optional<arith::AtomicRMWKind> kind = getAtomicCombinerKind(*this)) {
+      b.create<memref::AtomicRMWOp>(loc, update.getType(), *kind, update,
+                                    original(), starts);
+      return success();
+    }
+  }
+
   Value init = b.create<memref::LoadOp>(loc, original(), starts);
 
   BlockAndValueMapping bvm;
@@ -433,6 +566,12 @@ SmallVector<Range> SortOp::getIterationDomain(OpBuilder &builder) {
     loopBounds[dim].size = getDimValue(builder, loc, source, dim);
     loopBounds[dim].stride = one;
   }
+  // The scalar implementation sorts a whole line at once so step over the
+  // sort dimension in a single iteration.
+  int64_t sortDim = dimension();
+  loopBounds[sortDim].stride =
+      builder.createOrFold<arith::MaxUIOp>(loc, loopBounds[sortDim].size,
+                                              one);
   return loopBounds;
 }
 
@@ -485,77 +624,134 @@ Operation *SortOp::getTiledImplementation(OpBuilder &builder,
 
 LogicalResult SortOp::generateScalarImplementation(OpBuilder &b, Location loc,
                                                    ValueRange ivs) {
+  // The iteration domain covers the sort dimension with a single iteration so
+  // this sorts the whole line at `ivs` in place using heapsort. Heapsort needs
+  // no scratch memory and is O(n log n) in the worst case. Like the region
+  // semantics it does not preserve the order of equivalent elements.
   auto sortDim = dimension();
-  SmallVector<Value> indices, sortBlkArgs;
-  indices.append(ivs.begin(), ivs.end());
-  // Bubble sort innermost loop.
+  Type indexType = b.getIndexType();
   Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
   Value one = b.create<arith::ConstantIndexOp>(loc, 1);
-  Value ub;
+  Value two = b.create<arith::ConstantIndexOp>(loc, 2);
+  Value size;
   if (getOperandType(0).isDynamicDim(sortDim)) {
-    ub = b.create<memref::DimOp>(loc, operand(0), sortDim);
+    size = b.create<memref::DimOp>(loc, operand(0), sortDim);
   } else {
-    ub = b.create<arith::ConstantIndexOp>(
+    size = b.create<arith::ConstantIndexOp>(
         loc, getOperandType(0).getDimSize(sortDim));
   }
-  ub = b.create<arith::SubIOp>(loc, ub, one);
-  auto scfFor = b.create<scf::ForOp>(
-      loc, zero, ub, one, ValueRange{},
-      [&](OpBuilder &b, Location loc, Value iv, ValueRange iters) {
-        SmallVector<Value> indices(ivs);
-        Value ivPlusOne = b.create<arith::AddIOp>(loc, iv, one);
-        for (auto output : getOutputOperands()) {
-          indices[sortDim] = iv;
-          sortBlkArgs.push_back(
-              b.create<memref::LoadOp>(loc, output->get(), indices));
-          indices[sortDim] = ivPlusOne;
-          sortBlkArgs.push_back(
-              b.create<memref::LoadOp>(loc, output->get(), indices));
-        }
-      });
 
+  // Returns the comparator region applied to the elements at `lhs` and `rhs`;
+  // true if the element at `lhs` orders before the element at `rhs`.
   auto &srcBlock = region().front();
-  Region &region = scfFor.getRegion();
-  BlockAndValueMapping bvm;
-  {
-    OpBuilder::InsertionGuard guard(b);
-    auto &block = region.front();
-    b.setInsertionPointToEnd(&block);
-    for (auto it : llvm::zip(srcBlock.getArguments(), sortBlkArgs)) {
-      bvm.map(std::get<0>(it), std::get<1>(it));
+  auto emitCompare = [&](OpBuilder &b, Location loc, Value lhs,
+                         Value rhs) -> Value {
+    SmallVector<Value> indices(ivs);
+    BlockAndValueMapping bvm;
+    for (auto output : llvm::enumerate(getOutputOperands())) {
+      indices[sortDim] = lhs;
+      bvm.map(srcBlock.getArgument(output.index() * 2),
+              b.create<memref::LoadOp>(loc, output.value()->get(), indices));
+      indices[sortDim] = rhs;
+      bvm.map(srcBlock.getArgument(output.index() * 2 + 1),
+              b.create<memref::LoadOp>(loc, output.value()->get(), indices));
     }
     for (auto &blockOp : srcBlock.without_terminator()) {
       b.clone(blockOp, bvm);
     }
-  }
-  Value cond = bvm.lookupOrDefault(srcBlock.getTerminator()->getOperand(0));
+    return bvm.lookupOrDefault(srcBlock.getTerminator()->getOperand(0));
+  };
 
-  OpBuilder::InsertionGuard g(b);
-  b.setInsertionPointToEnd(&region.front());
-  b.create<scf::IfOp>(
-      loc, TypeRange{}, cond,
-      [&](OpBuilder &b, Location loc) {
-        // Do not swap the pairs if true.
+  // Swaps the elements at `lhs` and `rhs` of all outputs.
+  auto emitSwap = [&](OpBuilder &b, Location loc, Value lhs, Value rhs) {
+    SmallVector<Value> lhsIndices(ivs), rhsIndices(ivs);
+    lhsIndices[sortDim] = lhs;
+    rhsIndices[sortDim] = rhs;
+    for (auto output : getOutputOperands()) {
+      Value buffer = output->get();
+      Value lhsValue = b.create<memref::LoadOp>(loc, buffer, lhsIndices);
+      Value rhsValue = b.create<memref::LoadOp>(loc, buffer, rhsIndices);
+      b.create<memref::StoreOp>(loc, rhsValue, buffer, lhsIndices);
+      b.create<memref::StoreOp>(loc, lhsValue, buffer, rhsIndices);
+    }
+  };
+
+  // Moves the element at `root` down the heap formed by the elements in
+  // [0, end) until neither of its children orders after it.
+  auto emitSiftDown = [&](OpBuilder &b, Location loc, Value root, Value end) {
+    auto whileOp = b.create<scf::WhileOp>(loc, TypeRange{indexType, indexType},
+                                          ValueRange{root});
+    {
+      // Picks the child to swap `node` with or yields `end` to stop.
+      OpBuilder::InsertionGuard guard(b);
+      Block *before =
+          b.createBlock(&whileOp.getBefore(), {}, {indexType}, {loc});
+      Value node = before->getArgument(0);
+      Value left = b.create<arith::AddIOp>(
+          loc, b.create<arith::MulIOp>(loc, node, two), one);
+      Value hasLeft =
+          b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult, left, end);
+      auto pickOp = b.create<scf::IfOp>(
+          loc, TypeRange{indexType}, hasLeft,
+          [&](OpBuilder &b, Location loc) {
+            Value right = b.create<arith::AddIOp>(loc, left, one);
+            Value hasRight = b.create<arith::CmpIOp>(
+                loc, arith::CmpIPredicate::ult, right, end);
+            auto childOp = b.create<scf::IfOp>(
+                loc, TypeRange{indexType}, hasRight,
+                [&](OpBuilder &b, Location loc) {
+                  Value leftFirst = emitCompare(b, loc, left, right);
+                  b.create<scf::YieldOp>(
+                      loc, ValueRange{b.create<arith::SelectOp>(
+                               loc, leftFirst, right, left)});
+                },
+                [&](OpBuilder &b, Location loc) {
+                  b.create<scf::YieldOp>(loc, left);
+                });
+            Value child = childOp.getResult(0);
+            Value nodeFirst = emitCompare(b, loc, node, child);
+            b.create<scf::YieldOp>(
+                loc, ValueRange{b.create<arith::SelectOp>(loc, nodeFirst,
+                                                          child, end)});
+          },
+          [&](OpBuilder &b, Location loc) {
+            b.create<scf::YieldOp>(loc, end);
+          });
+      Value next = pickOp.getResult(0);
+      Value keepGoing =
+          b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult, next, end);
+      b.create<scf::ConditionOp>(loc, keepGoing, ValueRange{node, next});
+    }
+    {
+      OpBuilder::InsertionGuard guard(b);
+      Block *after = b.createBlock(&whileOp.getAfter(), {},
+                                   {indexType, indexType}, {loc, loc});
+      emitSwap(b, loc, after->getArgument(0), after->getArgument(1));
+      b.create<scf::YieldOp>(loc, ValueRange{after->getArgument(1)});
+    }
+  };
+
+  // Builds the heap from the bottom up.
+  Value half = b.create<arith::DivUIOp>(loc, size, two);
+  b.create<scf::ForOp>(
+      loc, zero, half, one, ValueRange{},
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange iters) {
+        Value root = b.create<arith::SubIOp>(
+            loc, b.create<arith::SubIOp>(loc, half, one), iv);
+        emitSiftDown(b, loc, root, size);
         b.create<scf::YieldOp>(loc);
-      },
-      [&](OpBuilder &b, Location loc) {
-        // Swap the pairs if false.
-        SmallVector<Value> indices(ivs.begin(), ivs.end());
-        Value ivPlusOne =
-            b.create<arith::AddIOp>(loc, scfFor.getInductionVar(), one);
-        for (int i = 0, e = getNumOutputs(); i < e; ++i) {
-          Value v1 = sortBlkArgs[i * 2];
-          Value v2 = sortBlkArgs[i * 2 + 1];
-          indices[sortDim] = scfFor.getInductionVar();
-          b.create<memref::StoreOp>(loc, v2, getOutputOperand(i)->get(),
-                                    indices);
-          indices[sortDim] = ivPlusOne;
-          b.create<memref::StoreOp>(loc, v1, getOutputOperand(i)->get(),
-                                    indices);
-        }
+      });
+
+  // Repeatedly moves the element ordering last to the end of the heap.
+  Value last = b.create<arith::SubIOp>(loc, size, one);
+  b.create<scf::ForOp>(
+      loc, zero, last, one, ValueRange{},
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange iters) {
+        Value end = b.create<arith::SubIOp>(loc, last, iv);
+        emitSwap(b, loc, zero, end);
+        emitSiftDown(b, loc, zero, end);
         b.create<scf::YieldOp>(loc);
       });
-  b.create<scf::YieldOp>(loc);
   return success();
 }
 
@@ -812,6 +1008,58 @@ Operation *FftOp::getTiledImplementation(OpBuilder &builder, ValueRange outputs,
   return tiledFftOp;
 }
 
+namespace {
+/// Materializes the twiddle factors exp(-2 * PI * j / m * I) of an fft stage
+/// with a constant stage as constant coefficient tensors. The butterflies then
+/// load them instead of computing a sin and a cos each, and no longer depend on
+/// their position along the innermost dimension, which makes that dimension
+/// partitionable as well.
+struct MaterializeFftCoefficients : public OpRewritePattern<FftOp> {
+  using OpRewritePattern<FftOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(FftOp fftOp,
+                                PatternRewriter &rewriter) const override {
+    if (fftOp.hasCoeff() || !fftOp.hasTensorSemantics()) return failure();
+    if (!fftOp.getOperandType().getElementType().isF32()) return failure();
+    APInt stageValue;
+    if (!matchPattern(fftOp.getStage(), m_ConstantInt(&stageValue)))
+      return failure();
+    int64_t stage = stageValue.getSExtValue();
+    int64_t length = fftOp.getFftLength();
+    if (stage < 1 || stage >= 32 ||
+        (length != ShapedType::kDynamicSize &&
+         (int64_t(1) << stage) > length)) {
+      return failure();
+    }
+
+    int64_t m = int64_t(1) << stage;
+    int64_t mh = m >> 1;
+    const double pi = acos(-1);
+    SmallVector<float> real, imag;
+    for (int64_t j = 0; j < mh; ++j) {
+      double w = -2 * pi * j / m;
+      real.push_back(static_cast<float>(cos(w)));
+      imag.push_back(static_cast<float>(sin(w)));
+    }
+    Location loc = fftOp.getLoc();
+    auto type = RankedTensorType::get({mh}, rewriter.getF32Type());
+    Value realCoeff = rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(type, llvm::makeArrayRef(real)));
+    Value imagCoeff = rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(type, llvm::makeArrayRef(imag)));
+    rewriter.replaceOpWithNewOp<FftOp>(
+        fftOp, fftOp->getResultTypes(),
+        ValueRange{fftOp.getStage(), realCoeff, imagCoeff}, fftOp.outputs());
+    return success();
+  }
+};
+} // namespace
+
+void FftOp::getCanonicalizationPatterns(RewritePatternSet &results,
+                                        MLIRContext *context) {
+  results.add<MaterializeFftCoefficients>(context);
+}
+
 //===----------------------------------------------------------------------===//
 // ScanOp
 //===----------------------------------------------------------------------===//
@@ -1180,6 +1428,248 @@ Operation *ReverseOp::getTiledImplementation(OpBuilder &builder,
   return tiledRevOp;
 }
 
+//===----------------------------------------------------------------------===//
+// TopkOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult TopkOp::verify() {
+  Operation *op = getOperation();
+  if (getNumInputs() != 1 && getNumInputs() != 2) {
+    return op->emitOpError("expected one or two input operands");
+  }
+  if (getNumOutputs() != 2) {
+    return op->emitOpError("expected two output operands");
+  }
+  int64_t rank = getInputRank();
+  if (dimension() < 0 || dimension() >= rank) {
+    return op->emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+
+  auto inputValuesType = getInputType();
+  auto outputValuesType = outputValues().getType().cast<ShapedType>();
+  auto outputIndicesType = outputIndices().getType().cast<ShapedType>();
+  if (inputValuesType.getElementType() != outputValuesType.getElementType()) {
+    return op->emitOpError("expected input/output value types to be identical");
+  }
+  if (!outputIndicesType.getElementType().isInteger(32)) {
+    return op->emitOpError("expected output indices to be of type i32");
+  }
+  if (outputValuesType.getRank() != rank ||
+      outputIndicesType.getRank() != rank) {
+    return op->emitOpError("expected input/output to have identical ranks");
+  }
+  if (outputValuesType.getShape() != outputIndicesType.getShape()) {
+    return op->emitOpError("expected output values/indices to have the same "
+                           "shape");
+  }
+  auto isIncompatible = [](int64_t lhs, int64_t rhs) {
+    return lhs != ShapedType::kDynamicSize && rhs != ShapedType::kDynamicSize &&
+           lhs != rhs;
+  };
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    if (dim == dimension()) continue;
+    if (isIncompatible(inputValuesType.getDimSize(dim),
+                       outputValuesType.getDimSize(dim))) {
+      return op->emitOpError("incompatible input/output shapes");
+    }
+  }
+  if (Optional<Value> inputIndices = indices()) {
+    auto inputIndicesType = inputIndices->getType().cast<ShapedType>();
+    if (!inputIndicesType.getElementType().isInteger(32)) {
+      return op->emitOpError("expected input indices to be of type i32");
+    }
+    if (inputIndicesType.getRank() != rank ||
+        llvm::any_of(llvm::zip(inputValuesType.getShape(),
+                               inputIndicesType.getShape()),
+                     [&](std::tuple<int64_t, int64_t> s) {
+                       return isIncompatible(std::get<0>(s), std::get<1>(s));
+                     })) {
+      return op->emitOpError("expected input values/indices to have the same "
+                             "shape");
+    }
+  }
+
+  Block &block = region().front();
+  if (block.getNumArguments() != 2) {
+    return op->emitOpError("region block should have 2 arguments");
+  }
+  if (block.getArgument(0).getType() != inputValuesType.getElementType() ||
+      block.getArgument(1).getType() != inputValuesType.getElementType()) {
+    return op->emitOpError("region block types must match input value type");
+  }
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1 ||
+      !yieldOp.getOperand(0).getType().isInteger(1)) {
+    return op->emitOpError("should yield i1");
+  }
+  return success();
+}
+
+SmallVector<Range> TopkOp::getIterationDomain(OpBuilder &builder) {
+  int64_t rank = getInputRank();
+  SmallVector<Range> loopBounds(rank);
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  Value source = values();
+  for (auto dim : llvm::seq<int64_t>(0, rank)) {
+    loopBounds[dim].offset = zero;
+    loopBounds[dim].size = getDimValue(builder, loc, source, dim);
+    loopBounds[dim].stride = one;
+  }
+  return loopBounds;
+}
+
+SmallVector<StringRef> TopkOp::getLoopIteratorTypes() {
+  SmallVector<StringRef> iteratorTypes(getInputRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[dimension()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<unsigned>
+TopkOp::getPartitionableLoops(unsigned maxNumParallelDims) {
+  auto range = llvm::seq<unsigned>(0, getInputRank());
+  SmallVector<unsigned> partitionableLoops(range.begin(), range.end());
+  partitionableLoops.erase(std::next(partitionableLoops.begin(), dimension()));
+  if (partitionableLoops.size() > maxNumParallelDims) {
+    partitionableLoops.erase(
+        partitionableLoops.begin(),
+        std::next(partitionableLoops.begin(),
+                  partitionableLoops.size() - maxNumParallelDims));
+  }
+  return partitionableLoops;
+}
+
+// Merges the input element at `ivs` into the sorted outputs:
+//   if (region(input, output[k - 1])) {
+//     for (j = 0; j < k; ++j) {
+//       if (inserted || region(input, output[j])) {
+//         swap(input, output[j])
+//         inserted = true
+//       }
+//     }
+//   }
+// The guard rejects most elements with a single comparison when k is much
+// smaller than the size of the dimension.
+LogicalResult TopkOp::generateScalarImplementation(OpBuilder &b, Location loc,
+                                                   ValueRange ivs) {
+  uint64_t kDim = dimension();
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value initialValue = b.create<memref::LoadOp>(loc, values(), ivs);
+  Value initialIndex;
+  if (Optional<Value> inputIndices = indices()) {
+    initialIndex = b.create<memref::LoadOp>(loc, *inputIndices, ivs);
+  } else {
+    Type indexType =
+        outputIndices().getType().cast<ShapedType>().getElementType();
+    initialIndex = b.create<arith::IndexCastOp>(loc, indexType, ivs[kDim]);
+  }
+
+  // Returns true if `lhs` orders before `rhs`.
+  auto &srcBlock = region().front();
+  auto emitCompare = [&](OpBuilder &b, Location loc, Value lhs,
+                         Value rhs) -> Value {
+    BlockAndValueMapping bvm;
+    bvm.map(srcBlock.getArgument(0), lhs);
+    bvm.map(srcBlock.getArgument(1), rhs);
+    for (auto &blockOp : srcBlock.without_terminator()) {
+      b.clone(blockOp, bvm);
+    }
+    return bvm.lookupOrDefault(srcBlock.getTerminator()->getOperand(0));
+  };
+
+  Value kSize = getDimValue(b, loc, outputValues(), kDim);
+  SmallVector<Value> lastIndices(ivs);
+  lastIndices[kDim] = b.create<arith::SubIOp>(loc, kSize, one);
+  Value lastValue = b.create<memref::LoadOp>(loc, outputValues(), lastIndices);
+  Value isSelected = emitCompare(b, loc, initialValue, lastValue);
+  b.create<scf::IfOp>(
+      loc, TypeRange{}, isSelected, [&](OpBuilder &b, Location loc) {
+        Value notInserted = b.create<arith::ConstantIntOp>(loc, 0, 1);
+        b.create<scf::ForOp>(
+            loc, zero, kSize, one,
+            ValueRange{initialValue, initialIndex, notInserted},
+            [&](OpBuilder &b, Location loc, Value iv, ValueRange iters) {
+              SmallVector<Value> indices(ivs);
+              indices[kDim] = iv;
+              Value value = iters[0];
+              Value index = iters[1];
+              Value outputValue =
+                  b.create<memref::LoadOp>(loc, outputValues(), indices);
+              Value outputIndex =
+                  b.create<memref::LoadOp>(loc, outputIndices(), indices);
+              // Once inserted the remaining elements shift down by one.
+              Value swap = b.create<arith::OrIOp>(
+                  loc, iters[2], emitCompare(b, loc, value, outputValue));
+              b.create<memref::StoreOp>(
+                  loc,
+                  b.create<arith::SelectOp>(loc, swap, value, outputValue),
+                  outputValues(), indices);
+              b.create<memref::StoreOp>(
+                  loc,
+                  b.create<arith::SelectOp>(loc, swap, index, outputIndex),
+                  outputIndices(), indices);
+              b.create<scf::YieldOp>(
+                  loc,
+                  ValueRange{b.create<arith::SelectOp>(loc, swap, outputValue,
+                                                       value),
+                             b.create<arith::SelectOp>(loc, swap, outputIndex,
+                                                       index),
+                             swap});
+            });
+        b.create<scf::YieldOp>(loc);
+      });
+  return success();
+}
+
+Operation *TopkOp::getTiledImplementation(OpBuilder &builder,
+                                          ValueRange outputs,
+                                          ArrayRef<OpFoldResult> offsets,
+                                          ArrayRef<OpFoldResult> sizes,
+                                          SmallVectorImpl<Value> &results) {
+  int64_t rank = getInputRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+  Location loc = getLoc();
+
+  SmallVector<Value> tiledOperands;
+  tiledOperands.emplace_back(
+      getSlice(builder, loc, values(), offsets, sizes, strides));
+  if (Optional<Value> inputIndices = indices()) {
+    tiledOperands.emplace_back(
+        getSlice(builder, loc, *inputIndices, offsets, sizes, strides));
+  }
+
+  // The outputs always cover all K elements of the tile.
+  SmallVector<OpFoldResult> outputOffsets(offsets.begin(), offsets.end());
+  SmallVector<OpFoldResult> outputSizes(sizes.begin(), sizes.end());
+  outputOffsets[dimension()] = builder.getI64IntegerAttr(0);
+  outputSizes[dimension()] = getDim(builder, loc, outputs[0], dimension());
+  tiledOperands.emplace_back(getSlice(builder, loc, outputs[0], outputOffsets,
+                                      outputSizes, strides));
+  tiledOperands.emplace_back(getSlice(builder, loc, outputs[1], outputOffsets,
+                                      outputSizes, strides));
+
+  SmallVector<Type, 2> resultTypes;
+  if (hasTensorSemantics()) {
+    resultTypes.push_back(tiledOperands[tiledOperands.size() - 2].getType());
+    resultTypes.push_back(tiledOperands[tiledOperands.size() - 1].getType());
+  }
+
+  Operation *tiledTopkOp = cast<LinalgExtOp>(getOperation())
+                               .clone(builder, loc, resultTypes, tiledOperands);
+  for (auto result : llvm::enumerate(tiledTopkOp->getResults())) {
+    auto insertSliceOp = builder.create<tensor::InsertSliceOp>(
+        loc, result.value(), outputs[result.index()], outputOffsets,
+        outputSizes, strides);
+    results.push_back(insertSliceOp.getResult());
+  }
+  return tiledTopkOp;
+}
+
 #define DEFINE_OP_GET_EFFECTS(OP_NAME)                                         \
   void OP_NAME::getEffects(                                                    \
       SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>      \
@@ -1195,6 +1685,7 @@ DEFINE_OP_GET_EFFECTS(SortOp)
 DEFINE_OP_GET_EFFECTS(FftOp)
 DEFINE_OP_GET_EFFECTS(ReverseOp)
 DEFINE_OP_GET_EFFECTS(ScanOp)
+DEFINE_OP_GET_EFFECTS(TopkOp)
 
 namespace {
 /// This is derived from mlir/lib/Dialect/Linalg/IR/LinalgOps.cpp without any
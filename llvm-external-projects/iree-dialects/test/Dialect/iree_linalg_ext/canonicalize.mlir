@@ -40,3 +40,24 @@ func @canonicalize_insert_slice_indices(
   }
   return %2 : tensor<?x?xf32>
 }
+
+// -----
+
+// CHECK-LABEL: func @fft_materialize_coefficients(
+//  CHECK-SAME:     %[[REAL:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:     %[[IMAG:[a-zA-Z0-9_]+]]
+func @fft_materialize_coefficients(%arg0: tensor<16xf32>, %arg1: tensor<16xf32>)
+    -> (tensor<16xf32>, tensor<16xf32>) {
+  //  CHECK-DAG: %[[STAGE:.+]] = arith.constant 2 : index
+  //  CHECK-DAG: %[[COEF_REAL:.+]] = arith.constant dense<[1.000000e+00, {{.+}}]> : tensor<2xf32>
+  //  CHECK-DAG: %[[COEF_IMAG:.+]] = arith.constant dense<[{{.+}}, -1.000000e+00]> : tensor<2xf32>
+  //      CHECK: iree_linalg_ext.fft
+  // CHECK-SAME:   ins(%[[STAGE]], %[[COEF_REAL]], %[[COEF_IMAG]] : index, tensor<2xf32>, tensor<2xf32>)
+  // CHECK-SAME:   outs(%[[REAL]], %[[IMAG]] : tensor<16xf32>, tensor<16xf32>)
+  %c2 = arith.constant 2 : index
+  %0:2 = iree_linalg_ext.fft
+    ins(%c2: index)
+    outs(%arg0, %arg1: tensor<16xf32>, tensor<16xf32>)
+  : tensor<16xf32>, tensor<16xf32>
+  return %0#0, %0#1 : tensor<16xf32>, tensor<16xf32>
+}
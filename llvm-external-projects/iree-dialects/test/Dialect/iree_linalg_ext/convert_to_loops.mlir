@@ -11,22 +11,29 @@ func @sort_1d(%arg0: memref<128xi32>) {
 }
 // CHECK-LABEL: func @sort_1d
 // CHECK-SAME:    %[[BUF:[a-zA-Z0-9]+]]
-// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
 // CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
-// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
-// CHECK-DAG:     %[[C127:.+]] = arith.constant 127 : index
-// CHECK:         scf.for %[[ARG1:.+]] = %[[C0]] to %[[C128]] step %[[C1]]
-// CHECK:           scf.for %[[ARG2:.+]] = %[[C0]] to %[[C127]] step %[[C1]]
-// CHECK:             %[[T1:.+]] = arith.addi %[[ARG2]], %[[C1]] : index
-// CHECK:             %[[V1:.+]] = memref.load %[[BUF]][%[[ARG2]]]
-// CHECK:             %[[V2:.+]] = memref.load %[[BUF]][%[[T1]]]
-// CHECK:             %[[COND:.+]] = arith.cmpi sgt, %[[V1]], %[[V2]] : i32
-// CHECK:             scf.if %[[COND]] {
-// CHECK:             } else {
-// CHECK:               %[[T2:.+]] = arith.addi %[[ARG2]], %[[C1]] : index
-// CHECK:               memref.store %[[V2]], %[[BUF]][%[[ARG2]]]
-// CHECK:               memref.store %[[V1]], %[[BUF]][%[[T2]]]
-// CHECK:             }
+// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
+// CHECK:         scf.for %{{.+}} = %[[C0]] to %[[C128]] step %[[C128]]
+// CHECK:           %[[HALF:.+]] = arith.divui
+// CHECK:           scf.for %{{.+}} = %{{.+}} to %[[HALF]]
+// CHECK:             scf.while (%{{.+}} = %{{.+}}) : (index) -> (index, index)
+// CHECK:               scf.if
+// CHECK:                 memref.load %[[BUF]]
+// CHECK:                 memref.load %[[BUF]]
+// CHECK:                 arith.cmpi sgt
+// CHECK:               scf.condition
+// CHECK:             } do {
+// CHECK:             ^bb0(%[[ROOT:.+]]: index, %[[NEXT:.+]]: index):
+// CHECK:               %[[V1:.+]] = memref.load %[[BUF]][%[[ROOT]]]
+// CHECK:               %[[V2:.+]] = memref.load %[[BUF]][%[[NEXT]]]
+// CHECK:               memref.store %[[V2]], %[[BUF]][%[[ROOT]]]
+// CHECK:               memref.store %[[V1]], %[[BUF]][%[[NEXT]]]
+// CHECK:               scf.yield %[[NEXT]]
+// CHECK:           %[[LAST:.+]] = arith.subi
+// CHECK:           scf.for %{{.+}} = %{{.+}} to %[[LAST]]
+// CHECK:             %[[END:.+]] = arith.subi %[[LAST]]
+// CHECK:             memref.store %{{.+}}, %[[BUF]][%[[END]]]
+// CHECK:             scf.while
 
 // -----
 
@@ -41,24 +48,23 @@ func @sort_2d(%arg0: memref<16x32xi32>) {
 }
 // CHECK-LABEL: func @sort_2d
 // CHECK-SAME:    %[[BUF:[a-zA-Z0-9]+]]
-// CHECK-DAG:     %[[C16:.+]] = arith.constant 16 : index
-// CHECK-DAG:     %[[C32:.+]] = arith.constant 32 : index
 // CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
 // CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
-// CHECK-DAG:     %[[C15:.+]] = arith.constant 15 : index
-// CHECK:         scf.for %[[ARG1:.+]] = %[[C0]] to %[[C16]] step %[[C1]]
-// CHECK:           scf.for %[[ARG2:.+]] = %[[C0]] to %[[C32]] step %[[C1]]
-// CHECK:             scf.for %[[ARG3:.+]] = %[[C0]] to %[[C15]] step %[[C1]]
-// CHECK:               %[[T1:.+]] = arith.addi %[[ARG3]], %[[C1]] : index
-// CHECK:               %[[V1:.+]] = memref.load %[[BUF]][%[[ARG3]], %[[ARG2]]]
-// CHECK:               %[[V2:.+]] = memref.load %[[BUF]][%[[T1]], %[[ARG2]]]
-// CHECK:               %[[COND:.+]] = arith.cmpi sgt, %[[V1]], %[[V2]] : i32
-// CHECK:               scf.if %[[COND]] {
-// CHECK:               } else {
-// CHECK:                 %[[T2:.+]] = arith.addi %[[ARG3]], %[[C1]] : index
-// CHECK:                 memref.store %[[V2]], %[[BUF]][%[[ARG3]], %[[ARG2]]]
-// CHECK:                 memref.store %[[V1]], %[[BUF]][%[[T2]], %[[ARG2]]]
-// CHECK:               }
+// CHECK-DAG:     %[[C16:.+]] = arith.constant 16 : index
+// CHECK-DAG:     %[[C32:.+]] = arith.constant 32 : index
+// CHECK:         scf.for %{{.+}} = %[[C0]] to %[[C16]] step %[[C16]]
+// CHECK:           scf.for %[[J:.+]] = %[[C0]] to %[[C32]] step %[[C1]]
+// CHECK:             scf.for
+// CHECK:               scf.while
+// CHECK:                 memref.load %[[BUF]][%{{.+}}, %[[J]]]
+// CHECK:                 arith.cmpi sgt
+// CHECK:               scf.condition
+// CHECK:             } do {
+// CHECK:             ^bb0(%[[ROOT:.+]]: index, %[[NEXT:.+]]: index):
+// CHECK:               memref.store %{{.+}}, %[[BUF]][%[[ROOT]], %[[J]]]
+// CHECK:               memref.store %{{.+}}, %[[BUF]][%[[NEXT]], %[[J]]]
+// CHECK:             scf.for
+// CHECK:               scf.while
 
 // -----
 
@@ -75,26 +81,18 @@ func @sort_multi(%arg0: memref<128xf32>, %arg1: memref<128xi32>) {
 // CHECK-LABEL: func @sort_multi
 // CHECK-SAME:    %[[BUF1:[a-zA-Z0-9]+]]
 // CHECK-SAME:    %[[BUF2:[a-zA-Z0-9]+]]
-// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
-// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
-// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
-// CHECK-DAG:     %[[C127:.+]] = arith.constant 127 : index
-// CHECK:         scf.for %[[ARG1:.+]] = %[[C0]] to %[[C128]] step %[[C1]]
-// CHECK:           scf.for %[[ARG2:.+]] = %[[C0]] to %[[C127]] step %[[C1]]
-// CHECK:             %[[T1:.+]] = arith.addi %[[ARG2]], %[[C1]] : index
-// CHECK:             %[[V1:.+]] = memref.load %[[BUF1]][%[[ARG2]]]
-// CHECK:             %[[V2:.+]] = memref.load %[[BUF1]][%[[T1]]]
-// CHECK:             %[[V3:.+]] = memref.load %[[BUF2]][%[[ARG2]]]
-// CHECK:             %[[V4:.+]] = memref.load %[[BUF2]][%[[T1]]]
-// CHECK:             %[[COND:.+]] = arith.cmpf ogt, %[[V1]], %[[V2]] : f32
-// CHECK:             scf.if %[[COND]] {
-// CHECK:             } else {
-// CHECK:               %[[T2:.+]] = arith.addi %[[ARG2]], %[[C1]] : index
-// CHECK:               memref.store %[[V2]], %[[BUF1]][%[[ARG2]]]
-// CHECK:               memref.store %[[V1]], %[[BUF1]][%[[T2]]]
-// CHECK:               memref.store %[[V4]], %[[BUF2]][%[[ARG2]]]
-// CHECK:               memref.store %[[V3]], %[[BUF2]][%[[T2]]]
-// CHECK:             }
+// CHECK:         scf.while
+// CHECK:           %[[V1:.+]] = memref.load %[[BUF1]]
+// CHECK:           %[[V2:.+]] = memref.load %[[BUF1]]
+// CHECK:           memref.load %[[BUF2]]
+// CHECK:           memref.load %[[BUF2]]
+// CHECK:           arith.cmpf ogt, %[[V1]], %[[V2]] : f32
+// CHECK:         } do {
+// CHECK:         ^bb0(%[[ROOT:.+]]: index, %[[NEXT:.+]]: index):
+// CHECK:           memref.store %{{.+}}, %[[BUF1]][%[[ROOT]]]
+// CHECK:           memref.store %{{.+}}, %[[BUF1]][%[[NEXT]]]
+// CHECK:           memref.store %{{.+}}, %[[BUF2]][%[[ROOT]]]
+// CHECK:           memref.store %{{.+}}, %[[BUF2]][%[[NEXT]]]
 
 // -----
 
@@ -214,6 +212,70 @@ func @scatter_add_scalar_1D(
 
 // -----
 
+func @scatter_repeated_indices_add_1D(
+    %original: memref<8xi32>, %indices: memref<3x1xi32>,
+    %updates: memref<3xi32>) {
+  iree_linalg_ext.scatter unique_indices(false)
+    ins(%updates, %indices : memref<3xi32>, memref<3x1xi32>)
+    outs(%original : memref<8xi32>)  {
+  ^bb0(%arg0: i32, %arg1: i32):  // no predecessors
+    %0 = arith.addi %arg1, %arg0 : i32
+    iree_linalg_ext.yield %0 : i32
+  }
+  return
+}
+// CHECK-LABEL: func @scatter_repeated_indices_add_1D
+// CHECK-SAME:    %[[ORIGINAL:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[UPDATES:[a-zA-Z0-9]+]]
+// CHECK:         scf.for %[[I:.+]] =
+// CHECK:           %[[T1:.+]] = memref.load %[[UPDATES]][%[[I]]] : memref<3xi32>
+// CHECK:           %[[T2:.+]] = memref.load %[[INDICES]][%[[I]], %{{.+}}] : memref<3x1xi32>
+// CHECK:           %[[IDX:.+]] = arith.index_cast %[[T2]] : i32 to index
+// CHECK:           memref.atomic_rmw addi %[[T1]], %[[ORIGINAL]][%[[IDX]]] : (i32, memref<8xi32>) -> i32
+// CHECK-NOT:       memref.store
+
+// -----
+
+func @scatter_repeated_indices_addf_1D(
+    %original: memref<8xf32>, %indices: memref<3x1xi32>,
+    %updates: memref<3xf32>) {
+  iree_linalg_ext.scatter unique_indices(false)
+    ins(%updates, %indices : memref<3xf32>, memref<3x1xi32>)
+    outs(%original : memref<8xf32>)  {
+  ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+    %0 = arith.addf %arg1, %arg0 : f32
+    iree_linalg_ext.yield %0 : f32
+  }
+  return
+}
+// Float atomics are not available on every target.
+// CHECK-LABEL: func @scatter_repeated_indices_addf_1D
+// CHECK-NOT:     memref.atomic_rmw
+// CHECK:         %[[ADD:.+]] = arith.addf
+// CHECK:         memref.store %[[ADD]]
+
+// -----
+
+func @scatter_repeated_indices_sub_1D(
+    %original: memref<8xf32>, %indices: memref<3x1xi32>,
+    %updates: memref<3xf32>) {
+  iree_linalg_ext.scatter unique_indices(false)
+    ins(%updates, %indices : memref<3xf32>, memref<3x1xi32>)
+    outs(%original : memref<8xf32>)  {
+  ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+    %0 = arith.subf %arg1, %arg0 : f32
+    iree_linalg_ext.yield %0 : f32
+  }
+  return
+}
+// CHECK-LABEL: func @scatter_repeated_indices_sub_1D
+// CHECK-NOT:     memref.atomic_rmw
+// CHECK:         %[[SUB:.+]] = arith.subf
+// CHECK:         memref.store %[[SUB]]
+
+// -----
+
 func @scatter_add_slice_2D(
     %original: memref<4x3xi32>, %indices: memref<2x1xi32>,
     %updates: memref<2x3xi32>) {
@@ -629,3 +691,70 @@ func @scan_2d(%0: memref<16x32xi32>, %1: memref<16x32xi32>) {
 // CHECK:               memref.store %[[V4]], %[[BUFO]][%[[ARG1]], %[[ARG2]]]
 // CHECK:               memref.store %[[V4]], %[[ACC]][%[[ARG2]]]
 // CHECK:             }
+
+// -----
+
+func @topk_memref(%input_values: memref<2x10xf32>, %input_indices: memref<2x10xi32>, %out_values: memref<2x3xf32>, %out_indices: memref<2x3xi32>) {
+  iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values, %input_indices : memref<2x10xf32> , memref<2x10xi32>)
+        outs(%out_values, %out_indices : memref<2x3xf32>, memref<2x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        }
+  return
+}
+// CHECK-LABEL: func @topk_memref
+//  CHECK-SAME:   %[[INPUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[INPUT_INDICES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_INDICES:[a-zA-Z0-9_]+]]
+//   CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[C2:.+]] = arith.constant 2 : index
+//   CHECK-DAG:   %[[C10:.+]] = arith.constant 10 : index
+//       CHECK:   scf.for %[[I:.+]] = %[[C0]] to %[[C2]] step %[[C1]]
+//       CHECK:     scf.for %[[J:.+]] = %[[C0]] to %[[C10]] step %[[C1]]
+//       CHECK:       %[[VALUE:.+]] = memref.load %[[INPUT_VALUES]][%[[I]], %[[J]]]
+//       CHECK:       %[[INDEX:.+]] = memref.load %[[INPUT_INDICES]][%[[I]], %[[J]]]
+//       CHECK:       %[[LAST:.+]] = memref.load %[[OUT_VALUES]][%[[I]], %{{.+}}]
+//       CHECK:       %[[SELECTED:.+]] = arith.cmpf ogt, %[[VALUE]], %[[LAST]] : f32
+//       CHECK:       scf.if %[[SELECTED]] {
+//       CHECK:         %[[FALSE:.+]] = arith.constant false
+//       CHECK:         scf.for %[[K:.+]] = %{{.+}} to %{{.+}} step %{{.+}} iter_args(%[[V:.+]] = %[[VALUE]], %[[IDX:.+]] = %[[INDEX]], %[[INSERTED:.+]] = %[[FALSE]])
+//       CHECK:           %[[OUT_V:.+]] = memref.load %[[OUT_VALUES]][%[[I]], %[[K]]]
+//       CHECK:           %[[OUT_I:.+]] = memref.load %[[OUT_INDICES]][%[[I]], %[[K]]]
+//       CHECK:           %[[CMP:.+]] = arith.cmpf ogt, %[[V]], %[[OUT_V]] : f32
+//       CHECK:           %[[SWAP:.+]] = arith.ori %[[INSERTED]], %[[CMP]] : i1
+//       CHECK:           %[[NEW_V:.+]] = arith.select %[[SWAP]], %[[V]], %[[OUT_V]] : f32
+//       CHECK:           memref.store %[[NEW_V]], %[[OUT_VALUES]][%[[I]], %[[K]]]
+//       CHECK:           %[[NEW_I:.+]] = arith.select %[[SWAP]], %[[IDX]], %[[OUT_I]] : i32
+//       CHECK:           memref.store %[[NEW_I]], %[[OUT_INDICES]][%[[I]], %[[K]]]
+//       CHECK:           %[[NEXT_V:.+]] = arith.select %[[SWAP]], %[[OUT_V]], %[[V]] : f32
+//       CHECK:           %[[NEXT_I:.+]] = arith.select %[[SWAP]], %[[OUT_I]], %[[IDX]] : i32
+//       CHECK:           scf.yield %[[NEXT_V]], %[[NEXT_I]], %[[SWAP]]
+
+// -----
+
+func @topk_memref_optional(%input_values: memref<10xi32>, %out_values: memref<3xi32>, %out_indices: memref<3xi32>) {
+  iree_linalg_ext.topk
+        dimension(0)
+        ins(%input_values : memref<10xi32>)
+        outs(%out_values, %out_indices : memref<3xi32>, memref<3xi32>) {
+        ^bb0(%arg0: i32, %arg1: i32):  // no predecessors
+          %0 = arith.cmpi slt, %arg0, %arg1 : i32
+          iree_linalg_ext.yield %0 : i1
+        }
+  return
+}
+// CHECK-LABEL: func @topk_memref_optional
+//  CHECK-SAME:   %[[INPUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_INDICES:[a-zA-Z0-9_]+]]
+//       CHECK:   scf.for %[[I:.+]] =
+//       CHECK:     %[[VALUE:.+]] = memref.load %[[INPUT_VALUES]][%[[I]]]
+//       CHECK:     %[[INDEX:.+]] = arith.index_cast %[[I]] : index to i32
+//       CHECK:     arith.cmpi slt, %[[VALUE]]
+//       CHECK:     scf.if
+//       CHECK:       scf.for {{.+}} iter_args(%{{.+}} = %[[VALUE]], %{{.+}} = %[[INDEX]], %{{.+}} = %{{.+}})
@@ -446,3 +446,48 @@ func @type_mismatch(%1 : tensor<1xf32>, %out : tensor<200xf32>) -> () {
       }
   }
 }
+
+// -----
+
+func @topk_invalid_dimension(%input_values: tensor<2x10xf32>, %out_values : tensor<2x3xf32>, %out_indices: tensor<2x3xi32>) -> (tensor<2x3xf32>, tensor<2x3xi32>) {
+  // expected-error@+1 {{dimension must be within [0, 2)}}
+  %0:2 = iree_linalg_ext.topk
+        dimension(2)
+        ins(%input_values : tensor<2x10xf32>)
+        outs(%out_values, %out_indices : tensor<2x3xf32>, tensor<2x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        } -> tensor<2x3xf32>, tensor<2x3xi32>
+  return %0#0, %0#1 : tensor<2x3xf32>, tensor<2x3xi32>
+}
+
+// -----
+
+func @topk_invalid_index_type(%input_values: tensor<2x10xf32>, %out_values : tensor<2x3xf32>, %out_indices: tensor<2x3xi64>) -> (tensor<2x3xf32>, tensor<2x3xi64>) {
+  // expected-error@+1 {{expected output indices to be of type i32}}
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values : tensor<2x10xf32>)
+        outs(%out_values, %out_indices : tensor<2x3xf32>, tensor<2x3xi64>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        } -> tensor<2x3xf32>, tensor<2x3xi64>
+  return %0#0, %0#1 : tensor<2x3xf32>, tensor<2x3xi64>
+}
+
+// -----
+
+func @topk_invalid_shapes(%input_values: tensor<2x10xf32>, %out_values : tensor<4x3xf32>, %out_indices: tensor<4x3xi32>) -> (tensor<4x3xf32>, tensor<4x3xi32>) {
+  // expected-error@+1 {{incompatible input/output shapes}}
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values : tensor<2x10xf32>)
+        outs(%out_values, %out_indices : tensor<4x3xf32>, tensor<4x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        } -> tensor<4x3xf32>, tensor<4x3xi32>
+  return %0#0, %0#1 : tensor<4x3xf32>, tensor<4x3xi32>
+}
@@ -594,3 +594,51 @@ func @no_terminator() -> () {
   }
   return
 }
+
+// -----
+
+func @topk_tensor(%input_values: tensor<2x10xf32>, %input_indices: tensor<2x10xi32>, %out_values : tensor<2x3xf32>, %out_indices: tensor<2x3xi32>) -> (tensor<2x3xf32>, tensor<2x3xi32>) {
+  %0:2 = iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values, %input_indices : tensor<2x10xf32> , tensor<2x10xi32>)
+        outs(%out_values, %out_indices : tensor<2x3xf32>, tensor<2x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        } -> tensor<2x3xf32>, tensor<2x3xi32>
+  return %0#0, %0#1 : tensor<2x3xf32>, tensor<2x3xi32>
+}
+// CHECK-LABEL: func @topk_tensor
+//  CHECK-SAME:   %[[INPUT_VALUES:[a-zA-Z0-9_]+]]: tensor<2x10xf32>
+//  CHECK-SAME:   %[[INPUT_INDICES:[a-zA-Z0-9_]+]]: tensor<2x10xi32>
+//  CHECK-SAME:   %[[OUT_VALUES:[a-zA-Z0-9_]+]]: tensor<2x3xf32>
+//  CHECK-SAME:   %[[OUT_INDICES:[a-zA-Z0-9_]+]]: tensor<2x3xi32>
+//       CHECK:   %[[RESULT:.+]]:2 = iree_linalg_ext.topk
+//  CHECK-SAME:      dimension(1)
+//  CHECK-SAME:      ins(%[[INPUT_VALUES]], %[[INPUT_INDICES]]
+//  CHECK-SAME:      outs(%[[OUT_VALUES]], %[[OUT_INDICES]]
+//       CHECK:   iree_linalg_ext.yield
+//       CHECK:   return %[[RESULT]]#0, %[[RESULT]]#1
+
+// -----
+
+func @topk_memref_optional(%input_values: memref<?x?xf32>, %out_values: memref<?x3xf32>, %out_indices: memref<?x3xi32>) {
+  iree_linalg_ext.topk
+        dimension(1)
+        ins(%input_values : memref<?x?xf32>)
+        outs(%out_values, %out_indices : memref<?x3xf32>, memref<?x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf olt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        }
+  return
+}
+// CHECK-LABEL: func @topk_memref_optional
+//  CHECK-SAME:   %[[INPUT_VALUES:[a-zA-Z0-9_]+]]: memref<?x?xf32>
+//  CHECK-SAME:   %[[OUT_VALUES:[a-zA-Z0-9_]+]]: memref<?x3xf32>
+//  CHECK-SAME:   %[[OUT_INDICES:[a-zA-Z0-9_]+]]: memref<?x3xi32>
+//       CHECK:   iree_linalg_ext.topk
+//  CHECK-SAME:      dimension(1)
+//  CHECK-SAME:      ins(%[[INPUT_VALUES]]
+//  CHECK-SAME:      outs(%[[OUT_VALUES]], %[[OUT_INDICES]]
+//       CHECK:   iree_linalg_ext.yield
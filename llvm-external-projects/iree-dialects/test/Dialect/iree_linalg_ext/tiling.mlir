@@ -231,7 +231,7 @@ func @scatter_repeated_indices_no_tiling(
     ins(%update, %indices : tensor<?x?xf32>, tensor<?x1xi32>)
     outs(%original : tensor<?x?xf32>) {
     ^bb0(%arg1: f32, %arg2: f32):
-      %1 = arith.addf %arg1, %arg2 : f32
+      %1 = arith.mulf %arg1, %arg2 : f32
       iree_linalg_ext.yield %1 : f32
     } -> tensor<?x?xf32>
   return %0 : tensor<?x?xf32>
@@ -1350,3 +1350,42 @@ func @scan_2d_memref(%0: memref<16x32xi32>, %1: memref<16x32xi32>) {
 // CHECK-SAME:       ins(%[[UPDATE_SLICE_IN]]
 // CHECK-SAME:       outs(%[[UPDATE_SLICE_OUT]], %[[UPDATE_SLICE_ACC]]
 //      CHECK:   return
+
+// -----
+
+func @topk_tile_tensor(%input_values: tensor<?x?xf32>, %input_indices: tensor<?x?xi32>, %out_values: tensor<?x3xf32> , %out_indices: tensor<?x3xi32>) -> (tensor<?x3xf32>, tensor<?x3xi32>) {
+  %0:2 = iree_linalg_ext.topk
+        {__internal_linalg_transform__ = "inner_reduce_input"}
+        dimension(1)
+        ins(%input_values, %input_indices : tensor<?x?xf32> , tensor<?x?xi32>)
+        outs(%out_values, %out_indices : tensor<?x3xf32>, tensor<?x3xi32>) {
+        ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+          %0 = arith.cmpf ogt, %arg0, %arg1 : f32
+          iree_linalg_ext.yield %0 : i1
+        } -> tensor<?x3xf32>, tensor<?x3xi32>
+  return %0#0, %0#1 : tensor<?x3xf32>, tensor<?x3xi32>
+}
+//       CHECK: func @topk_tile_tensor
+//  CHECK-SAME:   %[[INPUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[INPUT_INDICES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_VALUES:[a-zA-Z0-9_]+]]
+//  CHECK-SAME:   %[[OUT_INDICES:[a-zA-Z0-9_]+]]
+//   CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C10:.+]] = arith.constant 10 : index
+//   CHECK-DAG:   %[[D0:.+]] = tensor.dim %[[INPUT_VALUES]], %[[C0]]
+//       CHECK:   %[[RESULT:.+]]:2 = scf.for %[[I:.+]] = %[[C0]] to %[[D0]] step %[[C10]]
+//  CHECK-SAME:       iter_args(%[[ITER_V:.+]] = %[[OUT_VALUES]], %[[ITER_I:.+]] = %[[OUT_INDICES]])
+//       CHECK:     %[[SZ:.+]] = affine.min
+//       CHECK:     %[[VALUES_TILE:.+]] = tensor.extract_slice %[[INPUT_VALUES]][%[[I]], 0]
+//       CHECK:     %[[INDICES_TILE:.+]] = tensor.extract_slice %[[INPUT_INDICES]][%[[I]], 0]
+//       CHECK:     %[[OUT_VALUES_TILE:.+]] = tensor.extract_slice %[[ITER_V]][%[[I]], 0] [%[[SZ]], 3]
+//       CHECK:     %[[OUT_INDICES_TILE:.+]] = tensor.extract_slice %[[ITER_I]][%[[I]], 0] [%[[SZ]], 3]
+//       CHECK:     %[[TOPK:.+]]:2 = iree_linalg_ext.topk
+//  CHECK-SAME:         {__internal_linalg_transform__ = "inner_reduce_output"}
+//  CHECK-SAME:         dimension(1)
+//  CHECK-SAME:         ins(%[[VALUES_TILE]], %[[INDICES_TILE]]
+//  CHECK-SAME:         outs(%[[OUT_VALUES_TILE]], %[[OUT_INDICES_TILE]]
+//       CHECK:     %[[INSERT_V:.+]] = tensor.insert_slice %[[TOPK]]#0 into %[[ITER_V]][%[[I]], 0] [%[[SZ]], 3]
+//       CHECK:     %[[INSERT_I:.+]] = tensor.insert_slice %[[TOPK]]#1 into %[[ITER_I]][%[[I]], 0] [%[[SZ]], 3]
+//       CHECK:     scf.yield %[[INSERT_V]], %[[INSERT_I]]
+//       CHECK:   return %[[RESULT]]#0, %[[RESULT]]#1